@@ -0,0 +1,147 @@
+/**
+  @file at24cModel.c
+  @brief Behavioral model of an AT24Cxx serial eeprom, see at24cModel.h
+<pre>
+	The bus side (hostHal.c) calls, for each transaction:
+
+		at24cModelAddress(..)		- after START + device address, returns ACK.
+		at24cModelWriteByte(..)		- each byte master writes.
+		at24cModelReadByte(..)		- each byte master reads.
+		at24cModelStop(..)			- STOP, starts tWR if data bytes were latched.
+
+	A repeated START (random read) is just another at24cModelAddress(..)
+	call without a stop, the latch is then dropped as on the real part.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/10/2018
+
+*/
+#include <string.h>
+#include "at24cModel.h"
+
+/**
+ * @brief Configure the model, memory starts as all 0xFF (blank part).
+ *
+ * @param m				- model.
+ * @param addr7Bit		- 7 bit I2C address.
+ * @param capacity		- bytes, power of 2, <= AT24C_MODEL_MAX_BYTES.
+ * @param pageSize		- bytes, power of 2, <= AT24C_MODEL_MAX_PAGE.
+ * @param addressBytes	- word address bytes, 1 or 2.
+ * @param twrNs			- internal write cycle time in ns, (0 for none).
+ */
+void at24cModelInit(at24cModel *m, uint8_t addr7Bit, uint32_t capacity, uint16_t pageSize,
+					uint8_t addressBytes, uint32_t twrNs)
+{
+	memset(m, 0, sizeof(*m));
+
+	m->addr7Bit		= addr7Bit;
+	m->capacity		= capacity;
+	m->pageSize		= pageSize;
+	m->addressBytes = addressBytes;
+	m->twrNs		= twrNs;
+
+	at24cModelFill(m, 0xFF);
+}
+
+/**
+ * @brief Set the whole memory to value, (no write cycles counted).
+ */
+void at24cModelFill(at24cModel *m, uint8_t value)
+{
+	memset(m->mem, value, m->capacity);
+}
+
+/**
+ * @brief START + device address byte.
+ *
+ * @param m			- model.
+ * @param isRead	- R/W* bit.
+ * @param nowNs		- simulated time of the address byte.
+ * @returns true for ACK, false for NACK (internal write cycle still running).
+ */
+bool at24cModelAddress(at24cModel *m, bool isRead, uint64_t nowNs)
+{
+	if (nowNs < m->busyUntilNs)
+	{
+		m->nacks++;
+		m->writing = false;
+		return false;
+	}
+
+	// A (repeated) START abandons any write in progress without a write cycle.
+	m->writing			= !isRead;
+	m->addressBytesSeen = 0;
+	m->latchCount		= 0;
+	memset(m->latchUsed, 0, sizeof(m->latchUsed));
+
+	return true;
+}
+
+/**
+ * @brief One byte written by master, word address first then data.
+ */
+void at24cModelWriteByte(at24cModel *m, uint8_t byte)
+{
+	uint32_t offset;
+
+	if (!m->writing)
+	{
+		return;
+	}
+
+	if (m->addressBytesSeen < m->addressBytes)
+	{
+		// Word address, MSB first.  Unused upper bits are don't care.
+		if (m->addressBytesSeen == 0)
+		{
+			m->addrPointer = 0;
+		}
+		m->addrPointer = ((m->addrPointer << 8) | byte) & (m->capacity - 1);
+		m->addressBytesSeen++;
+		m->latchBase = m->addrPointer & ~((uint32_t)m->pageSize - 1);
+		return;
+	}
+
+	// Data byte into page latch, only the low address bits increment.
+	offset = m->addrPointer & ((uint32_t)m->pageSize - 1);
+	m->latch[offset]	 = byte;
+	m->latchUsed[offset] = true;
+	m->latchCount++;
+	m->addrPointer = m->latchBase | ((offset + 1) & ((uint32_t)m->pageSize - 1));
+}
+
+/**
+ * @brief One byte read by master, from current address, rolls over at end of memory.
+ */
+uint8_t at24cModelReadByte(at24cModel *m)
+{
+	uint8_t byte = m->mem[m->addrPointer];
+
+	m->addrPointer = (m->addrPointer + 1) & (m->capacity - 1);
+	m->bytesRead++;
+	return byte;
+}
+
+/**
+ * @brief STOP condition, latched data is written and tWR starts.
+ */
+void at24cModelStop(at24cModel *m, uint64_t nowNs)
+{
+	uint32_t i;
+
+	if (m->writing && (m->latchCount != 0))
+	{
+		for (i = 0; i < m->pageSize; i++)
+		{
+			if (m->latchUsed[i])
+			{
+				m->mem[m->latchBase + i] = m->latch[i];
+				m->bytesWritten++;
+			}
+		}
+		m->writeCycles++;
+		m->busyUntilNs = nowNs + m->twrNs;
+	}
+	m->writing = false;
+}
@@ -0,0 +1,71 @@
+/**
+  @file at24cModel.h
+  @brief Behavioral model of an AT24Cxx serial eeprom, for host side tests and benchmarks.
+<pre>
+	Models what the AT24C128/256 data sheet (0670F-SEEPR-2/02) says the part
+	does on the bus, at transaction level:
+
+	@li Word address of 1 or 2 bytes, upper unused address bits ignored.
+	@li Page write latch, low address bits roll over inside the page.
+	@li Partial page writes only change the bytes sent.
+	@li Internal write cycle tWR after STOP, device address NACKed until done.
+	@li Current address pointer, last address accessed + 1.
+	@li Sequential read rolls over from last byte of memory to byte 0.
+
+	The same model configured as 128 bytes, one page, 1 byte address and no
+	tWR behaves like the PIC16F15376 "EEPROM simulator" slave.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/10/2018
+
+*/
+
+#ifndef AT24CMODEL_H_
+#define AT24CMODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Largest device the model can hold, AT24C512.
+#define AT24C_MODEL_MAX_BYTES	65536
+#define AT24C_MODEL_MAX_PAGE	128
+
+typedef struct {
+	// Configuration:
+	uint8_t	 addr7Bit;					// 7 bit I2C device address.
+	uint32_t capacity;					// Bytes, power of 2.
+	uint16_t pageSize;					// Bytes, power of 2.
+	uint8_t	 addressBytes;				// Word address bytes, 1 or 2.
+	uint32_t twrNs;						// Internal write cycle time.
+
+	// Device state:
+	uint8_t	 mem[AT24C_MODEL_MAX_BYTES];
+	uint32_t addrPointer;				// Current address counter.
+	uint64_t busyUntilNs;				// End of internal write cycle.
+
+	// Write transaction in progress:
+	bool	 writing;
+	uint8_t	 addressBytesSeen;
+	uint32_t latchBase;					// Page base address of latch.
+	uint8_t	 latch[AT24C_MODEL_MAX_PAGE];
+	bool	 latchUsed[AT24C_MODEL_MAX_PAGE];
+	uint32_t latchCount;				// Data bytes received.
+
+	// Statistics:
+	uint32_t writeCycles;
+	uint32_t nacks;
+	uint32_t bytesRead;
+	uint32_t bytesWritten;
+} at24cModel;
+
+void at24cModelInit(at24cModel *m, uint8_t addr7Bit, uint32_t capacity, uint16_t pageSize,
+					uint8_t addressBytes, uint32_t twrNs);
+void at24cModelFill(at24cModel *m, uint8_t value);
+
+bool at24cModelAddress(at24cModel *m, bool isRead, uint64_t nowNs);
+void at24cModelWriteByte(at24cModel *m, uint8_t byte);
+uint8_t at24cModelReadByte(at24cModel *m);
+void at24cModelStop(at24cModel *m, uint64_t nowNs);
+
+#endif /* AT24CMODEL_H_ */
@@ -0,0 +1,1736 @@
+/**
+  @file hostBench.c
+  @brief Host side regression checks and benchmarks for the serial eeprom code.
+<pre>
+	Runs the real serialEEProm.c / eePromLog.c against the AT24Cxx model,
+	(the part selected by SEE_PART, see serialEEProm.h), on a simulated I2C bus, checks the data sheet behaviors the driver
+	relies on, and reports simulated bus time for common operations at
+	100 KHz, 400 KHz and 1 MHz.
+
+	Build and run on a PC, from the project directory:
+
+		gcc -std=gnu99 -Wall -IHostSim -IInc HostSim/at24cModel.c HostSim/hostHal.c HostSim/hostBench.c \
+			Src/serialEEProm.c Src/eePromLog.c Src/eePromFill.c Src/eePromCrc.c Src/i2cTrace.c Src/i2cSlaveEE.c \
+			Src/i2cScan.c Src/i2cBus.c Src/eePromCopy.c Src/i2cRetry.c Src/picEEBatch.c Src/i2cRegMap.c Src/adcSampler.c Src/adcFilter.c Src/adcAlarm.c Src/adcTemp.c Src/mainEvent.c Src/taskSched.c Src/pendWork.c Src/i2c_jmk.c Src/idleSleep.c -o hostBench
+		./hostBench
+
+	Add -DSEE_PART=AT24C64 etc. to both lines to check another part.
+
+	Exit code is the number of failed checks.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/10/2018
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "hostSim.h"
+#include "at24cModel.h"
+#include "serialEEProm.h"
+#include "eePromLog.h"
+#include "eePromFill.h"
+#include "eePromCrc.h"
+#include "i2c_jmk.h"
+#include "i2cTrace.h"
+#include "i2cSlaveEE.h"
+#include "i2cScan.h"
+#include "i2cBus.h"
+#include "eePromCopy.h"
+#include "i2cRetry.h"
+#include "picEEBatch.h"
+#include "i2cRegMap.h"
+#include "adcSampler.h"
+#include "adcFilter.h"
+#include "adcAlarm.h"
+#include "adcTemp.h"
+#include "mainEvent.h"
+#include "taskSched.h"
+#include "pendWork.h"
+#include "idleSleep.h"
+
+/// Part from serialEEProm.h descriptors, tWR at typical, (half the data sheet max).
+#define MODEL_CAPACITY	AT24C_DEVICE_BYTES
+#define MODEL_TWR_NS	(AT24C_TWR_MAX_MS * 500000)
+
+#define P				AT24C_PAGE_SIZE
+
+static at24cModel eeprom;
+static uint8_t	  buffer[AT24C_PAGE_SIZE];
+static int		  failures;
+
+#define CHECK(cond, what)	check((cond), (what), __LINE__)
+
+static void check(bool passed, const char *what, int line)
+{
+	if (!passed)
+	{
+		printf("  FAIL line %d: %s\n", line, what);
+		failures++;
+	}
+}
+
+/**
+ * @brief Fresh blank part at A0A1_00, bus at busHz.
+ */
+static void setupBus(uint32_t busHz)
+{
+	hostSimReset();
+	at24cModelInit(&eeprom, A0A1_00, MODEL_CAPACITY, AT24C_PAGE_SIZE, AT24C_ADDR_BYTES, MODEL_TWR_NS);
+	hostSimAttach(&eeprom);
+
+	memset(&hi2c2, 0, sizeof(hi2c2));
+	memset(&sEEBusRecovery, 0, sizeof(sEEBusRecovery));
+	i2cTraceClear();
+	i2cRetryInit();
+	hi2c2.Instance		  = I2C2;
+	hi2c2.Init.ClockSpeed = busHz;
+	hi2c2.State			  = HAL_I2C_STATE_READY;
+}
+
+static double elapsedMs(uint64_t startNs)
+{
+	return (double)(hostSimNowNs() - startNs) / 1000000.0;
+}
+
+/* ---------------------------------------------------------------------------
+ * Model / driver behavior checks.
+ * ------------------------------------------------------------------------- */
+
+static void testPageRollover(void)
+{
+	uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	printf("Page write rollover\n");
+	setupBus(100000);
+
+	// 8 bytes 4 before the end of page 1: 4 land at its end, 4 roll over to 0..3 of same page.
+	CHECK(sEEPromBytesWrite(&hi2c2, A0A1_00, 2 * P - 4, data, 8) == HAL_OK, "write started");
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_OK, "write completed");
+	CHECK(eeprom.mem[2 * P - 4] == 1 && eeprom.mem[2 * P - 1] == 4, "bytes up to page end");
+	CHECK(eeprom.mem[P] == 5 && eeprom.mem[P + 3] == 8, "bytes rolled to page start");
+	CHECK(eeprom.mem[2 * P] == 0xFF, "next page untouched");
+	CHECK(eeprom.writeCycles == 1, "one write cycle");
+}
+
+static void testBusyNack(void)
+{
+	uint64_t start;
+	uint8_t	 byte = 0x77;
+
+	printf("tWR busy NACK and ACK polling\n");
+	setupBus(100000);
+
+	sEEPromByteWrite(&hi2c2, A0A1_00, 0x0000, &byte);
+	sEEPromWaitForIdle(&hi2c2);
+
+	// Straight after STOP the part is in tWR, address must be NACKed, (no retries).
+	i2cRetryPolicy[I2CRETRY_NACK].maxRetries = 0;
+	CHECK(sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, buffer) == HAL_OK, "read started");
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_ERROR, "read NACKed during tWR");
+	CHECK(hi2c2.ErrorCode == HAL_I2C_ERROR_AF, "error is AF");
+
+	start = hostSimNowNs();
+	CHECK(sEEPromAckPoll(&hi2c2, A0A1_00) == HAL_OK, "ack poll completes");
+	CHECK(elapsedMs(start) < (MODEL_TWR_NS / 1000000.0) + 0.5, "ack poll ends just after tWR");
+
+	sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, buffer);
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_OK && buffer[0] == 0x77, "read back after tWR");
+
+	// With the default policy the NACKs during tWR are retried, the read just takes longer.
+	i2cRetryInit();
+	byte = 0x78;
+	sEEPromByteWrite(&hi2c2, A0A1_00, 0x0000, &byte);
+	sEEPromWaitForIdle(&hi2c2);
+	start = hostSimNowNs();
+	CHECK(sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, buffer) == HAL_OK, "read started in tWR");
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_OK && buffer[0] == 0x78, "read retried through tWR");
+	CHECK(i2cRetryState.retries[I2CRETRY_NACK] > 0 && i2cRetryState.giveUps[I2CRETRY_NACK] == 0, "NACKs retried");
+	CHECK(elapsedMs(start) < (MODEL_TWR_NS / 1000000.0) + 1.5, "read ends within a backoff of tWR");
+}
+
+static void testCurrentAddress(void)
+{
+	uint8_t byte;
+
+	printf("Current address pointer\n");
+	setupBus(100000);
+	eeprom.mem[0x0104] = 0xA5;
+
+	sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0100, buffer, 4);
+	sEEPromWaitForIdle(&hi2c2);
+	CHECK(sEEPromCurrentAddrReadByte(&hi2c2, A0A1_00, &byte) == HAL_OK, "current address read");
+	CHECK(byte == 0xA5, "continues after last byte read");
+}
+
+static void testSequentialWrap(void)
+{
+	printf("Sequential read wraparound\n");
+	setupBus(100000);
+	eeprom.mem[MODEL_CAPACITY - 2] = 0x11;
+	eeprom.mem[MODEL_CAPACITY - 1] = 0x22;
+	eeprom.mem[0x0000] = 0x33;
+	eeprom.mem[0x0001] = 0x44;
+
+	sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, MODEL_CAPACITY - 2, buffer, 4);
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_OK, "read completed");
+	CHECK(buffer[0] == 0x11 && buffer[1] == 0x22 && buffer[2] == 0x33 && buffer[3] == 0x44,
+		  "rolls over from last byte to byte 0");
+}
+
+static uint32_t deafAtTransaction;
+static uint64_t deafForNs;
+
+/// hostSimOnTransaction: part NACKs everything for deafForNs from transaction deafAtTransaction on.
+static void deafenPart(uint32_t transaction)
+{
+	if (transaction == deafAtTransaction)
+	{
+		eeprom.busyUntilNs = hostSimNowNs() + deafForNs;
+	}
+}
+
+static void testLogger(void)
+{
+	uint32_t i;
+	uint16_t head;
+	uint32_t cycles;
+	uint32_t nacks;
+
+	printf("Record log mount, wrap and torn page\n");
+	setupBus(400000);
+
+	eeLogInit();
+	CHECK(eeLogState.pageCount == 0, "blank device, empty log");
+
+	for (i = 0; i < 5 * EELOG_RECORDS_PER_PAGE; i++)
+	{
+		eeLogAppend(EELOG_TYPE_EVENT, EELOG_EVT_BUTTON, (uint16_t)i);
+	}
+	eeLogInit();
+	CHECK(eeLogState.pageCount == 5 && eeLogState.headPage == 4 && eeLogState.tailPage == 0, "5 pages found");
+	CHECK(eeLogState.nextSeq == 5, "sequence continues");
+
+	// Wrap the ring, then 3 pages more.
+	for (i = 0; i < (EELOG_PAGE_COUNT - 5 + 3) * EELOG_RECORDS_PER_PAGE; i++)
+	{
+		eeLogAppend(EELOG_TYPE_EVENT, EELOG_EVT_BUTTON, (uint16_t)i);
+	}
+	head = eeLogState.headPage;
+	eeLogInit();
+	CHECK(eeLogState.headPage == head && eeLogState.headPage == 2, "head found after wrap");
+	CHECK(eeLogState.tailPage == 3 && eeLogState.pageCount == EELOG_PAGE_COUNT, "tail after head");
+
+	// Tear the head page, mount must fall back to the page before.
+	eeprom.mem[(EELOG_FIRST_PAGE + 2) * AT24C_PAGE_SIZE + 20] ^= 0x5A;
+	eeLogInit();
+	CHECK(eeLogState.headPage == 1, "torn head page skipped");
+	CHECK(eeLogState.tailPage == 3 && eeLogState.pageCount == EELOG_PAGE_COUNT - 1, "torn page not counted");
+	CHECK(eeLogState.mounted, "mounted");
+
+	// Part deaf from the first search probe, (page 0 read ok), for 1.5 ack polls: a retry reads it.
+	hostSimOnTransaction = deafenPart;
+	deafAtTransaction	 = hostSimStats.transactions + 3;
+	deafForNs			 = AT24C_TWR_MAX_MS * 1500000ULL;
+	nacks				 = hostSimStats.nacks;
+	eeLogInit();
+	CHECK(hostSimStats.nacks > nacks && eeLogState.mounted, "short fault mid search retried");
+	CHECK(eeLogState.headPage == 1 && eeLogState.pageCount == EELOG_PAGE_COUNT - 1, "same head found");
+
+	// Deaf past every retry: would read as blank, (head too early), must stay unmounted instead.
+	deafAtTransaction = hostSimStats.transactions + 3;
+	deafForNs		  = EELOG_MOUNT_TRIES * AT24C_TWR_MAX_MS * 2000000ULL;
+	eeLogInit();
+	CHECK(!eeLogState.mounted && eeLogState.pageCount == 0, "fault mid search, unmounted");
+	hostSimOnTransaction = NULL;
+
+	// NACKing at boot, then back: a full log must not be taken for an empty one, nothing committed.
+	eeprom.busyUntilNs = hostSimNowNs() + 1000000000ULL;
+	eeLogInit();
+	CHECK(!eeLogState.mounted, "NACKing part at boot, unmounted");
+	eeprom.busyUntilNs = 0;
+	cycles = eeprom.writeCycles;
+	for (i = 0; i < EELOG_RECORDS_PER_PAGE; i++)
+	{
+		eeLogAppend(EELOG_TYPE_EVENT, EELOG_EVT_BUTTON, (uint16_t)i);
+	}
+	CHECK(!eeLogFlush() && eeprom.writeCycles == cycles && eeLogState.commitErrors != 0, "unmounted log commits nothing");
+
+	// Absent at boot, then attached.
+	hostSimReset();
+	eeLogInit();
+	CHECK(!eeLogState.mounted && hostSimStats.nacks != 0, "absent part, unmounted");
+	hostSimAttach(&eeprom);
+	eeLogInit();
+	CHECK(eeLogState.mounted && eeLogState.headPage == 1, "mounted once attached");
+}
+
+static void testFill(void)
+{
+	uint32_t i;
+	bool	 match = true;
+
+	printf("Background fill, unaligned range and verify\n");
+	setupBus(400000);
+
+	// 3/4 into page 0 .. 10 bytes into page 5: short first chunk, 4 whole pages, short last chunk.
+	CHECK(eeFillStart(&hi2c2, A0A1_00, 3 * P / 4, 5 * P + 10 - 3 * P / 4, FILL_INDEX, true), "fill started");
+	CHECK(eeFillBusy() && (hi2c2.State != HAL_I2C_STATE_READY), "returns with fill running");
+	while (eeFillBusy())
+	{
+		hostSimIdle();
+	}
+	CHECK(eeFillState.state == EEFILL_DONE && eeFillState.verifyErrors == 0, "fill verified");
+	CHECK(eeFillState.chunksTotal == 12 && eeFillPercentDone() == 100, "6 chunks written, 6 read");
+	CHECK(eeprom.writeCycles == 6 && eeFillState.ackPolls != 0, "writes chained by ack polling");
+
+	for (i = 3 * P / 4; i < 5 * P + 10; i++)
+	{
+		match = match && (eeprom.mem[i] == (uint8_t)(i & (AT24C_PAGE_SIZE - 1)));
+	}
+	CHECK(match && eeprom.mem[3 * P / 4 - 1] == 0xFF && eeprom.mem[5 * P + 10] == 0xFF, "exactly the range written");
+
+	// Corrupt the part behind the engine's back during verify: must be reported.
+	CHECK(eeFillStart(&hi2c2, A0A1_00, 0, 2 * P, FILL_0, true), "second fill started");
+	while (eeFillState.state == EEFILL_WRITING)
+	{
+		hostSimIdle();
+	}
+	eeprom.mem[P + 1] = 0x5A;
+	while (eeFillBusy())
+	{
+		hostSimIdle();
+	}
+	CHECK(eeFillState.verifyErrors == 1 && eeFillState.firstBadAddr == P, "verify error found");
+
+	// Nobody home: must fail, not hang.
+	CHECK(eeFillStart(&hi2c2, A0A1_01, 0, P, FILL_0, false) == false, "no device, not started");
+}
+
+static uint16_t badPageSeen;
+
+static void noteBadPage(uint16_t page, uint16_t expectedCrc, uint16_t actualCrc)
+{
+	(void)expectedCrc;
+	(void)actualCrc;
+	badPageSeen = page;
+}
+
+static void testCrc(void)
+{
+	uint8_t data[4] = { 9, 8, 7, 6 };
+
+	printf("Page CRC table, scans and incremental check\n");
+	setupBus(400000);
+
+	CHECK(eeCrc16((const uint8_t *)"123456789", 9, 0xFFFF) == 0x29B1, "CRC-16 CCITT check value");
+
+	eeCrcInit();
+	CHECK(eeCrcUnknownPages() == EECRC_PAGE_COUNT, "blank part, no CRCs known");
+	CHECK(eeCrcRelearn() == EECRC_PAGE_COUNT && eeCrcUnknownPages() == 0, "all pages learned");
+	CHECK(eeCrcState.tablePagesSaved == EECRC_TABLE_PAGES, "whole table saved");
+
+	// Whole page write: CRC from the data.  Partial write: unknown until checked.
+	sEEPromPageBufferFill(&eePromWritePageBytes, FILL_REVERSE_INDEX);
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	sEEPromBytesWrite(&hi2c2, A0A1_00, 5 * AT24C_PAGE_SIZE, eePromWritePageBytes.array, AT24C_PAGE_SIZE);
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	sEEPromBytesWrite(&hi2c2, A0A1_00, 9 * AT24C_PAGE_SIZE + 3, data, sizeof(data));
+	CHECK(eeCrcChangedPages() == 2 && eeCrcUnknownPages() == 1, "writes noted");
+
+	CHECK(eeCrcScan(true, noteBadPage) == 0, "incremental check clean");
+	CHECK(eeCrcState.lastScanPages == 2 && eeCrcState.lastScanLearned == 1, "only changed pages read");
+	CHECK(eeCrcChangedPages() == 0 && eeCrcUnknownPages() == 0, "nothing left to check");
+
+	// Bit rot: full scan must name the page, also after a reload of the table.
+	eeprom.mem[77 * AT24C_PAGE_SIZE + 10] ^= 0x04;
+	badPageSeen = 0;
+	CHECK(eeCrcScan(false, noteBadPage) == 1 && badPageSeen == 77, "bad page found");
+	eeCrcInit();
+	CHECK(eeCrcUnknownPages() == 0, "table reloaded");
+	badPageSeen = 0;
+	CHECK(eeCrcScan(false, noteBadPage) == 1 && badPageSeen == 77, "bad page found after reload");
+
+	// Torn table page: its pages, (31 on a 64 byte page part), become unknown, the rest stay known.
+	eeprom.mem[(EECRC_TABLE_FIRST_PAGE + 3) * AT24C_PAGE_SIZE] ^= 0xFF;
+	eeCrcInit();
+	CHECK(eeCrcUnknownPages() == EECRC_ENTRIES_PER_TABLE, "torn table page only loses its entries");
+}
+
+static void testBusRecovery(void)
+{
+	uint8_t	 data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	uint64_t start;
+
+	printf("Stuck bus recovery and replay\n");
+	setupBus(100000);
+	eeprom.mem[0x0100] = 0x5A;
+
+	// Slave cut off mid byte, holding SDA: start is held off, recovered, then goes ahead.
+	hostSimBusFault(HOSTSIM_FAULT_SDA_HELD, 5);
+	start = hostSimNowNs();
+	CHECK(sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0100, buffer, 4) == HAL_OK, "read started after recovery");
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_OK && buffer[0] == 0x5A, "read completed");
+	CHECK(sEEBusRecovery.busyFlagHeld == 1 && sEEBusRecovery.recoveries == 1, "held bus seen and recovered");
+	CHECK(sEEBusRecovery.lastRecoverClocks == 5 && sEEBusRecovery.recoverFailed == 0, "SDA freed by clocking");
+	CHECK(elapsedMs(start) < SEE_I2C_BUSY_FLAG_MS + 3, "recovered in a few ms");
+
+	// Transfer stops moving: recovered and started again, caller just sees it complete.
+	hostSimBusFault(HOSTSIM_FAULT_HANG, 0);
+	start = hostSimNowNs();
+	CHECK(sEEPromBytesWrite(&hi2c2, A0A1_00, 2 * P, data, 8) == HAL_OK, "write started");
+	CHECK(sEEPromWaitForIdle(&hi2c2) == HAL_OK, "write completed after replay");
+	CHECK(sEEBusRecovery.stuckTransfers == 1 && sEEBusRecovery.replays == 1, "stuck write replayed");
+	CHECK(elapsedMs(start) < SEE_I2C_STUCK_MS + 3, "recovered just after stuck limit");
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	CHECK(eeprom.mem[2 * P] == 1 && eeprom.mem[2 * P + 7] == 8, "replayed write landed");
+
+	// Background fill stuck: not ours to replay, the fill is told it failed.
+	hostSimBusFault(HOSTSIM_FAULT_HANG, 0);
+	CHECK(eeFillStart(&hi2c2, A0A1_00, 0, 4 * P, FILL_0, false), "fill started");
+	CHECK(sEEPromAckPoll(&hi2c2, A0A1_00) == HAL_OK, "bus usable again");
+	CHECK(eeFillState.state == EEFILL_FAILED && eeFillState.errorCode == HAL_I2C_ERROR_TIMEOUT, "fill failed, not hung");
+	CHECK(sEEBusRecovery.replays == 1 && sEEBusRecovery.recoveries == 3, "fill chunk not replayed");
+}
+
+/* ---------------------------------------------------------------------------
+ * Benchmarks, simulated bus time.
+ * ------------------------------------------------------------------------- */
+
+static void benchFullDevice(uint32_t busHz)
+{
+	uint64_t start;
+	uint32_t page;
+	double	 writeMs;
+	double	 readMs;
+	double	 fillMs;
+	double	 scanMs;
+	double	 mountMs;
+	uint32_t mountXfers;
+	uint32_t i;
+
+	setupBus(busHz);
+	sEEPromPageBufferFill(&eePromWritePageBytes, FILL_INDEX);
+
+	// Whole device, page writes chained by ack polling.
+	start = hostSimNowNs();
+	for (page = 0; page < MODEL_CAPACITY / AT24C_PAGE_SIZE; page++)
+	{
+		sEEPromAckPoll(&hi2c2, A0A1_00);
+		sEEPromBytesWrite(&hi2c2, A0A1_00, (uint16_t)(page * AT24C_PAGE_SIZE),
+						  eePromWritePageBytes.array, AT24C_PAGE_SIZE);
+	}
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	writeMs = elapsedMs(start);
+
+	// Same again, as a background fill, (no verify), up to end of the last tWR.
+	setupBus(busHz);
+	start = hostSimNowNs();
+	eeFillStart(&hi2c2, A0A1_00, 0, AT24C_DEVICE_BYTES, FILL_FF, false);
+	while (eeFillBusy())
+	{
+		hostSimIdle();
+	}
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	fillMs = elapsedMs(start);
+
+	// Whole device, one page per random read.
+	start = hostSimNowNs();
+	for (page = 0; page < MODEL_CAPACITY / AT24C_PAGE_SIZE; page++)
+	{
+		sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, (uint16_t)(page * AT24C_PAGE_SIZE), buffer, AT24C_PAGE_SIZE);
+		sEEPromWaitForIdle(&hi2c2);
+	}
+	readMs = elapsedMs(start);
+
+	// CRC scan of all data pages, (first one learns them, time the second).
+	eeCrcInit();
+	eeCrcRelearn();
+	start = hostSimNowNs();
+	eeCrcScan(false, NULL);
+	scanMs = elapsedMs(start);
+
+	// Log mount on a full ring.
+	setupBus(busHz);
+	for (i = 0; i < (EELOG_PAGE_COUNT + 17) * EELOG_RECORDS_PER_PAGE; i++)
+	{
+		eeLogAppend(EELOG_TYPE_TEMPERATURE, 16, (uint16_t)i);
+	}
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	start = hostSimNowNs();
+	i = hostSimStats.transactions;
+	eeLogInit();
+	mountMs = elapsedMs(start);
+	mountXfers = hostSimStats.transactions - i;
+
+	printf("  %7lu Hz: write %uK %7.1f ms (%.2f ms/page), background fill %7.1f ms, read %7.1f ms,"
+		   " CRC scan %7.1f ms, log mount %5.2f ms / %lu xfers\n",
+		   (unsigned long)busHz, MODEL_CAPACITY / 1024, writeMs, writeMs / (MODEL_CAPACITY / AT24C_PAGE_SIZE), fillMs, readMs,
+		   scanMs, mountMs, (unsigned long)mountXfers);
+}
+
+static i2cTraceRecord traceSeen[I2CTRACE_RECORDS];
+
+static void noteTraceRecord(uint32_t seq, const i2cTraceRecord *pRecord)
+{
+	traceSeen[seq & (I2CTRACE_RECORDS - 1)] = *pRecord;
+}
+
+static uint32_t traceUs(const i2cTraceRecord *pRecord)
+{
+	return i2cTraceCyclesToUs(pRecord->endCycles - pRecord->startCycles);
+}
+
+static void testTrace(void)
+{
+	uint8_t data[4] = { 1, 2, 3, 4 };
+	uint16_t count;
+
+	printf("I2C trace records\n");
+	setupBus(100000);
+
+	// 4 byte read: START, dev, address, reSTART, dev, 4 data, ~70 bit times at 100KHz.
+	sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0100, buffer, 4);
+	sEEPromWaitForIdle(&hi2c2);
+	count = i2cTraceQuery(noteTraceRecord, I2CTRACE_RECORDS);
+	CHECK(count == 1 && i2cTraceState.transactions == 1, "one record");
+	CHECK(traceSeen[0].kind == I2CTRACE_MEM_READ && traceSeen[0].devAddr7Bit == A0A1_00 &&
+		  traceSeen[0].memAddress == 0x0100 && traceSeen[0].length == 4, "read recorded");
+	CHECK(traceSeen[0].result == HAL_I2C_ERROR_NONE, "read ok");
+	CHECK(traceUs(&traceSeen[0]) > 500 && traceUs(&traceSeen[0]) < 900, "read duration from DWT");
+
+	// Write, then a read NACKed in tWR, (not retried), then ack poll.
+	i2cRetryPolicy[I2CRETRY_NACK].maxRetries = 0;
+	sEEPromBytesWrite(&hi2c2, A0A1_00, 0x0000, data, 4);
+	sEEPromWaitForIdle(&hi2c2);
+	sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, buffer);
+	sEEPromWaitForIdle(&hi2c2);
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	count = i2cTraceQuery(noteTraceRecord, I2CTRACE_RECORDS);
+	CHECK(count == 4 && i2cTraceState.errors == 1, "NACK counted as error");
+	CHECK(traceSeen[2].result == HAL_I2C_ERROR_AF, "NACKed read recorded");
+	CHECK(traceSeen[3].kind == I2CTRACE_ACK_POLL && traceSeen[3].ackPolls != 0 &&
+		  traceSeen[3].result == HAL_I2C_ERROR_NONE, "ack poll recorded with NACK count");
+	i2cRetryInit();
+
+	// Fill of 2 pages: second write is NACKed through the first's tWR, one record.
+	i2cTraceClear();
+	eeFillStart(&hi2c2, A0A1_00, 0, 2 * P, FILL_0, false);
+	while (eeFillBusy())
+	{
+		hostSimIdle();
+	}
+	count = i2cTraceQuery(noteTraceRecord, I2CTRACE_RECORDS);
+	CHECK(count == 3 && i2cTraceState.errors == 0, "ack poll + 2 page writes");
+	CHECK(traceSeen[2].kind == I2CTRACE_MEM_WRITE && traceSeen[2].memAddress == P &&
+		  traceSeen[2].ackPolls == eeFillState.ackPolls, "retries folded into the write");
+	CHECK(traceUs(&traceSeen[2]) > MODEL_TWR_NS / 1000, "write latency includes tWR");
+	CHECK(i2cTraceState.maxCycles == traceSeen[2].endCycles - traceSeen[2].startCycles, "slowest is the polled write");
+
+	// Ring keeps the newest I2CTRACE_RECORDS, oldest first.
+	for (count = 0; count < I2CTRACE_RECORDS + 3; count++)
+	{
+		sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, count, buffer);
+		sEEPromWaitForIdle(&hi2c2);
+	}
+	CHECK(i2cTraceCount() == I2CTRACE_RECORDS, "ring full");
+	// 3 fill records + 35 reads, oldest held is seq 6, the 4th read.
+	CHECK(i2cTraceQuery(noteTraceRecord, 1) == 1 && traceSeen[6].memAddress == 3, "oldest held is 4th read");
+}
+
+static void testSlaveEE(void)
+{
+	static I2C_HandleTypeDef slaveI2C;
+	const uint8_t write1[] = { 0x10, 1, 2, 3 };
+	const uint8_t wrap[]   = { 0x7E, 0xA1, 0xA2, 0xA3 };
+	const uint8_t backed[] = { 0x08, 0x5A };
+	uint8_t		  addr;
+	uint8_t		  got[4];
+	uint32_t	  i;
+
+	printf("I2C slave eeprom simulator\n");
+	setupBus(100000);
+	memset(&slaveI2C, 0, sizeof(slaveI2C));
+	slaveI2C.Instance		 = I2C1;
+	slaveI2C.Init.ClockSpeed = 100000;
+	slaveI2C.State			 = HAL_I2C_STATE_READY;
+	memset(i2cSlaveEEMem, 0, sizeof(i2cSlaveEEMem));
+
+	CHECK(!hostSimSlaveWrite(&slaveI2C, write1, sizeof(write1), true), "NACKed before start");
+	CHECK(i2cSlaveEEStart(&slaveI2C, I2CSLAVEEE_DEFAULT_ADDR, i2cSlaveEEMem, I2CSLAVEEE_DEFAULT_SIZE), "started");
+
+	CHECK(hostSimSlaveWrite(&slaveI2C, write1, sizeof(write1), true), "write acknowledged");
+	CHECK(i2cSlaveEEMem[0x10] == 1 && i2cSlaveEEMem[0x12] == 3 && i2cSlaveEEMem[0x13] == 0, "bytes written from address");
+	CHECK(i2cSlaveEEState.address == 0x13 && i2cSlaveEEState.bytesRx == 3, "address after write");
+	CHECK(slaveI2C.State == HAL_I2C_STATE_LISTEN, "listening again after STOP");
+
+	// Random read, address write then repeated START.
+	addr = 0x10;
+	CHECK(hostSimSlaveWrite(&slaveI2C, &addr, 1, false) && hostSimSlaveRead(&slaveI2C, got, 3), "random read");
+	CHECK(got[0] == 1 && got[1] == 2 && got[2] == 3, "read back");
+	CHECK(i2cSlaveEEState.address == 0x13 && i2cSlaveEEState.bytesTx == 3, "prefetched byte not counted");
+
+	// Current address read carries on.
+	i2cSlaveEEMem[0x13] = 0x44;
+	CHECK(hostSimSlaveRead(&slaveI2C, got, 1) && got[0] == 0x44, "current address read");
+
+	// Both directions wrap at the end of the region.
+	CHECK(hostSimSlaveWrite(&slaveI2C, wrap, sizeof(wrap), true), "write across end");
+	CHECK(i2cSlaveEEMem[0x7F] == 0xA2 && i2cSlaveEEMem[0x00] == 0xA3 && i2cSlaveEEState.address == 1, "write wrapped");
+	addr = 0x7F;
+	hostSimSlaveWrite(&slaveI2C, &addr, 1, false);
+	CHECK(hostSimSlaveRead(&slaveI2C, got, 2) && got[0] == 0xA2 && got[1] == 0xA3, "read wrapped");
+	CHECK(i2cSlaveEEState.errors == 0, "AF at end of transactions not an error");
+	CHECK(i2cSlaveEEState.maxIsrCycles < (9 * (SystemCoreClock / 100000)), "callbacks well under one byte time");
+
+	// AT24C backed: load, master write, written back once quiet.
+	for (i = 0; i < I2CSLAVEEE_DEFAULT_SIZE; i++)
+	{
+		eeprom.mem[0x200 + i] = (uint8_t)(i ^ 0x3C);
+	}
+	CHECK(i2cSlaveEELoad(&hi2c2, A0A1_00, 0x200), "loaded from AT24C");
+	CHECK(memcmp(i2cSlaveEEMem, &eeprom.mem[0x200], I2CSLAVEEE_DEFAULT_SIZE) == 0, "cache matches AT24C");
+	hostSimSlaveWrite(&slaveI2C, backed, sizeof(backed), true);
+	i2cSlaveEEService();
+	CHECK(i2cSlaveEEState.blocksFlushed == 0, "not written back while master active");
+	HAL_Delay(I2CSLAVEEE_FLUSH_QUIET_MS);
+	i2cSlaveEEService();
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	CHECK(i2cSlaveEEState.blocksFlushed == 1 && eeprom.mem[0x208] == 0x5A && i2cSlaveEEState.dirtyBlocks == 0,
+		  "written back");
+
+	i2cSlaveEEStop();
+	CHECK(!i2cSlaveEEState.listening && !hostSimSlaveWrite(&slaveI2C, write1, sizeof(write1), true), "stopped");
+
+	// Listening on the AT24C's own bus, master use waits for C[0x1D].
+	CHECK(i2cSlaveEEStart(&hi2c2, I2CSLAVEEE_DEFAULT_ADDR, i2cSlaveEEMem, I2CSLAVEEE_DEFAULT_SIZE), "started on I2C2");
+	CHECK(sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0, buffer) == HAL_BUSY, "master read refused");
+	CHECK(sEEBusRecovery.recoveries == 0, "listening bus not recovered");
+	CHECK(i2cSlaveEELoad(&hi2c2, A0A1_00, 0x200) && hi2c2.State == HAL_I2C_STATE_LISTEN, "load pauses listen");
+	i2cSlaveEEStop();
+	CHECK(sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0, buffer) == HAL_OK && sEEPromWaitForIdle(&hi2c2) == HAL_OK,
+		  "master again after stop");
+}
+
+static void testScan(void)
+{
+	static at24cModel small;
+	uint32_t		  probeUs;
+	uint32_t		  addr;
+
+	printf("I2C bus scan\n");
+	setupBus(100000);
+	at24cModelInit(&small, A0A1_11, AT24C32_CAPACITY, 32, 2, MODEL_TWR_NS);
+	at24cModelFill(&small, 0xFF);
+	hostSimAttach(&small);
+	for (addr = 0; addr < 2 * I2CSCAN_DETECT_BYTES; addr++)
+	{
+		eeprom.mem[addr] = (uint8_t)(addr * 7);
+	}
+
+	CHECK(i2cScanRun(&hi2c2, I2CSCAN_FIRST_ADDR, I2CSCAN_LAST_ADDR, false) == 2, "two devices found");
+	CHECK(i2cScanFound(A0A1_00) && i2cScanFound(A0A1_11) && !i2cScanFound(A0A1_01) && !i2cScanFound(0x08),
+		  "bitmap");
+	CHECK(i2cScanState.latencyCycles[I2CSCAN_FIRST_ADDR] != 0 && i2cScanState.latencyCycles[I2CSCAN_LAST_ADDR] != 0 &&
+		  i2cScanState.latencyCycles[I2CSCAN_LAST_ADDR + 1] == 0, "every address in range timed");
+	probeUs = i2cTraceCyclesToUs(i2cScanState.latencyCycles[A0A1_00]);
+	CHECK(probeUs >= 100 && probeUs < 150, "address only probe ~11 bit times");
+	CHECK(i2cTraceCyclesToUs(i2cScanState.endCycles - i2cScanState.startCycles) < 15000, "whole scan < 15ms");
+	CHECK(i2cTraceCount() == 0, "probes kept out of the trace");
+
+	// Sizes: at its real size a part's contents always repeat, the marker byte tells it from chance.
+	CHECK(i2cScanRun(&hi2c2, I2CSCAN_FIRST_ADDR, I2CSCAN_LAST_ADDR, true) == 2, "scan with AT24C sizes");
+
+	CHECK(i2cScanState.at24cBytes[A0A1_00 - I2CSCAN_AT24C_FIRST] == MODEL_CAPACITY, "size from contents");
+	CHECK(i2cScanState.at24cBytes[A0A1_11 - I2CSCAN_AT24C_FIRST] == AT24C32_CAPACITY, "erased part sized by marker");
+	CHECK(small.mem[0] == 0xFF && small.writeCycles == 2, "marker put back");
+	CHECK(eeprom.mem[0] == 0 && eeprom.mem[7] == 49 &&
+		  eeprom.writeCycles == ((MODEL_CAPACITY == AT24C512_CAPACITY) ? 0 : 2), "patterned part left as found");
+
+	// Scan refused while the bus is busy, and a small range.
+	CHECK(i2cScanStart(&hi2c2, 0x50, 0x57) && !i2cScanStart(&hi2c2, 0x50, 0x57), "one scan at a time");
+	while (i2cScanBusy())
+	{
+		hostSimIdle();
+	}
+	CHECK(i2cScanState.state == I2CSCAN_DONE && i2cScanState.foundCount == 2 && hi2c2.State == HAL_I2C_STATE_READY,
+		  "range scan done");
+}
+
+/**
+ * @brief Run a copy to its end, as the main loop would.
+ */
+static double runCopy(enumI2CBus dstBus, enumAT24C_7BitAddr dstAddr7Bit, uint32_t start, uint32_t length)
+{
+	uint64_t startNs = hostSimNowNs();
+
+	CHECK(eeCopyStart(I2CBUS_EE, A0A1_00, start, dstBus, dstAddr7Bit, start, length), "copy started");
+	while (eeCopyBusy())
+	{
+		i2cBusService();
+		hostSimIdle();
+	}
+	CHECK(eeCopyState.state == EECOPY_DONE && eeCopyState.bytesCopied == length, "copy done");
+	return elapsedMs(startNs);
+}
+
+/**
+ * @brief Queue READS page reads of one device, pages 0.., into pages, (two devices fill one queue).
+ */
+#define READS	(I2CBUS_QUEUE_DEPTH / 2)
+
+static void queueReads(enumI2CBus bus, enumAT24C_7BitAddr addr7Bit, i2cBusXfer *pXfers,
+					   uint8_t (*pages)[AT24C_PAGE_SIZE])
+{
+	uint32_t n;
+
+	for (n = 0; n < READS; n++)
+	{
+		memset(&pXfers[n], 0, sizeof(pXfers[n]));
+		pXfers[n].devAddr7Bit = addr7Bit;
+		pXfers[n].isRead	  = true;
+		pXfers[n].memAddSize  = AT24C_MEMADD_SIZE;
+		pXfers[n].memAddress  = (uint16_t)(n * AT24C_PAGE_SIZE);
+		pXfers[n].pData		  = pages[n];
+		pXfers[n].size		  = AT24C_PAGE_SIZE;
+		CHECK(i2cBusSubmit(bus, &pXfers[n]), "read queued");
+	}
+}
+
+static double runReads(void)
+{
+	uint64_t startNs = hostSimNowNs();
+
+	while (!i2cBusIdle(I2CBUS_EE) || !i2cBusIdle(I2CBUS_AUX))
+	{
+		hostSimIdle();
+	}
+	return elapsedMs(startNs);
+}
+
+static void testBusCopy(void)
+{
+	static at24cModel sameBus;
+	static at24cModel auxBus;
+	static DMA_HandleTypeDef dma[4];
+	uint32_t start	= P / 2 + 3;			// Unaligned, short first and last chunk.
+	uint32_t length = 16 * P;
+	uint32_t addr;
+	double	 sameMs;
+	double	 crossMs;
+	static i2cBusXfer xfers[2][READS];
+	static uint8_t	  pages[2][READS][AT24C_PAGE_SIZE];
+
+	printf("I2C1 / I2C2 bus copy\n");
+	setupBus(400000);
+	at24cModelInit(&sameBus, A0A1_01, MODEL_CAPACITY, AT24C_PAGE_SIZE, AT24C_ADDR_BYTES, MODEL_TWR_NS);
+	at24cModelInit(&auxBus, A0A1_00, MODEL_CAPACITY, AT24C_PAGE_SIZE, AT24C_ADDR_BYTES, MODEL_TWR_NS);
+	hostSimAttach(&sameBus);
+	hostSimAttachTo(I2C1, &auxBus);
+
+	memset(&hi2c1, 0, sizeof(hi2c1));
+	hi2c1.Instance		  = I2C1;
+	hi2c1.Init.ClockSpeed = 400000;
+	hi2c1.State			  = HAL_I2C_STATE_READY;
+	hi2c1.hdmatx		  = &dma[0];
+	hi2c1.hdmarx		  = &dma[1];
+	hi2c2.hdmatx		  = &dma[2];
+	hi2c2.hdmarx		  = &dma[3];
+	i2cBusInit();
+
+	for (addr = 0; addr < MODEL_CAPACITY; addr++)
+	{
+		eeprom.mem[addr] = (uint8_t)(addr * 13 + (addr >> 8));
+	}
+
+	// Same bus, each page read then written, (and its tWR waited out), one after the other.
+	sameMs = runCopy(I2CBUS_EE, A0A1_01, start, length);
+	CHECK(memcmp(&sameBus.mem[start], &eeprom.mem[start], length) == 0 && sameBus.mem[start - 1] == 0xFF &&
+		  sameBus.mem[start + length] == 0xFF, "same bus copy exact");
+
+	// Across buses, reads on I2C2 run while I2C1 writes.
+	crossMs = runCopy(I2CBUS_AUX, A0A1_00, start, length);
+	CHECK(memcmp(&auxBus.mem[start], &eeprom.mem[start], length) == 0 && auxBus.mem[start - 1] == 0xFF &&
+		  auxBus.mem[start + length] == 0xFF, "cross bus copy exact");
+	CHECK(auxBus.writeCycles == 17 && eeprom.writeCycles == 0, "page split writes, source only read");
+	// tWR NACK retries are up to I2CRETRY_NACK_MAX_US apart, where each page's tWR ends between two differs.
+	CHECK(crossMs <= sameMs * 1.05, "cross bus copy no slower");
+	CHECK(i2cBusState[I2CBUS_AUX].dmaXfers == 17 && i2cBusState[I2CBUS_EE].errors == 0 &&
+		  i2cBusState[I2CBUS_AUX].errors == 0 && i2cBusIdle(I2CBUS_EE) && i2cBusIdle(I2CBUS_AUX), "bus stats");
+	printf("  copy %u bytes at 400 KHz: same bus %.2f ms, I2C2 -> I2C1 %.2f ms, (x%.2f, destination tWR bound)\n",
+		   (unsigned)length, sameMs, crossMs, sameMs / crossMs);
+
+	// Reads of two parts, both on I2C2 then one on each bus, (no tWR, the bus is the limit).
+	sEEPromAckPoll(&hi2c2, A0A1_01);
+	sEEPromAckPoll(&hi2c1, A0A1_00);
+	queueReads(I2CBUS_EE, A0A1_00, xfers[0], pages[0]);
+	queueReads(I2CBUS_EE, A0A1_01, xfers[1], pages[1]);
+	CHECK(i2cBusSubmit(I2CBUS_EE, &xfers[1][0]) == false, "queue full refused");
+	sameMs = runReads();
+	queueReads(I2CBUS_EE, A0A1_00, xfers[0], pages[0]);
+	queueReads(I2CBUS_AUX, A0A1_00, xfers[1], pages[1]);
+	crossMs = runReads();
+	CHECK(xfers[1][READS - 1].errorCode == HAL_I2C_ERROR_NONE &&
+		  memcmp(pages[1], auxBus.mem, sizeof(pages[1])) == 0, "reads on both buses");
+	CHECK(crossMs * 1.8 < sameMs, "two buses read ~2x");
+	printf("  read 2 x %u bytes at 400 KHz: one bus %.2f ms, two buses %.2f ms, (x%.2f)\n",
+		   (unsigned)sizeof(pages[0]), sameMs, crossMs, sameMs / crossMs);
+
+	hi2c2.hdmatx = NULL;
+	hi2c2.hdmarx = NULL;
+}
+
+static uint32_t opsEnded;
+
+static void noteOpDone(sEEPromOp *pOp)
+{
+	opsEnded += (uint32_t)(uintptr_t)pOp->pContext;
+}
+
+static void testOps(void)
+{
+	static uint8_t readBack[2 * P];
+	sEEPromOp	   writes[2];
+	sEEPromOp	   read;
+	sEEPromOp	   nack;
+	I2C_HandleTypeDef unbound;
+	uint32_t	   work = 0;
+	uint32_t	   i;
+
+	printf("Non blocking ops, done handler and wait\n");
+	setupBus(400000);
+	i2cBusInit();
+	opsEnded = 0;
+	for (i = 0; i < P; i++)
+	{
+		buffer[i] = (uint8_t)(i + 1);
+	}
+
+	// Two page writes back to back, the second is NACKed through the first's tWR by the queue.
+	CHECK(sEEPromOpWrite(&writes[0], &hi2c2, A0A1_00, 2 * P, buffer, P, noteOpDone, (void *)1) == HAL_OK, "write 1 queued");
+	CHECK(sEEPromOpWrite(&writes[1], &hi2c2, A0A1_00, 3 * P, buffer, P, noteOpDone, (void *)10) == HAL_OK, "write 2 queued");
+	CHECK(sEEPromOpRead(&read, &hi2c2, A0A1_00, 2 * P, readBack, 2 * P, noteOpDone, (void *)100) == HAL_OK, "read queued");
+	CHECK(sEEPromOpStatus(&read) == HAL_BUSY && !sEEPromOpDone(&read), "returns before the data");
+
+	// Caller gets on with other work until the read is in.
+	while (!sEEPromOpDone(&read))
+	{
+		work++;
+		hostSimIdle();
+	}
+	CHECK(opsEnded == 111 && work > 0, "done handlers called, work overlapped");
+	CHECK(sEEPromOpStatus(&writes[1]) == HAL_OK && sEEPromOpStatus(&read) == HAL_OK, "final status ok");
+	CHECK(memcmp(readBack, buffer, P) == 0 && memcmp(readBack + P, buffer, P) == 0 && eeprom.writeCycles == 2,
+		  "data valid when done");
+	CHECK(i2cBusState[I2CBUS_EE].retries > 0, "tWR NACKs retried by the queue");
+
+	// No device, NACKed until the bus timeout, then HAL_ERROR with AF.
+	CHECK(sEEPromOpCurrentAddrRead(&nack, &hi2c2, A0A1_10, readBack, 1, NULL, NULL) == HAL_OK, "nack op queued");
+	CHECK(sEEPromOpWait(&nack) == HAL_ERROR && nack.xfer.errorCode == HAL_I2C_ERROR_AF, "NACK ends as HAL_ERROR");
+
+	// Transfer that never completes, recovered by the wait, ends as HAL_TIMEOUT.
+	hostSimBusFault(HOSTSIM_FAULT_HANG, 0);
+	CHECK(sEEPromOpRead(&read, &hi2c2, A0A1_00, 0, readBack, 4, NULL, NULL) == HAL_OK, "hung op queued");
+	CHECK(sEEPromOpWait(&read) == HAL_TIMEOUT && sEEBusRecovery.recoveries == 1, "hung op times out");
+	CHECK(sEEPromOpRead(&read, &hi2c2, A0A1_00, 2 * P, readBack, 4, NULL, NULL) == HAL_OK &&
+		  sEEPromOpWait(&read) == HAL_OK && readBack[3] == 4, "queue carries on");
+
+	memset(&unbound, 0, sizeof(unbound));
+	CHECK(sEEPromOpRead(&read, &unbound, A0A1_00, 0, readBack, 4, NULL, NULL) == HAL_ERROR, "handle not a bus");
+}
+
+/**
+ * @brief Policy, backoff and per device counters.
+ */
+static void testRetry(void)
+{
+	uint32_t backoffUs = 0;
+	uint32_t histTotal = 0;
+	uint32_t i;
+	uint32_t retries;
+	i2cBusXfer xfer;
+	const i2cTraceDeviceStruct *pDevice = &i2cTraceDevices[0];
+
+	printf("I2C retry policy, backoff and device stats\n");
+	setupBus(400000);
+	i2cBusInit();
+
+	// Classes, anything with OVR / DMA / TIMEOUT in it is not retried.
+	CHECK(i2cRetryClassOf(HAL_I2C_ERROR_AF) == I2CRETRY_NACK && i2cRetryClassOf(HAL_I2C_ERROR_ARLO) == I2CRETRY_ARLO &&
+		  i2cRetryClassOf(HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_AF) == I2CRETRY_BERR &&
+		  i2cRetryClassOf(HAL_I2C_ERROR_AF | HAL_I2C_ERROR_OVR) == I2CRETRY_CLASSES, "error classes");
+
+	// Backoff doubles up to its limit, then the retries run out.
+	CHECK(i2cRetryNext(HAL_I2C_ERROR_ARLO, 0, &backoffUs) && backoffUs == I2CRETRY_ARLO_BACKOFF_US, "first backoff");
+	CHECK(i2cRetryNext(HAL_I2C_ERROR_ARLO, 1, &backoffUs) && backoffUs == 2 * I2CRETRY_ARLO_BACKOFF_US, "doubled");
+	CHECK(i2cRetryNext(HAL_I2C_ERROR_ARLO, 10, &backoffUs) == false && i2cRetryState.giveUps[I2CRETRY_ARLO] == 1,
+		  "bounded");
+	CHECK(i2cRetryNext(HAL_I2C_ERROR_ARLO, 3, &backoffUs) && backoffUs == I2CRETRY_ARLO_MAX_US, "limited");
+	CHECK(i2cRetryNext(HAL_I2C_ERROR_TIMEOUT, 0, &backoffUs) == false && i2cRetryState.notRetried == 1, "not retried");
+
+	// Queued read of a part in tWR with a NACK backoff, the retries are started by the tick.
+	i2cRetryPolicy[I2CRETRY_NACK].backoffUs	   = 500;
+	i2cRetryPolicy[I2CRETRY_NACK].maxBackoffUs = 1000;
+	buffer[0] = 0x5A;
+	CHECK(sEEPromBytesWrite(&hi2c2, A0A1_00, 0, buffer, 1) == HAL_OK && sEEPromWaitForIdle(&hi2c2) == HAL_OK, "write");
+	memset(&xfer, 0, sizeof(xfer));
+	xfer.devAddr7Bit = A0A1_00;
+	xfer.isRead		 = true;
+	xfer.memAddSize	 = AT24C_MEMADD_SIZE;
+	xfer.pData		 = buffer;
+	xfer.size		 = 4;
+	buffer[0]		 = 0;
+	CHECK(i2cBusSubmit(I2CBUS_EE, &xfer), "read queued in tWR");
+	while (!i2cBusXferDone(&xfer))
+	{
+		hostSimIdle();
+	}
+	retries = i2cBusState[I2CBUS_EE].retries;
+	CHECK(xfer.errorCode == HAL_I2C_ERROR_NONE && buffer[0] == 0x5A, "read retried without the main loop");
+	CHECK(i2cTraceQuery(noteTraceRecord, I2CTRACE_RECORDS) == 2 && traceSeen[1].ackPolls == retries &&
+		  traceSeen[1].result == HAL_I2C_ERROR_NONE, "retries folded into one record");
+	CHECK(retries > 1 && retries <= (MODEL_TWR_NS / 1000000) + 1, "backoff kept the retries few");
+	i2cRetryInit();
+
+	// One write and two reads, counted against the device with their time.
+	for (i = 0; i < 2; i++)
+	{
+		sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0, buffer, 4);
+		sEEPromWaitForIdle(&hi2c2);
+	}
+	CHECK(pDevice->devAddr7Bit == A0A1_00 && pDevice->bus == 0 && i2cTraceDevices[1].devAddr7Bit == 0, "one device");
+	CHECK(pDevice->nacks == retries && pDevice->retries == retries && pDevice->arlo == 0 && pDevice->berr == 0,
+		  "NACKs and retries counted");
+	for (i = 0; i < I2CTRACE_HIST_BUCKETS; i++)
+	{
+		histTotal += pDevice->hist[i];
+	}
+	CHECK(histTotal == 4 && pDevice->attempts == 4 + retries, "every success in the histogram");
+	for (i = 0; (i2cTraceHistLimitUs(i) != 0) && (i2cTraceHistLimitUs(i) < MODEL_TWR_NS / 2000); i++)
+	{
+	}
+	CHECK(pDevice->hist[i] + pDevice->hist[i + 1] == 1, "read in tWR in the bucket for its wait");
+	printf("  read in tWR: %u retries, hist", (unsigned)retries);
+	for (i = 0; i < I2CTRACE_HIST_BUCKETS; i++)
+	{
+		printf(" %u", (unsigned)pDevice->hist[i]);
+	}
+	printf("\n");
+}
+
+/**
+ * @brief A NACKed _IT Mem transfer holds the bus, (no STOP from HAL V1.1.1), until the error callback's STOP.
+ */
+static void testNackStop(void)
+{
+	static i2cBusXfer writes[2];
+	uint32_t		  i;
+
+	printf("NACK without STOP, ack polled fill and queue retries\n");
+	setupBus(400000);
+	i2cBusInit();
+
+	// Every page after the first is NACKed through the one before's tWR, each poll started from the error callback.
+	CHECK(eeFillStart(&hi2c2, A0A1_00, 0, 4 * P, FILL_INDEX, false), "fill started");
+	while (eeFillBusy())
+	{
+		hostSimIdle();
+	}
+	CHECK(eeFillState.state == EEFILL_DONE && eeprom.writeCycles == 4, "ack polled fill done");
+	CHECK(hostSimStats.heldNacks != 0 && hostSimStats.heldNacks == eeFillState.ackPolls &&
+		  hostSimStats.heldStarts == 0, "bus let go before every ack poll");
+
+	// Two queued page writes, the second NACKed through the first's tWR and retried after its backoff.
+	sEEPromAckPoll(&hi2c2, A0A1_00);
+	hostSimStats.heldNacks = 0;
+	for (i = 0; i < 2; i++)
+	{
+		memset(&writes[i], 0, sizeof(writes[i]));
+		writes[i].devAddr7Bit = A0A1_00;
+		writes[i].memAddSize  = AT24C_MEMADD_SIZE;
+		writes[i].memAddress  = (uint16_t)((4 + i) * P);
+		writes[i].pData		  = buffer;
+		writes[i].size		  = P;
+		CHECK(i2cBusSubmit(I2CBUS_EE, &writes[i]), "write queued");
+	}
+	while (!i2cBusXferDone(&writes[1]))
+	{
+		hostSimIdle();
+	}
+	CHECK(writes[0].errorCode == HAL_I2C_ERROR_NONE && writes[1].errorCode == HAL_I2C_ERROR_NONE &&
+		  eeprom.writeCycles == 6, "NACK retried queue writes done");
+	CHECK(hostSimStats.heldNacks != 0 && hostSimStats.heldNacks == i2cBusState[I2CBUS_EE].retries &&
+		  hostSimStats.heldStarts == 0, "bus let go before every retry");
+	CHECK((hostI2C2.SR2 & I2C_SR2_MSL) == 0, "bus free");
+}
+
+/**
+ * @brief Register scan of the PIC simulator, one transaction per window against one batch.
+ */
+static void testPicBatch(void)
+{
+	static at24cModel pic;
+	static uint8_t	  readBack[24][4];
+	picEEWindow		  windows[24];
+	picEEWindow		  writes[3];
+	uint8_t			  writeData[3][8] = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 9, 9 }, { 0xA0, 0xA1, 0xA2, 0xA3 } };
+	uint32_t		  transactions;
+	uint64_t		  start;
+	double			  singleMs;
+	double			  batchMs;
+	bool			  same = true;
+	uint32_t		  i;
+	uint32_t		  n;
+
+	printf("PIC simulator batched windows\n");
+	setupBus(PICEE_MAX_BUS_HZ);
+	i2cBusInit();
+	at24cModelInit(&pic, PICEE_BATCH_ADDR, PICEE_CAPACITY, SEE_PAGE_SIZE(PICEE), PICEE_ADDR_BYTES, 0);
+	for (i = 0; i < PICEE_CAPACITY; i++)
+	{
+		pic.mem[i] = (uint8_t)(i ^ 0x5A);
+	}
+	hostSimAttach(&pic);
+
+	// 24 registers of 2..4 bytes every 5 bytes from 4, the last one wraps to 0..1.
+	for (i = 0; i < 24; i++)
+	{
+		windows[i].address = (uint8_t)(i * 5 + 4);
+		windows[i].length  = (uint8_t)(2 + (i % 3));
+		windows[i].pData   = readBack[i];
+	}
+	windows[23].address = PICEE_CAPACITY - 2;
+	windows[23].length	= 4;
+
+	transactions = hostSimStats.transactions;
+	start		 = hostSimNowNs();
+	for (i = 0; i < 24; i++)
+	{
+		RandomAccesPicEEReadBytes(&hi2c2, PICEE_BATCH_ADDR << 1, windows[i].address, windows[i].pData, windows[i].length);
+		sEEPromWaitForIdle(&hi2c2);
+	}
+	singleMs	 = elapsedMs(start);
+	transactions = hostSimStats.transactions - transactions;
+
+	memset(readBack, 0, sizeof(readBack));
+	start = hostSimNowNs();
+	CHECK(picEEBatchRun(I2CBUS_EE, PICEE_BATCH_ADDR, false, windows, 24) == HAL_OK, "read batch done");
+	batchMs = elapsedMs(start);
+	for (i = 0; i < 24; i++)
+	{
+		for (n = 0; n < windows[i].length; n++)
+		{
+			same = same && (readBack[i][n] == pic.mem[(windows[i].address + n) % PICEE_CAPACITY]);
+		}
+	}
+	CHECK(same, "every window read");
+	CHECK(picEEBatchState.spanCount == 1 && picEEBatchState.spans[0].start == PICEE_CAPACITY - 2,
+		  "gaps bridged, one span across the wrap");
+	CHECK(transactions >= 10 * picEEBatchState.spanCount && batchMs < singleMs, "10x fewer transactions, less bus time");
+	printf("  24 windows at 100 KHz: one each %u transactions %.2f ms, batch %u %.2f ms, (x%.1f)\n",
+		   (unsigned)transactions, singleMs, (unsigned)picEEBatchState.spanCount, batchMs, singleMs / batchMs);
+
+	// Wide gaps are not bridged.
+	windows[0].address = 0;
+	windows[1].address = 40;
+	windows[2].address = 80;
+	CHECK(picEEBatchPlan(windows, 3, false) == 3, "gaps over PICEE_BATCH_GAP_BYTES split");
+
+	// Writes: overlapping and touching windows merge, a later one wins, one wraps.
+	writes[0] = (picEEWindow){ 10, 8, writeData[0] };
+	writes[1] = (picEEWindow){ 12, 2, writeData[1] };
+	writes[2] = (picEEWindow){ PICEE_CAPACITY - 2, 4, writeData[2] };
+	transactions = hostSimStats.transactions;
+	CHECK(picEEBatchRun(I2CBUS_EE, PICEE_BATCH_ADDR, true, writes, 3) == HAL_OK, "write batch done");
+	CHECK(hostSimStats.transactions - transactions == 2 && picEEBatchState.spanCount == 2, "two write spans");
+	CHECK(pic.mem[10] == 1 && pic.mem[12] == 9 && pic.mem[13] == 9 && pic.mem[17] == 8 && pic.mem[18] == (18 ^ 0x5A),
+		  "later window wins");
+	CHECK(pic.mem[PICEE_CAPACITY - 1] == 0xA1 && pic.mem[0] == 0xA2 && pic.mem[1] == 0xA3 && pic.mem[2] == (2 ^ 0x5A),
+		  "write wraps to 0");
+
+	// No PIC, the batch fails with the NACK.
+	hostSimReset();
+	i2cRetryPolicy[I2CRETRY_NACK].maxRetries = 0;
+	CHECK(picEEBatchRun(I2CBUS_EE, PICEE_BATCH_ADDR, false, windows, 24) == HAL_ERROR &&
+		  picEEBatchState.errorCode == HAL_I2C_ERROR_AF && !picEEBatchBusy(), "absent PIC fails");
+	i2cRetryInit();
+}
+
+/// Sensor like register device, (an AT24C model with one page over its 256 byte space stands in).
+static const i2cRegDef sensorRegs[] = {
+	{ 0x00, 1, I2CREG_R },						// ID
+	{ 0x01, 1, I2CREG_RW },						// CONFIG
+	{ 0x02, 2, I2CREG_R | I2CREG_VOLATILE },	// TEMP
+	{ 0x04, 2, I2CREG_R | I2CREG_VOLATILE },	// HUMIDITY
+	{ 0x06, 4, I2CREG_R | I2CREG_VOLATILE },	// PRESSURE
+	{ 0x10, 2, I2CREG_RW },						// LIMIT_HI
+	{ 0x12, 2, I2CREG_RW },						// LIMIT_LO
+	{ 0x20, 1, I2CREG_W | I2CREG_VOLATILE },	// COMMAND
+};
+I2CREG_MAP(sensor, I2CBUS_EE, 0x48, I2C_MEMADD_SIZE_8BIT, true, sensorRegs);
+
+static void testRegMap(void)
+{
+	static at24cModel dev;
+	uint32_t		  values[8];
+	uint32_t		  limits[2] = { 0x1234, 0x0100 };
+	uint32_t		  value;
+	uint32_t		  transactions;
+	uint32_t		  i;
+	uint64_t		  start;
+	double			  singleMs;
+	double			  snapshotMs;
+
+	printf("Register map, bursts and shadow\n");
+	setupBus(400000);
+	i2cBusInit();
+	at24cModelInit(&dev, 0x48, 256, 256, 1, 0);
+	for (i = 0; i < 256; i++)
+	{
+		dev.mem[i] = (uint8_t)(0xC0 + i);
+	}
+	hostSimAttach(&dev);
+	CHECK(i2cRegMapInit(&sensor) && i2cRegFind(&sensor, 0x04) == 3 && i2cRegFind(&sensor, 0x05) == I2CREG_NONE,
+		  "table checked, found by address");
+
+	// ID read once, then from the shadow.
+	CHECK(i2cRegRead(&sensor, 0, &value) == HAL_OK && value == 0xC0, "ID read");
+	CHECK(i2cRegRead(&sensor, 0, &value) == HAL_OK && value == 0xC0 && sensor.transactions == 1 &&
+		  sensor.shadowReads == 1, "ID again from the shadow");
+
+	// Poll the three data registers one at a time, then as one snapshot.
+	transactions = hostSimStats.transactions;
+	start		 = hostSimNowNs();
+	for (i = 2; i <= 4; i++)
+	{
+		CHECK(i2cRegRead(&sensor, (uint16_t)i, &values[i]) == HAL_OK, "data read");
+	}
+	singleMs = elapsedMs(start);
+	CHECK(hostSimStats.transactions - transactions == 3, "volatile registers always read");
+
+	transactions = hostSimStats.transactions;
+	start		 = hostSimNowNs();
+	CHECK(i2cRegSnapshot(&sensor, 2, 3, &values[2]) == HAL_OK, "data snapshot");
+	snapshotMs = elapsedMs(start);
+	CHECK(hostSimStats.transactions - transactions == 1, "data registers in one burst");
+
+	transactions = hostSimStats.transactions;
+	CHECK(i2cRegSnapshot(&sensor, 0, 8, values) == HAL_OK, "snapshot");
+	CHECK(hostSimStats.transactions - transactions == 2, "0x00..0x09 and 0x10..0x13 bursts, COMMAND not read");
+	CHECK(values[1] == 0xC1 && values[2] == 0xC2C3 && values[4] == 0xC6C7C8C9 && values[6] == 0xD2D3 && values[7] == 0,
+		  "values msb first");
+	printf("  TEMP, HUMIDITY, PRESSURE at 400 KHz: one read each %.3f ms, snapshot %.3f ms\n", singleMs,
+		   snapshotMs);
+	CHECK(snapshotMs < singleMs, "snapshot faster");
+
+	// Writes: unchanged skipped, consecutive changed ones in one burst, volatile always written.
+	transactions = hostSimStats.transactions;
+	CHECK(i2cRegWrite(&sensor, 1, 0xC1) == HAL_OK && hostSimStats.transactions == transactions &&
+		  sensor.skippedWrites == 1, "unchanged CONFIG skipped");
+	CHECK(i2cRegWriteMany(&sensor, 5, 2, limits) == HAL_OK && hostSimStats.transactions == transactions + 1 &&
+		  dev.mem[0x10] == 0x12 && dev.mem[0x11] == 0x34 && dev.mem[0x12] == 0x01 && dev.mem[0x13] == 0x00,
+		  "both limits in one burst");
+	limits[1] = 0x0200;
+	CHECK(i2cRegWriteMany(&sensor, 5, 2, limits) == HAL_OK && hostSimStats.transactions == transactions + 2 &&
+		  dev.mem[0x12] == 0x02, "only the changed limit");
+	CHECK(i2cRegWrite(&sensor, 7, 0x5A) == HAL_OK && i2cRegWrite(&sensor, 7, 0x5A) == HAL_OK &&
+		  hostSimStats.transactions == transactions + 4 && dev.mem[0x20] == 0x5A, "COMMAND written every time");
+	CHECK(i2cRegWrite(&sensor, 0, 1) == HAL_ERROR && i2cRegRead(&sensor, 7, &value) == HAL_ERROR, "access enforced");
+}
+
+/// Temperature sensor input for testAdcSampler, 12 bit counts * 8, dithered by the pattern over 8 scans.
+static uint32_t adcInput8;
+
+/// testAdcSampler inputs: temperature dithered, Vrefint steady, PA2 1000 / 1010 alternately, PA3 grounded.
+static uint16_t adcInputs(uint32_t channel, uint32_t scan)
+{
+	switch (channel)
+	{
+	case ADC_CHANNEL_TEMPSENSOR:	return (uint16_t)((adcInput8 >> 3) + (((scan % 8) < (adcInput8 & 7)) ? 1 : 0));
+	case ADC_CHANNEL_VREFINT:		return 1490;
+	case 2:							return (scan & 1) ? 1010 : 1000;
+	default:						return 0;
+	}
+}
+
+static void testAdcSampler(void)
+{
+	static ADC_HandleTypeDef hadc;
+	static TIM_HandleTypeDef htim;
+	adcSamplerStatsStruct	 stats;
+	uint8_t					 temp;
+	uint16_t				 before;
+
+	printf("ADC scan, TIM3 triggered DMA, oversampling and statistics\n");
+	hostSimReset();
+	hadc.Instance		= ADC1;
+	htim.Instance		= TIM3;
+	htim.Init.Prescaler = (SystemCoreClock / 1000000) - 1;
+	htim.Init.Period	= (1000000 / ADCSAMPLER_RATE_HZ) - 1;
+	hostSimAdcSource	= adcInputs;
+	adcInput8			= 1000 * 8 + 3;		// 1000.375 counts, between two 12 bit codes.
+
+	CHECK(!adcSamplerStart(&hadc, &htim, ADCSAMPLER_DEFAULT_CHANNELS | 1) && !adcSamplerState.running,
+		  "5 channels refused");
+	CHECK(adcSamplerStart(&hadc, &htim, ADCSAMPLER_DEFAULT_CHANNELS) && adcSamplerState.running &&
+		  adcSamplerState.channelCount == 4, "started, 4 channels");
+	temp = adcSamplerFind(ADC_CHANNEL_TEMPSENSOR);
+	CHECK(temp == 2 && adcSamplerFind(2) == 0 && adcSamplerFind(5) == ADCSAMPLER_NONE, "ranks in channel order");
+
+	HAL_Delay(1000);
+	CHECK(adcSamplerState.blocks == (ADCSAMPLER_RATE_HZ / ADCSAMPLER_BLOCK) && adcSamplerState.missed == 0,
+		  "a block per 64 scans, in turn");
+	CHECK(adcSamplerState.channels[temp].latest == adcInput8 && adcSamplerFiltered(temp) == adcInput8,
+		  "oversampled to 15 bits, the .375 resolved");
+	CHECK(adcSamplerFiltered(adcSamplerFind(ADC_CHANNEL_VREFINT)) == 1490 * 8 && adcSamplerFiltered(adcSamplerFind(3)) == 0,
+		  "channels kept apart");
+	CHECK(adcSamplerStats(0, &stats) && stats.samples == adcSamplerState.blocks * ADCSAMPLER_BLOCK &&
+		  stats.min == 1000 && stats.max == 1010 && stats.meanQ4 == 1005 * 16 && stats.varianceQ4 == 25 * 16,
+		  "PA2 min, max, mean, variance");
+	adcSamplerStatsClear();
+	CHECK(!adcSamplerStats(0, &stats), "statistics cleared");
+
+	// Step, (mid block), the filter follows by a quarter of the way per block.
+	adcInput8 = 2000 * 8;
+	HAL_Delay(2 * ADCSAMPLER_BLOCK);
+	before = adcSamplerFiltered(temp);
+	CHECK(adcSamplerState.channels[temp].latest == adcInput8 && before > 8003 && before < adcInput8,
+		  "filter moves towards a step");
+	HAL_Delay(1000);
+	CHECK(adcSamplerFiltered(temp) >= (adcInput8 - adcInput8 / 50) && adcSamplerFiltered(temp) <= adcInput8,
+		  "settled within 2% after a second");
+	printf("  %u conversions, %u block interrupts, step to %u: %u after two blocks, %u after 1 s\n",
+		   (unsigned)(adcSamplerState.blocks * ADCSAMPLER_BLOCK * adcSamplerState.channelCount),
+		   (unsigned)adcSamplerState.blocks, (unsigned)adcInput8, (unsigned)before, (unsigned)adcSamplerFiltered(temp));
+
+	// New list, restarted.
+	CHECK(adcSamplerStart(&hadc, &htim, 1UL << ADC_CHANNEL_TEMPSENSOR) && adcSamplerState.channelCount == 1, "one channel");
+	HAL_Delay(ADCSAMPLER_BLOCK);
+	CHECK(adcSamplerState.blocks == 1 && adcSamplerFiltered(0) == adcInput8, "one channel sampled");
+
+	adcSamplerStop();
+	before = (uint16_t)adcSamplerState.blocks;
+	HAL_Delay(200);
+	CHECK(!adcSamplerState.running && adcSamplerState.blocks == before, "stopped");
+	hostSimAdcSource = NULL;
+}
+
+/// As stm32f1xx_it.c, PendSV runs the deferred work, (the filter, I2C done handlers).
+void PendSV_Handler(void)
+{
+	pendWorkService();
+}
+
+static void testAdcFilter(void)
+{
+	static ADC_HandleTypeDef hadc;
+	static TIM_HandleTypeDef htim;
+	uint16_t				 stepped;
+	uint32_t				 sampled;
+
+	printf("ADC block filter, deferred to PendSV\n");
+	hostSimReset();
+	hadc.Instance		= ADC1;
+	htim.Instance		= TIM3;
+	htim.Init.Prescaler = (SystemCoreClock / 1000000) - 1;
+	htim.Init.Period	= (1000000 / ADCSAMPLER_RATE_HZ) - 1;
+	hostSimAdcSource	= adcInputs;
+	adcInput8			= 1500 * 8;			// Steady, PA2 alternates 1000 / 1010 every scan.
+
+	CHECK(!adcFilterConfigure(ADCFILTER_AVERAGE, ADCFILTER_AVERAGE_MAX_LOG2 + 1) &&
+		  !adcFilterConfigure(ADCFILTER_BIQUAD, 0) && !adcFilterConfigure(ADCFILTER_BIQUAD, 3) &&
+		  !adcFilterConfigure((enumAdcFilterType)4, 0) && adcFilterState.type == ADCFILTER_NONE, "bad settings refused");
+
+	// PA2 rank 0, temperature rank 1.
+	CHECK(adcFilterConfigure(ADCFILTER_AVERAGE, 1) &&
+		  adcSamplerStart(&hadc, &htim, (1UL << 2) | (1UL << ADC_CHANNEL_TEMPSENSOR)), "average of 2, started");
+	HAL_Delay(ADCSAMPLER_BLOCK);
+	CHECK(adcFilterState.blocks == 1 && adcFilterValue(0) == 1005 * 8 && adcFilterValue(1) == 1500 * 8,
+		  "pairs averaged, channels kept apart");
+
+	CHECK(adcFilterConfigure(ADCFILTER_FIR, 0), "FIR");
+	HAL_Delay(2 * ADCSAMPLER_BLOCK);
+	CHECK(adcFilterState.blocks == 2 && adcFilterValue(0) >= 1005 * 8 - 1 && adcFilterValue(0) <= 1005 * 8 + 1 &&
+		  adcFilterValue(1) == 1500 * 8, "500 Hz removed, unity DC gain");
+
+	CHECK(adcFilterConfigure(ADCFILTER_BIQUAD, 2), "biquad, 2 stages");
+	sampled = adcSamplerState.blocks;
+	HAL_Delay(2 * ADCSAMPLER_BLOCK);
+	CHECK(adcFilterValue(0) >= 1005 * 8 - 2 && adcFilterValue(0) <= 1005 * 8 + 2 && adcFilterValue(1) == 1500 * 8,
+		  "primed, no start up ramp");
+
+	// Step, (mid block), 4th order 10 Hz: most of the way in 100ms, overshoot, settled by a second.
+	adcInput8 = 2000 * 8;
+	HAL_Delay(ADCSAMPLER_BLOCK + ADCSAMPLER_BLOCK / 2);
+	stepped = adcFilterValue(1);
+	CHECK(stepped > 1750 * 8 && stepped < 2000 * 8 * 112 / 100, "follows a step");
+	HAL_Delay(1000);
+	CHECK(adcFilterValue(1) >= 2000 * 8 - 2 && adcFilterValue(1) <= 2000 * 8 + 2, "settled after a second");
+	CHECK(adcFilterState.dropped == 0 && adcFilterState.late == 0 &&
+		  adcFilterState.blocks == adcSamplerState.blocks - sampled, "every block filtered in time");
+	printf("  %u blocks, step to %u: %u after %u ms, %u after 1 s\n",
+		   (unsigned)adcFilterState.blocks, (unsigned)adcInput8, (unsigned)stepped, ADCSAMPLER_BLOCK + ADCSAMPLER_BLOCK / 2,
+		   (unsigned)adcFilterValue(1));
+
+	// PendSV held off past the next block, the older block is dropped.
+	hostSimPendSVHeld = true;
+	HAL_Delay(2 * ADCSAMPLER_BLOCK);
+	hostSimPendSVHeld = false;
+	HAL_Delay(1);
+	CHECK(adcFilterState.dropped == 1 && adcFilterState.late == 0, "waiting block replaced, counted");
+
+	// New list, restarted, primed again.
+	adcInput8 = 1200 * 8;
+	CHECK(adcSamplerStart(&hadc, &htim, 1UL << ADC_CHANNEL_TEMPSENSOR), "one channel");
+	HAL_Delay(ADCSAMPLER_BLOCK);
+	CHECK(adcFilterValue(0) == 1200 * 8, "primed from the new list");
+
+	adcFilterConfigure(ADCFILTER_NONE, 0);
+	HAL_Delay(ADCSAMPLER_BLOCK);
+	CHECK(adcFilterState.blocks == 0 && adcFilterValue(0) == adcSamplerFiltered(0), "off, sampler value");
+	adcSamplerStop();
+	hostSimAdcSource = NULL;
+}
+
+/// Events handed to the notification by adcAlarmService(..)
+static adcAlarmEvent alarmEvents[ADCALARM_QUEUE];
+static uint32_t		 alarmEventCount;
+
+static void noteAlarm(const adcAlarmEvent *pEvent)
+{
+	if (alarmEventCount < ADCALARM_QUEUE)
+	{
+		alarmEvents[alarmEventCount] = *pEvent;
+	}
+	alarmEventCount++;
+}
+
+static void testAdcAlarm(void)
+{
+	static ADC_HandleTypeDef hadc;
+	static TIM_HandleTypeDef htim;
+	uint32_t				 raisedTick;
+
+	printf("ADC alarms, analog watchdog and block windows\n");
+	hostSimReset();
+	hadc.Instance		= ADC1;
+	htim.Instance		= TIM3;
+	htim.Init.Prescaler = (SystemCoreClock / 1000000) - 1;
+	htim.Init.Period	= (1000000 / ADCSAMPLER_RATE_HZ) - 1;
+	hostSimAdcSource	= adcInputs;
+	adcInput8			= 1750 * 8;			// Temperature sensor ~25C.
+	alarmEventCount		= 0;
+
+	adcAlarmInit(&hadc);
+	adcAlarmState.logToEEProm = false;		// No log device here.
+	CHECK(!adcAlarmSet(ADC_CHANNEL_TEMPSENSOR, 1000, 1000 + 2 * ADCALARM_HYSTERESIS) &&
+		  !adcAlarmSet(ADC_CHANNEL_TEMPSENSOR, 1000, 0x1000) && adcAlarmState.windowCount == 0, "bad windows refused");
+	CHECK(adcAlarmSet(ADC_CHANNEL_TEMPSENSOR, ADCALARM_TEMP_HOT, ADCALARM_TEMP_COLD) &&
+		  adcAlarmSet(ADC_CHANNEL_VREFINT, ADCALARM_VDDA_HIGH, ADCALARM_VDDA_LOW) &&
+		  adcAlarmSet(2, 1003, 1100), "3 windows");
+	CHECK((ADC1->CR1 & (ADC_CR1_AWDEN | ADC_CR1_AWDSGL | ADC_CR1_AWDIE)) == (ADC_CR1_AWDEN | ADC_CR1_AWDSGL | ADC_CR1_AWDIE) &&
+		  (ADC1->CR1 & ADC_CR1_AWDCH) == ADC_CHANNEL_TEMPSENSOR && ADC1->LTR == ADCALARM_TEMP_HOT &&
+		  ADC1->HTR == ADCALARM_TEMP_COLD, "analog watchdog on the first window");
+	CHECK(adcSamplerStart(&hadc, &htim, (1UL << 2) | (1UL << ADC_CHANNEL_TEMPSENSOR) | (1UL << ADC_CHANNEL_VREFINT)),
+		  "sampling");
+
+	// PA2 1000 / 1010 is below 1003 at times, raised from the first block.
+	HAL_Delay(ADCSAMPLER_BLOCK);
+	CHECK(adcAlarmService(noteAlarm) == 1 && alarmEvents[0].channel == 2 && alarmEvents[0].kind == ADCALARM_LOW &&
+		  alarmEvents[0].value == 1000 && adcAlarmState.awdIrqs == 0, "block window raised, others quiet");
+
+	// Over 70C, the watchdog interrupt raises it on the next conversion, once.
+	adcInput8  = 1400 * 8;
+	raisedTick = HAL_GetTick();
+	HAL_Delay(1);
+	CHECK(adcAlarmState.awdIrqs == 1 && adcAlarmState.windows[0].inAlarm && !(ADC1->CR1 & ADC_CR1_AWDIE),
+		  "watchdog interrupt within a scan");
+	HAL_Delay(200);
+	CHECK(adcAlarmService(noteAlarm) == 1 && alarmEvents[1].channel == ADC_CHANNEL_TEMPSENSOR &&
+		  alarmEvents[1].kind == ADCALARM_LOW && alarmEvents[1].value == 1400 && alarmEvents[1].tick <= raisedTick + 1 &&
+		  adcAlarmState.awdIrqs == 1, "one event while out, timed at the conversion");
+
+	// Back in, cleared by the next whole block inside, watchdog armed again.
+	adcInput8 = 1750 * 8;
+	HAL_Delay(2 * ADCSAMPLER_BLOCK);
+	CHECK(adcAlarmService(noteAlarm) == 1 && alarmEvents[2].kind == ADCALARM_CLEAR && alarmEvents[2].value == 1750 &&
+		  !adcAlarmState.windows[0].inAlarm && (ADC1->CR1 & ADC_CR1_AWDIE), "cleared, watchdog armed");
+	adcInput8 = 2000 * 8;					// Below -10C.
+	HAL_Delay(1);
+	CHECK(adcAlarmState.awdIrqs == 2 && adcAlarmService(noteAlarm) == 1 && alarmEvents[3].kind == ADCALARM_HIGH,
+		  "raised again, high");
+
+	// First window removed, the watchdog moves to the next.
+	CHECK(adcAlarmRemove(ADC_CHANNEL_TEMPSENSOR) && !adcAlarmRemove(ADC_CHANNEL_TEMPSENSOR) &&
+		  (ADC1->CR1 & ADC_CR1_AWDCH) == ADC_CHANNEL_VREFINT && adcAlarmState.windowCount == 2, "watchdog moved on");
+	adcAlarmState.notify = false;
+	HAL_Delay(2 * ADCSAMPLER_BLOCK);
+	CHECK(adcAlarmService(noteAlarm) == 0 && alarmEventCount == 4 && adcAlarmState.overflows == 0, "nothing more");
+	printf("  watchdog alarm %u ms after the input left its window, %u interrupts\n",
+		   (unsigned)(alarmEvents[1].tick - raisedTick), (unsigned)adcAlarmState.awdIrqs);
+
+	adcSamplerStop();
+	adcAlarmInit(NULL);
+	hostSimAdcSource = NULL;
+}
+
+/// Sensor reading, oversampled counts, at temp C for a part with v25 and slope, (volts), at Vdda 3.3V.
+static uint32_t sensorCounts(double temp, double v25, double slope)
+{
+	return (uint32_t)((v25 - (temp - 25.0) * slope) / 3.3 * 32760.0 + 0.5);
+}
+
+static void testAdcTemp(void)
+{
+	static ADC_HandleTypeDef hadc;
+	static TIM_HandleTypeDef htim;
+	static const struct {
+		int16_t		tempQ8;
+		uint8_t		decimals;
+		const char	*text;
+	} formats[] = {
+		{ 6400, 2, "25.00" }, { -2560, 2, "-10.00" }, { 1, 2, "0.00" }, { -1, 2, "0.00" }, { -2, 2, "-0.01" },
+		{ 32767, 2, "128.00" }, { -32768, 2, "-128.00" }, { 6527, 0, "25" }, { 6527, 1, "25.5" }, { 6527, 9, "25.50" },
+		{ 100, 0, "0" }, { 2566, 1, "10.0" }
+	};
+	char	 text[ADCTEMP_STR_MAX];
+	char	 expected[16];
+	double	 exact;
+	double	 worst = 0;
+	uint32_t counts;
+	uint32_t value;
+	uint32_t i;
+	int16_t	 tempQ8;
+	int		 wrong = 0;
+
+	printf("Chip temperature, fixed point, two point calibration\n");
+	setupBus(400000);
+	adcTempInit();
+	CHECK(!adcTempState.loaded && (adcTempState.cal.points == 0) && (ADCTEMP_DEFAULT_COUNTS == 13997) &&
+		  (adcTempFromCounts(ADCTEMP_DEFAULT_COUNTS) == 25 * 256), "blank eeprom, data sheet line, 1.41V is 25C");
+
+	// Data sheet line against the exact one, 1/256 C or better over the sensor range.
+	for (counts = sensorCounts(125.0, 1.41, 0.0043); counts <= sensorCounts(-40.0, 1.41, 0.0043); counts++)
+	{
+		exact = 256.0 * (25.0 + ((double)counts - ADCTEMP_DEFAULT_COUNTS) * -3.3 / (0.0043 * 32760.0));
+		exact = fabs(adcTempFromCounts((uint16_t)counts) - exact);
+		worst = (exact > worst) ? exact : worst;
+	}
+	CHECK(worst <= 1.0, "conversion within 1/256 C");
+	CHECK(adcTempFromCounts(0) == INT16_MAX && adcTempFromCounts(32760) == INT16_MIN, "saturates");
+
+	for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+	{
+		adcTempToString(formats[i].tempQ8, formats[i].decimals, text);
+		CHECK(strcmp(text, formats[i].text) == 0, formats[i].text);
+	}
+	// Every Q8 value, digits against divides.
+	for (i = 0; i <= 0xFFFF; i++)
+	{
+		tempQ8 = (int16_t)i;
+		value  = ((uint32_t)abs(tempQ8) * 100 + 128) >> 8;
+		snprintf(expected, sizeof(expected), "%s%u.%02u", ((tempQ8 < 0) && (value != 0)) ? "-" : "", value / 100, value % 100);
+		adcTempToString(tempQ8, 2, text);
+		wrong += (strcmp(text, expected) != 0);
+	}
+	CHECK(wrong == 0, "formatter, all 65536 values");
+
+	// A part off the typicals, V25 1.45V, 4.1mV/C: calibrated at 25C and 85C.
+	hadc.Instance		= ADC1;
+	htim.Instance		= TIM3;
+	htim.Init.Prescaler = (SystemCoreClock / 1000000) - 1;
+	htim.Init.Period	= (1000000 / ADCSAMPLER_RATE_HZ) - 1;
+	hostSimAdcSource	= adcInputs;
+	adcFilterConfigure(ADCFILTER_NONE, 0);
+	adcInput8 = sensorCounts(25.0, 1.45, 0.0041);
+	adcSamplerStart(&hadc, &htim, (1UL << ADC_CHANNEL_TEMPSENSOR) | (1UL << ADC_CHANNEL_VREFINT));
+	HAL_Delay(2000);
+	CHECK(adcTempRead(&tempQ8) && (tempQ8 < 22 * 256), "uncalibrated reads several degrees low");
+	CHECK(adcTempCalPoint(1, 2500) && adcTempState.pointsTaken == 1 && adcTempState.cal.points == 0, "point 1");
+	CHECK(!adcTempCalPoint(3, 2500) && !adcTempCalPoint(2, 12600) && !adcTempCalPoint(2, -4100), "bad points refused");
+	CHECK(!adcTempCalPoint(2, 2900) && adcTempState.pointsTaken == 0, "points too close refused");
+	CHECK(adcTempCalPoint(1, 2500), "point 1 again");
+	adcInput8 = sensorCounts(85.0, 1.45, 0.0041);
+	HAL_Delay(2000);
+	CHECK(adcTempCalPoint(2, 8500) && adcTempState.cal.points == 2, "point 2, line saved");
+
+	adcInput8 = sensorCounts(55.0, 1.45, 0.0041);
+	HAL_Delay(2000);
+	CHECK(adcTempRead(&tempQ8) && (abs(tempQ8 - 55 * 256) <= 13), "55C within 0.05C after calibration");
+	adcTempToString(tempQ8, 1, text);
+	printf("  55.0C part reads %s C calibrated, gainQ16 %d\n", text, (int)adcTempState.cal.gainQ16);
+
+	adcTempInit();
+	CHECK(adcTempState.loaded && adcTempState.cal.points == 2 && adcTempRead(&tempQ8) &&
+		  (abs(tempQ8 - 55 * 256) <= 13), "calibration back from the eeprom");
+	eeprom.mem[ADCTEMP_CAL_PAGE * AT24C_PAGE_SIZE + 4] ^= 0x01;
+	adcTempInit();
+	CHECK(!adcTempState.loaded && adcTempState.cal.points == 0, "bad CRC, data sheet line");
+
+	adcSamplerStop();
+	adcFilterConfigure(ADCFILTER_BIQUAD, 2);
+	hostSimAdcSource = NULL;
+}
+
+/// Runs of each test task, in the order they ran.
+static uint32_t taskRuns[4];
+static uint8_t	taskOrder[8];
+static uint32_t taskOrderCount;
+
+static void noteRun(uint8_t n)
+{
+	taskRuns[n]++;
+	if (taskOrderCount < sizeof(taskOrder))
+	{
+		taskOrder[taskOrderCount++] = n;
+	}
+}
+
+static void countTask(void)	{ noteRun(0); }
+static void highTask(void)	{ noteRun(1); }
+static void slowTask(void)	{ noteRun(2); hostSimAdvanceNs(300000); }		// 300us, over its 100us budget.
+static void lowTask(void)	{ noteRun(3); }
+
+/**
+ * @brief Main loop events: sleeping to the tick, coalescing, an I2C completion waking it.
+ */
+static void testMainEvent(void)
+{
+	i2cBusXfer xfer;
+	uint32_t   events;
+	uint32_t   startMs;
+	uint32_t   usPerCycle = SystemCoreClock / 1000000;
+
+	printf("Main loop events, sleep until an interrupt posts one\n");
+	setupBus(400000);
+	i2cBusInit();
+	memset(&mainEventState, 0, sizeof(mainEventState));
+
+	// A task due in 100ms, SysTick posts MAINEVT_TICK then.
+	taskSchedInit();
+	taskSchedOnce(taskSchedAdd("t", countTask, 0, 0, 0), 100);
+	startMs = HAL_GetTick();
+	events	= mainEventWait();
+	CHECK(events == MAINEVT_BIT(MAINEVT_TICK) && (HAL_GetTick() - startMs) == 100, "slept to the task due");
+	CHECK(mainEventState.sleeps > 0 && mainEventState.sleeps <= 101, "one wakeup per interrupt");
+
+	mainEventPost(MAINEVT_ALARM);
+	mainEventPost(MAINEVT_ALARM);
+	CHECK(mainEventWait() == MAINEVT_BIT(MAINEVT_ALARM) && mainEventState.coalesced[MAINEVT_ALARM] == 1 &&
+		  mainEventState.posted[MAINEVT_ALARM] == 2, "posted twice, handled once");
+
+	// A queued read completing wakes the loop, long before the tick.
+	memset(&xfer, 0, sizeof(xfer));
+	xfer.devAddr7Bit = A0A1_00;
+	xfer.isRead		 = true;
+	xfer.memAddSize	 = AT24C_MEMADD_SIZE;
+	xfer.pData		 = buffer;
+	xfer.size		 = 4;
+	startMs			 = HAL_GetTick();
+	CHECK(i2cBusSubmit(I2CBUS_EE, &xfer), "read queued");
+	events = mainEventWait();
+	CHECK((events & MAINEVT_BIT(MAINEVT_I2C)) && i2cBusXferDone(&xfer) && (HAL_GetTick() - startMs) < 2,
+		  "I2C completion wakes the loop");
+	CHECK(mainEventState.maxLatencyCycles[MAINEVT_I2C] < 10 * usPerCycle, "woken within 10us");
+	printf("  %u sleeps, max latency tick %u us, I2C %u us\n", (unsigned)mainEventState.sleeps,
+		   (unsigned)(mainEventState.maxLatencyCycles[MAINEVT_TICK] / usPerCycle),
+		   (unsigned)(mainEventState.maxLatencyCycles[MAINEVT_I2C] / usPerCycle));
+}
+
+/// Work items run, in the order they ran.
+static uint32_t workOrder[PENDWORK_QUEUE + 2];
+static uint32_t workCount;
+
+static void noteWork(void *pArg)
+{
+	if (workCount < (sizeof(workOrder) / sizeof(workOrder[0])))
+	{
+		workOrder[workCount++] = *(uint32_t *)pArg;
+	}
+}
+
+/**
+ * @brief PendSV work queue: order, a full queue, a slot reserved but not yet written.
+ */
+static void testPendWork(void)
+{
+	static uint32_t ids[PENDWORK_QUEUE + 1];
+	uint32_t		i;
+	bool			inOrder = true;
+
+	printf("PendSV deferred work queue\n");
+	memset(&pendWorkState, 0, sizeof(pendWorkState));
+	workCount = 0;
+
+	// Held off, (higher priority work running), the queue fills and refuses.
+	hostSimPendSVHeld = true;
+	for (i = 0; i <= PENDWORK_QUEUE; i++)
+	{
+		ids[i] = i;
+		if (pendWorkPost(noteWork, &ids[i]) != (i < PENDWORK_QUEUE))
+		{
+			inOrder = false;
+		}
+	}
+	CHECK(inOrder && pendWorkState.overflows == 1 && workCount == 0, "full queue refuses, nothing run while held");
+	hostSimPendSVHeld = false;
+	hostSimAdvanceNs(1000);
+	for (i = 0; i < workCount; i++)
+	{
+		inOrder = inOrder && (workOrder[i] == i);
+	}
+	CHECK(workCount == PENDWORK_QUEUE && inOrder && pendWorkState.ran == PENDWORK_QUEUE &&
+		  pendWorkState.maxDepth == PENDWORK_QUEUE, "run oldest first");
+
+	// A poster interrupted between reserving and writing its slot, PendSV stops there.
+	workCount = 0;
+	pendWorkState.head++;
+	CHECK(pendWorkPost(noteWork, &ids[1]), "posted behind the reserved slot");
+	hostSimAdvanceNs(1000);
+	CHECK(workCount == 0, "stopped at the reserved slot");
+	pendWorkState.items[(pendWorkState.head - 2) % PENDWORK_QUEUE].pArg = &ids[0];
+	pendWorkState.items[(pendWorkState.head - 2) % PENDWORK_QUEUE].func = noteWork;
+	SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	hostSimAdvanceNs(1000);
+	CHECK(workCount == 2 && workOrder[0] == 0 && workOrder[1] == 1, "both run once it is written");
+}
+
+/**
+ * @brief Task scheduler: periods kept, priority order, one shots, overruns and deadline misses.
+ */
+static void testTaskSched(void)
+{
+	uint8_t	 count;
+	uint8_t	 high;
+	uint8_t	 slow;
+	uint8_t	 low;
+	uint32_t startMs;
+
+	printf("Task scheduler, periodic, one shot, priorities, deadlines\n");
+	memset(taskRuns, 0, sizeof(taskRuns));
+	taskOrderCount = 0;
+	taskSchedInit();
+	count = taskSchedAdd("count", countTask, 4, 2, 0);
+	high  = taskSchedAdd("high", highTask, 0, 0, 0);
+	slow  = taskSchedAdd("slow", slowTask, 2, 0, 100);
+	low	  = taskSchedAdd("low", lowTask, 3, 0, 0);
+	CHECK(count == 0 && low == 3, "tasks added");
+
+	// Ready together, they run highest priority first, each once.
+	taskSchedReady(low);
+	taskSchedReady(slow);
+	taskSchedReady(high);
+	CHECK(taskSchedRun() == 3 && taskOrderCount == 3 && taskOrder[0] == 1 && taskOrder[1] == 2 && taskOrder[2] == 3,
+		  "priority order");
+	CHECK(taskSchedState.tasks[slow].overruns == 1 && taskSchedState.tasks[high].overruns == 0 &&
+		  i2cTraceCyclesToUs(taskSchedState.tasks[slow].maxCycles) >= 300, "overrun of the budget counted");
+	CHECK(taskSchedRun() == 0 && taskSchedState.armed == false, "nothing due, nothing armed");
+
+	// Every 10ms for a second, and a one shot at 250ms, the loop sleeping between.
+	taskSchedPeriodic(count, 10, 10);
+	taskSchedOnce(high, 250);
+	startMs = HAL_GetTick();
+	while ((HAL_GetTick() - startMs) < 1000)
+	{
+		mainEventWait();
+		taskSchedRun();
+	}
+	CHECK(taskRuns[0] == 100 && taskSchedState.tasks[count].misses == 0 && taskSchedState.tasks[count].maxLateMs <= 1,
+		  "periodic on time");
+	CHECK(taskRuns[1] == 2 && taskSchedState.tasks[high].timed == false, "one shot ran once");
+
+	// The loop held up 25ms, (a blocking command), one late run counted a miss, then back in phase.
+	HAL_Delay(25);
+	taskSchedRun();
+	CHECK(taskRuns[0] == 101 && taskSchedState.tasks[count].misses == 1 && taskSchedState.tasks[count].maxLateMs >= 10,
+		  "late start is a miss, not a burst");
+	startMs = HAL_GetTick();
+	while ((HAL_GetTick() - startMs) < 100)
+	{
+		mainEventWait();
+		taskSchedRun();
+	}
+	CHECK(taskRuns[0] == 111 && taskSchedState.tasks[count].misses == 1, "periodic again after the miss");
+
+	taskSchedStop(count);
+	CHECK(taskSchedState.armed == false, "stopped");
+	printf("  %u passes, count task %u runs, max late %u ms\n", (unsigned)taskSchedState.passes,
+		   (unsigned)taskSchedState.tasks[count].runs, (unsigned)taskSchedState.tasks[count].maxLateMs);
+}
+
+static void testIdleSleep(void)
+{
+	// 24 MHz, 10 ms asleep, 10000 cycles left of the ms in progress: SysTick loaded with 226000.
+	const uint32_t		   msCycles = 24000;
+	const uint32_t		   ms		= 10;
+	const uint32_t		   val		= 10000;
+	const uint32_t		   reload	= val + msCycles * (ms - 1);
+	idleSleepAccountStruct account;
+
+	printf("Tickless idle, ms slept from SysTick's count\n");
+
+	idleSleepAccount(msCycles, ms, val, reload - 4000, false, &account);
+	CHECK(account.ticks == 0 && account.nextCycles == 6000 && account.sleptCycles == 4000,
+		  "woke inside the first partial ms");
+
+	// 10000 + 3 whole ms + 5000 into the 5th.
+	idleSleepAccount(msCycles, ms, val, reload - (val + 3 * msCycles + 5000), false, &account);
+	CHECK(account.ticks == 4 && account.nextCycles == msCycles - 5000 && account.sleptCycles == val + 3 * msCycles + 5000,
+		  "woke mid sleep");
+
+	// Reached 0, (SysTick_Handler(..) counts the 10th ms), then 300 cycles on.
+	idleSleepAccount(msCycles, ms, val, reload - 300, true, &account);
+	CHECK(account.ticks == ms - 1 && account.nextCycles == msCycles - 300 && account.sleptCycles == reload + 300,
+		  "counted out");
+
+	// 1 cycle left of a ms, never loaded as 0, the ms is taken now.
+	idleSleepAccount(msCycles, ms, val, reload - (val + msCycles - 1), false, &account);
+	CHECK(account.ticks == 2 && account.nextCycles == msCycles + 1, "next < 2 rolls over, woke early");
+	idleSleepAccount(msCycles, ms, val, reload - (msCycles - 1), true, &account);
+	CHECK(account.ticks == ms && account.nextCycles == msCycles + 1, "next < 2 rolls over, counted out");
+}
+
+int main(void)
+{
+	testPageRollover();
+	testBusyNack();
+	testCurrentAddress();
+	testSequentialWrap();
+	testLogger();
+	testFill();
+	testCrc();
+	testBusRecovery();
+	testTrace();
+	testSlaveEE();
+	testScan();
+	testBusCopy();
+	testOps();
+	testRetry();
+	testNackStop();
+	testPicBatch();
+	testRegMap();
+	testAdcSampler();
+	testAdcFilter();
+	testAdcAlarm();
+	testAdcTemp();
+	testMainEvent();
+	testTaskSched();
+	testPendWork();
+	testIdleSleep();
+
+	printf("Benchmarks (simulated bus time, %u byte part, %u byte pages, tWR %.1f ms):\n",
+		   MODEL_CAPACITY, AT24C_PAGE_SIZE, MODEL_TWR_NS / 1000000.0);
+	benchFullDevice(100000);
+	benchFullDevice(400000);
+	if (AT24C_MAX_BUS_HZ >= 1000000)
+	{
+		benchFullDevice(1000000);
+	}
+
+	printf("%s, %d failed checks\n", (failures == 0) ? "PASS" : "FAIL", failures);
+	return failures;
+}
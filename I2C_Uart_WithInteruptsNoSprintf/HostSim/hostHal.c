@@ -0,0 +1,1075 @@
+/**
+  @file hostHal.c
+  @brief Host side stand-in for HAL I2C master, tick and delay, see HostSim/stm32f1xx_hal.h
+<pre>
+	Simulated bus timing, per transaction:
+
+		START			1 bit time
+		each byte		9 bit times (8 data + ACK)
+		repeated START	1 bit time
+		STOP			1 bit time
+
+	plus hostSimCpuNs of CPU time for each HAL call, so polling loops
+	make progress.  Bit time is 1/hi2c->Init.ClockSpeed.
+
+	Devices are attached with hostSimAttach(..), (I2C2), or
+	hostSimAttachTo(..), addresses with no device attached NACK like an
+	empty bus.  I2C1 and I2C2 are separate buses, a transfer on each may
+	be in flight at the same time.  _DMA transfers time as _IT ones.
+
+	hostSimBusFault(..) makes the bus misbehave the way a real one does
+	when a transfer is cut off, for the bus recovery code:
+
+		SDA held		BUSY flag set, starts fail with HAL_BUSY after the
+						HAL's 25ms BUSY wait, until SCL is clocked by GPIO.
+		Hang			next _IT transfer never completes, until DeInit.
+
+	As HAL V1.1.1, a NACKed address ends a plain master transfer, and a
+	blocking Mem one, with STOP, but an _IT / _DMA Mem one without: the
+	error callback runs with MSL and BUSY still set, and until CR1 STOP is
+	set, (or the peripheral is re-initialised), every start waits out the
+	HAL's 25ms BUSY wait and fails, _IT / _DMA with HAL_TIMEOUT.
+
+	A handle in slave listen mode is addressed by an outside master with
+	hostSimSlaveWrite(..) / hostSimSlaveRead(..), not by the bus devices.
+
+	Each simulated ms runs what the SysTick handler runs besides the tick
+	count, (i2cBusOnTick, taskSchedOnTick), so retries waiting out a
+	backoff start on time.  __WFI() jumps to the next interrupt: a tick, a
+	scan or a transfer completing.
+
+	With TIM3 and ADC1 DMA both started, each TIM3 update is a scan of
+	the regular sequence, (hostSimAdcSource per channel), written to the
+	DMA buffer at once, the half and full buffer callbacks run as the DMA
+	interrupts would.  Each conversion is checked by the analog watchdog,
+	as set by HAL_ADC_AnalogWDGConfig(..), first.  PendSV, when set
+	pending, runs after them.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/10/2018
+
+*/
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "at24cModel.h"
+#include "hostSim.h"
+#include "led.h"
+#include "i2cBus.h"
+#include "taskSched.h"
+
+/// CPU time charged to each HAL call, ns.
+uint32_t hostSimCpuNs = 2000;
+
+/// Core clock, for software delay loop counts and the DWT cycle counter.
+uint32_t SystemCoreClock = 24000000;
+
+I2C_TypeDef	 hostI2C1;
+I2C_TypeDef	 hostI2C2;
+GPIO_TypeDef hostGPIOA;
+GPIO_TypeDef hostGPIOB;
+GPIO_TypeDef hostGPIOC;
+DWT_Type	   hostDWT;
+CoreDebug_Type hostCoreDebug;
+SCB_Type	   hostSCB;
+SysTick_Type   hostSysTick;
+ADC_TypeDef	   hostADC1;
+TIM_TypeDef	   hostTIM3;
+
+uint16_t (*hostSimAdcSource)(uint32_t channel, uint32_t scan);
+void (*hostSimOnTransaction)(uint32_t transaction);
+bool hostSimPendSVHeld;
+
+/// HAL_I2C_Mem_xxx_IT BUSY flag wait, (I2C_TIMEOUT_BUSY_FLAG).
+#define HAL_BUSY_FLAG_WAIT_NS	25000000ULL
+
+/// End time of a transfer that never completes.
+#define HOSTSIM_NEVER			UINT64_MAX
+
+/// SysTick period.
+#define HOSTSIM_TICK_NS			1000000ULL
+
+/// SCL / SDA pins of I2C1 and I2C2, for the bus faults either one drives the faulted bus.
+#define HOST_SCL_PINS			(GPIO_PIN_6 | GPIO_PIN_10)
+#define HOST_SDA_PINS			(GPIO_PIN_7 | GPIO_PIN_11)
+
+/// Bus fault state.
+static uint32_t sdaHeldClocks;			// SCL clocks until the slave lets go of SDA, 0 = SDA free.
+static bool		hangNext;
+static bool		sclHigh = true;
+
+/// Simulated time since start, ns.
+static uint64_t simNowNs;
+static uint64_t nextTickNs = HOSTSIM_TICK_NS;		// Next SysTick.
+
+/// Attached devices, and the bus each is on.
+static at24cModel  *devices[HOSTSIM_MAX_DEVICES];
+static I2C_TypeDef *deviceBus[HOSTSIM_MAX_DEVICES];
+
+/// Non blocking transfer waiting to complete.
+typedef enum { PENDING_NONE, PENDING_MASTER_TX, PENDING_MASTER_RX, PENDING_MEM_TX, PENDING_MEM_RX } pendingKind;
+
+typedef struct {
+	I2C_HandleTypeDef *hi2c;
+	pendingKind		  kind;
+	uint64_t		  endNs;
+	uint32_t		  errorCode;
+	bool			  holdsBus;			// NACKed Mem transfer, no STOP sent.
+} pendingXfer;
+
+static pendingXfer pending[HOSTSIM_MAX_HANDLES];
+
+/// Bus statistics.
+hostSimStatsStruct hostSimStats;
+
+/// Timer triggered ADC with circular DMA.
+static struct hostAdcDma {
+	ADC_HandleTypeDef *hadc;			// DMA started.
+	TIM_HandleTypeDef *htim;			// Trigger started.
+	uint16_t		  *pData;
+	uint32_t		  length;
+	uint32_t		  index;			// Next DMA write.
+	uint32_t		  scan;				// Scans since start.
+	uint32_t		  sequence[16];		// Channel per rank.
+	uint64_t		  periodNs;
+	uint64_t		  nextNs;			// Next update, UINT64_MAX while either is stopped.
+} adc = { .nextNs = UINT64_MAX };
+
+/**
+ * @brief Analog watchdog check of the conversion of channel just in DR, the ADC interrupt if it is enabled.
+ */
+static void adcWatchdog(uint32_t channel)
+{
+	ADC_TypeDef *pAdc = adc.hadc->Instance;
+
+	if (!(pAdc->CR1 & ADC_CR1_AWDEN) || ((pAdc->CR1 & ADC_CR1_AWDSGL) && ((pAdc->CR1 & ADC_CR1_AWDCH) != channel)) ||
+		((pAdc->DR >= pAdc->LTR) && (pAdc->DR <= pAdc->HTR)))
+	{
+		return;
+	}
+	pAdc->SR |= ADC_SR_AWD;
+	if (pAdc->CR1 & ADC_CR1_AWDIE)
+	{
+		HAL_ADC_LevelOutOfWindowCallback(adc.hadc);		// As HAL_ADC_IRQHandler(..), flag cleared after.
+		pAdc->SR &= ~ADC_SR_AWD;
+	}
+}
+
+/**
+ * @brief One TIM3 update, the scan DMA'd and the buffer interrupts.
+ */
+static void adcConvert(void)
+{
+	uint32_t rank;
+
+	adc.nextNs += adc.periodNs;
+	for (rank = 0; rank < adc.hadc->Init.NbrOfConversion; rank++)
+	{
+		adc.hadc->Instance->DR = (hostSimAdcSource != NULL) ? hostSimAdcSource(adc.sequence[rank], adc.scan) : 0;
+		adcWatchdog(adc.sequence[rank]);
+		adc.pData[adc.index++] = (uint16_t)adc.hadc->Instance->DR;
+
+		if (adc.index == (adc.length / 2))
+		{
+			HAL_ADC_ConvHalfCpltCallback(adc.hadc);
+		}
+		else if (adc.index == adc.length)
+		{
+			adc.index = 0;
+			HAL_ADC_ConvCpltCallback(adc.hadc);
+		}
+	}
+	adc.scan++;
+}
+
+
+/**
+ * @brief Attach a device model to the I2C2 bus.
+ */
+void hostSimAttach(at24cModel *m)
+{
+	hostSimAttachTo(I2C2, m);
+}
+
+/**
+ * @brief Attach a device model to bus, (I2C1 or I2C2).
+ */
+void hostSimAttachTo(I2C_TypeDef *bus, at24cModel *m)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOSTSIM_MAX_DEVICES; i++)
+	{
+		if (devices[i] == NULL)
+		{
+			devices[i]	 = m;
+			deviceBus[i] = bus;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Detach all devices and reset time and statistics.
+ */
+void hostSimReset(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOSTSIM_MAX_DEVICES; i++)
+	{
+		devices[i] = NULL;
+	}
+	for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+	{
+		pending[i].kind = PENDING_NONE;
+	}
+	simNowNs   = 0;
+	nextTickNs = HOSTSIM_TICK_NS;
+	adc		   = (struct hostAdcDma){ .nextNs = UINT64_MAX };
+	hostDWT.CYCCNT = 0;
+	hostSCB.ICSR   = 0;
+	hostADC1	   = (ADC_TypeDef){ 0 };
+	hostSimPendSVHeld = false;
+	hostSimOnTransaction = NULL;
+	hostSimStats = (hostSimStatsStruct){ 0 };
+	hostI2C1	 = (I2C_TypeDef){ 0 };
+	hostI2C2	 = (I2C_TypeDef){ 0 };
+	sdaHeldClocks = 0;
+	hangNext	  = false;
+	sclHigh		  = true;
+}
+
+/**
+ * @brief Make the bus misbehave, see top of file.
+ *
+ * @param kind		- Fault.
+ * @param clocks	- HOSTSIM_FAULT_SDA_HELD: SCL clocks the slave needs to finish its byte, 1..9.
+ */
+void hostSimBusFault(hostSimFaultKind kind, uint32_t clocks)
+{
+	switch (kind)
+	{
+	case HOSTSIM_FAULT_SDA_HELD:	sdaHeldClocks = clocks;	break;
+	case HOSTSIM_FAULT_HANG:		hangNext	  = true;	break;
+	default:						sdaHeldClocks = 0; hangNext = false; break;
+	}
+}
+
+/**
+ * @brief BUSY: SDA held, or the bus held after a NACK until CR1 STOP is set, (it goes out at once).
+ */
+FlagStatus hostSimI2CFlag(I2C_HandleTypeDef *hi2c, uint32_t flag)
+{
+	I2C_TypeDef *bus = hi2c->Instance;
+
+	if (flag != I2C_FLAG_BUSY)
+	{
+		return RESET;
+	}
+	if ((bus != NULL) && (bus->SR2 & I2C_SR2_MSL) && (bus->CR1 & I2C_CR1_STOP))
+	{
+		bus->SR2 &= ~I2C_SR2_MSL;
+		bus->CR1 &= ~I2C_CR1_STOP;
+	}
+	return ((sdaHeldClocks != 0) || ((bus != NULL) && (bus->SR2 & I2C_SR2_MSL))) ? SET : RESET;
+}
+
+/**
+ * @brief A start finding BUSY set waits it out as the HAL does, true if it was set.
+ */
+static bool busyWait(I2C_HandleTypeDef *hi2c)
+{
+	if (hostSimI2CFlag(hi2c, I2C_FLAG_BUSY) == RESET)
+	{
+		return false;
+	}
+	if (sdaHeldClocks == 0)
+	{
+		hostSimStats.heldStarts++;
+	}
+	hostSimAdvanceNs(HAL_BUSY_FLAG_WAIT_NS);
+	return true;
+}
+
+static at24cModel *findDevice(I2C_HandleTypeDef *hi2c, uint16_t DevAddress)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOSTSIM_MAX_DEVICES; i++)
+	{
+		if ((devices[i] != NULL) && (deviceBus[i] == hi2c->Instance) && (devices[i]->addr7Bit == (DevAddress >> 1)))
+		{
+			return devices[i];
+		}
+	}
+	return NULL;
+}
+
+static uint64_t bitNs(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t hz = (hi2c->Init.ClockSpeed != 0) ? hi2c->Init.ClockSpeed : 100000;
+
+	return 1000000000ULL / hz;
+}
+
+/**
+ * @brief Run completion of every pending transfer whose end time has passed.
+ */
+static void completeDue(void)
+{
+	uint32_t i;
+	pendingXfer done;
+
+	for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+	{
+		if ((pending[i].kind != PENDING_NONE) && (pending[i].endNs <= simNowNs))
+		{
+			done = pending[i];
+			pending[i].kind = PENDING_NONE;
+
+			done.hi2c->State	 = HAL_I2C_STATE_READY;
+			done.hi2c->Mode		 = HAL_I2C_MODE_NONE;
+			done.hi2c->ErrorCode = done.errorCode;
+			done.hi2c->XferCount = 0;
+			if (done.holdsBus)
+			{
+				done.hi2c->Instance->SR2 |= I2C_SR2_MSL;
+			}
+
+			if (done.errorCode != HAL_I2C_ERROR_NONE)
+			{
+				HAL_I2C_ErrorCallback(done.hi2c);
+			}
+			else
+			{
+				switch (done.kind)
+				{
+				case PENDING_MASTER_TX: HAL_I2C_MasterTxCpltCallback(done.hi2c); break;
+				case PENDING_MASTER_RX: HAL_I2C_MasterRxCpltCallback(done.hi2c); break;
+				case PENDING_MEM_TX:	HAL_I2C_MemTxCpltCallback(done.hi2c);	break;
+				case PENDING_MEM_RX:	HAL_I2C_MemRxCpltCallback(done.hi2c);	break;
+				default: break;
+				}
+			}
+		}
+	}
+}
+
+static void adcSchedule(void)
+{
+	adc.nextNs = ((adc.hadc != NULL) && (adc.htim != NULL)) ? (simNowNs + adc.periodNs) : UINT64_MAX;
+}
+
+/**
+ * @brief Advance simulated time, completing transfers due in that time, (as ISR's would).
+ */
+void hostSimAdvanceNs(uint64_t ns)
+{
+	uint64_t target = simNowNs + ns;
+	uint64_t next;
+	uint32_t i;
+
+	for (;;)
+	{
+		next = (nextTickNs < target) ? nextTickNs : target;
+		next = (adc.nextNs < next) ? adc.nextNs : next;
+		for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+		{
+			if ((pending[i].kind != PENDING_NONE) && (pending[i].endNs < next))
+			{
+				next = pending[i].endNs;
+			}
+		}
+		if (next > simNowNs)
+		{
+			simNowNs	   = next;
+			hostDWT.CYCCNT = (uint32_t)((simNowNs * SystemCoreClock) / 1000000000ULL);
+		}
+		completeDue();
+		if (simNowNs >= nextTickNs)
+		{
+			nextTickNs += HOSTSIM_TICK_NS;
+			i2cBusOnTick();
+			taskSchedOnTick();
+		}
+		if (simNowNs >= adc.nextNs)
+		{
+			adcConvert();
+		}
+		if ((hostSCB.ICSR & SCB_ICSR_PENDSVSET_Msk) && !hostSimPendSVHeld)
+		{
+			hostSCB.ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+			PendSV_Handler();
+		}
+		if (next == target)
+		{
+			break;
+		}
+	}
+}
+
+uint64_t hostSimNowNs(void)
+{
+	return simNowNs;
+}
+
+/**
+ * @brief Called from wait loops, jumps to the next pending completion (or 1 us on).
+ */
+void hostSimIdle(void)
+{
+	uint64_t next = 0;
+	uint32_t i;
+
+	for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+	{
+		if ((pending[i].kind != PENDING_NONE) && (pending[i].endNs != HOSTSIM_NEVER) &&
+			((next == 0) || (pending[i].endNs < next)))
+		{
+			next = pending[i].endNs;
+		}
+	}
+	hostSimAdvanceNs(((next != 0) && (next > simNowNs)) ? (next - simNowNs) : 1000);
+}
+
+/**
+ * @brief __WFI(), on to the next interrupt, (SysTick at the latest).
+ */
+void hostSimWfi(void)
+{
+	uint64_t next = (adc.nextNs < nextTickNs) ? adc.nextNs : nextTickNs;
+	uint32_t i;
+
+	for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+	{
+		if ((pending[i].kind != PENDING_NONE) && (pending[i].endNs < next))
+		{
+			next = pending[i].endNs;
+		}
+	}
+	hostSimAdvanceNs((next > simNowNs) ? (next - simNowNs) : 1);
+}
+
+/// HAL tick, (stm32f1xx_hal.c), for idleSleep.c to link, the host's comes from simulated time, (tickless is never on here).
+__IO uint32_t uwTick;
+
+uint32_t HAL_GetTick(void)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	return (uint32_t)(simNowNs / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	hostSimAdvanceNs((uint64_t)Delay * 1000000ULL);
+}
+
+/**
+ * @brief One complete transaction on the simulated bus.
+ * <pre>
+ *	START, device address W, memory address bytes, then either data bytes
+ *	written, or repeated START, device address R and data bytes read.  STOP.
+ *	memAddSize 0 means no memory address phase (plain master transfer).
+ * </pre>
+ *
+ * @returns HAL_I2C_ERROR_NONE or HAL_I2C_ERROR_AF, and *pDurationNs bus time used.
+ */
+static uint32_t busTransaction(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+							   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, bool isRead,
+							   uint64_t *pDurationNs)
+{
+	at24cModel *m = findDevice(hi2c, DevAddress);
+	uint64_t bit = bitNs(hi2c);
+	uint64_t t	 = simNowNs + hostSimCpuNs;
+	uint32_t error = HAL_I2C_ERROR_NONE;
+	uint16_t i;
+	bool	 writePhase = (MemAddSize != 0) || !isRead;
+
+	hostSimStats.transactions++;
+	if (hostSimOnTransaction != NULL)
+	{
+		hostSimOnTransaction(hostSimStats.transactions);
+	}
+
+	t += bit;											// START
+	t += 9 * bit;										// Device address
+	if ((m == NULL) || !at24cModelAddress(m, writePhase ? false : true, t))
+	{
+		hostSimStats.nacks++;
+		error = HAL_I2C_ERROR_AF;
+		t += bit;										// STOP
+		*pDurationNs = t - simNowNs;
+		return error;
+	}
+
+	if (MemAddSize != 0)
+	{
+		if (MemAddSize != I2C_MEMADD_SIZE_8BIT)
+		{
+			at24cModelWriteByte(m, (uint8_t)(MemAddress >> 8));
+			t += 9 * bit;
+		}
+		at24cModelWriteByte(m, (uint8_t)MemAddress);
+		t += 9 * bit;
+
+		if (isRead)
+		{
+			t += bit;									// Repeated START
+			t += 9 * bit;								// Device address R
+			at24cModelAddress(m, true, t);
+		}
+	}
+
+	for (i = 0; i < Size; i++)
+	{
+		if (isRead)
+		{
+			pData[i] = at24cModelReadByte(m);
+		}
+		else
+		{
+			at24cModelWriteByte(m, pData[i]);
+		}
+		t += 9 * bit;
+	}
+	hostSimStats.bytes += Size;
+
+	t += bit;											// STOP
+	at24cModelStop(m, t);
+
+	*pDurationNs = t - simNowNs;
+	return error;
+}
+
+/**
+ * @brief Blocking transfer, time advances by its duration.
+ */
+static HAL_StatusTypeDef blockingXfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+									  uint16_t MemAddSize, uint8_t *pData, uint16_t Size, bool isRead)
+{
+	uint64_t duration;
+
+	if (hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+	if (busyWait(hi2c))
+	{
+		return HAL_BUSY;
+	}
+	hi2c->ErrorCode = busTransaction(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, isRead, &duration);
+	hostSimAdvanceNs(duration);
+
+	return (hi2c->ErrorCode == HAL_I2C_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Non blocking transfer, handle stays busy until simulated time reaches its end.
+ */
+static HAL_StatusTypeDef startXfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+								   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, bool isRead,
+								   pendingKind kind)
+{
+	uint64_t duration;
+	uint32_t i;
+
+	if (hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+	for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+	{
+		if (pending[i].kind == PENDING_NONE)
+		{
+			break;
+		}
+	}
+	if (i == HOSTSIM_MAX_HANDLES)
+	{
+		return HAL_BUSY;
+	}
+	if (sdaHeldClocks != 0)
+	{
+		hostSimAdvanceNs(HAL_BUSY_FLAG_WAIT_NS);
+		return HAL_BUSY;
+	}
+	if (busyWait(hi2c))
+	{
+		return HAL_TIMEOUT;
+	}
+
+	hi2c->ErrorCode	 = HAL_I2C_ERROR_NONE;
+	hi2c->State		 = isRead ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+	hi2c->Mode		 = (MemAddSize != 0) ? HAL_I2C_MODE_MEM : HAL_I2C_MODE_MASTER;
+	hi2c->pBuffPtr	 = pData;
+	hi2c->XferSize	 = Size;
+	hi2c->XferCount	 = Size;
+	hi2c->Devaddress = DevAddress;
+	hi2c->Memaddress = MemAddress;
+
+	pending[i].hi2c		= hi2c;
+	pending[i].kind		= kind;
+	pending[i].holdsBus = false;
+	if (hangNext)
+	{
+		// Never moves a byte, handle stays busy until HAL_I2C_DeInit.
+		hangNext			 = false;
+		pending[i].errorCode = HAL_I2C_ERROR_NONE;
+		pending[i].endNs	 = HOSTSIM_NEVER;
+	}
+	else
+	{
+		// Data moves now, but nobody may look at it until completion.
+		pending[i].errorCode = busTransaction(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, isRead, &duration);
+		if ((pending[i].errorCode == HAL_I2C_ERROR_AF) && (MemAddSize != 0))
+		{
+			// HAL_I2C_ER_IRQHandler(..) sends no STOP in HAL_I2C_MODE_MEM.
+			pending[i].holdsBus = true;
+			duration -= bitNs(hi2c);
+			hostSimStats.heldNacks++;
+		}
+		pending[i].endNs	 = simNowNs + duration;
+	}
+
+	hostSimAdvanceNs(hostSimCpuNs);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	return blockingXfer(hi2c, DevAddress, 0, 0, pData, Size, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	return blockingXfer(hi2c, DevAddress, 0, 0, pData, Size, true);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	return blockingXfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	return blockingXfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, true);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, 0, 0, pData, Size, false, PENDING_MASTER_TX);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, 0, 0, pData, Size, true, PENDING_MASTER_RX);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, false, PENDING_MEM_TX);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, true, PENDING_MEM_RX);
+}
+
+/* DMA moves the same bytes in the same bus time, the CPU is only spared the byte interrupts. */
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, 0, 0, pData, Size, false, PENDING_MASTER_TX);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, 0, 0, pData, Size, true, PENDING_MASTER_RX);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, false, PENDING_MEM_TX);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	return startXfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, true, PENDING_MEM_RX);
+}
+
+/**
+ * @brief START + device address + STOP, repeated up to Trials times until ACK.
+ */
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout)
+{
+	at24cModel *m = findDevice(hi2c, DevAddress);
+	uint64_t bit = bitNs(hi2c);
+	uint32_t trial;
+	bool	 ack;
+
+	if (hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+	if (busyWait(hi2c))
+	{
+		return HAL_BUSY;
+	}
+
+	for (trial = 0; trial < Trials; trial++)
+	{
+		hostSimStats.transactions++;
+		hostSimStats.ackPolls++;
+		if (hostSimOnTransaction != NULL)
+		{
+			hostSimOnTransaction(hostSimStats.transactions);
+		}
+		hostSimAdvanceNs(hostSimCpuNs + 10 * bit);		// START + address
+
+		ack = (m != NULL) && at24cModelAddress(m, false, simNowNs);
+		if (m != NULL)
+		{
+			at24cModelStop(m, simNowNs);
+		}
+		hostSimAdvanceNs(bit);							// STOP
+
+		if (ack)
+		{
+			return HAL_OK;
+		}
+		hostSimStats.nacks++;
+	}
+	return HAL_ERROR;
+}
+
+/**
+ * @brief Peripheral on, (registers from hi2c->Init).
+ */
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	hi2c->Instance->SR2 &= ~I2C_SR2_MSL;		// PE off and on, the bus is let go.
+	hi2c->Instance->CR1 &= ~I2C_CR1_STOP;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->State		= HAL_I2C_STATE_READY;
+	hi2c->Mode		= HAL_I2C_MODE_NONE;
+	return HAL_OK;
+}
+
+/**
+ * @brief Peripheral off, a transfer in progress is dropped without any callback.
+ */
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t i;
+
+	hostSimAdvanceNs(hostSimCpuNs);
+	for (i = 0; i < HOSTSIM_MAX_HANDLES; i++)
+	{
+		if ((pending[i].kind != PENDING_NONE) && (pending[i].hi2c == hi2c))
+		{
+			pending[i].kind = PENDING_NONE;
+		}
+	}
+	hi2c->Instance->SR2 &= ~I2C_SR2_MSL;
+	hi2c->Instance->CR1 &= ~I2C_CR1_STOP;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->State		= HAL_I2C_STATE_RESET;
+	hi2c->Mode		= HAL_I2C_MODE_NONE;
+	return HAL_OK;
+}
+
+/*
+ * Slave listen mode, as HAL V1.1.1 runs it.  The outside master is driven
+ * by hostSimSlaveWrite(..) / hostSimSlaveRead(..), each byte runs the same
+ * callbacks, in the same order, as the I2C event interrupt would.
+ */
+
+HAL_StatusTypeDef HAL_I2C_EnableListen_IT(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+	hi2c->State = HAL_I2C_STATE_LISTEN;
+	hi2c->Mode	= HAL_I2C_MODE_SLAVE;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DisableListen_IT(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c->State != HAL_I2C_STATE_LISTEN)
+	{
+		return HAL_BUSY;
+	}
+	hi2c->State = HAL_I2C_STATE_READY;
+	hi2c->Mode	= HAL_I2C_MODE_NONE;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef slaveArm(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size, uint32_t XferOptions,
+								  HAL_I2C_StateTypeDef state)
+{
+	if (hi2c->State != HAL_I2C_STATE_LISTEN)
+	{
+		return HAL_BUSY;
+	}
+	hi2c->State		  = state;
+	hi2c->ErrorCode	  = HAL_I2C_ERROR_NONE;
+	hi2c->pBuffPtr	  = pData;
+	hi2c->XferSize	  = Size;
+	hi2c->XferCount	  = Size;
+	hi2c->XferOptions = XferOptions;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Slave_Sequential_Transmit_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size, uint32_t XferOptions)
+{
+	return slaveArm(hi2c, pData, Size, XferOptions, HAL_I2C_STATE_BUSY_TX_LISTEN);
+}
+
+HAL_StatusTypeDef HAL_I2C_Slave_Sequential_Receive_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size, uint32_t XferOptions)
+{
+	return slaveArm(hi2c, pData, Size, XferOptions, HAL_I2C_STATE_BUSY_RX_LISTEN);
+}
+
+/**
+ * @brief Own address on the bus, false if not listening, (NACK).
+ */
+static bool slaveAddressed(I2C_HandleTypeDef *hi2c, uint8_t direction)
+{
+	if ((hi2c->State & HAL_I2C_STATE_LISTEN) != HAL_I2C_STATE_LISTEN)
+	{
+		return false;
+	}
+	hostSimAdvanceNs(10 * bitNs(hi2c));
+	HAL_I2C_AddrCallback(hi2c, direction, (uint16_t)hi2c->Init.OwnAddress1);
+	return true;
+}
+
+/**
+ * @brief STOP, I2C_Slave_STOPF: a transfer still armed ends as AF, then listen is over.
+ */
+static void slaveStop(I2C_HandleTypeDef *hi2c)
+{
+	hostSimAdvanceNs(bitNs(hi2c));
+	if (hi2c->XferCount != 0)
+	{
+		hi2c->ErrorCode |= HAL_I2C_ERROR_AF;
+		hi2c->State = HAL_I2C_STATE_LISTEN;
+		HAL_I2C_ErrorCallback(hi2c);
+	}
+	hi2c->XferOptions = 0;
+	hi2c->State		  = HAL_I2C_STATE_READY;
+	hi2c->Mode		  = HAL_I2C_MODE_NONE;
+	HAL_I2C_ListenCpltCallback(hi2c);
+}
+
+/**
+ * @brief Outside master writes size bytes to the slave, then STOP, (or leaves the bus for a repeated START).
+ */
+bool hostSimSlaveWrite(I2C_HandleTypeDef *hi2c, const uint8_t *pData, uint16_t size, bool stop)
+{
+	uint16_t i;
+
+	if (!slaveAddressed(hi2c, I2C_DIRECTION_TRANSMIT))
+	{
+		return false;
+	}
+	for (i = 0; i < size; i++)
+	{
+		hostSimAdvanceNs(9 * bitNs(hi2c));
+		if ((hi2c->State != HAL_I2C_STATE_BUSY_RX_LISTEN) || (hi2c->XferCount == 0))
+		{
+			// Nothing armed, the real slave stretches SCL forever.
+			return false;
+		}
+		*hi2c->pBuffPtr++ = pData[i];
+		if (--hi2c->XferCount == 0)
+		{
+			hi2c->State = HAL_I2C_STATE_LISTEN;
+			HAL_I2C_SlaveRxCpltCallback(hi2c);
+		}
+	}
+	if (stop)
+	{
+		slaveStop(hi2c);
+	}
+	return true;
+}
+
+/**
+ * @brief Next byte into the data register, (TXE), the slave loads one ahead of the bus.
+ */
+static uint8_t slaveLoad(I2C_HandleTypeDef *hi2c)
+{
+	uint8_t byte = 0xFF;
+
+	if ((hi2c->State == HAL_I2C_STATE_BUSY_TX_LISTEN) && (hi2c->XferCount != 0))
+	{
+		byte = *hi2c->pBuffPtr++;
+		if (--hi2c->XferCount == 0)
+		{
+			hi2c->State = HAL_I2C_STATE_LISTEN;
+			HAL_I2C_SlaveTxCpltCallback(hi2c);
+		}
+	}
+	return byte;
+}
+
+/**
+ * @brief Outside master reads size bytes from the slave, NACKs the last, then STOP.
+ */
+bool hostSimSlaveRead(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t size)
+{
+	uint8_t dr;
+	uint16_t i;
+
+	if (!slaveAddressed(hi2c, I2C_DIRECTION_RECEIVE))
+	{
+		return false;
+	}
+	dr = slaveLoad(hi2c);
+	for (i = 0; i < size; i++)
+	{
+		pData[i] = dr;
+		dr = slaveLoad(hi2c);				// Loaded as this byte starts shifting out.
+		hostSimAdvanceNs(9 * bitNs(hi2c));
+	}
+	slaveStop(hi2c);
+	return true;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	(void)GPIOx;
+	(void)GPIO_Init;
+	hostSimAdvanceNs(hostSimCpuNs);
+}
+
+/**
+ * @brief Pins by hand, each SCL rising edge clocks a slave holding SDA one bit on.
+ */
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	bool high = (PinState == GPIO_PIN_SET);
+
+	hostSimAdvanceNs(hostSimCpuNs);
+	GPIOx->ODR = high ? (GPIOx->ODR | GPIO_Pin) : (GPIOx->ODR & ~(uint32_t)GPIO_Pin);
+
+	if ((GPIOx == GPIOB) && (GPIO_Pin & HOST_SCL_PINS))
+	{
+		if (high && !sclHigh && (sdaHeldClocks != 0))
+		{
+			sdaHeldClocks--;
+		}
+		sclHigh = high;
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	if ((GPIOx == GPIOB) && (GPIO_Pin & HOST_SDA_PINS) && (sdaHeldClocks != 0))
+	{
+		return GPIO_PIN_RESET;
+	}
+	return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	return ((adc.hadc == NULL) && (hadc->Init.NbrOfConversion >= 1) && (hadc->Init.NbrOfConversion <= 16)) ? HAL_OK
+																										   : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+	(void)hadc;
+	hostSimAdvanceNs(hostSimCpuNs);
+	if ((sConfig->Rank < 1) || (sConfig->Rank > 16) || (sConfig->Channel > ADC_CHANNEL_VREFINT))
+	{
+		return HAL_ERROR;
+	}
+	adc.sequence[sConfig->Rank - 1] = sConfig->Channel;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc)
+{
+	(void)hadc;
+	hostSimAdvanceNs(hostSimCpuNs);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	if ((adc.hadc != NULL) || (Length < 2))
+	{
+		return HAL_BUSY;
+	}
+	adc.hadc   = hadc;
+	adc.pData  = (uint16_t *)pData;
+	adc.length = Length;
+	adc.index  = 0;
+	adc.scan   = 0;
+	adcSchedule();
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+	(void)hadc;
+	hostSimAdvanceNs(hostSimCpuNs);
+	adc.hadc = NULL;
+	adcSchedule();
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	hadc->Instance->CR1 = (hadc->Instance->CR1 & ~(ADC_CR1_AWDIE | ADC_CR1_AWDSGL | ADC_CR1_AWDEN | ADC_CR1_AWDCH)) |
+						  ((AnalogWDGConfig->ITMode == ENABLE) ? ADC_CR1_AWDIE : 0) | AnalogWDGConfig->WatchdogMode |
+						  AnalogWDGConfig->Channel;
+	hadc->Instance->HTR = AnalogWDGConfig->HighThreshold;
+	hadc->Instance->LTR = AnalogWDGConfig->LowThreshold;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+	hostSimAdvanceNs(hostSimCpuNs);
+	adc.htim	 = htim;
+	adc.periodNs = ((uint64_t)(htim->Init.Prescaler + 1) * (htim->Init.Period + 1) * 1000000000ULL) / SystemCoreClock;
+	adcSchedule();
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim)
+{
+	(void)htim;
+	hostSimAdvanceNs(hostSimCpuNs);
+	adc.htim = NULL;
+	adcSchedule();
+	return HAL_OK;
+}
+
+/* HAL callbacks, weak as in the real HAL, JMK code may replace them. */
+__attribute__((weak)) void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) { (void)hi2c; }
+__attribute__((weak)) void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) { (void)hi2c; }
+__attribute__((weak)) void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)	{ (void)hi2c; }
+__attribute__((weak)) void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)	{ (void)hi2c; }
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)		{ (void)hi2c; }
+__attribute__((weak)) void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)		{ (void)hadc; }
+__attribute__((weak)) void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)	{ (void)hadc; }
+__attribute__((weak)) void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc) { (void)hadc; }
+__attribute__((weak)) void PendSV_Handler(void)									{ }
+
+/* led.c stand-ins, wait loops toggle LED3 so this is where simulated time moves on. */
+void STM32vldisc_LEDOn(Led_TypeDef Led)		{ (void)Led; }
+void STM32vldisc_LEDOff(Led_TypeDef Led)	{ (void)Led; }
+void STM32vldisc_LEDToggle(Led_TypeDef Led) { (void)Led; hostSimIdle(); }
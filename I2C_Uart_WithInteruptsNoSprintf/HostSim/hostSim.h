@@ -0,0 +1,63 @@
+/**
+  @file hostSim.h
+  @brief Host simulation control, for hostBench.c and other host side checks.
+<pre>
+	See HostSim/stm32f1xx_hal.h for how the simulation hangs together.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/10/2018
+
+*/
+
+#ifndef HOSTSIM_H_
+#define HOSTSIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "at24cModel.h"
+
+/// Devices on the simulated buses, and I2C handles with a transfer in flight.
+#define HOSTSIM_MAX_DEVICES		6
+#define HOSTSIM_MAX_HANDLES		2
+
+typedef struct {
+	uint32_t transactions;				// START .. STOP sequences.
+	uint32_t ackPolls;					// Of which HAL_I2C_IsDeviceReady trials.
+	uint32_t nacks;						// Device address not acknowledged.
+	uint32_t bytes;						// Data bytes moved.
+	uint32_t heldNacks;					// Of the nacks, _IT / _DMA Mem ones that left the bus held, (no STOP).
+	uint32_t heldStarts;				// Starts that found the bus still held, HAL_TIMEOUT / HAL_BUSY after 25ms.
+} hostSimStatsStruct;
+
+/// Bus faults, see hostSimBusFault(..)
+typedef enum {
+	HOSTSIM_FAULT_NONE,
+	HOSTSIM_FAULT_SDA_HELD,				// A slave cut off mid byte holds SDA low for n more SCL clocks.
+	HOSTSIM_FAULT_HANG					// Next non blocking transfer never completes, (lost interrupt / SCL held).
+} hostSimFaultKind;
+
+extern hostSimStatsStruct hostSimStats;
+extern uint32_t hostSimCpuNs;
+
+/// Result of each simulated ADC conversion of channel, in the scan'th scan since HAL_ADC_Start_DMA, (0 if NULL).
+extern uint16_t (*hostSimAdcSource)(uint32_t channel, uint32_t scan);
+
+/// Called as each I2C transaction starts, (hostSimStats.transactions so far, this one included), NULL after hostSimReset().
+extern void (*hostSimOnTransaction)(uint32_t transaction);
+
+/// PendSV waits while true, (held off by higher priority work), PendSV_Handler(..) is weak, as in the startup code.
+extern bool hostSimPendSVHeld;
+void PendSV_Handler(void);
+
+void hostSimAttach(at24cModel *m);
+void hostSimAttachTo(I2C_TypeDef *bus, at24cModel *m);
+void hostSimReset(void);
+void hostSimBusFault(hostSimFaultKind kind, uint32_t clocks);
+
+// An outside master addressing hi2c while it listens as a slave, false if not acknowledged.
+bool hostSimSlaveWrite(I2C_HandleTypeDef *hi2c, const uint8_t *pData, uint16_t size, bool stop);
+bool hostSimSlaveRead(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t size);
+
+#endif /* HOSTSIM_H_ */
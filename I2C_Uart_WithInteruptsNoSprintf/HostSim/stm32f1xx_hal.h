@@ -0,0 +1,371 @@
+/**
+  @file stm32f1xx_hal.h (HostSim)
+  @brief Host side stand-in for the parts of the STM HAL used by the eeprom code.
+<pre>
+	When building on a PC put HostSim ahead of the Drivers include paths, so
+	"stm32f1xx_hal.h" resolves here instead of the real HAL.
+
+	Only the I2C master calls, the I2C slave listen calls, tick, delay,
+	the GPIO calls used for I2C bus recovery and a timer triggered ADC
+	with circular DMA are provided.  Transfers run
+	against the behavioral device models in at24cModel.c, with simulated
+	bus time advanced per bit at hi2c->Init.ClockSpeed.
+
+	Non blocking (_IT) transfers leave the handle busy until the code waits
+	on it.  Every wait loop in the JMK code toggles an LED, and the host
+	STM32vldisc_LEDToggle(..) runs hostSimIdle(), which advances simulated
+	time to the end of the transfer and runs the HAL completion callback.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/10/2018
+
+*/
+
+#ifndef HOSTSIM_STM32F1XX_HAL_H_
+#define HOSTSIM_STM32F1XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+#define SET_BIT(REG, BIT)		((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)		((REG) &= ~(BIT))
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus;
+
+extern uint32_t SystemCoreClock;
+
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  HAL_I2C_STATE_RESET             = 0x00U,
+  HAL_I2C_STATE_READY             = 0x20U,
+  HAL_I2C_STATE_BUSY              = 0x24U,
+  HAL_I2C_STATE_BUSY_TX           = 0x21U,
+  HAL_I2C_STATE_BUSY_RX           = 0x22U,
+  HAL_I2C_STATE_LISTEN            = 0x28U,
+  HAL_I2C_STATE_BUSY_TX_LISTEN    = 0x29U,
+  HAL_I2C_STATE_BUSY_RX_LISTEN    = 0x2AU
+} HAL_I2C_StateTypeDef;
+
+typedef enum
+{
+  HAL_I2C_MODE_NONE               = 0x00U,
+  HAL_I2C_MODE_MASTER             = 0x10U,
+  HAL_I2C_MODE_SLAVE              = 0x20U,
+  HAL_I2C_MODE_MEM                = 0x40U
+} HAL_I2C_ModeTypeDef;
+
+#define HAL_I2C_ERROR_NONE       0x00000000U
+#define HAL_I2C_ERROR_BERR       0x00000001U
+#define HAL_I2C_ERROR_ARLO       0x00000002U
+#define HAL_I2C_ERROR_AF         0x00000004U
+#define HAL_I2C_ERROR_OVR        0x00000008U
+#define HAL_I2C_ERROR_TIMEOUT    0x00000020U
+
+#define I2C_MEMADD_SIZE_8BIT     0x00000001U
+#define I2C_MEMADD_SIZE_16BIT    0x00000010U
+
+#define HAL_MAX_DELAY            0xFFFFFFFFU
+
+#define I2C_DIRECTION_RECEIVE    0x00000000U
+#define I2C_DIRECTION_TRANSMIT   0x00000001U
+#define I2C_FIRST_FRAME          0x00000001U
+#define I2C_NEXT_FRAME           0x00000002U
+#define I2C_FIRST_AND_LAST_FRAME 0x00000004U
+#define I2C_LAST_FRAME           0x00000008U
+
+typedef struct
+{
+  __IO uint32_t CR1;
+  __IO uint32_t SR2;
+} I2C_TypeDef;
+
+extern I2C_TypeDef hostI2C1;
+extern I2C_TypeDef hostI2C2;
+#define I2C1                     (&hostI2C1)
+#define I2C2                     (&hostI2C2)
+
+#define I2C_CR1_STOP             0x00000200U
+#define I2C_CR1_SWRST            0x00008000U
+#define I2C_SR2_MSL              0x00000001U
+#define I2C_FLAG_BUSY            0x00100002U
+
+// BUSY follows the simulated bus, (a slave holding SDA low).
+#define __HAL_I2C_GET_FLAG(__HANDLE__, __FLAG__)	hostSimI2CFlag((__HANDLE__), (__FLAG__))
+
+typedef struct
+{
+  uint32_t ClockSpeed;					// Bus speed in Hz, used for simulated timing.
+  uint32_t OwnAddress1;
+} I2C_InitTypeDef;
+
+// DMA, only linked or not matters, (the simulated bus moves the bytes).
+typedef struct
+{
+  void                       *Parent;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+  I2C_TypeDef                *Instance;
+  I2C_InitTypeDef            Init;
+  uint8_t                    *pBuffPtr;
+  uint16_t                   XferSize;
+  __IO uint16_t              XferCount;
+  __IO uint32_t              XferOptions;
+  __IO HAL_I2C_StateTypeDef  State;
+  __IO HAL_I2C_ModeTypeDef   Mode;
+  __IO uint32_t              ErrorCode;
+  __IO uint32_t              Devaddress;
+  __IO uint32_t              Memaddress;
+  DMA_HandleTypeDef          *hdmatx;
+  DMA_HandleTypeDef          *hdmarx;
+} I2C_HandleTypeDef;
+
+// ADC1 scanning its regular sequence on TIM3 updates into circular DMA, conversions come from hostSimAdcSource.
+// The analog watchdog checks every conversion, (one channel or all), against LTR..HTR.
+typedef struct
+{
+  __IO uint32_t SR;
+  __IO uint32_t CR1;
+  __IO uint32_t HTR;
+  __IO uint32_t LTR;
+  __IO uint32_t DR;
+} ADC_TypeDef;
+
+typedef struct
+{
+  uint32_t ScanConvMode;
+  uint32_t NbrOfConversion;				// Ranks scanned per trigger.
+} ADC_InitTypeDef;
+
+typedef struct
+{
+  ADC_TypeDef                *Instance;
+  ADC_InitTypeDef            Init;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t Channel;
+  uint32_t Rank;						// 1..16.
+  uint32_t SamplingTime;
+} ADC_ChannelConfTypeDef;
+
+#define ADC_SCAN_ENABLE              0x00000100U
+#define ADC_SAMPLETIME_239CYCLES_5   0x00000007U
+#define ADC_CHANNEL_TEMPSENSOR       16U
+#define ADC_CHANNEL_VREFINT          17U
+
+typedef struct
+{
+  uint32_t WatchdogMode;
+  uint32_t Channel;
+  uint32_t ITMode;
+  uint32_t HighThreshold;
+  uint32_t LowThreshold;
+  uint32_t WatchdogNumber;
+} ADC_AnalogWDGConfTypeDef;
+
+#define DISABLE                      0U
+#define ENABLE                       1U
+#define ADC_SR_AWD                   0x00000001U
+#define ADC_CR1_AWDCH                0x0000001FU
+#define ADC_CR1_AWDIE                0x00000040U
+#define ADC_CR1_AWDSGL               0x00000200U
+#define ADC_CR1_AWDEN                0x00800000U
+#define ADC_ANALOGWATCHDOG_NONE      0x00000000U
+#define ADC_ANALOGWATCHDOG_SINGLE_REG (ADC_CR1_AWDSGL | ADC_CR1_AWDEN)
+#define ADC_IT_AWD                   ADC_CR1_AWDIE
+#define ADC_FLAG_AWD                 ADC_SR_AWD
+#define __HAL_ADC_ENABLE_IT(__HANDLE__, __IT__)		SET_BIT((__HANDLE__)->Instance->CR1, (__IT__))
+#define __HAL_ADC_DISABLE_IT(__HANDLE__, __IT__)	CLEAR_BIT((__HANDLE__)->Instance->CR1, (__IT__))
+#define __HAL_ADC_CLEAR_FLAG(__HANDLE__, __FLAG__)	CLEAR_BIT((__HANDLE__)->Instance->SR, (__FLAG__))
+
+typedef struct
+{
+  __IO uint32_t CNT;
+} TIM_TypeDef;
+
+typedef struct
+{
+  uint32_t Prescaler;
+  uint32_t Period;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+  TIM_TypeDef                *Instance;
+  TIM_Base_InitTypeDef       Init;					// Update rate, at SystemCoreClock.
+} TIM_HandleTypeDef;
+
+extern ADC_TypeDef hostADC1;
+extern TIM_TypeDef hostTIM3;
+#define ADC1                     (&hostADC1)
+#define TIM3                     (&hostTIM3)
+
+// GPIO, only the I2C pins do anything, (SCL / SDA of the simulated bus).
+typedef struct
+{
+  __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+extern GPIO_TypeDef hostGPIOA;
+extern GPIO_TypeDef hostGPIOB;
+extern GPIO_TypeDef hostGPIOC;
+#define GPIOA                    (&hostGPIOA)
+#define GPIOB                    (&hostGPIOB)
+#define GPIOC                    (&hostGPIOC)
+
+#define GPIO_PIN_0               ((uint16_t)0x0001)
+#define GPIO_PIN_6               ((uint16_t)0x0040)
+#define GPIO_PIN_7               ((uint16_t)0x0080)
+#define GPIO_PIN_8               ((uint16_t)0x0100)
+#define GPIO_PIN_9               ((uint16_t)0x0200)
+#define GPIO_PIN_10              ((uint16_t)0x0400)
+#define GPIO_PIN_11              ((uint16_t)0x0800)
+
+#define GPIO_MODE_OUTPUT_OD      0x00000011U
+#define GPIO_NOPULL              0x00000000U
+#define GPIO_SPEED_FREQ_HIGH     0x00000003U
+
+// DWT cycle counter, (core_cm3.h), follows simulated time at SystemCoreClock.
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type		  hostDWT;
+extern CoreDebug_Type hostCoreDebug;
+#define DWT                          (&hostDWT)
+#define CoreDebug                    (&hostCoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk       0x00000001U
+#define CoreDebug_DEMCR_TRCENA_Msk   0x01000000U
+
+// PendSV set pending, (core_cm3.h), hostSimAdvanceNs(..) runs PendSV_Handler(..) for it.
+typedef struct
+{
+  __IO uint32_t ICSR;
+} SCB_Type;
+
+extern SCB_Type hostSCB;
+#define SCB                          (&hostSCB)
+#define SCB_ICSR_PENDSVSET_Msk       0x10000000U
+#define SCB_ICSR_PENDSTSET_Msk       0x04000000U
+
+// SysTick registers, (core_cm3.h), written by idleSleep.c only, the simulated ms come from hostSimAdvanceNs(..).
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+} SysTick_Type;
+
+extern SysTick_Type hostSysTick;
+#define SysTick                      (&hostSysTick)
+#define SysTick_CTRL_ENABLE_Msk      0x00000001U
+#define SysTick_LOAD_RELOAD_Msk      0x00FFFFFFU
+
+// Sleep until the next interrupt, (core_cm3.h), hostSimWfi(..) jumps to it.
+void hostSimWfi(void);
+static inline void	   __WFI(void)						{ hostSimWfi(); }
+
+// Core interrupt masking, (core_cm3.h), nothing to mask on the host.
+static inline void	   __disable_irq(void)				{ }
+static inline void	   __enable_irq(void)				{ }
+static inline uint32_t __get_PRIMASK(void)				{ return 0; }
+static inline void	   __set_PRIMASK(uint32_t priMask)	{ (void)priMask; }
+
+// Exclusive access and barriers, (cmsis_gcc.h), one thread, a store always succeeds.
+static inline uint32_t __LDREXW(volatile uint32_t *addr)	{ return *addr; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)	{ *addr = value; return 0; }
+static inline void	   __CLREX(void)					{ }
+static inline void	   __DMB(void)						{ __sync_synchronize(); }
+static inline void	   __DSB(void)						{ __sync_synchronize(); }
+static inline void	   __ISB(void)						{ }
+
+/* ------------ Function Prototypes --------------------------------------*/
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+
+HAL_StatusTypeDef HAL_I2C_EnableListen_IT(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DisableListen_IT(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Slave_Sequential_Transmit_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size, uint32_t XferOptions);
+HAL_StatusTypeDef HAL_I2C_Slave_Sequential_Receive_IT(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size, uint32_t XferOptions);
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_AddrCallback(I2C_HandleTypeDef *hi2c, uint8_t TransferDirection, uint16_t AddrMatchCode);
+void HAL_I2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ListenCpltCallback(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim);
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc);
+
+// Host simulation control, (hostHal.c).
+void	 hostSimIdle(void);
+uint64_t hostSimNowNs(void);
+void	 hostSimAdvanceNs(uint64_t ns);
+FlagStatus hostSimI2CFlag(I2C_HandleTypeDef *hi2c, uint32_t flag);
+
+#endif /* HOSTSIM_STM32F1XX_HAL_H_ */
@@ -0,0 +1,111 @@
+/**
+  @file adcAlarm.h
+  @brief Contains declarations/defines for adcAlarm.c, ADC window alarms from the analog watchdog.
+<pre>
+	An alarm window is a channel of the sampler's list and a range of raw
+	12 bit counts, (C[0x25]=ch,low,high).  Leaving the window raises an
+	alarm, being back inside it by ADCALARM_HYSTERESIS for a whole block
+	clears it.  Nothing polls, both come from interrupts:
+
+	@li The first window is watched by the ADC1 analog watchdog, which
+		checks every conversion of its channel in hardware.  The ADC
+		interrupt raises the alarm, microseconds after the conversion, and
+		is then disabled so an input that stays out interrupts once.
+	@li The F100 has one analog watchdog, (one channel, one window), so
+		the other windows are checked against each block's raw min / max
+		in the sampler's DMA interrupt, (a block time, 64ms, at worst).
+	@li Clearing is always from the block min / max, and re-arms the
+		watchdog.
+
+	Raising or clearing queues an adcAlarmEvent.  cmdAlarmService(..), in
+	the main loop, takes them off the queue: each one is logged as an
+	EELOG_TYPE_ALARM record, and sent unsolicited to the terminal as
+	"ALARM: ..", if those are on, (C[0x27]=log,notify).
+
+	The defaults, (main.c), watch the chip:
+
+		16	temperature sensor	ADCALARM_TEMP_HOT .. ADCALARM_TEMP_COLD
+		17	Vrefint				ADCALARM_VDDA_HIGH .. ADCALARM_VDDA_LOW
+
+	Both fall as what they measure rises, (sensor ~1.43V at 25C, -4.3mV/C,
+	Vrefint 1.20V read against Vdda), counts are at Vdda = 3.3V nominal.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/31/2018
+
+*/
+
+#ifndef ADCALARM_H_
+#define ADCALARM_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Windows, the first has the analog watchdog.
+#define ADCALARM_WINDOWS			4
+
+/// Events waiting for cmdAlarmService(..), more are counted as overflows.
+#define ADCALARM_QUEUE				8
+
+/// Counts a block must be inside the window by for its alarm to clear.
+#define ADCALARM_HYSTERESIS			8
+
+/// Temperature sensor, raw counts: above 70C, below -10C.
+#define ADCALARM_TEMP_HOT			1534
+#define ADCALARM_TEMP_COLD			1961
+
+/// Vrefint, raw counts: Vdda above 3.6V, below 3.0V.
+#define ADCALARM_VDDA_HIGH			1365
+#define ADCALARM_VDDA_LOW			1638
+
+/// adcAlarmStateStruct.awdWindow when no window is set.
+#define ADCALARM_NONE				0xFF
+
+typedef enum eAdcAlarmKind
+			{ ADCALARM_LOW = 1, ADCALARM_HIGH = 2, ADCALARM_CLEAR = 3 }
+			enumAdcAlarmKind;
+
+typedef struct {
+	uint8_t			channel;			// ADC channel number.
+	uint16_t		low;				// Raw counts, in window if low <= value <= high.
+	uint16_t		high;
+	__IO bool		inAlarm;
+	__IO uint32_t	alarms;				// Raised since set.
+} adcAlarmWindowStruct;
+
+typedef struct {
+	uint32_t		tick;				// HAL_GetTick() when raised or cleared.
+	uint8_t			channel;
+	uint8_t			kind;				// enumAdcAlarmKind
+	uint16_t		value;				// Raw counts: the conversion out of window, (block min / max in software), or block mean when cleared.
+} adcAlarmEvent;
+
+typedef struct {
+	ADC_HandleTypeDef		*hadc;
+	adcAlarmWindowStruct	windows[ADCALARM_WINDOWS];
+	uint8_t					windowCount;
+	uint8_t					awdWindow;			// Watched by the analog watchdog, 0 or ADCALARM_NONE.
+	bool					logToEEProm;
+	bool					notify;
+
+	adcAlarmEvent			queue[ADCALARM_QUEUE];
+	__IO uint8_t			head;				// Next written, (interrupts).
+	__IO uint8_t			tail;				// Next read, (main loop).
+	__IO uint32_t			overflows;
+	__IO uint32_t			awdIrqs;
+	uint32_t				maxDelayMs;			// Longest from event to cmdAlarmService(..)
+} adcAlarmStateStruct;
+
+/// Called once for each event taken off the queue, adcAlarmService(..)
+typedef void (*adcAlarmHandler)(const adcAlarmEvent *pEvent);
+
+extern adcAlarmStateStruct adcAlarmState;
+
+void	 adcAlarmInit(ADC_HandleTypeDef *hadc);
+bool	 adcAlarmSet(uint8_t channel, uint16_t low, uint16_t high);
+bool	 adcAlarmRemove(uint8_t channel);
+void	 adcAlarmBlock(void);
+uint32_t adcAlarmService(adcAlarmHandler handler);
+
+#endif /* ADCALARM_H_ */
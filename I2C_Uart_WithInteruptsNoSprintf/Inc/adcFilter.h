@@ -0,0 +1,122 @@
+/**
+  @file adcFilter.h
+  @brief Contains declarations/defines for adcFilter.c, fixed point filtering of the ADC sample blocks.
+<pre>
+	The sampler, (adcSampler.c), keeps per channel block values and a
+	one pole low pass, that is all it has time for in the DMA interrupt.
+	This is the stage after it, a filter run over every sample of each
+	block, out of the interrupt:
+
+		DMA half irq --> adcFilterPost(..) --> PendSV work --> adcFilterService(..)
+		  (sampler)		  (note the block)	   (pendWork.h, lowest priority)
+
+	adcFilterService(..) filters each channel of the block the DMA just
+	handed over, in place, in ADCFILTER_CHUNK sample pieces: a piece is
+	taken out of the interleaved DMA half, filtered in its own buffer,
+	and the last output kept.  Nothing is copied block sized, so the whole
+	stage costs ~300 bytes of RAM however long the block.
+
+	It has until the DMA comes back round to that half, one block time,
+	(64ms at 1 KHz), to finish.  Cycles per block are measured, a block
+	not finished in time is counted as late, one posted while the one
+	before is still waiting is dropped.
+
+	Filters, (C[0x24]=type,param):
+
+	@li ADCFILTER_AVERAGE, boxcar of 2^param samples, decimated, (a one
+		stage CIC), an add per sample and a shift per output.
+	@li ADCFILTER_FIR, 16 tap q15 low pass, -3dB at 50 Hz, -44dB at 200 Hz
+		and above, (Hamming windowed sinc, unity DC gain).
+	@li ADCFILTER_BIQUAD, q31 Butterworth low pass, -3dB at 10 Hz, param
+		stages: 1 is 2nd order, 2 is 4th order, (direct form 1, cascade).
+
+	Corners are for the 1 KHz scan rate, they move with ADCSAMPLER_RATE_HZ.
+
+	The kernels are those of CMSIS-DSP, arm_fir_q15(..) and
+	arm_biquad_cascade_df1_q31(..), with the same coefficient and state
+	layout and the same arithmetic.  Define ADCFILTER_CMSIS_DSP, with
+	ARM_MATH_CM3, and link libarm_cortexM3l_math.a to call the library
+	instead, the tree has only its header, (Drivers/CMSIS/Include).
+
+	Outputs are oversampled counts, (adcSampler.h), 12 bit samples << 3.
+	The biquad runs at half of q31 full scale, a 4th order Butterworth
+	overshoots ~11% on a step.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/30/2018
+
+*/
+
+#ifndef ADCFILTER_H_
+#define ADCFILTER_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "adcSampler.h"
+#ifdef ADCFILTER_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/// Samples per filter call, a block is ADCSAMPLER_BLOCK / ADCFILTER_CHUNK calls per channel.
+#define ADCFILTER_CHUNK				16
+
+/// FIR taps, CMSIS q15 FIR needs an even number, 4 or more.
+#define ADCFILTER_FIR_TAPS			16
+
+/// Biquad stages, (5 q31 coefficients, 4 q31 state each).
+#define ADCFILTER_BIQUAD_MAX_STAGES	2
+
+/// Longest boxcar, 2^n samples.
+#define ADCFILTER_AVERAGE_MAX_LOG2	6
+
+/// No block waiting, adcFilterStateStruct.pendingHalf.
+#define ADCFILTER_NO_BLOCK			0xFF
+
+typedef enum eAdcFilterType
+			{ ADCFILTER_NONE, ADCFILTER_AVERAGE, ADCFILTER_FIR, ADCFILTER_BIQUAD }
+			enumAdcFilterType;
+
+typedef struct {
+	__IO int16_t	output;				// Last filtered sample, oversampled counts.
+	bool			primed;				// State holds this channel's history.
+	union {
+		int16_t		fir[ADCFILTER_FIR_TAPS + ADCFILTER_CHUNK - 1];		// q15, oldest first.
+		int32_t		biquad[4 * ADCFILTER_BIQUAD_MAX_STAGES];			// q31, x[n-1] x[n-2] y[n-1] y[n-2] per stage.
+		struct {
+			uint32_t	sum;
+			uint8_t		count;
+		}			average;
+	} state;
+#ifdef ADCFILTER_CMSIS_DSP
+	union {
+		arm_fir_instance_q15			fir;
+		arm_biquad_casd_df1_inst_q31	biquad;
+	} instance;
+#endif
+} adcFilterChannelStruct;
+
+typedef struct {
+	enumAdcFilterType		type;
+	uint8_t					param;
+	adcFilterChannelStruct	channels[ADCSAMPLER_MAX_CHANNELS];	// Sampler rank order.
+
+	__IO uint8_t			pendingHalf;		// DMA half to filter next, ADCFILTER_NO_BLOCK if none.
+	__IO uint32_t			pendingBlock;		// adcSamplerState.blocks when it was posted.
+	__IO bool				reprime;			// Sampler restarted, channels start again.
+
+	__IO uint32_t			blocks;				// Filtered.
+	__IO uint32_t			dropped;			// Posted while the one before was waiting.
+	__IO uint32_t			late;				// DMA was back in the half before the filter was done.
+	uint32_t				lastCycles;			// Per block, all channels.
+	uint32_t				maxCycles;
+} adcFilterStateStruct;
+
+extern adcFilterStateStruct adcFilterState;
+
+bool	 adcFilterConfigure(enumAdcFilterType type, uint8_t param);
+void	 adcFilterPost(uint8_t half);
+void	 adcFilterService(void);
+uint16_t adcFilterValue(uint8_t index);
+
+#endif /* ADCFILTER_H_ */
@@ -0,0 +1,120 @@
+/**
+  @file adcSampler.h
+  @brief Contains declarations/defines for adcSampler.c, continuous DMA sampling of a list of ADC channels.
+<pre>
+	TIM3 update events, (TRGO), start one ADC1 scan of the channel list
+	each, DMA1 channel 1 moves every result into a circular buffer of two
+	halves.  The DMA half / full interrupts hand over one half, (a block),
+	while the other half fills, so the CPU does nothing per sample:
+
+		TIM3 1 KHz --> ADC1 scan ch a,b,.. --> DMA --> [ block 0 | block 1 ]
+														half irq ^   full irq ^
+
+	A block is ADCSAMPLER_BLOCK scans, interleaved, (a b c a b c ..).  Per
+	channel per block, in the DMA interrupt:
+
+	@li Oversample, the block of 4^ADCSAMPLER_EXTRA_BITS samples is summed
+		and shifted right by ADCSAMPLER_EXTRA_BITS, 12 bits of ADC become
+		15, (the sensor and ADC noise dither the extra bits).
+	@li Filter, first order low pass on the decimated values, each new
+		one moves the output 1 / 2^ADCSAMPLER_FILTER_SHIFT of the way.
+	@li Statistics, min / max of the raw samples, their sum and sum of
+		squares for mean and variance, since adcSamplerStatsClear(..).
+
+	Oversampled and filtered values are in "oversampled counts", 12 bit
+	ADC counts times 2^ADCSAMPLER_EXTRA_BITS, (0..32760 for 0..Vref).
+	Mean and variance, (adcSamplerStats), are Q4: 1/16 count, 1/16 count^2.
+
+	The list is ADC channel numbers, 0..17, converted in ascending order,
+	the default is ADCSAMPLER_DEFAULT_CHANNELS:
+
+		16	temperature sensor
+		17	Vrefint, 1.20V nominal, gives Vdda: 1.20 * 4095 / Vrefint counts
+		2,3	PA2, PA3, (ADC1_IN2, ADC1_IN3)
+
+	Internal channels need a 17.1us sample time, every channel uses 239.5
+	ADC cycles, (~63us per conversion at the 4 MHz ADC clock, ~21us at
+	12 MHz, clockProfile.h), so 4 channels could be scanned at ~3.9 KHz,
+	(~11.9 KHz), before the ADC is the limit.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/29/2018
+
+*/
+
+#ifndef ADCSAMPLER_H_
+#define ADCSAMPLER_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Scans per second, TIM3 update rate.
+#define ADCSAMPLER_RATE_HZ			1000
+
+/// Resolution gained by oversampling, a block is 4^n scans.
+#define ADCSAMPLER_EXTRA_BITS		3
+#define ADCSAMPLER_BLOCK			(1U << (2 * ADCSAMPLER_EXTRA_BITS))
+
+/// Low pass, output moves 1 / 2^n of the way to each new block value, (~0.26s time constant at 1 KHz).
+#define ADCSAMPLER_FILTER_SHIFT		2
+
+/// Longest channel list, the DMA buffer is 2 blocks of this many channels, (1 KB).
+#define ADCSAMPLER_MAX_CHANNELS		4
+
+/// Channel list as a bit per ADC channel number, (C[0x22]), temperature, Vrefint, PA2, PA3.
+#define ADCSAMPLER_CHANNEL_MASK		0x3FFFFUL
+#define ADCSAMPLER_DEFAULT_CHANNELS	((1UL << 16) | (1UL << 17) | (1UL << 2) | (1UL << 3))
+
+/// adcSamplerFind(..) did not find the channel.
+#define ADCSAMPLER_NONE				0xFF
+
+typedef struct {
+	uint8_t				channel;		// ADC channel number, 0..17.
+	__IO uint16_t		latest;			// Last block, oversampled counts.
+	__IO uint32_t		filterAcc;		// Filter output << ADCSAMPLER_FILTER_SHIFT.
+	uint16_t			blockMin;		// Raw 12 bit samples of the last block, (alarm windows).
+	uint16_t			blockMax;
+
+	// Since adcSamplerStatsClear(..), raw 12 bit samples.
+	uint16_t			min;
+	uint16_t			max;
+	uint32_t			samples;
+	uint64_t			sum;
+	uint64_t			sumSq;
+} adcSamplerChannelStruct;
+
+typedef struct {
+	ADC_HandleTypeDef		*hadc;
+	TIM_HandleTypeDef		*htim;
+	bool					running;
+	uint32_t				channelMask;		// Channels in the list.
+	uint8_t					channelCount;
+	adcSamplerChannelStruct	channels[ADCSAMPLER_MAX_CHANNELS];	// Rank order.
+
+	__IO uint32_t			blocks;				// Since start.
+	__IO uint32_t			missed;				// Blocks handed over out of turn, (interrupt held off a whole block).
+	__IO uint8_t			nextHalf;			// Half expected next, 0 or 1.
+	uint32_t				maxIsrCycles;		// Longest block processing.
+} adcSamplerStateStruct;
+
+/// One channel's statistics, adcSamplerStats(..)
+typedef struct {
+	uint32_t	samples;
+	uint16_t	min;
+	uint16_t	max;
+	uint32_t	meanQ4;						// Counts * 16.
+	uint32_t	varianceQ4;					// Counts^2 * 16.
+} adcSamplerStatsStruct;
+
+extern adcSamplerStateStruct adcSamplerState;
+
+bool	 adcSamplerStart(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim, uint32_t channelMask);
+void	 adcSamplerStop(void);
+uint8_t	 adcSamplerFind(uint32_t channel);
+uint16_t adcSamplerFiltered(uint8_t index);
+const uint16_t *adcSamplerBlock(uint8_t half);
+bool	 adcSamplerStats(uint8_t index, adcSamplerStatsStruct *pStats);
+void	 adcSamplerStatsClear(void);
+
+#endif /* ADCSAMPLER_H_ */
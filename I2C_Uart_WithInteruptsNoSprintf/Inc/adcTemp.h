@@ -0,0 +1,106 @@
+/**
+  @file adcTemp.h
+  @brief Contains declarations/defines for adcTemp.c, chip temperature in fixed point, two point calibration.
+<pre>
+	The F100 temperature sensor, (ADC channel 16), is a voltage falling
+	about 4.3mV per degree, ~1.41V at 25C, (data sheet V25, Avg_Slope).
+	Read as oversampled counts, (adcSampler.h), that is a straight line:
+
+		temp = refTemp + (counts - refCounts) * gain
+
+	held as refCounts, refTempQ8 and gainQ16.  Temperatures are Q8, signed
+	1/256 degree C in an int16_t, (-128.00 .. +127.99 C, the sensor is
+	specified -40 .. +125 C), so one conversion is a subtract, a 32x32
+	multiply, (SMULL), and a shift: no divide, no float.
+
+	The line starts out from the data sheet typicals at Vdda = 3.3V, which
+	are only good to a few degrees, (V25 is 1.34 .. 1.52V part to part).
+	A two point calibration replaces it:
+
+		C[0x28]=1,<centi C>		reading now is point 1, at this temperature
+		C[0x28]=2,<centi C>		reading now is point 2, line is worked out and saved
+		C[0x28]=0,0				back to the data sheet line, saved
+
+	Points are the filtered sensor reading, (adcFilterValue(..)), let it
+	settle at each temperature first.  The two must be ADCTEMP_CAL_MIN_C
+	apart, and the slope they give within 2:1 of the data sheet's.  The
+	calibration absorbs the Vdda error as it was when it was taken.
+
+	Saved to the first configuration page of the AT24C, (serialEEProm.h
+	memory map), with a CRC, adcTempInit(..) loads it at power up and
+	keeps the data sheet line if the page is blank or bad.
+
+	adcTempToString(..) formats Q8 temperatures to 0..2 decimals, digits
+	by multiply and shift, (x / 10 == (x * 0xCCCD) >> 19 below 81920).
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/01/2018
+
+*/
+
+#ifndef ADCTEMP_H_
+#define ADCTEMP_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+#include "adcSampler.h"
+
+/// Data sheet typicals, (STM32F100 temperature sensor characteristics), and the Vdda they are taken at.
+#define ADCTEMP_V25_UV				1410000
+#define ADCTEMP_SLOPE_UV			4300				// Per degree C.
+#define ADCTEMP_VDDA_UV				3300000
+
+/// Oversampled counts at Vdda, (12 bit full scale << ADCSAMPLER_EXTRA_BITS).
+#define ADCTEMP_FULL_SCALE			(4095ULL << ADCSAMPLER_EXTRA_BITS)
+
+/// Data sheet line: counts at 25C, Q8 degrees per count << 16, (~ -393000, 1 / 42.7 counts per degree).
+#define ADCTEMP_DEFAULT_COUNTS		((uint16_t)((ADCTEMP_V25_UV * ADCTEMP_FULL_SCALE + ADCTEMP_VDDA_UV / 2) / ADCTEMP_VDDA_UV))
+#define ADCTEMP_DEFAULT_TEMP_Q8		(25 * 256)
+#define ADCTEMP_DEFAULT_GAIN_Q16	(-(int32_t)((256ULL * 65536 * ADCTEMP_VDDA_UV) / (ADCTEMP_SLOPE_UV * ADCTEMP_FULL_SCALE)))
+
+/// Calibration points closer than this, (degrees C), are refused.
+#define ADCTEMP_CAL_MIN_C			5
+
+/// Eeprom page and device holding the calibration, first configuration page, (serialEEProm.h).
+#define ADCTEMP_I2C_HANDLE			(&hi2c2)
+#define ADCTEMP_DEV_ADDR			A0A1_00
+#define ADCTEMP_CAL_PAGE			SEE_MAP_CONFIG_FIRST
+#define ADCTEMP_CAL_MAGIC			0x5443				// "CT" in eeprom byte order.
+
+/// adcTempToString(..) longest, "-128.00" and the null.
+#define ADCTEMP_STR_MAX				8
+#define ADCTEMP_MAX_DECIMALS		2
+
+/// The calibration, as saved in the eeprom, 16 bytes.
+typedef struct {
+	uint16_t	magic;
+	uint16_t	refCounts;			// Oversampled counts at refTempQ8.
+	int16_t		refTempQ8;
+	uint8_t		points;				// 0 data sheet line, 2 two point calibration.
+	uint8_t		spare;
+	int32_t		gainQ16;			// Q8 degrees per count << 16, negative, the sensor voltage falls as it warms.
+	uint16_t	spare2;
+	uint16_t	crc;				// eeCrc16(..) of the bytes before it.
+} adcTempCalStruct;
+
+typedef struct {
+	adcTempCalStruct	cal;
+	bool				loaded;				// cal came from the eeprom.
+	uint16_t			pointCounts[2];		// Points taken by adcTempCalPoint(..), not yet used.
+	int16_t				pointTempQ8[2];
+	uint8_t				pointsTaken;		// Bit per point.
+	uint32_t			saveErrors;
+} adcTempStateStruct;
+
+extern adcTempStateStruct adcTempState;
+extern I2C_HandleTypeDef hi2c2;
+
+void	adcTempInit(void);
+int16_t	adcTempFromCounts(uint16_t counts);
+bool	adcTempRead(int16_t *pTempQ8);
+bool	adcTempCalPoint(uint8_t point, int32_t centiC);
+void	adcTempToString(int16_t tempQ8, uint8_t decimals, char *stringToCreate);
+
+#endif /* ADCTEMP_H_ */
@@ -0,0 +1,75 @@
+/**
+  @file clockProfile.h
+  @brief Contains declarations/defines for clockProfile.c, system clock profiles switched at run time.
+<pre>
+	SystemClock_Config() starts the core on HSI at 8 MHz, no PLL, a third
+	of the F100's 24 MHz.  The profiles, (AHB, APB1, APB2 all /1, so
+	HCLK = PCLK1 = PCLK2 = SYSCLK, no flash wait states up to 24 MHz):
+
+		CLOCKPROFILE_HSI_8MHZ		HSI						 8 MHz
+		CLOCKPROFILE_HSI_PLL_24MHZ	HSI / 2 * 6, PLL		24 MHz
+		CLOCKPROFILE_HSE_PLL_24MHZ	HSE 8 MHz * 3, PLL		24 MHz, (VL Discovery
+									crystal X2, if fitted)
+
+	clockProfileSet(..) changes profile with everything running, then puts
+	back what was derived from the old clock:
+
+		USART1 BRR		same baud, (huart1.Init.BaudRate), from PCLK2
+		I2C1 / I2C2		CR2 FREQ, CCR, TRISE, HAL_I2C_Init(..), from PCLK1
+		TIM3 PSC		1 MHz count, the ADC scan rate, from PCLK1
+		ADC prescaler	fastest PCLK2 / 2,4,6,8 not over 14 MHz
+		SysTick			1 ms reload, HAL_InitTick(..), then every NVIC
+						tier again, irqPriorityApply(..)
+
+	It refuses, (false, nothing changed), unless both I2C queues are empty
+	with their handles ready, (not mid transfer, not a retry waiting, not
+	the eeprom simulator listening), and USART1 is not sending.  A byte
+	coming in while the clock changes may be lost, (Rx_errors).  A PLL
+	profile is left for HSI first, the PLL can only be changed while it is
+	not the system clock.  HSE that does not start within
+	HSE_STARTUP_TIMEOUT goes back to the profile before, (hseFailures).
+
+	Cycle counts taken before a change, (S[0x1D], S[0x1E], I2C trace)
+	are at the old clock, they are converted with the new one.  The
+	interrupt stats are started again, their bound is checked against the
+	byte time at the new clock.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/06/2018
+
+*/
+
+#ifndef CLOCKPROFILE_H_
+#define CLOCKPROFILE_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+typedef enum eClockProfile
+			{ CLOCKPROFILE_HSI_8MHZ, CLOCKPROFILE_HSI_PLL_24MHZ, CLOCKPROFILE_HSE_PLL_24MHZ,
+			  CLOCKPROFILE_COUNT }
+			enumClockProfile;
+
+/// Set from main() once the peripherals are up.
+#define CLOCKPROFILE_BOOT			CLOCKPROFILE_HSI_PLL_24MHZ
+
+/// ADC clock maximum, (F100 data sheet).
+#define CLOCKPROFILE_ADC_MAX_HZ		14000000
+
+typedef struct {
+	enumClockProfile	profile;
+	uint32_t			adcPrescaler;		// RCC_ADCPCLK2_DIVx in use, (0 is DIV2, as SystemClock_Config()).
+	uint32_t			adcHz;
+	uint32_t			switches;
+	uint32_t			refused;			// Bus or UART busy.
+	uint32_t			hseFailures;		// HSE did not start, back to the profile before.
+	uint32_t			maxSwitchMs;		// Longest clockProfileSet(..), (HSE start up).
+} clockProfileStateStruct;
+
+extern clockProfileStateStruct clockProfileState;
+
+bool		clockProfileSet(enumClockProfile profile);
+const char *clockProfileName(enumClockProfile profile);
+
+#endif /* CLOCKPROFILE_H_ */
@@ -0,0 +1,70 @@
+/**
+  @file eePromCopy.h
+  @brief Contains declarations/defines for eePromCopy.c, background copy between two serial eeproms.
+<pre>
+	Copies a range from an AT24C on one bus to an AT24C on the same or the
+	other bus, through the i2cBus queues, entirely from the I2C callbacks.
+
+	EECOPY_BUFFERS page buffers go round read -> write -> read, so the
+	read of the next page runs while the destination sits in tWR.  On one
+	bus the read waits its turn behind the write's ack polls, on two buses
+	it runs while the page is still being written:
+
+		same bus		per page: ~ write + tWR, plus the read when it outlasts tWR
+		two buses		per page: the longer of read, write + tWR
+
+	Either way a copy is bound by the destination's write cycle, two buses
+	gain most with long pages and short tWR, (AT24C512 ~1.3x), reads of
+	parts on both buses run at twice the rate of one.
+
+	Writes never cross a page of the destination, so only the first and
+	last chunk of an unaligned range are short.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/23/2018
+
+*/
+
+#ifndef EEPROMCOPY_H_
+#define EEPROMCOPY_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+#include "i2cBus.h"
+
+/// Pages in flight, (2 is enough to keep both buses busy).
+#define EECOPY_BUFFERS		2
+
+typedef enum eEECopyState
+			{ EECOPY_IDLE, EECOPY_RUNNING, EECOPY_DONE, EECOPY_FAILED }
+			enumEECopyState;
+
+typedef struct {
+	enumI2CBus				srcBus;
+	enumAT24C_7BitAddr		srcAddr7Bit;
+	uint32_t				srcStart;
+	enumI2CBus				dstBus;
+	enumAT24C_7BitAddr		dstAddr7Bit;
+	uint32_t				dstStart;
+	uint32_t				length;
+
+	__IO enumEECopyState	state;
+	__IO uint32_t			readOffset;			// Next chunk to read, from the range start.
+	__IO uint32_t			bytesCopied;		// Written to the destination.
+	__IO uint32_t			inFlight;			// Buffers with a transfer queued.
+	__IO uint32_t			errorCode;			// HAL I2C error code that stopped a failed copy.
+
+	uint32_t				startTick;
+	__IO uint32_t			endTick;
+} eeCopyStateStruct;
+
+extern eeCopyStateStruct eeCopyState;
+
+bool	 eeCopyStart(enumI2CBus srcBus, enumAT24C_7BitAddr srcAddr7Bit, uint32_t srcStart,
+					 enumI2CBus dstBus, enumAT24C_7BitAddr dstAddr7Bit, uint32_t dstStart, uint32_t length);
+bool	 eeCopyBusy(void);
+uint32_t eeCopyElapsedMs(void);
+
+#endif /* EEPROMCOPY_H_ */
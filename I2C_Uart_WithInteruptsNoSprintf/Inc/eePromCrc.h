@@ -0,0 +1,79 @@
+/**
+  @file eePromCrc.h
+  @brief Contains declarations/defines for eePromCrc.c, per page CRC integrity layer for the serial eeprom.
+<pre>
+	A CRC-16 (CCITT, init 0xFFFF) is kept in RAM for every data page of the
+	part, and saved to a table in the top SEE_MAP_CRC_PAGES pages of it,
+	(top 16 pages of an AT24C256).
+
+	Each table page holds (page size - 2) / 2 page CRCs followed by a CRC-16
+	of the table page itself, so a torn table write only loses those entries.
+	For the 64 byte AT24C256 page:
+
+		 0..61	crc[31]			Little endian, data page (table page * 31 + i).
+		62..63	check			CRC-16 of bytes 0..61.
+
+	Every write through the driver (sEEProm writes, background fill) tells
+	eeCrcNoteWrite(..) about it, which marks the page as changed:
+
+	@li Whole aligned page written	- new CRC taken from the data written.
+	@li Partial page written		- CRC unknown until next check reads it back.
+
+	eeCrcScan(..) reads the pages back at full bus rate, reading the next
+	block while the previous one is checked, and reports bad pages.
+	A scan of changed pages only is the incremental check.  Table pages
+	holding changed entries are saved at the end of every scan.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/14/2018
+
+*/
+
+#ifndef EEPROMCRC_H_
+#define EEPROMCRC_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+
+/// I2C handle and eeprom device covered.
+#define EECRC_I2C_HANDLE		(&hi2c2)
+#define EECRC_DEV_ADDR			A0A1_00
+
+/// CRC table region, (top of part, see serialEEProm.h memory map), and data pages covered, (all below it).
+#define EECRC_TABLE_FIRST_PAGE	SEE_MAP_CRC_FIRST
+#define EECRC_TABLE_PAGES		SEE_MAP_CRC_PAGES
+#define EECRC_ENTRIES_PER_TABLE	((AT24C_PAGE_SIZE - 2) / 2)
+#define EECRC_PAGE_COUNT		EECRC_TABLE_FIRST_PAGE
+
+/// Pages per read while scanning, 128 bytes, (driver reads are at most 255 bytes), two of these buffers are used.
+#define EECRC_READ_PAGES		(128 / AT24C_PAGE_SIZE)
+
+typedef struct {
+	bool	 loaded;				// eeCrcInit(..) has run.
+	uint32_t lastScanPages;			// Pages read by last scan.
+	uint32_t lastScanBad;			// Pages that did not match their CRC.
+	uint32_t lastScanLearned;		// Pages with unknown CRC, CRC taken from what was read.
+	uint32_t lastScanMs;
+	uint32_t readErrors;			// Scan reads that failed, since boot.
+	uint32_t tablePagesSaved;		// Since boot.
+	uint32_t tableSaveErrors;		// Table page writes that did not start, kept dirty for the next save.
+} eeCrcStateStruct;
+
+/// Called for each page failing its CRC during eeCrcScan(..)
+typedef void (*eeCrcBadPageHandler)(uint16_t page, uint16_t expectedCrc, uint16_t actualCrc);
+
+extern eeCrcStateStruct eeCrcState;
+extern I2C_HandleTypeDef hi2c2;
+
+uint16_t eeCrc16(const uint8_t *pData, uint32_t length, uint16_t crc);
+
+void	 eeCrcInit(void);
+void	 eeCrcNoteWrite(enumAT24C_7BitAddr addr7Bit, uint32_t EEaddress, const uint8_t *pData, uint32_t length);
+uint32_t eeCrcScan(bool changedOnly, eeCrcBadPageHandler handler);
+uint32_t eeCrcRelearn(void);
+uint16_t eeCrcChangedPages(void);
+uint16_t eeCrcUnknownPages(void);
+
+#endif /* EEPROMCRC_H_ */
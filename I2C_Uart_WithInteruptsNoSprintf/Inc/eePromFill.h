@@ -0,0 +1,78 @@
+/**
+  @file eePromFill.h
+  @brief Contains declarations/defines for eePromFill.c, background fill / erase of a serial eeprom range.
+<pre>
+	A fill runs entirely from the I2C completion callbacks: each page write
+	completion starts the next page write, and while the part is in its
+	internal write cycle tWR the new write's device address is NACKed, the
+	error callback simply starts it again.  That is ACKNOWLEDGE POLLING
+	with the write itself, so the next page goes out as soon as tWR ends.
+
+	The data for every page comes straight from one of four const pattern
+	pages in flash, (one per enumArrayFillType), nothing is copied per page.
+
+	Optionally the range is read back and compared against the pattern
+	once all writes are done.
+
+	While a fill is running the I2C handle is never ready, so other eeprom
+	users wait for it in their usual ready loops.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/12/2018
+
+*/
+
+#ifndef EEPROMFILL_H_
+#define EEPROMFILL_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+
+/// Longest time one page may take, transfer + tWR + NACKed retries, before fill gives up.
+#define EEFILL_CHUNK_TIMEOUT_MS		(3 * AT24C_TWR_MAX_MS)
+
+typedef enum eEEFillState
+			{ EEFILL_IDLE, EEFILL_WRITING, EEFILL_VERIFYING, EEFILL_DONE, EEFILL_FAILED }
+			enumEEFillState;
+
+typedef struct {
+	I2C_HandleTypeDef		*hi2c;
+	enumAT24C_7BitAddr		addr7Bit;
+	enumArrayFillType		fillType;
+	bool					verify;
+
+	uint32_t				startAddr;			// First byte of range.
+	uint32_t				endAddr;			// One past last byte of range.
+
+	__IO enumEEFillState	state;
+	__IO uint32_t			nextAddr;			// Start of chunk in progress.
+	__IO uint16_t			chunkLength;		// Bytes in chunk in progress, (to page end or range end).
+	__IO uint32_t			chunkTick;			// HAL tick when chunk in progress was first tried.
+
+	__IO uint32_t			chunksDone;			// Writes + verify reads completed.
+	uint32_t				chunksTotal;		// Writes + verify reads needed.
+	__IO uint32_t			ackPolls;			// Attempts NACKed while part was busy.
+	__IO uint32_t			verifyErrors;		// Chunks that did not read back as the pattern.
+	__IO uint32_t			firstBadAddr;		// Start of first chunk that failed verify.
+	__IO uint32_t			errorCode;			// HAL I2C error code that stopped a failed fill.
+
+	uint32_t				startTick;
+	__IO uint32_t			endTick;
+} eeFillStateStruct;
+
+extern eeFillStateStruct eeFillState;
+
+bool eeFillStart(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint32_t startAddr, uint32_t length,
+				 enumArrayFillType fillType, bool verify);
+bool eeFillBusy(void);
+uint32_t eeFillPercentDone(void);
+uint32_t eeFillElapsedMs(void);
+
+// Called from the HAL I2C callbacks in i2c_jmk.c, true if the event belonged to the fill.
+bool eeFillOnTxCplt(I2C_HandleTypeDef *hi2c);
+bool eeFillOnRxCplt(I2C_HandleTypeDef *hi2c);
+bool eeFillOnError(I2C_HandleTypeDef *hi2c);
+
+#endif /* EEPROMFILL_H_ */
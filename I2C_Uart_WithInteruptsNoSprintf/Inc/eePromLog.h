@@ -0,0 +1,101 @@
+/**
+  @file eePromLog.h
+  @brief Contains declarations/defines for eePromLog.c, circular record log in serial eeprom.
+<pre>
+	The log lives in a range of whole AT24C256 pages.  Each page is committed
+	in one page write and starts with a small header holding a magic number,
+	a record count, a check byte and a page sequence number.
+
+	Page layout (64 bytes):
+
+		 0..1	magic			EELOG_PAGE_MAGIC
+		 2		recordCount		1..EELOG_RECORDS_PER_PAGE
+		 3		check			CRC-8 of the whole page, with this byte taken as 0.
+		 4..7	seq				Page sequence number, +1 for every page committed.
+		 8..63	record[7]		8 byte records, oldest first.
+
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/08/2018
+
+*/
+
+#ifndef EEPROMLOG_H_
+#define EEPROMLOG_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+
+/// I2C handle and eeprom device holding the log.
+#define EELOG_I2C_HANDLE		(&hi2c2)
+#define EELOG_DEV_ADDR			A0A1_00
+
+/// First page of the log region, and number of pages in the ring.
+/// (Everything below the configuration and CRC table pages, see serialEEProm.h
+/// memory map, pages 0..479 of the AT24C256)
+#define EELOG_FIRST_PAGE		SEE_MAP_LOG_FIRST
+#define EELOG_PAGE_COUNT		SEE_MAP_LOG_PAGES
+
+/// Tries eeLogInit(..) gives a page read that fails on the bus, any page still unread leaves the log unmounted.
+#define EELOG_MOUNT_TRIES		3
+
+#define EELOG_PAGE_MAGIC		0x4C47		// "GL" in eeprom byte order.
+#define EELOG_HEADER_SIZE		8
+#define EELOG_RECORD_SIZE		8
+#define EELOG_RECORDS_PER_PAGE	((AT24C_PAGE_SIZE - EELOG_HEADER_SIZE) / EELOG_RECORD_SIZE)
+
+/// Record types.
+typedef enum eLogRecordType
+			{ EELOG_TYPE_TEMPERATURE = 1, EELOG_TYPE_EVENT = 2, EELOG_TYPE_ALARM = 3, EELOG_TYPE_TEMP_Q8 = 4 }
+			enumLogRecordType;
+
+/// Event codes, used with EELOG_TYPE_EVENT.
+typedef enum eLogEventCode
+			{ EELOG_EVT_BOOT = 1, EELOG_EVT_BUTTON = 2, EELOG_EVT_FLUSH = 3 }
+			enumLogEventCode;
+
+/// One log record, 8 bytes.
+typedef struct {
+	uint32_t time;					// Log time in ms, continues across power cycles.
+	uint8_t  type;					// enumLogRecordType
+	uint8_t  code;					// ADC channel, or enumLogEventCode
+	uint16_t value;					// Raw ADC reading, or event parameter, (alarm: enumAdcAlarmKind << 12 | reading, temp Q8: int16_t 1/256 C).
+} eeLogRecord;
+
+/// One log page as stored in the eeprom, exactly AT24C_PAGE_SIZE bytes.
+typedef struct {
+	uint16_t magic;
+	uint8_t  recordCount;
+	uint8_t  check;
+	uint32_t seq;
+	eeLogRecord record[EELOG_RECORDS_PER_PAGE];
+} eeLogPage;
+
+/// Log state, as recovered by eeLogInit(..) and maintained by eeLogAppend(..)
+typedef struct {
+	bool	 mounted;				// eeLogInit(..) read every page it probed, (else nothing is committed, sequence unknown).
+	uint16_t headPage;				// Newest committed page, (index in log region).
+	uint16_t tailPage;				// Oldest committed page, (index in log region).
+	uint16_t pageCount;				// Committed pages in ring, 0..EELOG_PAGE_COUNT
+	uint32_t nextSeq;				// Sequence number for next page committed.
+	uint32_t timeBase;				// Added to HAL_GetTick() to get log time.
+	uint32_t pagesCommitted;		// Since boot.
+	uint32_t commitErrors;			// Since boot.
+} eeLogStateStruct;
+
+/// Called once for each record matching an eeLogQuery(..)
+typedef void (*eeLogRecordHandler)(const eeLogRecord *pRecord);
+
+extern eeLogStateStruct eeLogState;
+extern I2C_HandleTypeDef hi2c2;
+
+void	 eeLogInit(void);
+uint32_t eeLogNow(void);
+bool	 eeLogAppend(enumLogRecordType type, uint8_t code, uint16_t value);
+bool	 eeLogFlush(void);
+uint8_t	 eeLogPendingRecords(void);
+uint32_t eeLogQuery(uint32_t timeStart, uint32_t timeEnd, eeLogRecordHandler handler);
+
+#endif /* EEPROMLOG_H_ */
@@ -0,0 +1,112 @@
+/**
+  @file i2cBus.h
+  @brief Contains declarations/defines for i2cBus.c, per bus transfer queues for I2C2 and I2C1.
+<pre>
+	Each I2C peripheral is a bus instance with its own handle, interrupts,
+	DMA channels and queue of transfers:
+
+		I2CBUS_EE	I2C2, PB10/PB11, DMA1 ch4 (TX) ch5 (RX), the AT24C bus.
+		I2CBUS_AUX	I2C1, PB6/PB7,	 DMA1 ch6 (TX) ch7 (RX).
+
+	A transfer is an i2cBusXfer owned by the caller, (nothing is copied),
+	queued with i2cBusSubmit(..).  The queue runs from the completion
+	callbacks, each completion starts the next transfer on that bus, so
+	the two buses run side by side without the main loop.
+
+	A transfer that fails with NACK, (AT24C in tWR), arbitration lost or
+	bus error is started again as i2cRetry.h sets out, (ack polling with
+	the transfer itself, as the background fill does).  A retry with a
+	backoff is started from i2cBusOnTick(), (SysTick), or i2cBusService(),
+	whichever runs first once it is due, so ~1ms late at worst.  Transfers
+	of I2CBUS_DMA_MIN_BYTES or more use DMA when the handle has DMA linked,
+	(HAL_I2C_MspInit).
+
+	Other users of a bus, (sEEProm functions, fill, scan, slave), share the
+	handle: whichever starts first has it, and a queue that found its
+	handle busy is started again from i2cBusService(), (main loop).
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/23/2018
+
+*/
+
+#ifndef I2CBUS_H_
+#define I2CBUS_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Transfers waiting per bus, power of 2.
+#define I2CBUS_QUEUE_DEPTH		8
+
+/// Shorter transfers use interrupts only, a 1 byte DMA read needs special NACK handling on the F1.
+#define I2CBUS_DMA_MIN_BYTES	2
+
+/// Longest a transfer may wait for its handle, (first start or a retry), before it fails.
+#define I2CBUS_XFER_TIMEOUT_MS	30
+
+/// errorCode while queued or running.
+#define I2CBUS_XFER_PENDING		0xFFFFFFFF
+
+typedef enum eI2CBus
+			{ I2CBUS_EE, I2CBUS_AUX, I2CBUS_COUNT }
+			enumI2CBus;
+
+typedef struct i2cBusXferStruct i2cBusXfer;
+
+/// Called from PendSV, (pendWork.h), after a transfer ends and the next has started, it may queue more.
+typedef void (*i2cBusDoneHandler)(i2cBusXfer *pXfer);
+
+struct i2cBusXferStruct {
+	uint8_t				devAddr7Bit;
+	bool				isRead;
+	uint16_t			memAddSize;			// I2C_MEMADD_SIZE_8BIT / _16BIT, 0 for a plain master transfer.
+	uint16_t			memAddress;
+	uint8_t				*pData;
+	uint16_t			size;
+	i2cBusDoneHandler	done;				// NULL to poll errorCode.
+	void				*pContext;			// For the done handler.
+
+	__IO uint32_t		errorCode;			// HAL_I2C_ERROR_xxx once ended, I2CBUS_XFER_PENDING before.
+};
+
+typedef struct {
+	I2C_HandleTypeDef	*hi2c;
+	i2cBusXfer			*queue[I2CBUS_QUEUE_DEPTH];
+	__IO uint32_t		head;				// Next to run, (running while active).
+	__IO uint32_t		tail;				// Next free.
+	__IO bool			active;				// Head transfer started.
+	__IO bool			headTried;			// firstTryTick set for the head transfer.
+	__IO uint32_t		firstTryTick;
+	__IO uint32_t		startCycles;		// DWT cycles when the head transfer started.
+	__IO uint32_t		headRetries;		// Times the head transfer has been started again.
+	__IO bool			retryWaiting;		// Head failed, start again at retryAtCycles.
+	__IO uint32_t		retryAtCycles;
+	__IO uint32_t		retryTick;			// When retryWaiting was set.
+
+	__IO uint32_t		xfers;				// Ended, ok or not.
+	__IO uint32_t		errors;
+	__IO uint32_t		retries;			// Failed and started again.
+	__IO uint32_t		dmaXfers;
+	__IO uint32_t		bytes;				// Moved by transfers that ended ok.
+	__IO uint32_t		busyCycles;			// Start to end, summed over transfers.
+	__IO uint32_t		maxQueued;
+} i2cBusStateStruct;
+
+extern i2cBusStateStruct i2cBusState[I2CBUS_COUNT];
+
+void	 i2cBusInit(void);
+enumI2CBus i2cBusOfHandle(I2C_HandleTypeDef *hi2c);
+bool	 i2cBusSubmit(enumI2CBus bus, i2cBusXfer *pXfer);
+bool	 i2cBusIdle(enumI2CBus bus);
+bool	 i2cBusXferDone(const i2cBusXfer *pXfer);
+uint32_t i2cBusEvents(I2C_HandleTypeDef *hi2c);
+void	 i2cBusService(void);
+void	 i2cBusOnTick(void);
+
+// Called from the HAL I2C callbacks in i2c_jmk.c, true if the event belonged to a queued transfer.
+bool i2cBusOnCplt(I2C_HandleTypeDef *hi2c);
+bool i2cBusOnError(I2C_HandleTypeDef *hi2c);
+
+#endif /* I2CBUS_H_ */
@@ -0,0 +1,104 @@
+/**
+  @file i2cRegMap.h
+  @brief Contains declarations/defines for i2cRegMap.c, table driven access to I2C register devices.
+<pre>
+	A device is described once, as a table of its registers, (address,
+	width, access), rather than with a hand written wrapper per register
+	like those in i2c_jmk.c:
+
+		static const i2cRegDef sensorRegs[] = {
+			{ 0x00, 1, I2CREG_R },						// ID
+			{ 0x01, 1, I2CREG_RW },						// CONFIG
+			{ 0x02, 2, I2CREG_R | I2CREG_VOLATILE },	// TEMP
+			{ 0x04, 2, I2CREG_R | I2CREG_VOLATILE },	// HUMIDITY
+		};
+		I2CREG_MAP(sensor, I2CBUS_EE, 0x48, I2C_MEMADD_SIZE_8BIT, true, sensorRegs);
+
+	Every register has a RAM shadow, its last value read or written:
+
+	@li A read of a register that is not I2CREG_VOLATILE, (ID, config), is
+		served from the shadow once it is known, no bus traffic.
+	@li A write of the value already in the shadow is skipped, unless the
+		register is I2CREG_VOLATILE, (command, write 1 to clear).
+	@li i2cRegSnapshot(..) reads a range of registers from the device in
+		as few transactions as possible: registers that follow on in
+		address, (the device auto increments), are one burst, so the
+		TEMP / HUMIDITY pair above is one read of 4 bytes.
+	@li i2cRegWriteMany(..) writes the changed ones, changed registers
+		that follow on in address are one burst.
+
+		Three 2..4 byte registers at 400 KHz, (hostBench):
+			one i2cRegRead each			3 transactions, 0.42ms on the bus
+			i2cRegSnapshot				1 transaction,	0.26ms
+
+	Transfers go through the bus queue, (i2cBus.c), and are waited on, so
+	these are for the main loop, as the sEEProm functions are.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/28/2018
+
+*/
+
+#ifndef I2CREGMAP_H_
+#define I2CREGMAP_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "i2cBus.h"
+
+/// Register access, i2cRegDef.access bits.
+#define I2CREG_R				0x01
+#define I2CREG_W				0x02
+#define I2CREG_RW				(I2CREG_R | I2CREG_W)
+#define I2CREG_VOLATILE			0x04		// Changes by itself or acts on write, the shadow is never trusted.
+
+/// Widest register, (value is a uint32_t).
+#define I2CREG_MAX_WIDTH		4
+
+/// Longest burst, bytes.
+#define I2CREG_MAX_BURST		32
+
+/// i2cRegFind(..) did not find the address.
+#define I2CREG_NONE				0xFFFF
+
+#define I2CREG_VALID_WORDS(regCount)	(((regCount) + 31) / 32)
+
+typedef struct {
+	uint16_t	address;				// In the device.
+	uint8_t		width;					// Bytes, 1..I2CREG_MAX_WIDTH.
+	uint8_t		access;					// I2CREG_xxx bits.
+} i2cRegDef;
+
+typedef struct {
+	enumI2CBus			bus;
+	uint8_t				devAddr7Bit;
+	uint16_t			memAddSize;		// I2C_MEMADD_SIZE_8BIT / _16BIT.
+	bool				msbFirst;		// Byte order of registers wider than 1 byte.
+	const i2cRegDef		*pRegs;			// Ascending address.
+	uint16_t			regCount;
+	uint32_t			*pShadow;		// Value per register.
+	uint32_t			*pValid;		// Bit per register, shadow known.
+
+	uint32_t			transactions;	// On the bus, since i2cRegMapInit(..)
+	uint32_t			shadowReads;	// Served without one.
+	uint32_t			skippedWrites;	// Value unchanged.
+	uint32_t			errors;
+} i2cRegMap;
+
+/// Define an i2cRegMap called name, with its shadow, for a const i2cRegDef table.
+#define I2CREG_MAP(name, onBus, addr7Bit, addSize, wideMsbFirst, regs)										\
+	static uint32_t name##Shadow[sizeof(regs) / sizeof((regs)[0])];											\
+	static uint32_t name##Valid[I2CREG_VALID_WORDS(sizeof(regs) / sizeof((regs)[0]))];						\
+	i2cRegMap name = { .bus = (onBus), .devAddr7Bit = (addr7Bit), .memAddSize = (addSize),					\
+					   .msbFirst = (wideMsbFirst), .pRegs = (regs), .regCount = sizeof(regs) / sizeof((regs)[0]),	\
+					   .pShadow = name##Shadow, .pValid = name##Valid }
+
+bool			  i2cRegMapInit(i2cRegMap *pMap);
+uint16_t		  i2cRegFind(const i2cRegMap *pMap, uint16_t address);
+HAL_StatusTypeDef i2cRegRead(i2cRegMap *pMap, uint16_t reg, uint32_t *pValue);
+HAL_StatusTypeDef i2cRegWrite(i2cRegMap *pMap, uint16_t reg, uint32_t value);
+HAL_StatusTypeDef i2cRegSnapshot(i2cRegMap *pMap, uint16_t firstReg, uint16_t count, uint32_t *pValues);
+HAL_StatusTypeDef i2cRegWriteMany(i2cRegMap *pMap, uint16_t firstReg, uint16_t count, const uint32_t *pValues);
+
+#endif /* I2CREGMAP_H_ */
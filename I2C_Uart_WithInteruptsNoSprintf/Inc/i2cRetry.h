@@ -0,0 +1,84 @@
+/**
+  @file i2cRetry.h
+  @brief Contains declarations/defines for i2cRetry.c, retry policy for failed I2C transfers.
+<pre>
+	A non blocking transfer that ends in HAL_I2C_ErrorCallback is started
+	again, or given up on, by the class of its error:
+
+		NACK	AF, device busy in its internal write cycle tWR, (or absent).
+		ARLO	Arbitration lost to another master.
+		BERR	Misplaced START / STOP, (noise on the bus).
+
+	Anything else, (OVR, DMA, TIMEOUT), is not retried, nor is an error with
+	one of those bits set along with a retried one.
+
+	Each class has a policy: retry k, (0 first), waits
+
+		min(backoffUs << k, maxBackoffUs)
+
+	before the transfer is started again, up to maxRetries times, so a
+	transient fault costs a bounded delay and a persistent one still
+	fails.  Defaults below, changed at run time with C[0x20] / C[0x21].
+
+	A backoff is a least, the bus queues start a retry from SysTick or
+	the main loop, so it may run up to 1ms later.  NACK has one all the
+	same: a retry started at once runs in the I2C error interrupt, and an
+	absent or busy part would keep the CPU there for every NACK, (SysTick,
+	the ADC and PendSV held off).  A page write behind another loses up to
+	1ms of the first one's tWR instead.
+
+	Used by the bus queues, (i2cBus.c), and by sEEPromWaitForIdle(..) for
+	transfers started by the sEEProm functions.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/26/2018
+
+*/
+
+#ifndef I2CRETRY_H_
+#define I2CRETRY_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// NACK: ack polling, a part in tWR is seen ready at the first retry after it, 100us doubling to
+/// 500us, (1ms apart from a bus queue), 40 of those are more than tWR max of any part.
+#define I2CRETRY_NACK_RETRIES		40
+#define I2CRETRY_NACK_BACKOFF_US	100
+#define I2CRETRY_NACK_MAX_US		500
+
+/// Arbitration lost: the other master's transfer is short, start again soon.
+#define I2CRETRY_ARLO_RETRIES		4
+#define I2CRETRY_ARLO_BACKOFF_US	50
+#define I2CRETRY_ARLO_MAX_US		400
+
+/// Bus error: a glitch, more than a few in a row is a wiring fault, not worth retrying.
+#define I2CRETRY_BERR_RETRIES		3
+#define I2CRETRY_BERR_BACKOFF_US	100
+#define I2CRETRY_BERR_MAX_US		400
+
+typedef enum eI2CRetryClass
+			{ I2CRETRY_NACK, I2CRETRY_ARLO, I2CRETRY_BERR, I2CRETRY_CLASSES }
+			enumI2CRetryClass;
+
+typedef struct {
+	uint16_t	maxRetries;					// After the first try, 0 fails at once.
+	uint16_t	backoffUs;					// Before the first retry, 0 starts it again at once.
+	uint16_t	maxBackoffUs;				// Backoff doubles per retry up to this.
+} i2cRetryPolicyStruct;
+
+typedef struct {
+	__IO uint32_t	retries[I2CRETRY_CLASSES];		// Transfers started again.
+	__IO uint32_t	giveUps[I2CRETRY_CLASSES];		// Failed with every retry used.
+	__IO uint32_t	notRetried;						// Failed with an error no policy covers.
+} i2cRetryStateStruct;
+
+extern i2cRetryPolicyStruct i2cRetryPolicy[I2CRETRY_CLASSES];
+extern i2cRetryStateStruct	i2cRetryState;
+
+void			  i2cRetryInit(void);
+enumI2CRetryClass i2cRetryClassOf(uint32_t errorCode);
+bool			  i2cRetryNext(uint32_t errorCode, uint32_t retries, uint32_t *pBackoffUs);
+
+#endif /* I2CRETRY_H_ */
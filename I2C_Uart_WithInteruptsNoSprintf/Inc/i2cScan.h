@@ -0,0 +1,89 @@
+/**
+  @file i2cScan.h
+  @brief Contains declarations/defines for i2cScan.c, I2C bus scan and AT24C capacity detect.
+<pre>
+	Finds what answers on a bus rather than relying on the hard coded
+	addresses, (PIC 0x08, AT24C 0x50..0x53).
+
+	Each address is probed with the smallest possible transaction:
+	START, address + W, STOP, no data.  An ACK ends in the master transmit
+	complete callback, a NACK in the error callback with AF, and either
+	one starts the probe of the next address, so the whole scan runs from
+	the I2C interrupts, about 11 bit times per address:
+
+		100 KHz		112 addresses, ~13ms.
+		400 KHz		112 addresses, ~4ms.
+
+	Results are a bitmap of the addresses that acknowledged, and for every
+	address probed the DWT cycles from start to its completion callback,
+	(ACK or NACK).
+
+	i2cScanDetectAT24C(..) then finds the size of an AT24Cxx that answered,
+	from where its memory address wraps, see i2cScan.c.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/21/2018
+
+*/
+
+#ifndef I2CSCAN_H_
+#define I2CSCAN_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+
+/// Default range, 0x00..0x07 and 0x78..0x7F are reserved addresses, (general call, 10 bit, ...).
+#define I2CSCAN_FIRST_ADDR		0x08
+#define I2CSCAN_LAST_ADDR		0x77
+
+/// 7 bit address space.
+#define I2CSCAN_ADDRESSES		128
+
+/// AT24Cxx address range, A0..A2 pins, (the 4 enumAT24C_7BitAddr ones plus A2 on the smaller parts).
+#define I2CSCAN_AT24C_FIRST		0x50
+#define I2CSCAN_AT24C_LAST		0x57
+
+/// Bytes compared at 0 and at each candidate size before a marker byte is tried.
+#define I2CSCAN_DETECT_BYTES	16
+
+/// Longest a whole scan may take, 128 addresses at 100 KHz is ~15ms.
+#define I2CSCAN_TIMEOUT_MS		50
+
+typedef enum eI2CScanState
+			{ I2CSCAN_IDLE, I2CSCAN_RUNNING, I2CSCAN_DONE, I2CSCAN_FAILED }
+			enumI2CScanState;
+
+typedef struct {
+	I2C_HandleTypeDef		*hi2c;
+	uint8_t					firstAddr;
+	uint8_t					lastAddr;
+
+	__IO enumI2CScanState	state;
+	__IO uint8_t			addr;						// Being probed.
+	__IO uint32_t			probeCycles;				// DWT cycles when its probe was started.
+
+	__IO uint32_t			found[I2CSCAN_ADDRESSES / 32];	// Bit per 7 bit address that acknowledged.
+	__IO uint16_t			foundCount;
+	uint16_t				latencyCycles[I2CSCAN_ADDRESSES];	// Probe start to completion, 0xFFFF max, 0 not probed.
+	uint32_t				at24cBytes[I2CSCAN_AT24C_LAST - I2CSCAN_AT24C_FIRST + 1];	// Detected size, 0 unknown.
+	__IO uint32_t			errorCode;					// HAL I2C error code that stopped a failed scan.
+
+	uint32_t				startCycles;
+	__IO uint32_t			endCycles;
+} i2cScanStateStruct;
+
+extern i2cScanStateStruct i2cScanState;
+
+bool	 i2cScanStart(I2C_HandleTypeDef *hi2c, uint8_t firstAddr, uint8_t lastAddr);
+bool	 i2cScanBusy(void);
+bool	 i2cScanFound(uint8_t addr7Bit);
+uint16_t i2cScanRun(I2C_HandleTypeDef *hi2c, uint8_t firstAddr, uint8_t lastAddr, bool detectAT24C);
+uint32_t i2cScanDetectAT24C(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit);
+
+// Called from the HAL I2C callbacks in i2c_jmk.c, true if the event belonged to the scan.
+bool i2cScanOnTxCplt(I2C_HandleTypeDef *hi2c);
+bool i2cScanOnError(I2C_HandleTypeDef *hi2c);
+
+#endif /* I2CSCAN_H_ */
@@ -0,0 +1,94 @@
+/**
+  @file i2cSlaveEE.h
+  @brief Contains declarations/defines for i2cSlaveEE.c, STM32 as an I2C slave "EEPROM simulator".
+<pre>
+	Runs the same slave protocol as the PicMPLabExpress_16F15376 demo board,
+	(see the note in i2c_jmk.c), so the STM32 can stand in for the PIC on a
+	test rig:
+
+	@li Master write: first byte is the 1 byte memory address, any further
+		bytes are written from there.
+	@li Master read: bytes from the current address.
+	@li Every byte read or written moves the address on by 1, and past the
+		end of the region it continues from 0.
+
+	The region is RAM, optionally a cache of an AT24Cxx range: loaded from
+	it at start, and bytes written by the master are written back to it
+	in 8 byte blocks once the master has been quiet for I2CSLAVEEE_FLUSH_QUIET_MS,
+	(i2cSlaveEEService(), main loop).
+
+	Every byte is handled from the HAL slave callbacks, one byte armed at
+	a time straight from the region, so SCL is only stretched for the
+	interrupt entry plus a few stores, well under one byte time.  The
+	longest callback is kept, (DWT cycles), see S[0x14].
+
+	While the slave is listening on a bus, master transfers on that bus
+	(sEEProm functions) return HAL_BUSY.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/19/2018
+
+*/
+
+#ifndef I2CSLAVEEE_H_
+#define I2CSLAVEEE_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+
+/// PIC demo board defaults, (address 0x08, 128 bytes).
+#define I2CSLAVEEE_DEFAULT_ADDR		0x08
+#define I2CSLAVEEE_DEFAULT_SIZE		PICEE_CAPACITY
+
+/// 1 byte memory address.
+#define I2CSLAVEEE_MAX_SIZE			256
+
+/// AT24C write back granularity, divides every AT24C page size, and backing address must be aligned to it.
+#define I2CSLAVEEE_BLOCK_SIZE		8
+
+/// Master quiet time before written bytes are written back to the AT24C.
+#define I2CSLAVEEE_FLUSH_QUIET_MS	50
+
+typedef struct {
+	I2C_HandleTypeDef	*hi2c;				// Bus the slave listens on.
+	uint8_t				ownAddr7Bit;
+	uint8_t				*pMem;				// Region, size bytes.
+	uint16_t			size;
+	bool				listening;
+
+	__IO uint16_t		address;			// Current address.
+	__IO uint32_t		writes;				// Master write transactions.
+	__IO uint32_t		reads;				// Master read transactions.
+	__IO uint32_t		bytesRx;			// Data bytes written by the master, (not the address bytes).
+	__IO uint32_t		bytesTx;			// Data bytes read by the master.
+	__IO uint32_t		errors;				// Bus errors other than the NACK ending a read.
+	__IO uint32_t		maxIsrCycles;		// Longest slave callback, DWT cycles.
+	__IO uint32_t		lastStopTick;		// HAL tick at end of last transaction.
+
+	I2C_HandleTypeDef	*hi2cEE;			// AT24C backing, NULL for RAM only.
+	enumAT24C_7BitAddr	eeAddr7Bit;
+	uint16_t			eeAddress;
+	__IO uint32_t		dirtyBlocks;		// Bit per I2CSLAVEEE_BLOCK_SIZE block, written by the master.
+	uint32_t			blocksFlushed;
+	uint32_t			flushErrors;
+} i2cSlaveEEStateStruct;
+
+extern i2cSlaveEEStateStruct i2cSlaveEEState;
+extern uint8_t i2cSlaveEEMem[I2CSLAVEEE_MAX_SIZE];
+
+bool	 i2cSlaveEEStart(I2C_HandleTypeDef *hi2c, uint8_t ownAddr7Bit, uint8_t *pMem, uint16_t size);
+bool	 i2cSlaveEELoad(I2C_HandleTypeDef *hi2cEE, enumAT24C_7BitAddr eeAddr7Bit, uint16_t eeAddress);
+void	 i2cSlaveEEStop(void);
+uint32_t i2cSlaveEEFlush(void);
+void	 i2cSlaveEEService(void);
+
+// Called from the HAL I2C callbacks in i2c_jmk.c, true if the event belonged to the slave.
+bool i2cSlaveEEOnAddr(I2C_HandleTypeDef *hi2c, uint8_t transferDirection);
+bool i2cSlaveEEOnRxCplt(I2C_HandleTypeDef *hi2c);
+bool i2cSlaveEEOnTxCplt(I2C_HandleTypeDef *hi2c);
+bool i2cSlaveEEOnListenCplt(I2C_HandleTypeDef *hi2c);
+bool i2cSlaveEEOnError(I2C_HandleTypeDef *hi2c);
+
+#endif /* I2CSLAVEEE_H_ */
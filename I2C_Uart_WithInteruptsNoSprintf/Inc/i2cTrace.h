@@ -0,0 +1,141 @@
+/**
+  @file i2cTrace.h
+  @brief Contains declarations/defines for i2cTrace.c, always on trace of I2C transactions.
+<pre>
+	Every transaction started through the driver, (sEEProm functions, PIC
+	accessors, background fill, ack polling), is recorded in a RAM ring of
+	the last I2CTRACE_RECORDS transactions:
+
+		startCycles		DWT cycle counter when started.
+		endCycles		DWT cycle counter at completion callback.
+		memAddress		Memory address in the device.
+		length			Bytes.
+		devAddr7Bit		7 bit device address.
+		kind			enumI2CTraceKind, I2CTRACE_BUS1 added for I2C1.
+		result			HAL_I2C_ERROR_xxx bits, I2CTRACE_RUNNING until done.
+		ackPolls		Attempts NACKed before this one went through, (255 max).
+
+	A record is 16 bytes, kept little endian as is, so the binary dump is
+	just the ring.  Cost per transaction is a few register reads and stores.
+
+	Each device, (bus and address), also gets counters that outlive the
+	ring, for the first I2CTRACE_DEVICES seen: attempts, NACK / ARLO / BERR
+	/ other errors, retries, and a histogram of how long its successful
+	transactions took, (first try to completion, so tWR waits show up).
+
+	Usage around a transfer:
+
+		i2cTraceBegin(..)				- before starting it.
+		i2cTraceDone(hi2c, status)		- blocking transfer returned, or a non
+										  blocking start failed.
+		i2cTraceEnd(hi2c, ErrorCode)	- non blocking transfer ended, (HAL I2C
+										  callbacks in i2c_jmk.c).
+		i2cTraceRetry(hi2c)				- failed transfer started again, a NACKed
+										  one reopens its record, (ack poll with
+										  the transfer itself), others get a new
+										  record like the last.
+
+	The DWT counter runs at SystemCoreClock, (24MHz, wraps every 179s),
+	durations are endCycles - startCycles in unsigned 32 bit.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/17/2018
+
+*/
+
+#ifndef I2CTRACE_H_
+#define I2CTRACE_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Records kept, power of 2.
+#define I2CTRACE_RECORDS		32
+
+/// result while the transaction is still running.
+#define I2CTRACE_RUNNING		0xFF
+
+/// Added to kind for transactions on I2C1, (I2C2 is the eeprom bus).
+#define I2CTRACE_BUS1			0x80
+
+/// Devices with their own counters, first seen first served.
+#define I2CTRACE_DEVICES		8
+
+/// Latency histogram, bucket 0 is below I2CTRACE_HIST_FIRST_US, each next one twice as wide, the last is the rest.
+#define I2CTRACE_HIST_BUCKETS	8
+#define I2CTRACE_HIST_FIRST_US	128
+
+/// Binary dump frame: header then count records, all little endian.
+#define I2CTRACE_DUMP_MAGIC		0x54433249		// "I2CT"
+#define I2CTRACE_DUMP_VERSION	1
+
+typedef enum eI2CTraceKind
+			{ I2CTRACE_MEM_WRITE, I2CTRACE_MEM_READ, I2CTRACE_WRITE, I2CTRACE_READ, I2CTRACE_ACK_POLL }
+			enumI2CTraceKind;
+
+typedef struct {
+	uint32_t startCycles;
+	uint32_t endCycles;
+	uint16_t memAddress;
+	uint16_t length;
+	uint8_t	 devAddr7Bit;
+	uint8_t	 kind;
+	uint8_t	 result;
+	uint8_t	 ackPolls;
+} i2cTraceRecord;
+
+typedef struct {
+	uint32_t magic;
+	uint8_t	 version;
+	uint8_t	 recordSize;
+	uint16_t count;
+	uint32_t cyclesPerSecond;
+	uint32_t nowCycles;					// DWT counter when dumped, to place records in time.
+} i2cTraceDumpHeader;
+
+typedef struct {
+	uint32_t transactions;				// Recorded since boot, (or clear).
+	uint32_t errors;					// Of which ended with an I2C error.
+	uint32_t maxCycles;					// Longest completed transaction.
+	uint16_t maxMemAddress;				// And where it went.
+	uint8_t	 maxDevAddr7Bit;
+	uint8_t	 maxKind;
+} i2cTraceStateStruct;
+
+typedef struct {
+	uint8_t	 devAddr7Bit;					// 0 for an unused entry.
+	uint8_t	 bus;							// 0 I2C2, 1 I2C1.
+	uint16_t hist[I2CTRACE_HIST_BUCKETS];	// Successful transactions by duration, (saturates).
+	uint32_t attempts;						// Ended, ok or not, each retry counts.
+	uint32_t nacks;
+	uint32_t arlo;
+	uint32_t berr;
+	uint32_t otherErrors;					// OVR, TIMEOUT, DMA.
+	uint32_t retries;						// Started again after an error.
+} i2cTraceDeviceStruct;
+
+/// Called for each record by i2cTraceQuery(..), oldest first, seq counts from boot.
+typedef void (*i2cTraceRecordHandler)(uint32_t seq, const i2cTraceRecord *pRecord);
+
+extern i2cTraceStateStruct  i2cTraceState;
+extern i2cTraceDeviceStruct i2cTraceDevices[I2CTRACE_DEVICES];
+
+void	 i2cTraceInit(void);
+void	 i2cTraceClear(void);
+uint32_t i2cTraceNow(void);
+uint32_t i2cTraceCyclesToUs(uint32_t cycles);
+
+void	 i2cTraceBegin(I2C_HandleTypeDef *hi2c, enumI2CTraceKind kind, uint16_t HAL_DevAddr, uint16_t memAddress,
+					   uint16_t length);
+void	 i2cTraceRetry(I2C_HandleTypeDef *hi2c);
+void	 i2cTraceEnd(I2C_HandleTypeDef *hi2c, uint32_t errorCode);
+void	 i2cTraceDone(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef status);
+void	 i2cTraceAckPolls(I2C_HandleTypeDef *hi2c, uint32_t polls);
+
+uint32_t i2cTraceHistLimitUs(uint32_t bucket);
+uint16_t i2cTraceQuery(i2cTraceRecordHandler handler, uint16_t maxRecords);
+uint16_t i2cTraceCount(void);
+void	 i2cTraceHeader(i2cTraceDumpHeader *pHeader);
+
+#endif /* I2CTRACE_H_ */
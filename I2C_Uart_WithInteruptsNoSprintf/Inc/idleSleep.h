@@ -0,0 +1,73 @@
+/**
+  @file idleSleep.h
+  @brief Contains declarations/defines for idleSleep.c, tickless idle for the main loop.
+<pre>
+	mainEventWait(..) sleeps, (WFI), when no event is pending, but SysTick
+	still woke the core every ms, (1000 wakeups a second doing nothing
+	but HAL_IncTick()).  idleSleepEnter(..), in place of the WFI, stops
+	that: the next timer deadline is the earliest task due time,
+	(taskSchedState.nextDueMs), so SysTick is reloaded to count right to
+	it, up to its 24 bit limit, (~699 ms at 24 MHz, ~2 s at 8 MHz), and
+	the core sleeps until it, or any other interrupt, comes:
+
+		counted out		the SysTick interrupt is pending, it counts the
+						last ms and posts MAINEVT_TICK as always
+		woke early		UART byte, I2C or DMA done, EXTI0 button, ADC block
+
+	Either way the ms slept are added to HAL_GetTick() from SysTick's count
+	before interrupts are back on, so every handler sees the right time,
+	and SysTick is restarted in phase, (the next ms ends when it would
+	have).  Interrupts other than SysTick are untouched, they wake the core
+	exactly as before, a command line is not answered any later.
+
+	The tick is kept, (plain WFI), when:
+		the next task is due in less than IDLESLEEP_MIN_MS
+		an I2C retry is waiting out its backoff, (i2cBusOnTick(..) each ms)
+		tickless is off, C[0x2C]=0
+
+	Sleep, not stop: on the F100 USART1 and the I2Cs are not clocked in
+	stop mode, the byte that would wake it on its start bit is lost, TIM3
+	and the ADC stop, and without the RTC there is nothing to time the
+	wake up for the next task.  In sleep only the core clock stops.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/07/2018
+
+*/
+
+#ifndef IDLESLEEP_H_
+#define IDLESLEEP_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Shortest sleep SysTick is stopped for, less sleeps with the tick on.
+#define IDLESLEEP_MIN_MS			2
+
+typedef struct {
+	bool		enabled;			// Tickless, else plain WFI.
+	uint32_t	tickless;			// Sleeps with SysTick stretched.
+	uint32_t	tickKept;			// Sleeps with the tick on, (too soon, retry, off).
+	uint32_t	early;				// Tickless sleeps ended by another interrupt.
+	uint32_t	ticksSkipped;		// SysTick interrupts not taken.
+	uint32_t	maxSleepMs;
+	uint64_t	sleptUs;			// Tickless sleeps, total.
+	uint32_t	sinceTick;			// HAL_GetTick() when the stats started.
+} idleSleepStateStruct;
+
+/// The HAL tick and SysTick restart after a tickless sleep, idleSleepAccount(..)
+typedef struct {
+	uint32_t	ticks;				// ms ended asleep, added to HAL_GetTick(), (not the one SysTick_Handler(..) counts).
+	uint32_t	nextCycles;			// To the end of the ms in progress, SysTick's first reload after.
+	uint32_t	sleptCycles;
+} idleSleepAccountStruct;
+
+extern idleSleepStateStruct idleSleepState;
+
+void idleSleepInit(bool enabled);
+void idleSleepEnter(void);
+void idleSleepAccount(uint32_t msCycles, uint32_t ms, uint32_t val, uint32_t valNow, bool countedOut,
+					  idleSleepAccountStruct *pAccount);
+
+#endif /* IDLESLEEP_H_ */
@@ -0,0 +1,83 @@
+/**
+  @file irqPriority.h
+  @brief Contains declarations/defines for irqPriority.c, NVIC priority tiers and ISR run time / latency stats.
+<pre>
+	Every interrupt used to be at priority 0, none could preempt another,
+	so a UART byte could wait out a whole I2C event handler, (or DMA, ADC,
+	SysTick), and be overrun.  The tiers, (NVIC_PRIORITYGROUP_4, 0..15
+	preempt priority, 0 highest), are set here and only here:
+
+		IRQPRIO_UART		USART1, a byte every 10.85us at 921600 baud.
+		IRQPRIO_I2C			I2C1 / I2C2 event and error, their DMA channels 4..7.
+		IRQPRIO_ADC			ADC1 analog watchdog, sampler DMA channel 1, EXTI0 button.
+		IRQPRIO_SYSTICK		SysTick, (HAL tick, I2C retry backoff, task due times).
+		IRQPRIO_DEFERRED	PendSV, work deferred from all of the above, (pendWork.h).
+
+	irqPriorityApply(..) sets them, after the MX_xxx_Init()'s and after any
+	HAL_RCC_ClockConfig(..), (HAL_InitTick(..) puts SysTick back to
+	TICK_INT_PRIORITY).  CubeMX keeps generating 0's, they are overridden.
+
+	Each handler in stm32f1xx_it.c is bracketed by IRQPRIO_ENTER(..) and
+	irqPriorityExit(..), DWT cycles, so per IRQ there is a count and the
+	longest run, (including anything that preempted it, so never low).
+	SysTick's entry latency is measured exactly, (SysTick->LOAD - VAL at
+	entry is cycles since it fired).  For the others the event time is
+	not known, their worst entry latency is bounded from the runs:
+
+		bound(irq) = longest run in its own tier, (it may have just started)
+				   + longest run of each higher tier IRQ, (once each)
+
+	S[0x1E] lists both, and the UART line compares USART1's bound plus its
+	own run against one byte time at the baud rate in use, next to the
+	overrun count, (uart_jmk.c), which is the proof.  Interrupts off,
+	(PRIMASK), in main loop and handler code is not counted, those are a
+	few stores each.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/05/2018
+
+*/
+
+#ifndef IRQPRIORITY_H_
+#define IRQPRIORITY_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Preempt priorities, 0 highest, 15 lowest.
+#define IRQPRIO_UART				0
+#define IRQPRIO_I2C					1
+#define IRQPRIO_ADC					2
+#define IRQPRIO_SYSTICK				3
+#define IRQPRIO_DEFERRED			15
+
+/// Instrumented handlers, stm32f1xx_it.c.
+typedef enum eIrqStat
+			{ IRQSTAT_USART1, IRQSTAT_I2C2_EV, IRQSTAT_I2C2_ER, IRQSTAT_I2C1_EV, IRQSTAT_I2C1_ER,
+			  IRQSTAT_DMA1_CH4, IRQSTAT_DMA1_CH5, IRQSTAT_DMA1_CH6, IRQSTAT_DMA1_CH7,
+			  IRQSTAT_DMA1_CH1, IRQSTAT_ADC1, IRQSTAT_EXTI0, IRQSTAT_SYSTICK, IRQSTAT_PENDSV,
+			  IRQSTAT_COUNT }
+			enumIrqStat;
+
+typedef struct {
+	uint32_t	entryCycles[IRQSTAT_COUNT];		// DWT at entry of the run in progress.
+	uint32_t	count[IRQSTAT_COUNT];
+	uint32_t	maxRunCycles[IRQSTAT_COUNT];
+	uint32_t	maxTickEntryCycles;				// SysTick fired to handler entry.
+} irqPriorityStateStruct;
+
+extern irqPriorityStateStruct irqPriorityState;
+
+/// First thing in a handler.
+#define IRQPRIO_ENTER(irq)			(irqPriorityState.entryCycles[(irq)] = DWT->CYCCNT)
+
+void	 irqPriorityApply(void);
+void	 irqPriorityExit(enumIrqStat irq);
+void	 irqPriorityTickEntry(void);
+uint8_t	 irqPriorityOf(enumIrqStat irq);
+const char *irqPriorityName(enumIrqStat irq);
+uint32_t irqPriorityBoundCycles(enumIrqStat irq);
+void	 irqPriorityClear(void);
+
+#endif /* IRQPRIORITY_H_ */
@@ -0,0 +1,61 @@
+/**
+  @file mainEvent.h
+  @brief Contains declarations/defines for mainEvent.c, interrupts wake the main loop with events.
+<pre>
+	The main loop used to go round every 100ms, (HAL_Delay(100)), and look
+	at everything, so a command line waited up to 100ms for cmdHandler(..).
+	Now it sleeps, (WFI), until an interrupt posts an event, and runs only
+	the work for the events posted:
+
+		UART RX, CR in		--> MAINEVT_COMMAND	--> cmdHandler(..)
+		ADC alarm queued	--> MAINEVT_ALARM	--> cmdAlarmService(..)
+		I2C queue xfer done	--> MAINEVT_I2C		--> i2cBusService(..)
+		EXTI0, blue button	--> MAINEVT_BUTTON	--> demo mode, LED4
+		SysTick, task due	--> MAINEVT_TICK	--> taskSchedRun(..), (taskSched.h)
+
+	The work itself is tasks, (taskSched.h), events make them ready.
+
+	An event is a bit in a word: posting one that is still pending only
+	counts it, (coalesced), the loop handles it once.  Every handler
+	drains all its work, (the whole alarm queue, every bus), so nothing
+	is lost, and the word can not overflow the way a FIFO of codes can.
+
+	Posted to handled latency is measured per event, (DWT cycles), S[0x1C]
+	shows it with the counts.  Other interrupts, (ADC DMA, I2C bytes),
+	still wake the core, the loop goes back to sleep if they posted
+	nothing.  SysTick does not wake it every ms, (idleSleep.h).
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/02/2018
+
+*/
+
+#ifndef MAINEVENT_H_
+#define MAINEVENT_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+typedef enum eMainEvent
+			{ MAINEVT_COMMAND, MAINEVT_ALARM, MAINEVT_I2C, MAINEVT_BUTTON, MAINEVT_TICK, MAINEVT_COUNT }
+			enumMainEvent;
+
+/// Bit of an event in what mainEventWait(..) returns.
+#define MAINEVT_BIT(event)			(1UL << (event))
+
+typedef struct {
+	__IO uint32_t	pending;						// MAINEVT_BIT per event posted, not yet taken.
+	__IO uint32_t	postCycles[MAINEVT_COUNT];		// DWT when it was first posted.
+	__IO uint32_t	posted[MAINEVT_COUNT];
+	__IO uint32_t	coalesced[MAINEVT_COUNT];		// Posted while still pending.
+	uint32_t		maxLatencyCycles[MAINEVT_COUNT];	// Posted to taken by mainEventWait(..)
+	uint32_t		sleeps;							// WFI's, (wakeups).
+} mainEventStateStruct;
+
+extern mainEventStateStruct mainEventState;
+
+void	 mainEventPost(enumMainEvent event);
+uint32_t mainEventWait(void);
+
+#endif /* MAINEVENT_H_ */
@@ -0,0 +1,67 @@
+/**
+  @file pendWork.h
+  @brief Contains declarations/defines for pendWork.c, interrupt work deferred to PendSV.
+<pre>
+	An interrupt handler does only what can not wait, (take the byte, note
+	the block, start the next transfer), and posts the rest as a work
+	item, a function and its argument:
+
+		UART RX, CR in		--> line to cmdBuffer, MAINEVT_COMMAND
+		ADC DMA half / full	--> adcFilterService(..)
+		I2C queue xfer done	--> the transfer's done handler
+
+	PendSV runs the items, oldest first.  It is set to the lowest priority
+	in HAL_MspInit(..), so the work waits for every other interrupt, and
+	interrupts never wait for the work: a UART byte can not be held off by
+	a filter block or a copy's next chunk being set up.
+
+	The queue is lock free, no interrupts off: a poster reserves a slot by
+	counting head up with LDREX / STREX, writes the argument, then the
+	function, which marks the slot full.  PendSV takes slots in order from
+	tail while they are full, a slot reserved but not yet written, (its
+	poster was interrupted), stops it, the poster pends PendSV again when
+	it is done.  Posting is ~20 cycles, more only if another post got in
+	between LDREX and STREX.
+
+	A full queue refuses the post, (overflows), the poster does the work
+	itself rather than lose it.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/04/2018
+
+*/
+
+#ifndef PENDWORK_H_
+#define PENDWORK_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Work items the queue holds, power of 2.
+#define PENDWORK_QUEUE				16
+
+typedef void (*pendWorkFunc)(void *pArg);
+
+typedef struct {
+	pendWorkFunc volatile	func;		// NULL until the poster has written the slot.
+	void					*pArg;
+} pendWorkItem;
+
+typedef struct {
+	pendWorkItem	items[PENDWORK_QUEUE];
+	__IO uint32_t	head;				// Slots reserved, counts up.
+	__IO uint32_t	tail;				// Slots run, counts up, PendSV only.
+	__IO uint32_t	posted;
+	__IO uint32_t	overflows;			// Posts refused, queue full.
+	uint32_t		ran;
+	uint32_t		maxDepth;			// Most waiting when PendSV ran.
+	uint32_t		maxRunCycles;		// Longest item, DWT cycles.
+} pendWorkStateStruct;
+
+extern pendWorkStateStruct pendWorkState;
+
+bool pendWorkPost(pendWorkFunc func, void *pArg);
+void pendWorkService(void);
+
+#endif /* PENDWORK_H_ */
@@ -0,0 +1,104 @@
+/**
+  @file picEEBatch.h
+  @brief Contains declarations/defines for picEEBatch.c, batched access to the PIC "EEPROM simulator".
+<pre>
+	RandomAccesPicEEReadBytes(..) / RandomAccesPicEEWriteBytes(..) cost a
+	transaction per call, and a register scan is many small calls.  A
+	batch takes the whole list of windows, (address, length), at once and
+	turns it into as few transactions as the PIC protocol allows, (see the
+	note in i2c_jmk.c):
+
+	@li Windows that overlap or touch are one span, every byte moves once.
+	@li Reads also bridge gaps of up to PICEE_BATCH_GAP_BYTES, reading a
+		few bytes nobody asked for is cheaper than a new START, device
+		address, memory address, repeated START and device address.
+	@li The address wraps from 127 to 0, so a span may run past the end,
+		windows at both ends of the region are one transaction.
+
+	Spans run one after the other through the bus queue, (i2cBus.c), each
+	started from the completion of the one before, so the batch needs no
+	main loop.  Read data is handed out to the windows when the last span
+	is in, written windows are merged in list order, a later one wins
+	where they overlap.
+
+		24 windows of 2..4 bytes, 1..3 byte gaps, at 100 KHz, (hostBench):
+			one transaction each	24 transactions, 13.8ms on the bus
+			batch					 1 transaction,	 11.0ms
+
+	Bus time gains less than the round trips, bridged gap bytes still take
+	their 9 bit times, the win is 1 START, wait and completion per batch
+	rather than per window.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/27/2018
+
+*/
+
+#ifndef PICEEBATCH_H_
+#define PICEEBATCH_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+#include "serialEEProm.h"
+#include "i2cBus.h"
+
+/// PIC demo board address, (i2c_jmk.c).
+#define PICEE_BATCH_ADDR			0x08
+
+/// Unwanted bytes a read span may take in to join two windows, each is 9 bit times, a new transaction ~30.
+#define PICEE_BATCH_GAP_BYTES		3
+
+/// Spans of the worst batch, (every other byte written).
+#define PICEE_BATCH_MAX_SPANS		(PICEE_CAPACITY / 2)
+
+/// Longest picEEBatchRun(..) waits, a full region at 100 KHz is ~12ms.
+#define PICEE_BATCH_TIMEOUT_MS		50
+
+typedef enum ePicEEBatchState
+			{ PICEE_BATCH_IDLE, PICEE_BATCH_RUNNING, PICEE_BATCH_DONE, PICEE_BATCH_FAILED }
+			enumPicEEBatchState;
+
+/// One window of a batch, must stay valid until the batch is done.
+typedef struct {
+	uint8_t		address;				// First byte, 0..PICEE_CAPACITY - 1.
+	uint8_t		length;					// 1..PICEE_CAPACITY, wraps past the end.
+	uint8_t		*pData;					// Read into, or written from.
+} picEEWindow;
+
+typedef struct {
+	uint8_t		start;
+	uint8_t		length;					// Up to PICEE_CAPACITY, wraps past the end.
+} picEESpan;
+
+typedef struct {
+	enumI2CBus					bus;
+	uint8_t						devAddr7Bit;
+	bool						isWrite;
+	const picEEWindow			*pWindows;
+	uint16_t					windowCount;
+	picEESpan					spans[PICEE_BATCH_MAX_SPANS];
+	uint16_t					spanCount;
+
+	__IO enumPicEEBatchState	state;
+	__IO uint16_t				spanNext;			// Next span to start.
+	__IO uint32_t				errorCode;			// HAL I2C error code that stopped a failed batch.
+	uint32_t					startCycles;
+	__IO uint32_t				endCycles;
+
+	uint32_t					batches;			// Since boot.
+	uint32_t					windows;			// Asked for.
+	uint32_t					transactions;		// Run for them.
+	uint32_t					bytes;				// Moved on the bus, (bridged gaps included).
+} picEEBatchStateStruct;
+
+extern picEEBatchStateStruct picEEBatchState;
+
+uint16_t picEEBatchPlan(const picEEWindow *pWindows, uint16_t windowCount, bool isWrite);
+bool	 picEEBatchStart(enumI2CBus bus, uint8_t devAddr7Bit, bool isWrite, const picEEWindow *pWindows,
+						 uint16_t windowCount);
+bool	 picEEBatchBusy(void);
+HAL_StatusTypeDef picEEBatchRun(enumI2CBus bus, uint8_t devAddr7Bit, bool isWrite, const picEEWindow *pWindows,
+								uint16_t windowCount);
+
+#endif /* PICEEBATCH_H_ */
@@ -1,16 +1,18 @@
-/**
- * @file serialCmdParser.h
- * @brief Contains declarations/defines for serialCmdParser.c
- *
- * @author Joe Kuss (JMK)
- * @date 2/16/2018
- */
-
-#ifndef SERIALCMDPARSER_H_
-#define SERIALCMDPARSER_H_
-
-//-------- Function Prototypes -------------------------
-
-void cmdHandler(char * cmdStr);
-
-#endif /* SERIALCMDPARSER_H_ */
+/**
+ * @file serialCmdParser.h
+ * @brief Contains declarations/defines for serialCmdParser.c
+ *
+ * @author Joe Kuss (JMK)
+ * @date 2/16/2018
+ */
+
+#ifndef SERIALCMDPARSER_H_
+#define SERIALCMDPARSER_H_
+
+//-------- Function Prototypes -------------------------
+
+void cmdHandler(char * cmdStr);
+void cmdStreamService(void);
+void cmdAlarmService(void);
+
+#endif /* SERIALCMDPARSER_H_ */
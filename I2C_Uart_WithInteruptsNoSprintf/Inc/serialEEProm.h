@@ -1,56 +1,225 @@
-/**
-  @file serialEEProm.h
-  @brief This file contains common defines and function prototypes for serialEEProm.c
-<pre>
-	Presently the target device is Atmel AT24C256.
-	Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
-
-</pre>
-
-   @author 	Joe Kuss (JMK)
-   @date 	03/01/2018
-
-*/
-
-
-#ifndef SERIALEEPROM_H_
-#define SERIALEEPROM_H_
-
-#include "stm32f1xx_hal.h"
-
-#define AT24C_PAGE_SIZE 64
-
-typedef enum eArrayFillType
-			{ FILL_0, FILL_FF, FILL_INDEX, FILL_REVERSE_INDEX }
-		    enumArrayFillType;
-
-typedef enum eAT24C_7BitAddr
-			{ A0A1_00 = 0x50, A0A1_01 = 0x51, A0A1_10 = 0x52, A0A1_11 = 0x53 }
-			enumAT24C_7BitAddr;
-
-// Typedefs:
-typedef struct {
-  uint8_t array[AT24C_PAGE_SIZE];
-  uint8_t bytesInPage;				// Can not initialize a typedef: Both  =  AT24C_PAGE_SIZE or = sizeof(pageByteArrayStruct.array) not allowed.
-} pageByteArrayStruct;
-
-// Global variables:
-extern uint8_t 					eePromByteRead;
-extern uint8_t 					eePromByteToBeWritten;
-extern pageByteArrayStruct 		eePromWritePageBytes;
-extern pageByteArrayStruct 		eePromReadPageBytes;
-
-//########
-extern pageByteArrayStruct bas1;
-extern pageByteArrayStruct bas2;
-
-void sEEPromPageBufferFill(pageByteArrayStruct* pByteArrayStruct, enumArrayFillType fillType );
-
-HAL_StatusTypeDef sEEPromByteWrite(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer);
-HAL_StatusTypeDef sEEPromBytesWrite(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint16_t bufferLength);
-HAL_StatusTypeDef sEEPromCurrentAddrReadByte(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint8_t *pByteRcvd);
-HAL_StatusTypeDef sEEPromCurrentAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bits, uint8_t *pBytesRcvd, uint16_t expectedByteCount);
-HAL_StatusTypeDef sEEPromRandomAddrByteRead(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer);
-HAL_StatusTypeDef sEEPromRandomAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint8_t bufferLength);
-
-#endif /* SERIALEEPROM_H_ */
+/**
+  @file serialEEProm.h
+  @brief This file contains common defines and function prototypes for serialEEProm.c
+<pre>
+	Presently the target device is Atmel AT24C256.
+	Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
+
+	Any AT24C32 .. AT24C512 can be used instead by building with
+	-DSEE_PART=AT24Cxxx, see "Device descriptors" below.
+
+	The sEEProm functions return once their transfer has started, the data
+	is only valid after sEEPromWaitForIdle(..).  The sEEPromOp functions
+	instead queue the transfer on the bus of hi2c, (i2cBus.c), and hand back
+	an sEEPromOp, a small handle that is polled, waited on, or has a done
+	handler called, with the final status:
+
+		HAL_BUSY		still queued or running.
+		HAL_OK			done, data read is valid / write accepted, (tWR
+						still to run, a following op waits it out).
+		HAL_ERROR		NACKed past I2CBUS_XFER_TIMEOUT_MS, or bus error,
+						(xfer.errorCode has the HAL I2C error).
+		HAL_TIMEOUT		never got the bus, or dropped by a bus recovery.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/01/2018
+
+*/
+
+
+#ifndef SERIALEEPROM_H_
+#define SERIALEEPROM_H_
+
+#include "stm32f1xx_hal.h"
+#include "i2cBus.h"
+
+/*
+ * Device descriptors.
+ *
+ * Each part is a set of constants named <part>_<field>, so everything
+ * derived from them below is an integer constant expression: page offset
+ * and page number are a mask and a shift, array sizes follow the part,
+ * and nothing is looked up at run time.
+ *
+ *	CAPACITY	- Bytes, power of 2.
+ *	PAGE_SHIFT	- log2 of page write size.
+ *	ADDR_BYTES	- Word address bytes sent after the device address.
+ *	TWR_MAX_MS	- Max internal write cycle time tWR, (0 for none).
+ *	MAX_BUS_HZ	- Fastest SCL, (at 5V).
+ */
+#define AT24C32_CAPACITY		4096
+#define AT24C32_PAGE_SHIFT		5
+#define AT24C32_ADDR_BYTES		2
+#define AT24C32_TWR_MAX_MS		10
+#define AT24C32_MAX_BUS_HZ		400000
+
+#define AT24C64_CAPACITY		8192
+#define AT24C64_PAGE_SHIFT		5
+#define AT24C64_ADDR_BYTES		2
+#define AT24C64_TWR_MAX_MS		10
+#define AT24C64_MAX_BUS_HZ		400000
+
+#define AT24C128_CAPACITY		16384
+#define AT24C128_PAGE_SHIFT		6
+#define AT24C128_ADDR_BYTES		2
+#define AT24C128_TWR_MAX_MS		10
+#define AT24C128_MAX_BUS_HZ		1000000
+
+#define AT24C256_CAPACITY		32768
+#define AT24C256_PAGE_SHIFT		6
+#define AT24C256_ADDR_BYTES		2
+#define AT24C256_TWR_MAX_MS		10
+#define AT24C256_MAX_BUS_HZ		1000000
+
+#define AT24C512_CAPACITY		65536
+#define AT24C512_PAGE_SHIFT		7
+#define AT24C512_ADDR_BYTES		2
+#define AT24C512_TWR_MAX_MS		5
+#define AT24C512_MAX_BUS_HZ		1000000
+
+/// PIC16F15376 demo board "EEPROM simulator", (i2c_jmk.c), writes wrap over the whole 128 bytes.
+#define PICEE_CAPACITY			128
+#define PICEE_PAGE_SHIFT		7
+#define PICEE_ADDR_BYTES		1
+#define PICEE_TWR_MAX_MS		0
+#define PICEE_MAX_BUS_HZ		100000
+
+#define SEE_PARAM_(part, field)				part##_##field
+#define SEE_PARAM(part, field)				SEE_PARAM_(part, field)
+
+#define SEE_PAGE_SIZE(part)					(1U << SEE_PARAM(part, PAGE_SHIFT))
+#define SEE_PAGE_OFFSET(part, addr)			((addr) & (SEE_PAGE_SIZE(part) - 1))
+#define SEE_PAGE_OF(part, addr)				((addr) >> SEE_PARAM(part, PAGE_SHIFT))
+#define SEE_BYTES_TO_PAGE_END(part, addr)	(SEE_PAGE_SIZE(part) - SEE_PAGE_OFFSET(part, addr))
+#define SEE_WRAP(part, addr)				((addr) & (SEE_PARAM(part, CAPACITY) - 1))
+#define SEE_MEMADD_SIZE(part)				((SEE_PARAM(part, ADDR_BYTES) == 1) ? I2C_MEMADD_SIZE_8BIT : I2C_MEMADD_SIZE_16BIT)
+
+/// Largest page of any part above, (size of const pattern pages etc.)
+#define SEE_MAX_PAGE_SIZE		128
+
+/// AT24Cxx part on the bus.
+#ifndef SEE_PART
+#define SEE_PART				AT24C256
+#endif
+
+#define AT24C_DEVICE_BYTES		SEE_PARAM(SEE_PART, CAPACITY)
+#define AT24C_PAGE_SHIFT		SEE_PARAM(SEE_PART, PAGE_SHIFT)
+#define AT24C_PAGE_SIZE			(1 << AT24C_PAGE_SHIFT)
+#define AT24C_PAGE_COUNT		(AT24C_DEVICE_BYTES >> AT24C_PAGE_SHIFT)
+#define AT24C_ADDR_BYTES		SEE_PARAM(SEE_PART, ADDR_BYTES)
+#define AT24C_MEMADD_SIZE		SEE_MEMADD_SIZE(SEE_PART)
+/// Max internal write cycle time tWR.
+#define AT24C_TWR_MAX_MS		SEE_PARAM(SEE_PART, TWR_MAX_MS)
+#define AT24C_MAX_BUS_HZ		SEE_PARAM(SEE_PART, MAX_BUS_HZ)
+
+#if (AT24C_PAGE_COUNT < 64) || (AT24C_PAGE_SIZE > SEE_MAX_PAGE_SIZE)
+#error "SEE_PART must be one of AT24C32 .. AT24C512"
+#endif
+
+/*
+ * Memory map of the AT24Cxx part, in pages, scales with SEE_PART:
+ *
+ *	0 .. SEE_MAP_CONFIG_FIRST - 1		Record log, (eePromLog.c).
+ *	SEE_MAP_CONFIG_FIRST ..				Configuration data, 1/32 of the part.
+ *	SEE_MAP_CRC_FIRST .. last page		Page CRC table, (eePromCrc.c), one 2 byte CRC per page.
+ *
+ *	For the AT24C256: log 0..479, configuration 480..495, CRC table 496..511.
+ */
+#define SEE_MAP_CRC_PAGES		(AT24C_PAGE_COUNT / (AT24C_PAGE_SIZE / 2))
+#define SEE_MAP_CRC_FIRST		(AT24C_PAGE_COUNT - SEE_MAP_CRC_PAGES)
+#define SEE_MAP_CONFIG_PAGES	(AT24C_PAGE_COUNT / 32)
+#define SEE_MAP_CONFIG_FIRST	(SEE_MAP_CRC_FIRST - SEE_MAP_CONFIG_PAGES)
+#define SEE_MAP_LOG_FIRST		0
+#define SEE_MAP_LOG_PAGES		SEE_MAP_CONFIG_FIRST
+
+/// Device address trials per ACKNOWLEDGE POLLING step, polling runs until tWR max has passed.
+#define AT24C_ACK_POLL_TRIALS	8
+
+/// Bus recovery, see sEE_I2C_PartReset(..)
+#define SEE_I2C_STUCK_MS		25		// Transfer moving no bytes this long is stuck, (255 byte read at 100 KHz is ~23ms).
+#define SEE_I2C_BUSY_FLAG_MS	2		// Handle ready but bus BUSY flag still set this long, a slave is holding the bus.
+#define SEE_I2C_RECOVER_CLOCKS	9		// SCL pulses, enough to finish any partial byte + ACK.
+#define SEE_I2C_RECOVER_HALF_US	5		// SCL half period while recovering, (100 KHz).
+
+typedef enum eArrayFillType
+			{ FILL_0, FILL_FF, FILL_INDEX, FILL_REVERSE_INDEX }
+		    enumArrayFillType;
+
+typedef enum eAT24C_7BitAddr
+			{ A0A1_00 = 0x50, A0A1_01 = 0x51, A0A1_10 = 0x52, A0A1_11 = 0x53 }
+			enumAT24C_7BitAddr;
+
+/// Transfers the sEEProm functions start, (kept so a stuck one can be replayed).
+typedef enum eSEEXferKind
+			{ SEE_XFER_MEM_WRITE, SEE_XFER_MEM_READ }
+			enumSEEXferKind;
+
+// Typedefs:
+typedef struct {
+	uint32_t stuckTransfers;		// Transfers that stopped moving bytes.
+	uint32_t busyFlagHeld;			// Starts held off by the bus BUSY flag.
+	uint32_t recoveries;			// sEE_I2C_PartReset(..) runs.
+	uint32_t recoverFailed;			// Of which SDA stayed low after all clocks.
+	uint32_t replays;				// Transactions started again after a recovery.
+	uint32_t lastRecoverClocks;		// SCL pulses the last recovery needed.
+} sEEBusRecoveryStruct;
+
+typedef struct {
+  uint8_t array[AT24C_PAGE_SIZE];
+  uint8_t bytesInPage;				// Can not initialize a typedef: Both  =  AT24C_PAGE_SIZE or = sizeof(pageByteArrayStruct.array) not allowed.
+} pageByteArrayStruct;
+
+typedef struct sEEPromOpStruct sEEPromOp;
+
+/// Called in interrupt context when an op ends, may start another.
+typedef void (*sEEPromOpDoneHandler)(sEEPromOp *pOp);
+
+/// Non blocking eeprom operation, owned by the caller, must stay put until done.
+struct sEEPromOpStruct {
+	i2cBusXfer				xfer;			// Queued on bus.
+	enumI2CBus				bus;
+	sEEPromOpDoneHandler	done;			// NULL to poll / wait.
+	void					*pContext;		// For the done handler.
+};
+
+/// Longest sEEPromOpWait(..) waits, a full queue of NACKed transfers ahead of the op.
+#define SEE_OP_WAIT_MS			(I2CBUS_QUEUE_DEPTH * (I2CBUS_XFER_TIMEOUT_MS + SEE_I2C_STUCK_MS))
+
+// Global variables:
+extern uint8_t 					eePromByteRead;
+extern uint8_t 					eePromByteToBeWritten;
+extern pageByteArrayStruct 		eePromWritePageBytes;
+extern pageByteArrayStruct 		eePromReadPageBytes;
+extern sEEBusRecoveryStruct		sEEBusRecovery;
+
+//########
+extern pageByteArrayStruct bas1;
+extern pageByteArrayStruct bas2;
+
+void sEEPromPageBufferFill(pageByteArrayStruct* pByteArrayStruct, enumArrayFillType fillType );
+
+HAL_StatusTypeDef sEEPromByteWrite(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer);
+HAL_StatusTypeDef sEEPromBytesWrite(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint16_t bufferLength);
+HAL_StatusTypeDef sEEPromCurrentAddrReadByte(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint8_t *pByteRcvd);
+HAL_StatusTypeDef sEEPromCurrentAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bits, uint8_t *pBytesRcvd, uint16_t expectedByteCount);
+HAL_StatusTypeDef sEEPromRandomAddrByteRead(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer);
+HAL_StatusTypeDef sEEPromRandomAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint8_t bufferLength);
+HAL_StatusTypeDef sEEPromWaitForIdle(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef sEEPromAckPoll(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit);
+HAL_StatusTypeDef sEEPromWaitForReady(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef sEE_I2C_StartXfer(I2C_HandleTypeDef *hi2c, enumSEEXferKind kind, uint16_t HAL_DevAddr, uint16_t memAddress,
+									uint16_t memAddSize, uint8_t *pData, uint16_t size);
+HAL_StatusTypeDef sEE_I2C_PartReset(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef sEEPromOpWrite(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress,
+								 uint8_t *pData, uint16_t length, sEEPromOpDoneHandler done, void *pContext);
+HAL_StatusTypeDef sEEPromOpRead(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress,
+								uint8_t *pData, uint16_t length, sEEPromOpDoneHandler done, void *pContext);
+HAL_StatusTypeDef sEEPromOpCurrentAddrRead(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit,
+										   uint8_t *pData, uint16_t length, sEEPromOpDoneHandler done, void *pContext);
+bool			  sEEPromOpDone(const sEEPromOp *pOp);
+HAL_StatusTypeDef sEEPromOpStatus(const sEEPromOp *pOp);
+HAL_StatusTypeDef sEEPromOpWait(sEEPromOp *pOp);
+
+#endif /* SERIALEEPROM_H_ */
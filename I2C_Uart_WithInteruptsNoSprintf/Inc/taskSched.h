@@ -0,0 +1,98 @@
+/**
+  @file taskSched.h
+  @brief Contains declarations/defines for taskSched.c, run to completion task scheduler.
+<pre>
+	The main loop's work is a table of tasks, each a void function that
+	does a little and returns, (no blocking delays, no loops waiting on
+	hardware).  A task runs:
+
+		periodically	taskSchedPeriodic(..), every periodMs, first after firstMs
+		once			taskSchedOnce(..), delayMs from now
+		when made ready	taskSchedReady(..), on the next pass, (main loop
+						events: a command line, an alarm, a button edge)
+
+	Due times are SysTick ms, (HAL_GetTick()).  taskSchedOnTick(..), in
+	SysTick_Handler, posts MAINEVT_TICK when the earliest is reached, so
+	the main loop sleeps, (mainEventWait(..)), until there is something to
+	run rather than waking every 100ms to look.
+
+	taskSchedRun(..) runs what is due or ready, highest priority first,
+	(0 highest, as the NVIC), each at most once a pass.  A periodic task
+	keeps its phase: the next due time is the last one plus periodMs, a
+	task that fell a whole period behind skips to now plus periodMs
+	rather than running several times back to back.
+
+	Per task, (S[0x1D]):
+		runs, total and worst run time, DWT cycles
+		overruns	ran longer than its budgetUs
+		misses		started more than deadlineMs after it was due
+		maxLateMs	latest start after due
+
+	A task that overruns delays every one after it, the stats show which.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/03/2018
+
+*/
+
+#ifndef TASKSCHED_H_
+#define TASKSCHED_H_
+
+#include <stdbool.h>
+#include "stm32f1xx_hal.h"
+
+/// Tasks in the table, taskSchedAdd(..) refuses more.
+#define TASKSCHED_MAX				12
+
+/// taskSchedAdd(..) table full.
+#define TASKSCHED_NONE				0xFF
+
+/// Priorities used by main.c, 0 highest.
+#define TASKSCHED_PRIO_COMMAND		0
+#define TASKSCHED_PRIO_ALARM		1
+#define TASKSCHED_PRIO_I2C			2
+#define TASKSCHED_PRIO_BUTTON		3
+#define TASKSCHED_PRIO_BACKGROUND	4
+
+typedef void (*taskSchedFunc)(void);
+
+typedef struct {
+	const char		*name;
+	taskSchedFunc	func;
+	uint8_t			priority;
+	bool			timed;				// dueMs is set, (periodic, or one shot not yet run).
+	bool			ready;				// taskSchedReady(..), run on the next pass.
+	uint32_t		periodMs;			// 0 one shot.
+	uint32_t		dueMs;				// HAL_GetTick() it is next due.
+	uint32_t		deadlineMs;			// Start within this of dueMs, else a miss, (0 no deadline).
+	uint32_t		budgetUs;			// Run longer is an overrun, (0 no budget).
+	uint32_t		runs;
+	uint32_t		overruns;
+	uint32_t		misses;
+	uint32_t		maxLateMs;
+	uint32_t		maxCycles;
+	uint64_t		totalCycles;
+} taskSchedTaskStruct;
+
+typedef struct {
+	taskSchedTaskStruct	tasks[TASKSCHED_MAX];
+	uint8_t				count;
+	__IO bool			armed;			// nextDueMs is a due time taskSchedOnTick(..) is waiting for.
+	__IO uint32_t		nextDueMs;
+	uint32_t			passes;			// taskSchedRun(..) that ran something.
+} taskSchedStateStruct;
+
+extern taskSchedStateStruct taskSchedState;
+
+void	taskSchedInit(void);
+uint8_t	taskSchedAdd(const char *name, taskSchedFunc func, uint8_t priority, uint32_t deadlineMs, uint32_t budgetUs);
+void	taskSchedPeriodic(uint8_t id, uint32_t periodMs, uint32_t firstMs);
+void	taskSchedOnce(uint8_t id, uint32_t delayMs);
+void	taskSchedReady(uint8_t id);
+void	taskSchedStop(uint8_t id);
+uint32_t taskSchedRun(void);
+void	taskSchedClearStats(void);
+void	taskSchedOnTick(void);
+
+#endif /* TASKSCHED_H_ */
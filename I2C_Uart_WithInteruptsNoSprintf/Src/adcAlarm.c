@@ -0,0 +1,293 @@
+/**
+  @file adcAlarm.c
+  @brief ADC window alarms from the analog watchdog, see adcAlarm.h
+<pre>
+	The analog watchdog is set for windows[0] by applyWatchdog(..), any
+	time the table changes.  Its interrupt, (ADC1_IRQHandler, through
+	HAL_ADC_IRQHandler(..)), disables itself, adcAlarmBlock(..) enables it
+	again when the alarm clears.
+
+	The queue is written from the ADC and DMA interrupts, read by the main
+	loop: head moves only in interrupts, (with interrupts off, so the two
+	can not interleave), tail only in adcAlarmService(..).
+
+	Alarms are logged with eeLogFlush(..) after them, a page of its own
+	rather than waiting in RAM for the page to fill, they are rare and
+	wanted after a power fail.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/31/2018
+
+*/
+#include <string.h>
+#include "adcAlarm.h"
+#include "adcSampler.h"
+#include "eePromLog.h"
+#include "mainEvent.h"
+
+/// Windows, event queue and counts.
+adcAlarmStateStruct adcAlarmState = { .awdWindow = ADCALARM_NONE, .logToEEProm = true, .notify = true };
+
+
+static void queueEvent(const adcAlarmWindowStruct *pWindow, enumAdcAlarmKind kind, uint16_t value)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t	 next;
+
+	__disable_irq();
+	next = (adcAlarmState.head + 1) % ADCALARM_QUEUE;
+	if (next == adcAlarmState.tail)
+	{
+		adcAlarmState.overflows++;
+	}
+	else
+	{
+		adcAlarmState.queue[adcAlarmState.head].tick	= HAL_GetTick();
+		adcAlarmState.queue[adcAlarmState.head].channel = pWindow->channel;
+		adcAlarmState.queue[adcAlarmState.head].kind	= (uint8_t)kind;
+		adcAlarmState.queue[adcAlarmState.head].value	= value;
+		adcAlarmState.head								= next;
+		mainEventPost(MAINEVT_ALARM);
+	}
+	__set_PRIMASK(primask);
+}
+
+static void raiseAlarm(adcAlarmWindowStruct *pWindow, uint16_t value)
+{
+	pWindow->inAlarm = true;
+	pWindow->alarms++;
+	queueEvent(pWindow, (value > pWindow->high) ? ADCALARM_HIGH : ADCALARM_LOW, value);
+}
+
+/**
+ * @brief Analog watchdog on windows[0], (interrupt only if it is not already in alarm), or off.
+ */
+static void applyWatchdog(void)
+{
+	ADC_AnalogWDGConfTypeDef awd;
+
+	memset(&awd, 0, sizeof(awd));
+	awd.WatchdogMode = ADC_ANALOGWATCHDOG_NONE;
+	awd.ITMode		 = DISABLE;
+	adcAlarmState.awdWindow = ADCALARM_NONE;
+	if (adcAlarmState.windowCount != 0)
+	{
+		awd.WatchdogMode		= ADC_ANALOGWATCHDOG_SINGLE_REG;
+		awd.Channel				= adcAlarmState.windows[0].channel;		// ADC_CHANNEL_n is n.
+		awd.ITMode				= adcAlarmState.windows[0].inAlarm ? DISABLE : ENABLE;
+		awd.HighThreshold		= adcAlarmState.windows[0].high;
+		awd.LowThreshold		= adcAlarmState.windows[0].low;
+		adcAlarmState.awdWindow = 0;
+	}
+	if (adcAlarmState.hadc != NULL)
+	{
+		__HAL_ADC_CLEAR_FLAG(adcAlarmState.hadc, ADC_FLAG_AWD);
+		HAL_ADC_AnalogWDGConfig(adcAlarmState.hadc, &awd);
+	}
+}
+
+/**
+ * @brief No windows, empty queue, the analog watchdog of hadc off.
+ */
+void adcAlarmInit(ADC_HandleTypeDef *hadc)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	adcAlarmState.hadc		  = hadc;
+	adcAlarmState.windowCount = 0;
+	adcAlarmState.head		  = 0;
+	adcAlarmState.tail		  = 0;
+	adcAlarmState.overflows	  = 0;
+	adcAlarmState.awdIrqs	  = 0;
+	adcAlarmState.maxDelayMs  = 0;
+	applyWatchdog();
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Set the window of channel, a new one goes after those already set.
+ * <pre>
+ *	The first window set has the analog watchdog, so set the one that needs
+ *	the quickest alarm first.  Changing a window starts it out of alarm.
+ * </pre>
+ *
+ * @param channel - ADC channel number, 0..17, alarms only while it is in the sampler's list.
+ * @param low	  - Raw counts, lowest in window.
+ * @param high	  - Raw counts, highest in window, 0xFFF at most.
+ *
+ * @returns false if the window is narrower than twice ADCALARM_HYSTERESIS or all ADCALARM_WINDOWS are set.
+ */
+bool adcAlarmSet(uint8_t channel, uint16_t low, uint16_t high)
+{
+	adcAlarmWindowStruct *pWindow;
+	uint32_t			  primask;
+	uint8_t				  index;
+
+	if ((channel > ADC_CHANNEL_VREFINT) || (high > 0xFFF) || ((low + 2 * ADCALARM_HYSTERESIS) >= high))
+	{
+		return false;
+	}
+	for (index = 0; (index < adcAlarmState.windowCount) && (adcAlarmState.windows[index].channel != channel); index++)
+	{
+	}
+	if (index == ADCALARM_WINDOWS)
+	{
+		return false;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	pWindow			 = &adcAlarmState.windows[index];
+	pWindow->channel = channel;
+	pWindow->low	 = low;
+	pWindow->high	 = high;
+	pWindow->inAlarm = false;
+	pWindow->alarms	 = 0;
+	if (index == adcAlarmState.windowCount)
+	{
+		adcAlarmState.windowCount++;
+	}
+	applyWatchdog();
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * @brief Stop watching channel, the windows after it move up, (the next one may get the analog watchdog).
+ *
+ * @returns false if channel has no window.
+ */
+bool adcAlarmRemove(uint8_t channel)
+{
+	uint32_t primask;
+	uint8_t	 index;
+
+	for (index = 0; (index < adcAlarmState.windowCount) && (adcAlarmState.windows[index].channel != channel); index++)
+	{
+	}
+	if (index == adcAlarmState.windowCount)
+	{
+		return false;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	memmove(&adcAlarmState.windows[index], &adcAlarmState.windows[index + 1],
+			(adcAlarmState.windowCount - index - 1) * sizeof(adcAlarmWindowStruct));
+	adcAlarmState.windowCount--;
+	applyWatchdog();
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * @brief Check the block just in against every window, sampler DMA interrupt context.
+ * <pre>
+ *	Raises the windows the analog watchdog does not watch, clears any
+ *	whose block min / max is back inside by ADCALARM_HYSTERESIS.
+ * </pre>
+ */
+void adcAlarmBlock(void)
+{
+	adcAlarmWindowStruct		  *pWindow;
+	const adcSamplerChannelStruct *pChannel;
+	uint8_t						   index;
+	uint8_t						   w;
+
+	for (w = 0; w < adcAlarmState.windowCount; w++)
+	{
+		pWindow = &adcAlarmState.windows[w];
+		index	= adcSamplerFind(pWindow->channel);
+		if (index == ADCSAMPLER_NONE)
+		{
+			continue;
+		}
+		pChannel = &adcSamplerState.channels[index];
+
+		if (!pWindow->inAlarm)
+		{
+			if (w == adcAlarmState.awdWindow)
+			{
+				continue;
+			}
+			if (pChannel->blockMax > pWindow->high)
+			{
+				raiseAlarm(pWindow, pChannel->blockMax);
+			}
+			else if (pChannel->blockMin < pWindow->low)
+			{
+				raiseAlarm(pWindow, pChannel->blockMin);
+			}
+		}
+		else if ((pChannel->blockMin >= (pWindow->low + ADCALARM_HYSTERESIS)) &&
+				 ((pChannel->blockMax + ADCALARM_HYSTERESIS) <= pWindow->high))
+		{
+			pWindow->inAlarm = false;
+			queueEvent(pWindow, ADCALARM_CLEAR, (uint16_t)(pChannel->latest >> ADCSAMPLER_EXTRA_BITS));
+			if (w == adcAlarmState.awdWindow)
+			{
+				__HAL_ADC_CLEAR_FLAG(adcAlarmState.hadc, ADC_FLAG_AWD);
+				__HAL_ADC_ENABLE_IT(adcAlarmState.hadc, ADC_IT_AWD);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Take every queued event, log it and hand it to handler, as enabled, main loop only.
+ *
+ * @param handler - Sends the notification, may be NULL.
+ *
+ * @returns events taken.
+ */
+uint32_t adcAlarmService(adcAlarmHandler handler)
+{
+	adcAlarmEvent event;
+	uint32_t	  count = 0;
+	uint32_t	  delayMs;
+
+	while (adcAlarmState.tail != adcAlarmState.head)
+	{
+		event				= adcAlarmState.queue[adcAlarmState.tail];
+		adcAlarmState.tail	= (adcAlarmState.tail + 1) % ADCALARM_QUEUE;
+		count++;
+
+		delayMs = HAL_GetTick() - event.tick;
+		if (delayMs > adcAlarmState.maxDelayMs)
+		{
+			adcAlarmState.maxDelayMs = delayMs;
+		}
+		if (adcAlarmState.logToEEProm)
+		{
+			eeLogAppend(EELOG_TYPE_ALARM, event.channel, (uint16_t)((event.kind << 12) | event.value));
+		}
+		if (adcAlarmState.notify && (handler != NULL))
+		{
+			handler(&event);
+		}
+	}
+	if ((count != 0) && adcAlarmState.logToEEProm)
+	{
+		eeLogFlush();
+	}
+	return count;
+}
+
+/**
+ * @brief Analog watchdog, a conversion of windows[0]'s channel is out of it, (HAL weak callback).
+ */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+	if ((hadc != adcAlarmState.hadc) || (adcAlarmState.awdWindow == ADCALARM_NONE))
+	{
+		return;
+	}
+	__HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);		// Once per excursion, adcAlarmBlock(..) enables it again.
+	adcAlarmState.awdIrqs++;
+	if (!adcAlarmState.windows[adcAlarmState.awdWindow].inAlarm)
+	{
+		raiseAlarm(&adcAlarmState.windows[adcAlarmState.awdWindow], (uint16_t)(hadc->Instance->DR & 0xFFF));
+	}
+}
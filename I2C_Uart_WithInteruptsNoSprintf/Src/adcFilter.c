@@ -0,0 +1,395 @@
+/**
+  @file adcFilter.c
+  @brief Fixed point filtering of the ADC sample blocks, see adcFilter.h
+<pre>
+	The sampler's DMA interrupt posts each block, (adcFilterPost), as
+	PendSV work, (pendWork.h), PendSV runs adcFilterService(..) for it.
+	So filtering waits for every other interrupt, and the main loop waits
+	for it.
+
+	Per channel, per ADCFILTER_CHUNK samples: the samples are taken out of
+	the interleaved block into work[] as q15, (<< ADCSAMPLER_EXTRA_BITS,
+	so outputs are in oversampled counts), and filtered there in place.
+	The biquad widens work[] into work31[], q15 << 15, half of q31 full
+	scale for overshoot.
+
+	A channel is primed from its first sample, filter state as if that
+	value had always been the input, so there is no start up ramp.  This
+	happens again after the filter is configured or the sampler restarted.
+
+	Native kernels follow CMSIS-DSP exactly:
+
+	@li arm_fir_q15(..), coefficients time reversed, (these are
+		symmetric), state numTaps - 1 past samples then the new block, 64
+		bit accumulator, output saturated from >> 15.
+	@li arm_biquad_cascade_df1_q31(..), coefficients b0 b1 b2 a1 a2 per
+		stage, a1 / a2 with the sign to add, (y = b0 x + .. + a1 y[n-1] +
+		a2 y[n-2]), 64 bit accumulator >> (31 - postShift).
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/30/2018
+
+*/
+#include <string.h>
+#include "adcFilter.h"
+#include "i2cTrace.h"
+#include "pendWork.h"
+
+/// Biquad coefficients are scaled by 2^-n to fit q31, (a1 ~1.9).
+#define ADCFILTER_BIQUAD_POST_SHIFT	1
+
+/// Filter, per channel state and counts.
+adcFilterStateStruct adcFilterState = { .pendingHalf = ADCFILTER_NO_BLOCK };
+
+/// Low pass, 50 Hz at 1 KHz, Hamming windowed sinc, sum 32768, (unity DC gain).
+static const int16_t firCoeffs[ADCFILTER_FIR_TAPS] = {
+	112, 243, 618, 1293, 2217, 3225, 4089, 4587, 4587, 4089, 3225, 2217, 1293, 618, 243, 112
+};
+
+/// Butterworth low pass, 10 Hz at 1 KHz, {b0, b1, b2, a1, a2} * 2^30, b1 trimmed for unity DC gain.
+static const int32_t biquad2ndCoeffs[5] = {
+	1014355, 2028711, 1014355, 2052132225, -982447822				// Q 0.707
+};
+static const int32_t biquad4thCoeffs[5 * 2] = {
+	1001305, 2002612, 1001305, 2025731614, -955995012,				// Q 0.541
+	1034533, 2069068, 1034533, 2092954699, -1023351009				// Q 1.307
+};
+
+/// One chunk of one channel, filtered in place.
+static int16_t work[ADCFILTER_CHUNK];
+static int32_t work31[ADCFILTER_CHUNK];
+
+
+static int16_t saturate16(int64_t value)
+{
+	return (value > 32767) ? 32767 : ((value < -32768) ? -32768 : (int16_t)value);
+}
+
+static const int32_t *biquadCoeffs(void)
+{
+	return (adcFilterState.param == 1) ? biquad2ndCoeffs : biquad4thCoeffs;
+}
+
+/**
+ * @brief Filter state as if x had always been the input.
+ */
+static void prime(adcFilterChannelStruct *pChannel, int16_t x)
+{
+	uint8_t i;
+
+	switch (adcFilterState.type)
+	{
+		case ADCFILTER_FIR:
+#ifdef ADCFILTER_CMSIS_DSP
+			arm_fir_init_q15(&pChannel->instance.fir, ADCFILTER_FIR_TAPS, (q15_t *)firCoeffs, pChannel->state.fir,
+							 ADCFILTER_CHUNK);
+#endif
+			for (i = 0; i < (ADCFILTER_FIR_TAPS - 1); i++)
+			{
+				pChannel->state.fir[i] = x;
+			}
+			break;
+
+		case ADCFILTER_BIQUAD:
+#ifdef ADCFILTER_CMSIS_DSP
+			arm_biquad_cascade_df1_init_q31(&pChannel->instance.biquad, adcFilterState.param, (q31_t *)biquadCoeffs(),
+											pChannel->state.biquad, ADCFILTER_BIQUAD_POST_SHIFT);
+#endif
+			for (i = 0; i < (4 * adcFilterState.param); i++)
+			{
+				pChannel->state.biquad[i] = (int32_t)x << 15;		// Every section has unity DC gain.
+			}
+			break;
+
+		default:
+			pChannel->state.average.sum	  = 0;
+			pChannel->state.average.count = 0;
+			break;
+	}
+	pChannel->output = x;
+	pChannel->primed = true;
+}
+
+/**
+ * @brief Boxcar of 2^param samples, an output per window, (decimated), written from work[0].
+ */
+static void average(adcFilterChannelStruct *pChannel)
+{
+	uint8_t in;
+	uint8_t out = 0;
+
+	for (in = 0; in < ADCFILTER_CHUNK; in++)
+	{
+		pChannel->state.average.sum += (uint16_t)work[in];
+		if (++pChannel->state.average.count == (1U << adcFilterState.param))
+		{
+			work[out++] = (int16_t)(pChannel->state.average.sum >> adcFilterState.param);
+			pChannel->state.average.sum	  = 0;
+			pChannel->state.average.count = 0;
+		}
+	}
+	if (out != 0)
+	{
+		pChannel->output = work[out - 1];
+	}
+}
+
+static void fir(adcFilterChannelStruct *pChannel)
+{
+#ifdef ADCFILTER_CMSIS_DSP
+	arm_fir_q15(&pChannel->instance.fir, work, work, ADCFILTER_CHUNK);
+#else
+	int16_t *pState = pChannel->state.fir;
+	int64_t	 acc;
+	uint8_t	 n;
+	uint8_t	 tap;
+
+	memcpy(&pState[ADCFILTER_FIR_TAPS - 1], work, sizeof(work));
+	for (n = 0; n < ADCFILTER_CHUNK; n++)
+	{
+		acc = 0;
+		for (tap = 0; tap < ADCFILTER_FIR_TAPS; tap++)
+		{
+			acc += (int32_t)pState[n + tap] * firCoeffs[tap];
+		}
+		work[n] = saturate16(acc >> 15);
+	}
+	memmove(pState, &pState[ADCFILTER_CHUNK], (ADCFILTER_FIR_TAPS - 1) * sizeof(int16_t));
+#endif
+	pChannel->output = work[ADCFILTER_CHUNK - 1];
+}
+
+static void biquad(adcFilterChannelStruct *pChannel)
+{
+	uint8_t n;
+
+	for (n = 0; n < ADCFILTER_CHUNK; n++)
+	{
+		work31[n] = (int32_t)work[n] << 15;
+	}
+#ifdef ADCFILTER_CMSIS_DSP
+	arm_biquad_cascade_df1_q31(&pChannel->instance.biquad, work31, work31, ADCFILTER_CHUNK);
+#else
+	{
+		const int32_t *pCoeffs = biquadCoeffs();
+		int32_t		  *pState  = pChannel->state.biquad;
+		int64_t		   acc;
+		int32_t		   x;
+		uint8_t		   stage;
+
+		for (stage = 0; stage < adcFilterState.param; stage++, pCoeffs += 5, pState += 4)
+		{
+			for (n = 0; n < ADCFILTER_CHUNK; n++)
+			{
+				x	= work31[n];
+				acc = (int64_t)pCoeffs[0] * x + (int64_t)pCoeffs[1] * pState[0] + (int64_t)pCoeffs[2] * pState[1] +
+					  (int64_t)pCoeffs[3] * pState[2] + (int64_t)pCoeffs[4] * pState[3];
+
+				pState[1] = pState[0];
+				pState[0] = x;
+				pState[3] = pState[2];
+				pState[2] = (int32_t)(acc >> (31 - ADCFILTER_BIQUAD_POST_SHIFT));
+				work31[n] = pState[2];
+			}
+		}
+	}
+#endif
+	pChannel->output = saturate16(work31[ADCFILTER_CHUNK - 1] >> 15);
+}
+
+/**
+ * @brief Filter one channel of a block, pSample is its first sample, every channelCount'th is the next.
+ */
+static void filterChannel(adcFilterChannelStruct *pChannel, const uint16_t *pSample)
+{
+	uint8_t	 stride = adcSamplerState.channelCount;
+	uint32_t chunk;
+	uint8_t	 i;
+
+	for (chunk = 0; chunk < ADCSAMPLER_BLOCK; chunk += ADCFILTER_CHUNK)
+	{
+		for (i = 0; i < ADCFILTER_CHUNK; i++, pSample += stride)
+		{
+			work[i] = (int16_t)(*pSample << ADCSAMPLER_EXTRA_BITS);
+		}
+		if (!pChannel->primed)
+		{
+			prime(pChannel, work[0]);
+		}
+
+		switch (adcFilterState.type)
+		{
+			case ADCFILTER_AVERAGE:
+				average(pChannel);
+				break;
+			case ADCFILTER_FIR:
+				fir(pChannel);
+				break;
+			case ADCFILTER_BIQUAD:
+				biquad(pChannel);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * @brief Choose the filter, every channel starts again from its next sample.
+ *
+ * @param type	- ADCFILTER_xxx.
+ * @param param	- ADCFILTER_AVERAGE: window 2^param, 0..ADCFILTER_AVERAGE_MAX_LOG2.
+ *				  ADCFILTER_BIQUAD: stages, 1 or 2.  Not used by the others.
+ *
+ * @returns false if param is out of range for type, the filter is unchanged.
+ */
+bool adcFilterConfigure(enumAdcFilterType type, uint8_t param)
+{
+	uint32_t primask;
+	uint8_t	 rank;
+
+	switch (type)
+	{
+		case ADCFILTER_AVERAGE:
+			if (param > ADCFILTER_AVERAGE_MAX_LOG2)
+			{
+				return false;
+			}
+			break;
+		case ADCFILTER_BIQUAD:
+			if ((param == 0) || (param > ADCFILTER_BIQUAD_MAX_STAGES))
+			{
+				return false;
+			}
+			break;
+		case ADCFILTER_NONE:
+		case ADCFILTER_FIR:
+			param = 0;
+			break;
+		default:
+			return false;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	adcFilterState.type	 = type;
+	adcFilterState.param = param;
+	for (rank = 0; rank < ADCSAMPLER_MAX_CHANNELS; rank++)
+	{
+		adcFilterState.channels[rank].primed = false;
+	}
+	adcFilterState.pendingHalf = ADCFILTER_NO_BLOCK;
+	adcFilterState.blocks	   = 0;
+	adcFilterState.dropped	   = 0;
+	adcFilterState.late		   = 0;
+	adcFilterState.lastCycles  = 0;
+	adcFilterState.maxCycles   = 0;
+	__set_PRIMASK(primask);
+	return true;
+}
+
+static void filterWork(void *pArg)
+{
+	(void)pArg;
+	adcFilterService();
+}
+
+/**
+ * @brief A block is in, (sampler DMA interrupt), note it and post PendSV work to filter it.
+ * <pre>
+ *	A block still waiting is replaced, (dropped), its work item is already
+ *	queued.  A full work queue drops the block too.
+ * </pre>
+ */
+void adcFilterPost(uint8_t half)
+{
+	if (adcSamplerState.blocks == 1)
+	{
+		adcFilterState.reprime = true;
+	}
+	if (adcFilterState.type == ADCFILTER_NONE)
+	{
+		return;
+	}
+	if (adcFilterState.pendingHalf != ADCFILTER_NO_BLOCK)
+	{
+		adcFilterState.dropped++;
+		adcFilterState.pendingHalf	= half;
+		adcFilterState.pendingBlock = adcSamplerState.blocks;
+		return;
+	}
+	adcFilterState.pendingHalf	= half;
+	adcFilterState.pendingBlock = adcSamplerState.blocks;
+	if (!pendWorkPost(filterWork, NULL))
+	{
+		adcFilterState.pendingHalf = ADCFILTER_NO_BLOCK;
+		adcFilterState.dropped++;
+	}
+}
+
+/**
+ * @brief Filter the block posted last, every channel, PendSV work, (pendWork.h).
+ * <pre>
+ *	Does nothing if no block is waiting, so an extra call costs nothing.
+ * </pre>
+ */
+void adcFilterService(void)
+{
+	const uint16_t *pBlock;
+	uint32_t		primask;
+	uint32_t		block;
+	uint32_t		start;
+	uint8_t			half;
+	uint8_t			rank;
+	bool			reprime;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	half						= adcFilterState.pendingHalf;
+	block						= adcFilterState.pendingBlock;
+	reprime						= adcFilterState.reprime;
+	adcFilterState.pendingHalf	= ADCFILTER_NO_BLOCK;
+	adcFilterState.reprime		= false;
+	__set_PRIMASK(primask);
+
+	if (half == ADCFILTER_NO_BLOCK)
+	{
+		return;
+	}
+
+	start  = i2cTraceNow();
+	pBlock = adcSamplerBlock(half);
+	for (rank = 0; rank < adcSamplerState.channelCount; rank++)
+	{
+		if (reprime)
+		{
+			adcFilterState.channels[rank].primed = false;
+		}
+		filterChannel(&adcFilterState.channels[rank], &pBlock[rank]);
+	}
+
+	adcFilterState.lastCycles = i2cTraceNow() - start;
+	if (adcFilterState.lastCycles > adcFilterState.maxCycles)
+	{
+		adcFilterState.maxCycles = adcFilterState.lastCycles;
+	}
+	if (adcSamplerState.blocks != block)
+	{
+		adcFilterState.late++;
+	}
+	adcFilterState.blocks++;
+}
+
+/**
+ * @brief Output of the channel at index, oversampled counts, the sampler's filtered value if the filter is off.
+ */
+uint16_t adcFilterValue(uint8_t index)
+{
+	if ((index >= adcSamplerState.channelCount) || (adcFilterState.type == ADCFILTER_NONE) ||
+		!adcFilterState.channels[index].primed)
+	{
+		return adcSamplerFiltered(index);
+	}
+	return (adcFilterState.channels[index].output < 0) ? 0 : (uint16_t)adcFilterState.channels[index].output;
+}
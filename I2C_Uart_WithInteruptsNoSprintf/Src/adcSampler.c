@@ -0,0 +1,329 @@
+/**
+  @file adcSampler.c
+  @brief Continuous DMA sampling of a list of ADC channels, see adcSampler.h
+<pre>
+	MX_ADC1_Init(..) sets ADC1 to convert on TIM3 TRGO, MX_TIM3_Init(..)
+	sets TIM3 to ADCSAMPLER_RATE_HZ, the DMA channel is circular, (HAL
+	ADC MSP).  Started here with the channel list as the regular
+	sequence, after that only the block interrupts run.
+
+	A block is handed over by the half transfer interrupt, (block 0), or
+	the transfer complete one, (block 1), DMA is filling the other half
+	while it is summed, ADCSAMPLER_BLOCK scans' time to do it in.
+
+	Block sums and sums of squares fit 32 bits, (64 * 4095^2 < 2^32),
+	they are added to the 64 bit totals once per block.  The totals are
+	read and cleared from the main loop with interrupts off.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/29/2018
+
+*/
+#include <string.h>
+#include "adcSampler.h"
+#include "i2cTrace.h"
+#include "adcFilter.h"
+#include "adcAlarm.h"
+
+/// Sampler, latest values and counts.
+adcSamplerStateStruct adcSamplerState;
+
+/// Both halves, DMA writes every conversion here, interleaved by rank.
+static uint16_t samples[2 * ADCSAMPLER_BLOCK * ADCSAMPLER_MAX_CHANNELS];
+
+
+/**
+ * @brief Oversample, filter and add to the statistics of one channel of a block.
+ */
+static void channelBlockDone(adcSamplerChannelStruct *pChannel, const uint16_t *pSample, bool first)
+{
+	uint8_t	 stride = adcSamplerState.channelCount;
+	uint32_t sum	= 0;
+	uint32_t sumSq	= 0;
+	uint16_t min	= 0xFFFF;
+	uint16_t max	= 0;
+	uint32_t i;
+
+	for (i = 0; i < ADCSAMPLER_BLOCK; i++, pSample += stride)
+	{
+		sum	  += *pSample;
+		sumSq += (uint32_t)*pSample * *pSample;
+		if (*pSample < min)
+		{
+			min = *pSample;
+		}
+		if (*pSample > max)
+		{
+			max = *pSample;
+		}
+	}
+
+	pChannel->latest = (uint16_t)(sum >> ADCSAMPLER_EXTRA_BITS);
+	if (first)
+	{
+		pChannel->filterAcc = (uint32_t)pChannel->latest << ADCSAMPLER_FILTER_SHIFT;
+	}
+	else
+	{
+		pChannel->filterAcc += pChannel->latest - (pChannel->filterAcc >> ADCSAMPLER_FILTER_SHIFT);
+	}
+
+	pChannel->blockMin = min;
+	pChannel->blockMax = max;
+	if (min < pChannel->min)
+	{
+		pChannel->min = min;
+	}
+	if (max > pChannel->max)
+	{
+		pChannel->max = max;
+	}
+	pChannel->samples += ADCSAMPLER_BLOCK;
+	pChannel->sum	  += sum;
+	pChannel->sumSq	  += sumSq;
+}
+
+/**
+ * @brief Every channel of one block, DMA interrupt context.
+ */
+static void blockDone(uint8_t half)
+{
+	const uint16_t *pBlock = &samples[half * ADCSAMPLER_BLOCK * adcSamplerState.channelCount];
+	uint32_t		start  = i2cTraceNow();
+	uint32_t		cycles;
+	uint8_t			rank;
+
+	if (half != adcSamplerState.nextHalf)
+	{
+		adcSamplerState.missed++;
+	}
+	adcSamplerState.nextHalf = half ^ 1;
+
+	for (rank = 0; rank < adcSamplerState.channelCount; rank++)
+	{
+		channelBlockDone(&adcSamplerState.channels[rank], &pBlock[rank], (adcSamplerState.blocks == 0));
+	}
+	adcSamplerState.blocks++;
+	adcAlarmBlock();
+	adcFilterPost(half);
+
+	cycles = i2cTraceNow() - start;
+	if (cycles > adcSamplerState.maxIsrCycles)
+	{
+		adcSamplerState.maxIsrCycles = cycles;
+	}
+}
+
+/**
+ * @brief Regular sequence of hadc from the channel list, ascending channel numbers.
+ *
+ * @returns false if the list is empty or longer than ADCSAMPLER_MAX_CHANNELS.
+ */
+static bool configure(ADC_HandleTypeDef *hadc, uint32_t channelMask)
+{
+	ADC_ChannelConfTypeDef sConfig;
+	uint32_t			   channel;
+	uint8_t				   count = 0;
+
+	if ((channelMask == 0) || (channelMask & ~ADCSAMPLER_CHANNEL_MASK))
+	{
+		return false;
+	}
+	for (channel = 0; channelMask >> channel; channel++)
+	{
+		if (channelMask & (1UL << channel))
+		{
+			if (count == ADCSAMPLER_MAX_CHANNELS)
+			{
+				return false;
+			}
+			adcSamplerState.channels[count++].channel = (uint8_t)channel;
+		}
+	}
+
+	hadc->Init.ScanConvMode	   = ADC_SCAN_ENABLE;
+	hadc->Init.NbrOfConversion = count;
+	if (HAL_ADC_Init(hadc) != HAL_OK)
+	{
+		return false;
+	}
+	for (sConfig.Rank = 1; sConfig.Rank <= count; sConfig.Rank++)
+	{
+		sConfig.Channel		 = adcSamplerState.channels[sConfig.Rank - 1].channel;	// ADC_CHANNEL_n is n.
+		sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5;							// Internal channels need >= 17.1us.
+		if (HAL_ADC_ConfigChannel(hadc, &sConfig) != HAL_OK)
+		{
+			return false;
+		}
+	}
+	adcSamplerState.channelMask	 = channelMask;
+	adcSamplerState.channelCount = count;
+	return true;
+}
+
+/**
+ * @brief Set the channel list, calibrate the ADC, start DMA into the block buffer, then the trigger timer.
+ * <pre>
+ *	Restarts with the new list if already running, values and statistics start again.
+ * </pre>
+ *
+ * @param hadc		  - ADC set up for TIM3 TRGO, DMA linked in circular mode.
+ * @param htim		  - Trigger timer, TRGO on update.
+ * @param channelMask - Bit per ADC channel number, up to ADCSAMPLER_MAX_CHANNELS bits.
+ *
+ * @returns true if sampling.
+ */
+bool adcSamplerStart(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim, uint32_t channelMask)
+{
+	adcSamplerStop();
+	memset(&adcSamplerState, 0, sizeof(adcSamplerState));
+	adcSamplerState.hadc = hadc;
+	adcSamplerState.htim = htim;
+	adcSamplerStatsClear();
+
+	if (!configure(hadc, channelMask) || (HAL_ADCEx_Calibration_Start(hadc) != HAL_OK) ||
+		(HAL_ADC_Start_DMA(hadc, (uint32_t *)samples, 2 * ADCSAMPLER_BLOCK * adcSamplerState.channelCount) != HAL_OK))
+	{
+		return false;
+	}
+	if (HAL_TIM_Base_Start(htim) != HAL_OK)
+	{
+		HAL_ADC_Stop_DMA(hadc);
+		return false;
+	}
+	adcSamplerState.running = true;
+	return true;
+}
+
+void adcSamplerStop(void)
+{
+	if (adcSamplerState.running)
+	{
+		HAL_TIM_Base_Stop(adcSamplerState.htim);
+		HAL_ADC_Stop_DMA(adcSamplerState.hadc);
+		adcSamplerState.running = false;
+	}
+}
+
+/**
+ * @brief Index of channel in the list, (rank - 1), ADCSAMPLER_NONE if not sampled.
+ */
+uint8_t adcSamplerFind(uint32_t channel)
+{
+	uint8_t index;
+
+	for (index = 0; index < adcSamplerState.channelCount; index++)
+	{
+		if (adcSamplerState.channels[index].channel == channel)
+		{
+			return index;
+		}
+	}
+	return ADCSAMPLER_NONE;
+}
+
+/**
+ * @brief Filtered reading of the channel at index, oversampled counts, 0 until the first block is in.
+ */
+uint16_t adcSamplerFiltered(uint8_t index)
+{
+	return (index < adcSamplerState.channelCount) ?
+			   (uint16_t)(adcSamplerState.channels[index].filterAcc >> ADCSAMPLER_FILTER_SHIFT) : 0;
+}
+
+/**
+ * @brief Samples of block 0 or 1 of the DMA buffer, interleaved by rank, ADCSAMPLER_BLOCK scans.
+ * <pre>
+ *	Only steady until the DMA comes back round to that half, one block time
+ *	after its interrupt.
+ * </pre>
+ */
+const uint16_t *adcSamplerBlock(uint8_t half)
+{
+	return &samples[(half & 1) * ADCSAMPLER_BLOCK * adcSamplerState.channelCount];
+}
+
+/**
+ * @brief Statistics of the channel at index since adcSamplerStatsClear(..), main loop only.
+ * <pre>
+ *	mean	 = sum / n
+ *	variance = sumSq / n - mean^2, worked in Q8 so the result is never
+ *			   negative, (mean is rounded down), then taken to Q4.
+ * </pre>
+ *
+ * @returns false if index is not in the list or no block is in yet.
+ */
+bool adcSamplerStats(uint8_t index, adcSamplerStatsStruct *pStats)
+{
+	adcSamplerChannelStruct channel;
+	uint32_t				primask;
+	uint64_t				meanSqQ8;
+	uint64_t				meanQ4;
+
+	if (index >= adcSamplerState.channelCount)
+	{
+		return false;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	channel = adcSamplerState.channels[index];
+	__set_PRIMASK(primask);
+
+	if (channel.samples == 0)
+	{
+		return false;
+	}
+	meanQ4	 = (channel.sum << 4) / channel.samples;
+	meanSqQ8 = (channel.sumSq << 8) / channel.samples;
+
+	pStats->samples	   = channel.samples;
+	pStats->min		   = channel.min;
+	pStats->max		   = channel.max;
+	pStats->meanQ4	   = (uint32_t)meanQ4;
+	pStats->varianceQ4 = (uint32_t)((meanSqQ8 - meanQ4 * meanQ4) >> 4);
+	return true;
+}
+
+/**
+ * @brief Start the statistics of every channel again.
+ */
+void adcSamplerStatsClear(void)
+{
+	adcSamplerChannelStruct *pChannel;
+	uint32_t				 primask = __get_PRIMASK();
+
+	__disable_irq();
+	for (pChannel = adcSamplerState.channels; pChannel < &adcSamplerState.channels[ADCSAMPLER_MAX_CHANNELS]; pChannel++)
+	{
+		pChannel->min	  = 0xFFFF;
+		pChannel->max	  = 0;
+		pChannel->samples = 0;
+		pChannel->sum	  = 0;
+		pChannel->sumSq	  = 0;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief ADC DMA half transfer, block 0 is in, (HAL weak callback).
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if (hadc == adcSamplerState.hadc)
+	{
+		blockDone(0);
+	}
+}
+
+/**
+ * @brief ADC DMA transfer complete, block 1 is in, (HAL weak callback).
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if (hadc == adcSamplerState.hadc)
+	{
+		blockDone(1);
+	}
+}
@@ -0,0 +1,240 @@
+/**
+  @file adcTemp.c
+  @brief Chip temperature in fixed point, two point calibration, see adcTemp.h
+<pre>
+	Only adcTempCalPoint(..) divides, once per calibration, conversion
+	and formatting are multiplies and shifts, they may run at any rate,
+	(or in an interrupt).
+
+	The calibration page is read and written blocking, as the log's are,
+	at power up and when a calibration is taken.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/01/2018
+
+*/
+#include <stddef.h>
+#include <string.h>
+#include "adcTemp.h"
+#include "adcFilter.h"
+#include "eePromCrc.h"
+
+/// Calibration in use, points being taken.
+adcTempStateStruct adcTempState;
+
+/// Calibration being written, must stay untouched until the non blocking write is done.
+static adcTempCalStruct savePage;
+
+// Compile time check: the calibration fits the page, and has no padding the CRC would miss.
+typedef char adcTempCalSizeCheck[((sizeof(adcTempCalStruct) == 16) && (sizeof(adcTempCalStruct) <= AT24C_PAGE_SIZE)) ? 1 : -1];
+
+
+static uint16_t calCrc(const adcTempCalStruct *pCal)
+{
+	return eeCrc16((const uint8_t *)pCal, offsetof(adcTempCalStruct, crc), 0xFFFF);
+}
+
+static void calDefault(adcTempCalStruct *pCal)
+{
+	memset(pCal, 0, sizeof(adcTempCalStruct));
+	pCal->magic		= ADCTEMP_CAL_MAGIC;
+	pCal->refCounts = ADCTEMP_DEFAULT_COUNTS;
+	pCal->refTempQ8 = ADCTEMP_DEFAULT_TEMP_Q8;
+	pCal->gainQ16	= ADCTEMP_DEFAULT_GAIN_Q16;
+	pCal->points	= 0;
+}
+
+/**
+ * @brief Write the calibration in use to its eeprom page, (blocking until the write starts).
+ */
+static bool calSave(void)
+{
+	savePage	 = adcTempState.cal;
+	savePage.crc = calCrc(&savePage);
+
+	// Previous write still in its tWR ?
+	if ((sEEPromAckPoll(ADCTEMP_I2C_HANDLE, ADCTEMP_DEV_ADDR) != HAL_OK) ||
+		(sEEPromBytesWrite(ADCTEMP_I2C_HANDLE, ADCTEMP_DEV_ADDR, (uint16_t)(ADCTEMP_CAL_PAGE * AT24C_PAGE_SIZE),
+						   (uint8_t *)&savePage, sizeof(savePage)) != HAL_OK))
+	{
+		adcTempState.saveErrors++;
+		return false;
+	}
+	adcTempState.cal = savePage;
+	return true;
+}
+
+/**
+ * @brief Load the calibration from the eeprom, the data sheet line if there is none.
+ * <pre>
+ *	Call once after I2C is initialized, (blocking, one page read).
+ * </pre>
+ */
+void adcTempInit(void)
+{
+	adcTempCalStruct cal;
+
+	memset(&adcTempState, 0, sizeof(adcTempState));
+	calDefault(&adcTempState.cal);
+
+	if ((sEEPromAckPoll(ADCTEMP_I2C_HANDLE, ADCTEMP_DEV_ADDR) != HAL_OK) ||
+		(sEEPromRandomAddrReadBytes(ADCTEMP_I2C_HANDLE, ADCTEMP_DEV_ADDR, (uint16_t)(ADCTEMP_CAL_PAGE * AT24C_PAGE_SIZE),
+									(uint8_t *)&cal, sizeof(cal)) != HAL_OK) ||
+		(sEEPromWaitForIdle(ADCTEMP_I2C_HANDLE) != HAL_OK))
+	{
+		return;
+	}
+	if ((cal.magic == ADCTEMP_CAL_MAGIC) && (cal.crc == calCrc(&cal)) && (cal.gainQ16 < 0))
+	{
+		adcTempState.cal	= cal;
+		adcTempState.loaded = true;
+	}
+}
+
+/**
+ * @brief Temperature from a sensor reading, Q8 degrees C, (saturates at the int16_t limits).
+ *
+ * @param counts - Oversampled counts, (adcSamplerFiltered(..), adcFilterValue(..)).
+ */
+int16_t adcTempFromCounts(uint16_t counts)
+{
+	int32_t tempQ8;
+
+	tempQ8 = adcTempState.cal.refTempQ8 +
+			 (int32_t)((((int64_t)((int32_t)counts - adcTempState.cal.refCounts) * adcTempState.cal.gainQ16) + 0x8000) >> 16);
+	if (tempQ8 > INT16_MAX)
+	{
+		return INT16_MAX;
+	}
+	if (tempQ8 < INT16_MIN)
+	{
+		return INT16_MIN;
+	}
+	return (int16_t)tempQ8;
+}
+
+/**
+ * @brief Chip temperature now, Q8 degrees C, from the filtered sensor reading.
+ *
+ * @returns false if the sensor is not in the sampler's list, or no block is in yet.
+ */
+bool adcTempRead(int16_t *pTempQ8)
+{
+	uint8_t index = adcSamplerFind(ADC_CHANNEL_TEMPSENSOR);
+
+	if ((index == ADCSAMPLER_NONE) || (adcSamplerState.blocks == 0))
+	{
+		return false;
+	}
+	*pTempQ8 = adcTempFromCounts(adcFilterValue(index));
+	return true;
+}
+
+/**
+ * @brief Take the sensor reading now as calibration point 1 or 2, the line is worked out and saved when both are in.
+ * <pre>
+ *	Point 0 goes back to the data sheet line, (and saves it).
+ * </pre>
+ *
+ * @param point	 - 0, 1 or 2.
+ * @param centiC - Temperature of the chip now, 1/100 degree C, -40.00 .. 125.00.
+ *
+ * @returns false if the point is refused, or the two are too close, or the slope is not believable.
+ */
+bool adcTempCalPoint(uint8_t point, int32_t centiC)
+{
+	int32_t countSpan;
+	int32_t tempSpan;
+	int32_t gainQ16;
+	int16_t tempQ8;
+
+	if (point == 0)
+	{
+		adcTempState.pointsTaken = 0;
+		adcTempState.loaded		 = false;
+		calDefault(&adcTempState.cal);
+		return calSave();
+	}
+	if ((point > 2) || (centiC < -4000) || (centiC > 12500) ||
+		(adcSamplerFind(ADC_CHANNEL_TEMPSENSOR) == ADCSAMPLER_NONE) || (adcSamplerState.blocks == 0))
+	{
+		return false;
+	}
+
+	// Rare, the one divide here is cheaper than a table.
+	tempQ8 = (int16_t)(((centiC * 256) + ((centiC < 0) ? -50 : 50)) / 100);
+	adcTempState.pointCounts[point - 1] = adcFilterValue(adcSamplerFind(ADC_CHANNEL_TEMPSENSOR));
+	adcTempState.pointTempQ8[point - 1] = tempQ8;
+	adcTempState.pointsTaken |= (uint8_t)(1 << (point - 1));
+	if (adcTempState.pointsTaken != 3)
+	{
+		return true;
+	}
+	adcTempState.pointsTaken = 0;
+
+	countSpan = (int32_t)adcTempState.pointCounts[1] - adcTempState.pointCounts[0];
+	tempSpan  = (int32_t)adcTempState.pointTempQ8[1] - adcTempState.pointTempQ8[0];
+	if ((countSpan == 0) || ((tempSpan > -(ADCTEMP_CAL_MIN_C * 256)) && (tempSpan < (ADCTEMP_CAL_MIN_C * 256))))
+	{
+		return false;
+	}
+	gainQ16 = (int32_t)(((int64_t)tempSpan << 16) / countSpan);
+	if ((gainQ16 > (ADCTEMP_DEFAULT_GAIN_Q16 / 2)) || (gainQ16 < (ADCTEMP_DEFAULT_GAIN_Q16 * 2)))
+	{
+		return false;
+	}
+
+	adcTempState.cal.refCounts = adcTempState.pointCounts[0];
+	adcTempState.cal.refTempQ8 = adcTempState.pointTempQ8[0];
+	adcTempState.cal.gainQ16   = gainQ16;
+	adcTempState.cal.points	   = 2;
+	adcTempState.loaded		   = false;
+	return calSave();
+}
+
+/**
+ * @brief Q8 temperature as decimal text, "-12.34", no divide.
+ * <pre>
+ *	Rounded to decimals places, 0..ADCTEMP_MAX_DECIMALS, no "-" if it
+ *	rounds to 0.  stringToCreate must hold ADCTEMP_STR_MAX chars.
+ * </pre>
+ */
+void adcTempToString(int16_t tempQ8, uint8_t decimals, char *stringToCreate)
+{
+	static const uint8_t scale[ADCTEMP_MAX_DECIMALS + 1] = { 1, 10, 100 };
+	char				 digits[ADCTEMP_STR_MAX];
+	uint32_t			 value;
+	uint32_t			 tenth;
+	uint8_t				 count = 0;
+
+	if (decimals > ADCTEMP_MAX_DECIMALS)
+	{
+		decimals = ADCTEMP_MAX_DECIMALS;
+	}
+
+	// Units of 10^-decimals degrees, rounded, at most 12800.
+	value = ((uint32_t)((tempQ8 < 0) ? -(int32_t)tempQ8 : tempQ8) * scale[decimals] + 128) >> 8;
+	if ((tempQ8 < 0) && (value != 0))
+	{
+		*stringToCreate++ = '-';
+	}
+
+	// Least significant first, at least one digit before the point.
+	do
+	{
+		tenth			= (value * 0xCCCDU) >> 19;
+		digits[count++] = (char)('0' + (value - (tenth * 10)));
+		value			= tenth;
+	} while ((value != 0) || (count <= decimals));
+
+	while (count != 0)
+	{
+		if (count-- == decimals)
+		{
+			*stringToCreate++ = '.';
+		}
+		*stringToCreate++ = digits[count];
+	}
+	*stringToCreate = '\0';
+}
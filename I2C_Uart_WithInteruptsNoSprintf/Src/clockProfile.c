@@ -0,0 +1,224 @@
+/**
+  @file clockProfile.c
+  @brief System clock profiles switched at run time, see clockProfile.h
+<pre>
+	HAL_RCC_OscConfig(..) / HAL_RCC_ClockConfig(..) time out on
+	HAL_GetTick(), so SysTick must keep running, interrupts stay on
+	through a change.  The peripherals are re-timed after each step that
+	moves SYSCLK, (the stop on HSI included), so they are at the wrong
+	clock only between the two calls.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/06/2018
+
+*/
+#include "clockProfile.h"
+#include "irqPriority.h"
+#include "i2cBus.h"
+
+extern UART_HandleTypeDef huart1;
+extern TIM_HandleTypeDef  htim3;
+
+/// Per profile: its oscillator and PLL set up, SYSCLK source, name for S[0x1F].
+static const struct {
+	uint32_t	oscillatorType;
+	uint32_t	hseState;
+	uint32_t	pllState;
+	uint32_t	pllSource;
+	uint32_t	pllMul;
+	uint32_t	sysclkSource;
+	const char	*name;
+} profileTable[CLOCKPROFILE_COUNT] = {
+	{ RCC_OSCILLATORTYPE_HSI, RCC_HSE_OFF, RCC_PLL_OFF, RCC_PLLSOURCE_HSI_DIV2, RCC_PLL_MUL6,
+	  RCC_SYSCLKSOURCE_HSI,		"HSI 8MHz"		},
+	{ RCC_OSCILLATORTYPE_HSI, RCC_HSE_OFF, RCC_PLL_ON,  RCC_PLLSOURCE_HSI_DIV2, RCC_PLL_MUL6,
+	  RCC_SYSCLKSOURCE_PLLCLK,	"HSI PLL 24MHz"	},
+	{ RCC_OSCILLATORTYPE_HSE, RCC_HSE_ON,  RCC_PLL_ON,  RCC_PLLSOURCE_HSE,		RCC_PLL_MUL3,
+	  RCC_SYSCLKSOURCE_PLLCLK,	"HSE PLL 24MHz"	}
+};
+
+/// Profile in use, switch counts.
+clockProfileStateStruct clockProfileState;
+
+
+/**
+ * @brief Put back what depends on PCLK1 / PCLK2 / HCLK, after SYSCLK moved.
+ */
+static void retime(void)
+{
+	RCC_PeriphCLKInitTypeDef periphClkInit;
+	uint32_t				 pclk2	= HAL_RCC_GetPCLK2Freq();
+	uint32_t				 bus;
+
+	huart1.Instance->BRR = UART_BRR_SAMPLING16(pclk2, huart1.Init.BaudRate);
+
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		HAL_I2C_Init(i2cBusState[bus].hi2c);
+	}
+
+	// Loaded at the next update, no extra TRGO, (no extra ADC scan).
+	htim3.Init.Prescaler = (HAL_RCC_GetPCLK1Freq() / 1000000) - 1;
+	__HAL_TIM_SET_PRESCALER(&htim3, htim3.Init.Prescaler);
+
+	if (pclk2 / 2 <= CLOCKPROFILE_ADC_MAX_HZ)
+	{
+		periphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV2;
+		clockProfileState.adcHz			= pclk2 / 2;
+	}
+	else if (pclk2 / 4 <= CLOCKPROFILE_ADC_MAX_HZ)
+	{
+		periphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV4;
+		clockProfileState.adcHz			= pclk2 / 4;
+	}
+	else if (pclk2 / 6 <= CLOCKPROFILE_ADC_MAX_HZ)
+	{
+		periphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV6;
+		clockProfileState.adcHz			= pclk2 / 6;
+	}
+	else
+	{
+		periphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV8;
+		clockProfileState.adcHz			= pclk2 / 8;
+	}
+	if (periphClkInit.AdcClockSelection != clockProfileState.adcPrescaler)
+	{
+		periphClkInit.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+		HAL_RCCEx_PeriphCLKConfig(&periphClkInit);
+		clockProfileState.adcPrescaler = periphClkInit.AdcClockSelection;
+	}
+
+	// HAL_RCC_ClockConfig(..) reloaded SysTick for 1 ms, at TICK_INT_PRIORITY.
+	irqPriorityApply();
+}
+
+/**
+ * @brief SYSCLK from source, all bus dividers 1, then retime().
+ */
+static bool selectSysclk(uint32_t sysclkSource)
+{
+	RCC_ClkInitTypeDef clkInit;
+	HAL_StatusTypeDef  status;
+
+	clkInit.ClockType	   = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clkInit.SYSCLKSource   = sysclkSource;
+	clkInit.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+	clkInit.APB1CLKDivider = RCC_HCLK_DIV1;
+	clkInit.APB2CLKDivider = RCC_HCLK_DIV1;
+	status = HAL_RCC_ClockConfig(&clkInit, FLASH_LATENCY_0);
+	retime();
+	return (status == HAL_OK);
+}
+
+/**
+ * @brief Oscillators and PLL for profile, SYSCLK from it.  Starts and ends on HSI if it fails.
+ */
+static bool applyProfile(enumClockProfile profile)
+{
+	RCC_OscInitTypeDef oscInit;
+
+	if (__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_HSI)
+	{
+		if (!selectSysclk(RCC_SYSCLKSOURCE_HSI))
+		{
+			return false;
+		}
+	}
+
+	oscInit.OscillatorType		= profileTable[profile].oscillatorType;
+	oscInit.HSEState			= profileTable[profile].hseState;
+	oscInit.HSEPredivValue		= RCC_HSE_PREDIV_DIV1;
+	oscInit.HSIState			= RCC_HSI_ON;
+	oscInit.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+	oscInit.LSEState			= RCC_LSE_OFF;
+	oscInit.LSIState			= RCC_LSI_OFF;
+	oscInit.PLL.PLLState		= profileTable[profile].pllState;
+	oscInit.PLL.PLLSource		= profileTable[profile].pllSource;
+	oscInit.PLL.PLLMUL			= profileTable[profile].pllMul;
+	if (HAL_RCC_OscConfig(&oscInit) != HAL_OK)
+	{
+		return false;
+	}
+
+	if ((profileTable[profile].sysclkSource != RCC_SYSCLKSOURCE_HSI) &&
+		!selectSysclk(profileTable[profile].sysclkSource))
+	{
+		return false;
+	}
+
+	if (profileTable[profile].hseState == RCC_HSE_OFF)
+	{
+		// HSE is no PLL source now, (HSI profile PLL off, HSI PLL profile HSI / 2).
+		oscInit.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+		oscInit.PLL.PLLState   = RCC_PLL_NONE;
+		HAL_RCC_OscConfig(&oscInit);
+	}
+	return true;
+}
+
+/**
+ * @brief Run from profile, USART1, I2C, TIM3, ADC and SysTick re-timed, (clockProfile.h).
+ *
+ * @returns false if a bus or the UART is busy, or the profile's oscillator did not start.
+ */
+bool clockProfileSet(enumClockProfile profile)
+{
+	enumClockProfile previous = clockProfileState.profile;
+	uint32_t		 startTick;
+	uint32_t		 ms;
+	uint32_t		 bus;
+	bool			 ok;
+
+	if (profile >= CLOCKPROFILE_COUNT)
+	{
+		return false;
+	}
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		if (!i2cBusIdle((enumI2CBus)bus) || (i2cBusState[bus].hi2c->State != HAL_I2C_STATE_READY))
+		{
+			clockProfileState.refused++;
+			return false;
+		}
+	}
+	if (huart1.gState != HAL_UART_STATE_READY)
+	{
+		clockProfileState.refused++;
+		return false;
+	}
+
+	startTick = HAL_GetTick();
+	ok = applyProfile(profile);
+	if (!ok)
+	{
+		if (profileTable[profile].hseState == RCC_HSE_ON)
+		{
+			clockProfileState.hseFailures++;
+		}
+		if (!applyProfile(previous))
+		{
+			previous = CLOCKPROFILE_HSI_8MHZ;		// Left on HSI.
+			selectSysclk(RCC_SYSCLKSOURCE_HSI);
+		}
+		profile = previous;
+	}
+	else
+	{
+		clockProfileState.switches++;
+	}
+	clockProfileState.profile = profile;
+	irqPriorityClear();
+
+	ms = HAL_GetTick() - startTick;
+	if (ms > clockProfileState.maxSwitchMs)
+	{
+		clockProfileState.maxSwitchMs = ms;
+	}
+	return ok;
+}
+
+const char *clockProfileName(enumClockProfile profile)
+{
+	return profileTable[profile].name;
+}
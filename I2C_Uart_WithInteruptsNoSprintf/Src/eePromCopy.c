@@ -0,0 +1,192 @@
+/**
+  @file eePromCopy.c
+  @brief Background copy between two serial eeproms, see eePromCopy.h
+<pre>
+	Flow per buffer, all after eeCopyStart(..) runs in I2C interrupt context:
+
+		read done		- queue the write of the same bytes on the destination bus.
+		write done		- queue the read of the next chunk not yet taken.
+
+	A failed transfer stops the copy, buffers still queued are let run out
+	and their results ignored, eeCopyBusy() stays true until they have.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/23/2018
+
+*/
+#include <string.h>
+#include "eePromCopy.h"
+#include "eePromCrc.h"
+
+typedef struct {
+	i2cBusXfer	xfer;
+	uint32_t	offset;					// From the range start.
+	uint8_t		data[AT24C_PAGE_SIZE];
+} copyBuffer;
+
+/// Copy in progress, or last one run.
+eeCopyStateStruct eeCopyState;
+
+static copyBuffer buffers[EECOPY_BUFFERS];
+
+
+static void copyFinished(enumEECopyState state)
+{
+	eeCopyState.endTick = HAL_GetTick();
+	eeCopyState.state	= state;
+}
+
+/**
+ * @brief Bytes from offset to the end of its destination page, or to the end of the range.
+ */
+static uint16_t chunkLengthAt(uint32_t offset)
+{
+	uint32_t dstAddr = eeCopyState.dstStart + offset;
+	uint32_t length	 = AT24C_PAGE_SIZE - (dstAddr & (AT24C_PAGE_SIZE - 1));
+
+	if (length > (eeCopyState.length - offset))
+	{
+		length = eeCopyState.length - offset;
+	}
+	return (uint16_t)length;
+}
+
+static void copyDone(i2cBusXfer *pXfer);
+
+/**
+ * @brief Queue a transfer for pBuffer, the copy fails if the queue is full.
+ */
+static void submit(copyBuffer *pBuffer, enumI2CBus bus)
+{
+	eeCopyState.inFlight++;
+	if (!i2cBusSubmit(bus, &pBuffer->xfer))
+	{
+		eeCopyState.inFlight--;
+		eeCopyState.errorCode = HAL_I2C_ERROR_OVR;
+		copyFinished(EECOPY_FAILED);
+	}
+}
+
+/**
+ * @brief Take the next chunk of the range into pBuffer and queue its read.
+ */
+static void startRead(copyBuffer *pBuffer)
+{
+	pBuffer->offset				= eeCopyState.readOffset;
+	pBuffer->xfer.devAddr7Bit	= eeCopyState.srcAddr7Bit;
+	pBuffer->xfer.isRead		= true;
+	pBuffer->xfer.memAddSize	= AT24C_MEMADD_SIZE;
+	pBuffer->xfer.memAddress	= (uint16_t)(eeCopyState.srcStart + pBuffer->offset);
+	pBuffer->xfer.pData			= pBuffer->data;
+	pBuffer->xfer.size			= chunkLengthAt(pBuffer->offset);
+	pBuffer->xfer.done			= copyDone;
+	pBuffer->xfer.pContext		= pBuffer;
+	eeCopyState.readOffset += pBuffer->xfer.size;
+
+	submit(pBuffer, eeCopyState.srcBus);
+}
+
+/**
+ * @brief i2cBus done handler, for reads and writes of every buffer.
+ */
+static void copyDone(i2cBusXfer *pXfer)
+{
+	copyBuffer *pBuffer = (copyBuffer *)pXfer->pContext;
+
+	eeCopyState.inFlight--;
+	if (eeCopyState.state != EECOPY_RUNNING)
+	{
+		return;
+	}
+	if (pXfer->errorCode != HAL_I2C_ERROR_NONE)
+	{
+		eeCopyState.errorCode = pXfer->errorCode;
+		copyFinished(EECOPY_FAILED);
+		return;
+	}
+
+	if (pXfer->isRead)
+	{
+		pXfer->isRead	   = false;
+		pXfer->devAddr7Bit = eeCopyState.dstAddr7Bit;
+		pXfer->memAddress  = (uint16_t)(eeCopyState.dstStart + pBuffer->offset);
+		submit(pBuffer, eeCopyState.dstBus);
+		return;
+	}
+
+	if (eeCopyState.dstBus == I2CBUS_EE)
+	{
+		eeCrcNoteWrite(eeCopyState.dstAddr7Bit, pXfer->memAddress, pBuffer->data, pXfer->size);
+	}
+	eeCopyState.bytesCopied += pXfer->size;
+	if (eeCopyState.bytesCopied >= eeCopyState.length)
+	{
+		copyFinished(EECOPY_DONE);
+	}
+	else if (eeCopyState.readOffset < eeCopyState.length)
+	{
+		startRead(pBuffer);
+	}
+}
+
+/**
+ * @brief Start a background copy, progress in eeCopyState.
+ *
+ * @param srcBus		- Bus, device and first byte to copy from.
+ * @param srcAddr7Bit
+ * @param srcStart
+ * @param dstBus		- Bus, device and first byte to copy to, (ranges on one part must not overlap).
+ * @param dstAddr7Bit
+ * @param dstStart
+ * @param length		- Bytes, both ranges within AT24C_DEVICE_BYTES.
+ *
+ * @returns true if started.
+ */
+bool eeCopyStart(enumI2CBus srcBus, enumAT24C_7BitAddr srcAddr7Bit, uint32_t srcStart,
+				 enumI2CBus dstBus, enumAT24C_7BitAddr dstAddr7Bit, uint32_t dstStart, uint32_t length)
+{
+	uint32_t primask;
+	uint32_t i;
+
+	if (eeCopyBusy() || (length == 0) || (srcBus >= I2CBUS_COUNT) || (dstBus >= I2CBUS_COUNT) ||
+		(srcStart + length > AT24C_DEVICE_BYTES) || (dstStart + length > AT24C_DEVICE_BYTES))
+	{
+		return false;
+	}
+
+	memset(&eeCopyState, 0, sizeof(eeCopyState));
+	eeCopyState.srcBus		= srcBus;
+	eeCopyState.srcAddr7Bit = srcAddr7Bit;
+	eeCopyState.srcStart	= srcStart;
+	eeCopyState.dstBus		= dstBus;
+	eeCopyState.dstAddr7Bit = dstAddr7Bit;
+	eeCopyState.dstStart	= dstStart;
+	eeCopyState.length		= length;
+	eeCopyState.startTick	= HAL_GetTick();
+	eeCopyState.state		= EECOPY_RUNNING;
+
+	// The first read may end before the second is queued, inFlight is shared with the callbacks.
+	primask = __get_PRIMASK();
+	__disable_irq();
+	for (i = 0; (i < EECOPY_BUFFERS) && (eeCopyState.readOffset < length); i++)
+	{
+		startRead(&buffers[i]);
+	}
+	__set_PRIMASK(primask);
+
+	return (eeCopyState.state != EECOPY_FAILED);
+}
+
+/**
+ * @brief true while the copy runs, or a stopped one still has transfers queued.
+ */
+bool eeCopyBusy(void)
+{
+	return (eeCopyState.state == EECOPY_RUNNING) || (eeCopyState.inFlight != 0);
+}
+
+uint32_t eeCopyElapsedMs(void)
+{
+	return ((eeCopyState.state == EECOPY_RUNNING) ? HAL_GetTick() : eeCopyState.endTick) - eeCopyState.startTick;
+}
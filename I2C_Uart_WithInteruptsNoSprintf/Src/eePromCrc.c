@@ -0,0 +1,412 @@
+/**
+  @file eePromCrc.c
+  @brief Per page CRC integrity layer for the serial eeprom, see eePromCrc.h
+<pre>
+	RAM use: 2 bytes per data page of CRCs, two page bitmaps and two
+	scan buffers of EECRC_READ_PAGES pages, (992 + 2 x 62 bytes + 256 bytes
+	on an AT24C256).
+
+	Page bitmaps:
+
+		changedMap		- written since last check, (incremental scan list).
+		unknownMap		- CRC not known, (partial write, or lost table page).
+
+	eeCrcNoteWrite(..) may run in I2C interrupt context (background fill),
+	so bitmap updates from main context are done with interrupts off.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/14/2018
+
+*/
+#include <string.h>
+#include "eePromCrc.h"
+
+/// Table must cover exactly the pages below it.
+typedef char eeCrcTableSizeCheck[(EECRC_TABLE_PAGES * EECRC_ENTRIES_PER_TABLE == EECRC_PAGE_COUNT) &&
+								 (EECRC_ENTRIES_PER_TABLE * 2 + 2 == AT24C_PAGE_SIZE) ? 1 : -1];
+
+/// tablePagesDirty has one bit per table page.
+typedef char eeCrcTablePagesCheck[(EECRC_TABLE_PAGES <= 16) ? 1 : -1];
+
+#define MAP_BYTES	((EECRC_PAGE_COUNT + 7) / 8)
+
+/// CRC-16 CCITT, one entry per nibble, (16 entries rather than 256 saves flash).
+static const uint16_t crcNibbleTable[16] =
+	{ 0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF };
+
+eeCrcStateStruct eeCrcState;
+
+static uint16_t pageCrc[EECRC_PAGE_COUNT];
+static uint8_t	changedMap[MAP_BYTES];
+static uint8_t	unknownMap[MAP_BYTES];
+static __IO uint16_t tablePagesDirty;		// Bit per table page needing a save.
+
+static uint8_t	scanBuffer[2][EECRC_READ_PAGES * AT24C_PAGE_SIZE];
+static uint8_t	tableBuffer[AT24C_PAGE_SIZE];
+
+/// Pages read by one scan transfer.
+typedef struct {
+	uint16_t firstPage;
+	uint16_t pageCount;
+} scanRun;
+
+
+/**
+ * @brief CRC-16 CCITT over pData, start with crc = 0xFFFF.
+ */
+uint16_t eeCrc16(const uint8_t *pData, uint32_t length, uint16_t crc)
+{
+	while (length--)
+	{
+		crc = (crc << 4) ^ crcNibbleTable[(crc >> 12) ^ (*pData >> 4)];
+		crc = (crc << 4) ^ crcNibbleTable[(crc >> 12) ^ (*pData & 0x0F)];
+		pData++;
+	}
+	return crc;
+}
+
+static bool mapTest(const uint8_t *map, uint16_t page)
+{
+	return (map[page >> 3] & (1 << (page & 7))) != 0;
+}
+
+static void mapSet(uint8_t *map, uint16_t page)
+{
+	map[page >> 3] |= (1 << (page & 7));
+}
+
+static void mapClear(uint8_t *map, uint16_t page)
+{
+	map[page >> 3] &= ~(1 << (page & 7));
+}
+
+static uint16_t mapCount(const uint8_t *map)
+{
+	uint16_t page;
+	uint16_t count = 0;
+
+	for (page = 0; page < EECRC_PAGE_COUNT; page++)
+	{
+		count += mapTest(map, page) ? 1 : 0;
+	}
+	return count;
+}
+
+/**
+ * @brief Save the table pages holding entries changed since the last save.
+ */
+static void saveTable(void)
+{
+	uint16_t t;
+	uint16_t i;
+	uint16_t crc;
+	uint16_t page;
+
+	for (t = 0; t < EECRC_TABLE_PAGES; t++)
+	{
+		if ((tablePagesDirty & (1 << t)) == 0)
+		{
+			continue;
+		}
+
+		// tableBuffer is still being sent by the previous write until the ack poll.
+		if (sEEPromAckPoll(EECRC_I2C_HANDLE, EECRC_DEV_ADDR) != HAL_OK)
+		{
+			return;
+		}
+
+		__disable_irq();
+		tablePagesDirty &= ~(1 << t);
+		for (i = 0; i < EECRC_ENTRIES_PER_TABLE; i++)
+		{
+			page = t * EECRC_ENTRIES_PER_TABLE + i;
+			// Unknown entries are saved as they are, the table page check still holds.
+			tableBuffer[2 * i]	   = (uint8_t)pageCrc[page];
+			tableBuffer[2 * i + 1] = (uint8_t)(pageCrc[page] >> 8);
+		}
+		__enable_irq();
+
+		crc = eeCrc16(tableBuffer, AT24C_PAGE_SIZE - 2, 0xFFFF);
+		tableBuffer[AT24C_PAGE_SIZE - 2] = (uint8_t)crc;
+		tableBuffer[AT24C_PAGE_SIZE - 1] = (uint8_t)(crc >> 8);
+
+		if (sEEPromBytesWrite(EECRC_I2C_HANDLE, EECRC_DEV_ADDR, (EECRC_TABLE_FIRST_PAGE + t) * AT24C_PAGE_SIZE,
+							  tableBuffer, AT24C_PAGE_SIZE) != HAL_OK)
+		{
+			// Saved again with the next scan, or the next change on this table page.
+			__disable_irq();
+			tablePagesDirty |= (1 << t);
+			__enable_irq();
+			eeCrcState.tableSaveErrors++;
+			continue;
+		}
+		eeCrcState.tablePagesSaved++;
+	}
+	sEEPromWaitForIdle(EECRC_I2C_HANDLE);
+}
+
+/**
+ * @brief Load the page CRC table from the eeprom, call once at startup.
+ * <pre>
+ *	Entries from a table page that fails its own check, (never saved or
+ *	torn), are unknown until the next scan learns them.
+ * </pre>
+ */
+void eeCrcInit(void)
+{
+	uint16_t t;
+	uint16_t i;
+	uint16_t page;
+	bool	 valid;
+
+	memset(changedMap, 0, sizeof(changedMap));
+	memset(unknownMap, 0, sizeof(unknownMap));
+	tablePagesDirty = 0;
+
+	for (t = 0; t < EECRC_TABLE_PAGES; t++)
+	{
+		valid = (sEEPromAckPoll(EECRC_I2C_HANDLE, EECRC_DEV_ADDR) == HAL_OK) &&
+				(sEEPromRandomAddrReadBytes(EECRC_I2C_HANDLE, EECRC_DEV_ADDR,
+											(EECRC_TABLE_FIRST_PAGE + t) * AT24C_PAGE_SIZE,
+											tableBuffer, AT24C_PAGE_SIZE) == HAL_OK) &&
+				(sEEPromWaitForIdle(EECRC_I2C_HANDLE) == HAL_OK) &&
+				(eeCrc16(tableBuffer, AT24C_PAGE_SIZE - 2, 0xFFFF) ==
+				 (tableBuffer[AT24C_PAGE_SIZE - 2] | ((uint16_t)tableBuffer[AT24C_PAGE_SIZE - 1] << 8)));
+
+		for (i = 0; i < EECRC_ENTRIES_PER_TABLE; i++)
+		{
+			page = t * EECRC_ENTRIES_PER_TABLE + i;
+			pageCrc[page] = tableBuffer[2 * i] | ((uint16_t)tableBuffer[2 * i + 1] << 8);
+			if (!valid)
+			{
+				mapSet(unknownMap, page);
+			}
+		}
+	}
+	eeCrcState.loaded = true;
+}
+
+/**
+ * @brief Record a write to the eeprom, called by the driver when the write is started.
+ *
+ * @param addr7Bit	- Device written, only EECRC_DEV_ADDR is covered.
+ * @param EEaddress	- First byte written.
+ * @param pData		- Data written.
+ * @param length	- Bytes written, (a page write stays within one page).
+ */
+void eeCrcNoteWrite(enumAT24C_7BitAddr addr7Bit, uint32_t EEaddress, const uint8_t *pData, uint32_t length)
+{
+	uint16_t page = (uint16_t)(EEaddress / AT24C_PAGE_SIZE);
+	bool	 wholePage = ((EEaddress & (AT24C_PAGE_SIZE - 1)) == 0) && (length == AT24C_PAGE_SIZE);
+	uint16_t crc = 0;
+	uint32_t primask;
+
+	if ((addr7Bit != EECRC_DEV_ADDR) || (page >= EECRC_PAGE_COUNT) || !eeCrcState.loaded)
+	{
+		return;
+	}
+
+	if (wholePage)
+	{
+		crc = eeCrc16(pData, AT24C_PAGE_SIZE, 0xFFFF);
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (wholePage)
+	{
+		pageCrc[page] = crc;
+		mapClear(unknownMap, page);
+		tablePagesDirty |= (1 << (page / EECRC_ENTRIES_PER_TABLE));
+	}
+	else
+	{
+		mapSet(unknownMap, page);
+	}
+	mapSet(changedMap, page);
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Find the next block of pages to read, (up to EECRC_READ_PAGES, contiguous).
+ */
+static bool nextRun(uint16_t *pCursor, bool changedOnly, scanRun *pRun)
+{
+	uint16_t page = *pCursor;
+
+	while ((page < EECRC_PAGE_COUNT) && changedOnly && !mapTest(changedMap, page))
+	{
+		page++;
+	}
+	if (page >= EECRC_PAGE_COUNT)
+	{
+		return false;
+	}
+
+	pRun->firstPage = page;
+	pRun->pageCount = 0;
+	while ((page < EECRC_PAGE_COUNT) && (pRun->pageCount < EECRC_READ_PAGES) &&
+		   (!changedOnly || mapTest(changedMap, page)))
+	{
+		page++;
+		pRun->pageCount++;
+	}
+	*pCursor = page;
+	return true;
+}
+
+static HAL_StatusTypeDef startRun(const scanRun *pRun, uint8_t *pBuffer)
+{
+	return sEEPromRandomAddrReadBytes(EECRC_I2C_HANDLE, EECRC_DEV_ADDR, pRun->firstPage * AT24C_PAGE_SIZE,
+									  pBuffer, (uint8_t)(pRun->pageCount * AT24C_PAGE_SIZE));
+}
+
+/**
+ * @brief Check (or learn) the CRC of each page in a block just read.
+ */
+static void checkRun(const scanRun *pRun, const uint8_t *pBuffer, eeCrcBadPageHandler handler)
+{
+	uint16_t i;
+	uint16_t page;
+	uint16_t crc;
+	uint16_t expected;
+	bool	 bad;
+
+	for (i = 0; i < pRun->pageCount; i++)
+	{
+		page = pRun->firstPage + i;
+		crc	 = eeCrc16(&pBuffer[i * AT24C_PAGE_SIZE], AT24C_PAGE_SIZE, 0xFFFF);
+		bad	 = false;
+
+		__disable_irq();
+		expected = pageCrc[page];
+		if (mapTest(unknownMap, page))
+		{
+			pageCrc[page] = crc;
+			mapClear(unknownMap, page);
+			tablePagesDirty |= (1 << (page / EECRC_ENTRIES_PER_TABLE));
+			eeCrcState.lastScanLearned++;
+		}
+		else if (crc != expected)
+		{
+			// Keep the expected CRC, so the page stays bad until rewritten or relearned.
+			bad = true;
+		}
+		mapClear(changedMap, page);
+		__enable_irq();
+
+		if (bad)
+		{
+			eeCrcState.lastScanBad++;
+			if (handler != NULL)
+			{
+				handler(page, expected, crc);
+			}
+		}
+		eeCrcState.lastScanPages++;
+	}
+}
+
+/**
+ * @brief Read pages back and check them against their CRCs.
+ * <pre>
+ *	Blocking.  The next block is read by the I2C interrupts while the
+ *	block before it is checked, so the bus is kept busy the whole scan.
+ *
+ *	Pages with unknown CRC are learned, (taken as good).  At the end the
+ *	table pages with changed entries are saved.
+ * </pre>
+ *
+ * @param changedOnly	- true for pages written since their last check only.
+ * @param handler		- Called for each bad page, may be NULL.
+ *
+ * @returns Number of bad pages found.
+ */
+uint32_t eeCrcScan(bool changedOnly, eeCrcBadPageHandler handler)
+{
+	scanRun	 run[2];
+	uint16_t cursor = 0;
+	uint8_t	 current = 0;
+	bool	 have;
+	bool	 haveNext;
+	bool	 started[2];			// The read of run[n] got going, (else scanBuffer[n] is stale).
+	bool	 readOk;
+	uint32_t startTick = HAL_GetTick();
+
+	eeCrcState.lastScanPages   = 0;
+	eeCrcState.lastScanBad	   = 0;
+	eeCrcState.lastScanLearned = 0;
+
+	// Any write in tWR must finish before the first read.
+	if (sEEPromAckPoll(EECRC_I2C_HANDLE, EECRC_DEV_ADDR) != HAL_OK)
+	{
+		eeCrcState.readErrors++;
+		return 0;
+	}
+
+	have = nextRun(&cursor, changedOnly, &run[current]);
+	if (have)
+	{
+		started[current] = (startRun(&run[current], scanBuffer[current]) == HAL_OK);
+	}
+
+	while (have)
+	{
+		readOk	 = (sEEPromWaitForIdle(EECRC_I2C_HANDLE) == HAL_OK) && started[current];
+		haveNext = nextRun(&cursor, changedOnly, &run[current ^ 1]);
+		if (haveNext)
+		{
+			started[current ^ 1] = (startRun(&run[current ^ 1], scanBuffer[current ^ 1]) == HAL_OK);
+		}
+
+		if (readOk)
+		{
+			checkRun(&run[current], scanBuffer[current], handler);
+		}
+		else
+		{
+			// Pages stay changed, next incremental check reads them again.
+			eeCrcState.readErrors++;
+		}
+		current ^= 1;
+		have = haveNext;
+	}
+
+	saveTable();
+	eeCrcState.lastScanMs = HAL_GetTick() - startTick;
+
+	return eeCrcState.lastScanBad;
+}
+
+/**
+ * @brief Take the present eeprom contents as good, learn every page CRC.
+ *
+ * @returns Pages learned.
+ */
+uint32_t eeCrcRelearn(void)
+{
+	__disable_irq();
+	memset(unknownMap, 0xFF, sizeof(unknownMap));
+	__enable_irq();
+
+	eeCrcScan(false, NULL);
+	return eeCrcState.lastScanLearned;
+}
+
+/**
+ * @brief Pages written since their last check.
+ */
+uint16_t eeCrcChangedPages(void)
+{
+	return mapCount(changedMap);
+}
+
+/**
+ * @brief Pages with no known CRC.
+ */
+uint16_t eeCrcUnknownPages(void)
+{
+	return mapCount(unknownMap);
+}
@@ -0,0 +1,318 @@
+/**
+  @file eePromFill.c
+  @brief Background fill / erase of any serial eeprom address range, see eePromFill.h
+<pre>
+	The range is cut into chunks that never cross a page boundary, (a page
+	write rolls over inside its page), so only the first and last chunk of
+	an unaligned range are short.  A whole part fill is AT24C_PAGE_COUNT page
+	writes, (512 on a 32K AT24C256), and takes about that x (tWR + page transfer time).
+
+	Flow, all after eeFillStart(..) runs in I2C interrupt context:
+
+		eeFillStart			- ack poll, start first chunk write.
+		MemTxCplt			- next chunk write, (or first verify read).
+		Error, AF			- part still in tWR, start the same chunk again,
+							  (HAL_I2C_ErrorCallback(..) has sent the STOP).
+		MemRxCplt			- compare chunk with pattern, next verify read.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/12/2018
+
+*/
+#include <string.h>
+#include "eePromFill.h"
+#include "eePromCrc.h"
+#include "i2cTrace.h"
+
+/// Pattern tables are built for the largest page, see SEE_MAX_PAGE_SIZE.
+typedef char eeFillPageSizeCheck[(SEE_MAX_PAGE_SIZE == 128) ? 1 : -1];
+
+#define ROW8(n)		(n), (n) + 1, (n) + 2, (n) + 3, (n) + 4, (n) + 5, (n) + 6, (n) + 7
+#define RROW8(n)	(n), (n) - 1, (n) - 2, (n) - 3, (n) - 4, (n) - 5, (n) - 6, (n) - 7
+#define ROW64(n)	ROW8(n), ROW8((n) + 0x08), ROW8((n) + 0x10), ROW8((n) + 0x18), \
+					ROW8((n) + 0x20), ROW8((n) + 0x28), ROW8((n) + 0x30), ROW8((n) + 0x38)
+#define RROW64(n)	RROW8(n), RROW8((n) - 0x08), RROW8((n) - 0x10), RROW8((n) - 0x18), \
+					RROW8((n) - 0x20), RROW8((n) - 0x28), RROW8((n) - 0x30), RROW8((n) - 0x38)
+#define FF8			0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+#define FF64		FF8, FF8, FF8, FF8, FF8, FF8, FF8, FF8
+
+/// One const page per enumArrayFillType, same data as sEEPromPageBufferFill(..) gives.
+static const uint8_t fillPattern0[SEE_MAX_PAGE_SIZE] = { 0 };
+static const uint8_t fillPatternFF[SEE_MAX_PAGE_SIZE] = { FF64, FF64 };
+static const uint8_t fillPatternIndex[SEE_MAX_PAGE_SIZE] = { ROW64(0x00), ROW64(0x40) };
+static const uint8_t fillPatternReverse[SEE_MAX_PAGE_SIZE] = { RROW64(0x7F), RROW64(0x3F) };
+
+/// Reverse index counts down to 0 at the end of a page, so use its last AT24C_PAGE_SIZE bytes.
+static const uint8_t * const fillPatterns[] =
+	{ fillPattern0, fillPatternFF, fillPatternIndex, &fillPatternReverse[SEE_MAX_PAGE_SIZE - AT24C_PAGE_SIZE] };
+
+/// Fill in progress, or last one run.
+eeFillStateStruct eeFillState;
+
+/// Verify reads land here.
+static uint8_t verifyBuffer[AT24C_PAGE_SIZE];
+
+
+/**
+ * @brief Pattern bytes for the chunk at addr, (patterns are page aligned).
+ */
+static const uint8_t *chunkPattern(uint32_t addr)
+{
+	return &fillPatterns[eeFillState.fillType][addr & (AT24C_PAGE_SIZE - 1)];
+}
+
+/**
+ * @brief Bytes from addr to the end of its page, or to the end of the range.
+ */
+static uint16_t chunkLengthAt(uint32_t addr)
+{
+	uint32_t length = AT24C_PAGE_SIZE - (addr & (AT24C_PAGE_SIZE - 1));
+
+	if (length > (eeFillState.endAddr - addr))
+	{
+		length = eeFillState.endAddr - addr;
+	}
+	return (uint16_t)length;
+}
+
+/**
+ * @brief Start the write or verify read of the chunk at eeFillState.nextAddr.
+ *
+ * @param retry - Same chunk again after a NACK, (traced as an ack poll of the first try).
+ */
+static HAL_StatusTypeDef startChunk(bool retry)
+{
+	uint16_t		  HAL_DevAddr = ((uint16_t)eeFillState.addr7Bit << 1);
+	uint32_t		  addr		  = eeFillState.nextAddr;
+	bool			  writing	  = (eeFillState.state == EEFILL_WRITING);
+	HAL_StatusTypeDef status;
+
+	eeFillState.chunkLength = chunkLengthAt(addr);
+
+	if (retry)
+	{
+		i2cTraceRetry(eeFillState.hi2c);
+	}
+	else
+	{
+		i2cTraceBegin(eeFillState.hi2c, writing ? I2CTRACE_MEM_WRITE : I2CTRACE_MEM_READ, HAL_DevAddr,
+					  (uint16_t)addr, eeFillState.chunkLength);
+	}
+
+	if (writing)
+	{
+		// HAL wants a non const pointer, but only reads from it for a write.
+		status = HAL_I2C_Mem_Write_IT(eeFillState.hi2c, HAL_DevAddr, (uint16_t)addr, AT24C_MEMADD_SIZE,
+									  (uint8_t *)chunkPattern(addr), eeFillState.chunkLength);
+	}
+	else
+	{
+		status = HAL_I2C_Mem_Read_IT(eeFillState.hi2c, HAL_DevAddr, (uint16_t)addr, AT24C_MEMADD_SIZE,
+									 verifyBuffer, eeFillState.chunkLength);
+	}
+	if (status != HAL_OK)
+	{
+		i2cTraceDone(eeFillState.hi2c, status);
+	}
+	return status;
+}
+
+static void fillFinished(enumEEFillState state)
+{
+	eeFillState.endTick = HAL_GetTick();
+	eeFillState.state	= state;
+}
+
+/**
+ * @brief Chunk completed, move on to the next one, or the next phase.
+ */
+static void nextChunk(void)
+{
+	eeFillState.chunksDone++;
+	eeFillState.nextAddr += eeFillState.chunkLength;
+
+	if (eeFillState.nextAddr >= eeFillState.endAddr)
+	{
+		if ((eeFillState.state == EEFILL_WRITING) && eeFillState.verify)
+		{
+			// First read is NACKed until the last write's tWR is over, that is fine.
+			eeFillState.state	 = EEFILL_VERIFYING;
+			eeFillState.nextAddr = eeFillState.startAddr;
+		}
+		else
+		{
+			fillFinished(EEFILL_DONE);
+			return;
+		}
+	}
+
+	eeFillState.chunkTick = HAL_GetTick();
+	if (startChunk(false) != HAL_OK)
+	{
+		eeFillState.errorCode = eeFillState.hi2c->ErrorCode;
+		fillFinished(EEFILL_FAILED);
+	}
+}
+
+/**
+ * @brief Start filling an eeprom address range with one of the page patterns.
+ * <pre>
+ *	Returns as soon as the first page write is started, the rest runs from
+ *	the I2C callbacks.  Watch eeFillState.state, or eeFillBusy(), for the end.
+ *
+ *	FILL_FF is an erase, (blank part reads 0xFF).
+ *
+ *	Without verify the last page is still in tWR at EEFILL_DONE, so
+ *	sEEPromAckPoll(..) before the next access, (as after any write).
+ * </pre>
+ *
+ * @param hi2c		- I2C handle of the bus the eeprom is on.
+ * @param addr7Bit	- 7 bit eeprom device address.
+ * @param startAddr	- First byte to fill, any alignment.
+ * @param length	- Bytes to fill, startAddr + length <= AT24C_DEVICE_BYTES.
+ * @param fillType	- Pattern, as sEEPromPageBufferFill(..) uses.
+ * @param verify	- Read the range back and compare when all writes are done.
+ *
+ * @returns true if fill started, false if already running, bad range or the first write failed.
+ */
+bool eeFillStart(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint32_t startAddr, uint32_t length,
+				 enumArrayFillType fillType, bool verify)
+{
+	uint32_t chunks;
+	uint32_t addr;
+
+	if (eeFillBusy() || (length == 0) || (startAddr >= AT24C_DEVICE_BYTES) ||
+		(length > (AT24C_DEVICE_BYTES - startAddr)) || ((uint32_t)fillType > FILL_REVERSE_INDEX))
+	{
+		return false;
+	}
+
+	// Previous non blocking access and its tWR must be over before we own the bus.
+	if (sEEPromAckPoll(hi2c, addr7Bit) != HAL_OK)
+	{
+		return false;
+	}
+
+	memset(&eeFillState, 0, sizeof(eeFillState));
+	eeFillState.hi2c	  = hi2c;
+	eeFillState.addr7Bit  = addr7Bit;
+	eeFillState.fillType  = fillType;
+	eeFillState.verify	  = verify;
+	eeFillState.startAddr = startAddr;
+	eeFillState.endAddr	  = startAddr + length;
+	eeFillState.nextAddr  = startAddr;
+
+	// Chunks: pages touched by the range.
+	chunks = 0;
+	for (addr = startAddr; addr < eeFillState.endAddr; addr += chunkLengthAt(addr))
+	{
+		chunks++;
+	}
+	eeFillState.chunksTotal = verify ? (2 * chunks) : chunks;
+
+	eeFillState.startTick = HAL_GetTick();
+	eeFillState.chunkTick = eeFillState.startTick;
+	eeFillState.state	  = EEFILL_WRITING;
+
+	if (startChunk(false) != HAL_OK)
+	{
+		eeFillState.errorCode = hi2c->ErrorCode;
+		fillFinished(EEFILL_FAILED);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief true while a fill is writing or verifying.
+ */
+bool eeFillBusy(void)
+{
+	return (eeFillState.state == EEFILL_WRITING) || (eeFillState.state == EEFILL_VERIFYING);
+}
+
+/**
+ * @brief Progress of fill in progress, (or the last one), 0..100.
+ */
+uint32_t eeFillPercentDone(void)
+{
+	if (eeFillState.chunksTotal == 0)
+	{
+		return 0;
+	}
+	return (eeFillState.chunksDone * 100) / eeFillState.chunksTotal;
+}
+
+/**
+ * @brief ms since fill started, or total time once it has finished.
+ */
+uint32_t eeFillElapsedMs(void)
+{
+	return (eeFillBusy() ? HAL_GetTick() : eeFillState.endTick) - eeFillState.startTick;
+}
+
+/**
+ * @brief Page write done, (STOP sent, tWR starting).
+ */
+bool eeFillOnTxCplt(I2C_HandleTypeDef *hi2c)
+{
+	if ((hi2c != eeFillState.hi2c) || (eeFillState.state != EEFILL_WRITING))
+	{
+		return false;
+	}
+	eeCrcNoteWrite(eeFillState.addr7Bit, eeFillState.nextAddr, chunkPattern(eeFillState.nextAddr),
+				   eeFillState.chunkLength);
+	nextChunk();
+	return true;
+}
+
+/**
+ * @brief Verify read done, compare it against the pattern.
+ */
+bool eeFillOnRxCplt(I2C_HandleTypeDef *hi2c)
+{
+	if ((hi2c != eeFillState.hi2c) || (eeFillState.state != EEFILL_VERIFYING))
+	{
+		return false;
+	}
+
+	if (memcmp(verifyBuffer, chunkPattern(eeFillState.nextAddr), eeFillState.chunkLength) != 0)
+	{
+		if (eeFillState.verifyErrors == 0)
+		{
+			eeFillState.firstBadAddr = eeFillState.nextAddr;
+		}
+		eeFillState.verifyErrors++;
+	}
+	nextChunk();
+	return true;
+}
+
+/**
+ * @brief Transfer failed.  A NACK (AF) means the part is still in tWR,
+ *        so try the same chunk again, that is the ack poll.
+ */
+bool eeFillOnError(I2C_HandleTypeDef *hi2c)
+{
+	if ((hi2c != eeFillState.hi2c) || !eeFillBusy())
+	{
+		return false;
+	}
+
+	// The bus is still BUSY only if the STOP after the NACK did not go out, a start would spin 25ms on it here.
+	if ((hi2c->ErrorCode == HAL_I2C_ERROR_AF) &&
+		((HAL_GetTick() - eeFillState.chunkTick) <= EEFILL_CHUNK_TIMEOUT_MS) &&
+		(__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY) == RESET))
+	{
+		eeFillState.ackPolls++;
+		if (startChunk(true) == HAL_OK)
+		{
+			return true;
+		}
+	}
+
+	eeFillState.errorCode = hi2c->ErrorCode;
+	fillFinished(EEFILL_FAILED);
+	return true;
+}
@@ -0,0 +1,471 @@
+/**
+  @file eePromLog.c
+  @brief Power fail safe circular record log, kept in serial eeprom pages.
+<pre>
+	Records (temperature samples, event codes) are batched in RAM and
+	committed to the eeprom one whole page at a time, so each commit costs
+	a single page write and a single tWR.
+
+	Every committed page carries a sequence number which is one more than
+	the page before it.  The ring is written in page order, so reading the
+	sequence numbers around the ring gives:
+
+		page:	0    1    2  ...  h   h+1 ...  N-1
+		seq:	S0  S0+1 S0+2   S0+h  old ...  old		(old < S0, or page blank)
+
+	"valid and seq >= S0" is true for pages 0..h and false after, so the head
+	(newest page h) is found by binary search, about 9 page reads for
+	480 pages, instead of a full scan.  The tail (oldest) is the first valid
+	page after the head, or page 0 if the ring has not wrapped yet.
+
+	A page torn by power loss during its write fails the CRC-8 check byte
+	and is treated like a blank page.
+
+	Record times are kept in ms "log time", which is the newest time found
+	at power up plus HAL_GetTick(), so times keep increasing across power
+	cycles and a time range query can also binary search the ring.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/08/2018
+
+*/
+#include <stddef.h>
+#include <string.h>
+#include "eePromLog.h"
+#include "serialEEProm.h"
+
+/// eeLogReadPage(..) result, a page that could not be read says nothing about the log.
+typedef enum eLogPageRead
+			{ EELOG_PAGE_VALID, EELOG_PAGE_INVALID, EELOG_PAGE_READ_ERROR }
+			enumLogPageRead;
+
+/// Log state, recovered at power up.
+eeLogStateStruct eeLogState;
+
+/// Records collecting in RAM, until a page full (or flush).
+static eeLogPage fillPage;
+
+/// Page being written, must stay untouched until non blocking write is done.
+static eeLogPage commitPage;
+
+/// Scratch page for mount and query reads.
+static eeLogPage readPage;
+
+// Compile time check: eeLogPage must be exactly one eeprom page.
+typedef char eeLogPageSizeCheck[(sizeof(eeLogPage) == AT24C_PAGE_SIZE) ? 1 : -1];
+
+
+/**
+ * @brief CRC-8 (poly 0x07) over a page, with the check byte taken as 0.
+ *
+ * @param pPage - page to check.
+ * @returns CRC-8 value.
+ */
+static uint8_t eeLogPageCrc(const eeLogPage *pPage)
+{
+	const uint8_t *pBytes = (const uint8_t *)pPage;
+	uint8_t crc = 0;
+	uint32_t i;
+	uint32_t bit;
+
+	for (i = 0; i < sizeof(eeLogPage); i++)
+	{
+		crc ^= (i == offsetof(eeLogPage, check)) ? 0 : pBytes[i];
+
+		for (bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief Check magic, record count and CRC of a page read back from eeprom.
+ */
+static bool eeLogPageIsValid(const eeLogPage *pPage)
+{
+	return (pPage->magic == EELOG_PAGE_MAGIC) &&
+		   (pPage->recordCount >= 1) &&
+		   (pPage->recordCount <= EELOG_RECORDS_PER_PAGE) &&
+		   (pPage->check == eeLogPageCrc(pPage));
+}
+
+/**
+ * @brief Eeprom byte address of a page in the log region.
+ */
+static uint16_t eeLogPageAddress(uint16_t logPage)
+{
+	return (uint16_t)((EELOG_FIRST_PAGE + logPage) * AT24C_PAGE_SIZE);
+}
+
+/**
+ * @brief Read one log page into pPage (blocking), and check it.
+ *
+ * @param logPage - page index in the log region, 0..EELOG_PAGE_COUNT-1
+ * @param pPage	  - destination.
+ * @returns EELOG_PAGE_VALID, EELOG_PAGE_INVALID if blank or torn, EELOG_PAGE_READ_ERROR if not read, (I2C).
+ */
+static enumLogPageRead eeLogReadPage(uint16_t logPage, eeLogPage *pPage)
+{
+	// Previous page commit may still be in its tWR.
+	if (sEEPromAckPoll(EELOG_I2C_HANDLE, EELOG_DEV_ADDR) != HAL_OK)
+	{
+		return EELOG_PAGE_READ_ERROR;
+	}
+
+	if (sEEPromRandomAddrReadBytes(EELOG_I2C_HANDLE, EELOG_DEV_ADDR, eeLogPageAddress(logPage),
+								   (uint8_t *)pPage, (uint8_t)AT24C_PAGE_SIZE) != HAL_OK)
+	{
+		return EELOG_PAGE_READ_ERROR;
+	}
+
+	if (sEEPromWaitForIdle(EELOG_I2C_HANDLE) != HAL_OK)
+	{
+		return EELOG_PAGE_READ_ERROR;
+	}
+
+	return eeLogPageIsValid(pPage) ? EELOG_PAGE_VALID : EELOG_PAGE_INVALID;
+}
+
+/**
+ * @brief eeLogReadPage(..) into readPage for eeLogInit(..), a read error tried again up to EELOG_MOUNT_TRIES times.
+ *
+ * @param logPage - page index in the log region.
+ * @param pError  - set if the page could not be read, (left alone otherwise).
+ * @returns true if the page is a valid log page.
+ */
+static bool eeLogMountReadPage(uint16_t logPage, bool *pError)
+{
+	enumLogPageRead result = EELOG_PAGE_READ_ERROR;
+	uint8_t			tries;
+
+	for (tries = 0; (tries < EELOG_MOUNT_TRIES) && (result == EELOG_PAGE_READ_ERROR); tries++)
+	{
+		result = eeLogReadPage(logPage, &readPage);
+	}
+	if (result == EELOG_PAGE_READ_ERROR)
+	{
+		*pError = true;
+	}
+	return (result == EELOG_PAGE_VALID);
+}
+
+/**
+ * @brief Find head and tail of the log after power up.
+ * <pre>
+ *	Call once after I2C is initialized, before any other eeLog function.
+ *	Leaves eeLogState describing the committed pages, and log time
+ *	continuing from the newest record found.
+ *
+ *	Only a page read back blank or torn steers the search.  One that can
+ *	not be read, (part absent or NACKing past its retries), would look
+ *	the same and put the head on an older page, or mount a full log as
+ *	empty, and the next commit would reuse sequence numbers.  So any such
+ *	page leaves the log unmounted, (eeLogState.mounted false).
+ * </pre>
+ */
+void eeLogInit(void)
+{
+	uint16_t lo;
+	uint16_t hi;
+	uint16_t mid;
+	uint16_t next;
+	uint32_t refSeq;
+	bool	 found = false;
+	bool	 valid;
+	bool	 readError = false;
+
+	memset(&eeLogState, 0, sizeof(eeLogState));
+	memset(&fillPage, 0, sizeof(fillPage));
+
+	valid = eeLogMountReadPage(0, &readError);
+	if (readError)
+	{
+		return;
+	}
+	if (valid)
+	{
+		// Binary search for the last page with "valid && seq >= S0".
+		refSeq = readPage.seq;
+		lo = 0;
+		hi = EELOG_PAGE_COUNT - 1;
+
+		while (lo < hi)
+		{
+			mid = (uint16_t)((lo + hi + 1) / 2);
+
+			valid = eeLogMountReadPage(mid, &readError);
+			if (readError)
+			{
+				return;
+			}
+			if (valid && ((int32_t)(readPage.seq - refSeq) >= 0))
+			{
+				lo = mid;
+			}
+			else
+			{
+				hi = mid - 1;
+			}
+		}
+		eeLogState.headPage = lo;
+		found = true;
+	}
+	else
+	{
+		valid = eeLogMountReadPage(EELOG_PAGE_COUNT - 1, &readError);
+		if (readError)
+		{
+			return;
+		}
+		if (valid)
+		{
+			// Page 0 torn (or blank) just as the ring wrapped, newest is the last page.
+			eeLogState.headPage = EELOG_PAGE_COUNT - 1;
+			found = true;
+		}
+	}
+
+	if (found)
+	{
+		// Reload head page, to pick up its sequence number and newest record time,
+		// (readPage is otherwise the last page the search probed, an older one).
+		if (!eeLogMountReadPage(eeLogState.headPage, &readError))
+		{
+			// Unmounted, committing now would reuse sequence numbers.
+			return;
+		}
+		eeLogState.nextSeq  = readPage.seq + 1;
+		eeLogState.timeBase = readPage.record[readPage.recordCount - 1].time + 1;
+
+		// Tail is first valid page after the head, (skipping one torn page), or page 0.
+		eeLogState.tailPage = 0;
+		for (next = 1; next <= 2; next++)
+		{
+			mid = (uint16_t)((eeLogState.headPage + next) % EELOG_PAGE_COUNT);
+
+			if (mid == eeLogState.headPage)
+			{
+				continue;
+			}
+			valid = eeLogMountReadPage(mid, &readError);
+			if (readError)
+			{
+				return;
+			}
+			if (valid)
+			{
+				eeLogState.tailPage = mid;
+				break;
+			}
+		}
+
+		eeLogState.pageCount = (uint16_t)(((eeLogState.headPage + EELOG_PAGE_COUNT - eeLogState.tailPage)
+										   % EELOG_PAGE_COUNT) + 1);
+	}
+
+	eeLogState.mounted = true;
+}
+
+/**
+ * @brief Present log time in ms.
+ */
+uint32_t eeLogNow(void)
+{
+	return eeLogState.timeBase + HAL_GetTick();
+}
+
+/**
+ * @brief Commit the RAM page (if it has any records) to the next page of the ring.
+ * <pre>
+ *	Blocks only while a previous commit is still in its write cycle, the
+ *	page write itself is started non blocking.
+ * </pre>
+ *
+ * @returns true if page write was started, (or there was nothing to commit).
+ */
+static bool eeLogCommit(void)
+{
+	uint16_t nextPage;
+
+	if (fillPage.recordCount == 0)
+	{
+		return true;
+	}
+
+	// Head not found at init, the next sequence number is not known.
+	if (!eeLogState.mounted)
+	{
+		eeLogState.commitErrors++;
+		return false;
+	}
+
+	// Previous commit still writing ?
+	if (sEEPromAckPoll(EELOG_I2C_HANDLE, EELOG_DEV_ADDR) != HAL_OK)
+	{
+		eeLogState.commitErrors++;
+		return false;
+	}
+
+	nextPage = (eeLogState.pageCount == 0) ? 0 :
+				(uint16_t)((eeLogState.headPage + 1) % EELOG_PAGE_COUNT);
+
+	commitPage = fillPage;
+	commitPage.magic = EELOG_PAGE_MAGIC;
+	commitPage.seq	 = eeLogState.nextSeq;
+	commitPage.check = eeLogPageCrc(&commitPage);
+
+	if (sEEPromBytesWrite(EELOG_I2C_HANDLE, EELOG_DEV_ADDR, eeLogPageAddress(nextPage),
+						  (uint8_t *)&commitPage, (uint16_t)AT24C_PAGE_SIZE) != HAL_OK)
+	{
+		eeLogState.commitErrors++;
+		return false;
+	}
+
+	// Ring bookkeeping, oldest page is dropped once the ring is full.
+	if (eeLogState.pageCount == EELOG_PAGE_COUNT)
+	{
+		eeLogState.tailPage = (uint16_t)((eeLogState.tailPage + 1) % EELOG_PAGE_COUNT);
+	}
+	else
+	{
+		eeLogState.pageCount++;
+	}
+	eeLogState.headPage = nextPage;
+	eeLogState.nextSeq++;
+	eeLogState.pagesCommitted++;
+
+	memset(&fillPage, 0, sizeof(fillPage));
+
+	return true;
+}
+
+/**
+ * @brief Add one record to the log.
+ * <pre>
+ *	Record is stamped with eeLogNow() and kept in RAM, the RAM page is
+ *	committed to eeprom when it fills.  Call from main loop, not an ISR.
+ * </pre>
+ *
+ * @param type	- record type.
+ * @param code	- ADC channel, or event code.
+ * @param value	- ADC reading, or event parameter.
+ *
+ * @returns false if a full page could not be committed, (record is still kept).
+ */
+bool eeLogAppend(enumLogRecordType type, uint8_t code, uint16_t value)
+{
+	eeLogRecord *pRecord;
+
+	// RAM page still full from a failed commit ? Try again first.
+	if ((fillPage.recordCount >= EELOG_RECORDS_PER_PAGE) && !eeLogCommit())
+	{
+		return false;
+	}
+
+	pRecord = &fillPage.record[fillPage.recordCount++];
+	pRecord->time  = eeLogNow();
+	pRecord->type  = (uint8_t)type;
+	pRecord->code  = code;
+	pRecord->value = value;
+
+	if (fillPage.recordCount == EELOG_RECORDS_PER_PAGE)
+	{
+		return eeLogCommit();
+	}
+	return true;
+}
+
+/**
+ * @brief Commit records waiting in RAM now, as a partial page.
+ */
+bool eeLogFlush(void)
+{
+	return eeLogCommit();
+}
+
+/**
+ * @brief Number of records in RAM not yet committed to eeprom.
+ */
+uint8_t eeLogPendingRecords(void)
+{
+	return fillPage.recordCount;
+}
+
+/**
+ * @brief Pass each record with timeStart <= time <= timeEnd to handler, oldest first.
+ * <pre>
+ *	Binary searches the committed pages for the last page starting at or
+ *	before timeStart, then reads pages in order until a page starts after
+ *	timeEnd.  Records still in RAM are included at the end.
+ * </pre>
+ *
+ * @param timeStart	- log time, ms.
+ * @param timeEnd	- log time, ms.
+ * @param handler	- called for every matching record.
+ *
+ * @returns number of records passed to handler.
+ */
+uint32_t eeLogQuery(uint32_t timeStart, uint32_t timeEnd, eeLogRecordHandler handler)
+{
+	uint16_t lo = 0;
+	uint16_t hi;
+	uint16_t mid;
+	uint16_t logical;
+	uint32_t i;
+	uint32_t matches = 0;
+
+	if (eeLogState.pageCount != 0)
+	{
+		// Last logical page whose first record is <= timeStart, (or logical page 0).
+		hi = eeLogState.pageCount - 1;
+		while (lo < hi)
+		{
+			mid = (uint16_t)((lo + hi + 1) / 2);
+
+			if ((eeLogReadPage((uint16_t)((eeLogState.tailPage + mid) % EELOG_PAGE_COUNT), &readPage) == EELOG_PAGE_VALID) &&
+				(readPage.record[0].time <= timeStart))
+			{
+				lo = mid;
+			}
+			else
+			{
+				hi = mid - 1;
+			}
+		}
+
+		// Stream pages from there on.
+		for (logical = lo; logical < eeLogState.pageCount; logical++)
+		{
+			if (eeLogReadPage((uint16_t)((eeLogState.tailPage + logical) % EELOG_PAGE_COUNT), &readPage) != EELOG_PAGE_VALID)
+			{
+				continue;	// Torn page, skip it.
+			}
+			if (readPage.record[0].time > timeEnd)
+			{
+				break;
+			}
+			for (i = 0; i < readPage.recordCount; i++)
+			{
+				if ((readPage.record[i].time >= timeStart) && (readPage.record[i].time <= timeEnd))
+				{
+					handler(&readPage.record[i]);
+					matches++;
+				}
+			}
+		}
+	}
+
+	for (i = 0; i < fillPage.recordCount; i++)
+	{
+		if ((fillPage.record[i].time >= timeStart) && (fillPage.record[i].time <= timeEnd))
+		{
+			handler(&fillPage.record[i]);
+			matches++;
+		}
+	}
+
+	return matches;
+}
@@ -0,0 +1,431 @@
+/**
+  @file i2cBus.c
+  @brief Per bus transfer queues for I2C2 and I2C1, see i2cBus.h
+<pre>
+	Flow per bus, all after the first start runs in I2C interrupt context:
+
+		i2cBusSubmit		- queue it, start it if the bus is idle.
+		Mem/Master Cplt		- end the head transfer, start the next one,
+							  post its done handler as PendSV work.
+		Error, retried		- start the same transfer again after its
+							  backoff, (i2cRetry.h), from SysTick or the
+							  main loop, at once only if it has none and
+							  the bus is free.
+		Error, given up		- end the head transfer with the error.
+
+	The queue is a ring of pointers, head and tail only ever count up,
+	(tail - head is the number queued).  Submit may be called from a done
+	handler, (interrupt context), so queue updates are done with
+	interrupts off.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/23/2018
+
+*/
+#include <string.h>
+#include "i2cBus.h"
+#include "i2c_jmk.h"
+#include "i2cTrace.h"
+#include "i2cRetry.h"
+#include "mainEvent.h"
+#include "pendWork.h"
+
+typedef char i2cBusQueueDepthCheck[((I2CBUS_QUEUE_DEPTH & (I2CBUS_QUEUE_DEPTH - 1)) == 0) ? 1 : -1];
+
+#define QUEUE_MASK		(I2CBUS_QUEUE_DEPTH - 1)
+
+i2cBusStateStruct i2cBusState[I2CBUS_COUNT];
+
+
+/**
+ * @brief Bus instance running on hi2c, NULL if none.
+ */
+static i2cBusStateStruct *busOf(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t bus;
+
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		if (i2cBusState[bus].hi2c == hi2c)
+		{
+			return &i2cBusState[bus];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Bus instance running on hi2c, I2CBUS_COUNT if none.
+ */
+enumI2CBus i2cBusOfHandle(I2C_HandleTypeDef *hi2c)
+{
+	i2cBusStateStruct *pBus = busOf(hi2c);
+
+	return (pBus == NULL) ? I2CBUS_COUNT : (enumI2CBus)(pBus - i2cBusState);
+}
+
+/**
+ * @brief Bind the bus instances to their handles, call once after the MX_I2Cx_Init()'s.
+ */
+void i2cBusInit(void)
+{
+	memset(i2cBusState, 0, sizeof(i2cBusState));
+	i2cBusState[I2CBUS_EE].hi2c	 = &hi2c2;
+	i2cBusState[I2CBUS_AUX].hi2c = &hi2c1;
+}
+
+/**
+ * @brief Start the head transfer of pBus.
+ *
+ * @param retry - Same transfer again after an error, (traced by i2cTraceRetry(..)).
+ */
+static HAL_StatusTypeDef startHead(i2cBusStateStruct *pBus, bool retry)
+{
+	I2C_HandleTypeDef *hi2c		   = pBus->hi2c;
+	i2cBusXfer		  *pXfer	   = pBus->queue[pBus->head & QUEUE_MASK];
+	uint16_t		   HAL_DevAddr = ((uint16_t)pXfer->devAddr7Bit << 1);
+	bool			   useDma;
+	HAL_StatusTypeDef  status;
+
+	useDma = (pXfer->size >= I2CBUS_DMA_MIN_BYTES) && ((pXfer->isRead ? hi2c->hdmarx : hi2c->hdmatx) != NULL);
+
+	if (retry)
+	{
+		i2cTraceRetry(hi2c);
+	}
+	else
+	{
+		i2cTraceBegin(hi2c, (pXfer->memAddSize != 0) ? (pXfer->isRead ? I2CTRACE_MEM_READ : I2CTRACE_MEM_WRITE) :
+													  (pXfer->isRead ? I2CTRACE_READ : I2CTRACE_WRITE),
+					  HAL_DevAddr, pXfer->memAddress, pXfer->size);
+	}
+
+	if (pXfer->memAddSize != 0)
+	{
+		if (pXfer->isRead)
+		{
+			status = useDma ? HAL_I2C_Mem_Read_DMA(hi2c, HAL_DevAddr, pXfer->memAddress, pXfer->memAddSize,
+												   pXfer->pData, pXfer->size) :
+							  HAL_I2C_Mem_Read_IT(hi2c, HAL_DevAddr, pXfer->memAddress, pXfer->memAddSize,
+												  pXfer->pData, pXfer->size);
+		}
+		else
+		{
+			status = useDma ? HAL_I2C_Mem_Write_DMA(hi2c, HAL_DevAddr, pXfer->memAddress, pXfer->memAddSize,
+													pXfer->pData, pXfer->size) :
+							  HAL_I2C_Mem_Write_IT(hi2c, HAL_DevAddr, pXfer->memAddress, pXfer->memAddSize,
+												   pXfer->pData, pXfer->size);
+		}
+	}
+	else
+	{
+		if (pXfer->isRead)
+		{
+			status = useDma ? HAL_I2C_Master_Receive_DMA(hi2c, HAL_DevAddr, pXfer->pData, pXfer->size) :
+							  HAL_I2C_Master_Receive_IT(hi2c, HAL_DevAddr, pXfer->pData, pXfer->size);
+		}
+		else
+		{
+			status = useDma ? HAL_I2C_Master_Transmit_DMA(hi2c, HAL_DevAddr, pXfer->pData, pXfer->size) :
+							  HAL_I2C_Master_Transmit_IT(hi2c, HAL_DevAddr, pXfer->pData, pXfer->size);
+		}
+	}
+
+	if (status != HAL_OK)
+	{
+		i2cTraceDone(hi2c, status);
+	}
+	else if (useDma && !retry)
+	{
+		pBus->dmaXfers++;
+	}
+	return status;
+}
+
+/**
+ * @brief Start the head transfer if the bus is idle and its handle free.
+ * <pre>
+ *	If the handle is in use by someone else it stays queued, i2cBusService()
+ *	tries again.
+ * </pre>
+ */
+static void kick(i2cBusStateStruct *pBus)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (pBus->active || (pBus->head == pBus->tail) || (pBus->hi2c->State != HAL_I2C_STATE_READY))
+	{
+		__set_PRIMASK(primask);
+		return;
+	}
+	pBus->active = true;
+	__set_PRIMASK(primask);
+
+	if (!pBus->headTried)
+	{
+		pBus->headTried	   = true;
+		pBus->firstTryTick = HAL_GetTick();
+	}
+	pBus->startCycles = i2cTraceNow();
+	if (startHead(pBus, false) != HAL_OK)
+	{
+		pBus->active = false;
+	}
+}
+
+static void doneWork(void *pArg)
+{
+	i2cBusXfer *pXfer = (i2cBusXfer *)pArg;
+
+	pXfer->done(pXfer);
+}
+
+/**
+ * @brief Head transfer has ended, hand it back and start the next.
+ */
+static void finishHead(i2cBusStateStruct *pBus, uint32_t errorCode)
+{
+	i2cBusXfer *pXfer = pBus->queue[pBus->head & QUEUE_MASK];
+
+	pBus->xfers++;
+	pBus->busyCycles += i2cTraceNow() - pBus->startCycles;
+	if (errorCode == HAL_I2C_ERROR_NONE)
+	{
+		pBus->bytes += pXfer->size;
+	}
+	else
+	{
+		pBus->errors++;
+	}
+
+	pBus->head++;
+	pBus->headTried	   = false;
+	pBus->headRetries  = 0;
+	pBus->retryWaiting = false;
+	pBus->active	   = false;
+
+	// The next transfer starts first, the done handler is PendSV work,
+	// (pendWork.h), unless the work queue is full.
+	pXfer->errorCode = errorCode;
+	kick(pBus);
+	if ((pXfer->done != NULL) && !pendWorkPost(doneWork, pXfer))
+	{
+		pXfer->done(pXfer);
+	}
+	mainEventPost(MAINEVT_I2C);
+}
+
+/**
+ * @brief Queue a transfer on bus.
+ * <pre>
+ *	pXfer, and its data, must stay put until it has ended, (errorCode no
+ *	longer I2CBUS_XFER_PENDING, or its done handler called).  May be called
+ *	from a done handler.
+ * </pre>
+ *
+ * @param bus	- I2CBUS_EE or I2CBUS_AUX.
+ * @param pXfer	- Transfer, everything but errorCode filled in.
+ *
+ * @returns false if the queue is full.
+ */
+bool i2cBusSubmit(enumI2CBus bus, i2cBusXfer *pXfer)
+{
+	i2cBusStateStruct *pBus	   = &i2cBusState[bus];
+	uint32_t		   primask = __get_PRIMASK();
+	uint32_t		   queued;
+
+	__disable_irq();
+	queued = pBus->tail - pBus->head;
+	if (queued >= I2CBUS_QUEUE_DEPTH)
+	{
+		__set_PRIMASK(primask);
+		return false;
+	}
+	pXfer->errorCode = I2CBUS_XFER_PENDING;
+	pBus->queue[pBus->tail & QUEUE_MASK] = pXfer;
+	pBus->tail++;
+	if (queued + 1 > pBus->maxQueued)
+	{
+		pBus->maxQueued = queued + 1;
+	}
+	__set_PRIMASK(primask);
+
+	kick(pBus);
+	return true;
+}
+
+/**
+ * @brief true when nothing is queued or running on bus.
+ */
+bool i2cBusIdle(enumI2CBus bus)
+{
+	return (i2cBusState[bus].head == i2cBusState[bus].tail);
+}
+
+bool i2cBusXferDone(const i2cBusXfer *pXfer)
+{
+	return (pXfer->errorCode != I2CBUS_XFER_PENDING);
+}
+
+/**
+ * @brief Transfers ended plus retries on the queue of hi2c, 0 if none.
+ * <pre>
+ *	A transfer NACKed and started again from the error callback never lets
+ *	the handle show ready, this changing is what tells it from a stuck one.
+ * </pre>
+ */
+uint32_t i2cBusEvents(I2C_HandleTypeDef *hi2c)
+{
+	i2cBusStateStruct *pBus = busOf(hi2c);
+
+	return (pBus == NULL) ? 0 : (pBus->xfers + pBus->retries);
+}
+
+/**
+ * @brief Start a head transfer whose retry backoff is over, fail it if its handle stays busy.
+ */
+static void retryIfDue(i2cBusStateStruct *pBus)
+{
+	uint32_t primask = __get_PRIMASK();
+	bool	 due;
+	bool	 expired;
+
+	// Both the SysTick hook and the main loop come here, only one may take it, (started or failed).
+	__disable_irq();
+	due = pBus->retryWaiting && ((int32_t)(i2cTraceNow() - pBus->retryAtCycles) >= 0) &&
+		  (pBus->hi2c->State == HAL_I2C_STATE_READY);
+	expired = pBus->retryWaiting && !due && ((HAL_GetTick() - pBus->retryTick) > I2CBUS_XFER_TIMEOUT_MS);
+	if (due || expired)
+	{
+		pBus->retryWaiting = false;
+	}
+	__set_PRIMASK(primask);
+
+	if (due)
+	{
+		if (startHead(pBus, true) != HAL_OK)
+		{
+			finishHead(pBus, HAL_I2C_ERROR_TIMEOUT);
+		}
+	}
+	else if (expired)
+	{
+		finishHead(pBus, HAL_I2C_ERROR_TIMEOUT);
+	}
+}
+
+/**
+ * @brief Retries whose backoff is over, call from SysTick_Handler.
+ */
+void i2cBusOnTick(void)
+{
+	uint32_t bus;
+
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		if (i2cBusState[bus].retryWaiting)
+		{
+			retryIfDue(&i2cBusState[bus]);
+		}
+	}
+}
+
+/**
+ * @brief Start queues that found their handle busy or whose retry is due, fail a head transfer that never got it, (main loop).
+ */
+void i2cBusService(void)
+{
+	i2cBusStateStruct *pBus;
+	uint32_t		   bus;
+	uint32_t		   primask;
+	bool			   timedOut;
+
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		pBus = &i2cBusState[bus];
+		if (pBus->retryWaiting)
+		{
+			retryIfDue(pBus);
+			continue;
+		}
+
+		// A done handler may submit, (and kick(..) start the head), from PendSV, so claim the head as kick(..) does.
+		primask = __get_PRIMASK();
+		__disable_irq();
+		if (pBus->active || (pBus->head == pBus->tail))
+		{
+			__set_PRIMASK(primask);
+			continue;
+		}
+		timedOut = pBus->headTried && ((HAL_GetTick() - pBus->firstTryTick) > I2CBUS_XFER_TIMEOUT_MS);
+		if (timedOut)
+		{
+			pBus->active = true;
+		}
+		__set_PRIMASK(primask);
+
+		if (timedOut)
+		{
+			pBus->startCycles = i2cTraceNow();
+			finishHead(pBus, HAL_I2C_ERROR_TIMEOUT);
+		}
+		else
+		{
+			kick(pBus);
+		}
+	}
+}
+
+/**
+ * @brief Queued transfer complete, (Mem or Master, Tx or Rx).
+ */
+bool i2cBusOnCplt(I2C_HandleTypeDef *hi2c)
+{
+	i2cBusStateStruct *pBus = busOf(hi2c);
+
+	// While a retry waits out its backoff the handle is free, the event is someone else's.
+	if ((pBus == NULL) || !pBus->active || pBus->retryWaiting)
+	{
+		return false;
+	}
+	finishHead(pBus, HAL_I2C_ERROR_NONE);
+	return true;
+}
+
+/**
+ * @brief Queued transfer failed, started again as the retry policy says, or ended with the error.
+ */
+bool i2cBusOnError(I2C_HandleTypeDef *hi2c)
+{
+	i2cBusStateStruct *pBus = busOf(hi2c);
+	uint32_t		   backoffUs;
+
+	if ((pBus == NULL) || !pBus->active || pBus->retryWaiting)
+	{
+		return false;
+	}
+
+	if (i2cRetryNext(hi2c->ErrorCode, pBus->headRetries, &backoffUs))
+	{
+		pBus->headRetries++;
+		pBus->retries++;
+		// A NACKed Mem transfer holds the bus until HAL_I2C_ErrorCallback(..)'s STOP is out,
+		// a start while it is BUSY would spin 25ms here, in the interrupt.
+		if ((backoffUs != 0) || (__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY) != RESET))
+		{
+			// Head stays active, nothing else may start on this bus meanwhile.
+			pBus->retryAtCycles = i2cTraceNow() + backoffUs * (SystemCoreClock / 1000000);
+			pBus->retryTick		= HAL_GetTick();
+			pBus->retryWaiting	= true;
+			return true;
+		}
+		if (startHead(pBus, true) == HAL_OK)
+		{
+			return true;
+		}
+	}
+	finishHead(pBus, hi2c->ErrorCode);
+	return true;
+}
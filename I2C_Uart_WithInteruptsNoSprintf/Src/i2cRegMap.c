@@ -0,0 +1,320 @@
+/**
+  @file i2cRegMap.c
+  @brief Table driven access to I2C register devices, see i2cRegMap.h
+<pre>
+	Registers are referred to by their index in the table, i2cRegFind(..)
+	gives it from an address.  A burst is a run of table entries where
+	each one's address is the one before plus its width, all with the
+	access the burst needs, and I2CREG_MAX_BURST bytes at most.
+
+	Each transfer is an sEEPromOp on the bus queue, waited on with
+	sEEPromOpWait(..), so a stuck bus is recovered on the way.  The op and
+	its buffer are static, one that timed out may still be queued, and
+	until it ends no other transfer is started, (HAL_BUSY).
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/28/2018
+
+*/
+#include <string.h>
+#include "i2cRegMap.h"
+#include "serialEEProm.h"
+
+static sEEPromOp op;
+static uint8_t	 burst[I2CREG_MAX_BURST];
+
+static bool shadowValid(const i2cRegMap *pMap, uint16_t reg)
+{
+	return (pMap->pValid[reg / 32] & (1UL << (reg % 32))) != 0;
+}
+
+static void shadowSet(i2cRegMap *pMap, uint16_t reg, uint32_t value)
+{
+	pMap->pShadow[reg]		 = value;
+	pMap->pValid[reg / 32] |= (1UL << (reg % 32));
+}
+
+/**
+ * @brief Register value from its bytes as on the bus.
+ */
+static uint32_t decode(const i2cRegMap *pMap, uint16_t reg, const uint8_t *pBytes)
+{
+	uint8_t	 width = pMap->pRegs[reg].width;
+	uint32_t value = 0;
+	uint8_t	 n;
+
+	for (n = 0; n < width; n++)
+	{
+		value = (value << 8) | pBytes[pMap->msbFirst ? n : (width - 1 - n)];
+	}
+	return value;
+}
+
+static void encode(const i2cRegMap *pMap, uint16_t reg, uint32_t value, uint8_t *pBytes)
+{
+	uint8_t width = pMap->pRegs[reg].width;
+	uint8_t n;
+
+	for (n = 0; n < width; n++)
+	{
+		pBytes[pMap->msbFirst ? (width - 1 - n) : n] = (uint8_t)value;
+		value >>= 8;
+	}
+}
+
+/**
+ * @brief true if reg continues the burst ending with reg - 1, (at the next address, with access).
+ */
+static bool followsOn(const i2cRegMap *pMap, uint16_t reg, uint8_t access, uint16_t burstBytes)
+{
+	const i2cRegDef *pDef = &pMap->pRegs[reg];
+
+	return ((pDef->access & access) == access) &&
+		   (pDef->address == (pMap->pRegs[reg - 1].address + pMap->pRegs[reg - 1].width)) &&
+		   ((burstBytes + pDef->width) <= I2CREG_MAX_BURST);
+}
+
+/**
+ * @brief One burst of burst[] at the address of firstReg, queued and waited on.
+ */
+static HAL_StatusTypeDef transfer(i2cRegMap *pMap, uint16_t firstReg, bool isRead, uint16_t length)
+{
+	HAL_StatusTypeDef status;
+
+	if (op.xfer.errorCode == I2CBUS_XFER_PENDING)
+	{
+		return HAL_BUSY;
+	}
+	memset(&op, 0, sizeof(op));
+	op.bus				= pMap->bus;
+	op.xfer.devAddr7Bit = pMap->devAddr7Bit;
+	op.xfer.isRead		= isRead;
+	op.xfer.memAddSize	= pMap->memAddSize;
+	op.xfer.memAddress	= pMap->pRegs[firstReg].address;
+	op.xfer.pData		= burst;
+	op.xfer.size		= length;
+
+	pMap->transactions++;
+	status = i2cBusSubmit(pMap->bus, &op.xfer) ? sEEPromOpWait(&op) : HAL_BUSY;
+	if (status != HAL_OK)
+	{
+		pMap->errors++;
+	}
+	return status;
+}
+
+/**
+ * @brief Check the table, forget the shadow and clear the counters.
+ *
+ * @returns false if the table is not in ascending address order or a width is out of range.
+ */
+bool i2cRegMapInit(i2cRegMap *pMap)
+{
+	uint16_t reg;
+
+	memset(pMap->pValid, 0, I2CREG_VALID_WORDS(pMap->regCount) * sizeof(uint32_t));
+	pMap->transactions	= 0;
+	pMap->shadowReads	= 0;
+	pMap->skippedWrites = 0;
+	pMap->errors		= 0;
+
+	for (reg = 0; reg < pMap->regCount; reg++)
+	{
+		if ((pMap->pRegs[reg].width == 0) || (pMap->pRegs[reg].width > I2CREG_MAX_WIDTH) ||
+			((reg != 0) && (pMap->pRegs[reg].address <= pMap->pRegs[reg - 1].address)))
+		{
+			return false;
+		}
+	}
+	return (pMap->bus < I2CBUS_COUNT);
+}
+
+/**
+ * @brief Index of the register at address, I2CREG_NONE if there is none.
+ */
+uint16_t i2cRegFind(const i2cRegMap *pMap, uint16_t address)
+{
+	uint16_t low  = 0;
+	uint16_t high = pMap->regCount;
+	uint16_t mid;
+
+	while (low < high)
+	{
+		mid = (uint16_t)((low + high) / 2);
+		if (pMap->pRegs[mid].address < address)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return ((low < pMap->regCount) && (pMap->pRegs[low].address == address)) ? low : I2CREG_NONE;
+}
+
+/**
+ * @brief Read one register, from the shadow when it can be trusted.
+ *
+ * @returns HAL_OK, HAL_ERROR if reg is not readable, else as sEEPromOpWait(..)
+ */
+HAL_StatusTypeDef i2cRegRead(i2cRegMap *pMap, uint16_t reg, uint32_t *pValue)
+{
+	HAL_StatusTypeDef status;
+
+	if ((reg >= pMap->regCount) || !(pMap->pRegs[reg].access & I2CREG_R))
+	{
+		return HAL_ERROR;
+	}
+	if (!(pMap->pRegs[reg].access & I2CREG_VOLATILE) && shadowValid(pMap, reg))
+	{
+		pMap->shadowReads++;
+		*pValue = pMap->pShadow[reg];
+		return HAL_OK;
+	}
+
+	status = transfer(pMap, reg, true, pMap->pRegs[reg].width);
+	if (status == HAL_OK)
+	{
+		shadowSet(pMap, reg, decode(pMap, reg, burst));
+		*pValue = pMap->pShadow[reg];
+	}
+	return status;
+}
+
+/**
+ * @brief Write one register, skipped if the shadow says it already holds value.
+ *
+ * @returns HAL_OK, HAL_ERROR if reg is not writable, else as sEEPromOpWait(..)
+ */
+HAL_StatusTypeDef i2cRegWrite(i2cRegMap *pMap, uint16_t reg, uint32_t value)
+{
+	return ((reg < pMap->regCount) && (pMap->pRegs[reg].access & I2CREG_W)) ? i2cRegWriteMany(pMap, reg, 1, &value)
+																			: HAL_ERROR;
+}
+
+/**
+ * @brief Read count registers from firstReg, all from the device, in bursts.
+ * <pre>
+ *	Write only registers in the range are not read, their pValues entry is
+ *	the shadow, (last written), or 0.  Every register read updates the shadow.
+ * </pre>
+ *
+ * @param pValues - count values, pValues[0] for firstReg.
+ *
+ * @returns HAL_OK, HAL_ERROR for a range past the table, else as sEEPromOpWait(..) for the failed burst.
+ */
+HAL_StatusTypeDef i2cRegSnapshot(i2cRegMap *pMap, uint16_t firstReg, uint16_t count, uint32_t *pValues)
+{
+	uint16_t		  end = firstReg + count;
+	uint16_t		  reg = firstReg;
+	uint16_t		  burstEnd;
+	uint16_t		  burstBytes;
+	uint16_t		  offset;
+	HAL_StatusTypeDef status;
+
+	if ((count == 0) || (end > pMap->regCount))
+	{
+		return HAL_ERROR;
+	}
+
+	while (reg < end)
+	{
+		if (!(pMap->pRegs[reg].access & I2CREG_R))
+		{
+			pValues[reg - firstReg] = shadowValid(pMap, reg) ? pMap->pShadow[reg] : 0;
+			reg++;
+			continue;
+		}
+
+		burstBytes = pMap->pRegs[reg].width;
+		for (burstEnd = reg + 1; (burstEnd < end) && followsOn(pMap, burstEnd, I2CREG_R, burstBytes); burstEnd++)
+		{
+			burstBytes += pMap->pRegs[burstEnd].width;
+		}
+
+		status = transfer(pMap, reg, true, burstBytes);
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+		for (offset = 0; reg < burstEnd; reg++)
+		{
+			shadowSet(pMap, reg, decode(pMap, reg, &burst[offset]));
+			pValues[reg - firstReg] = pMap->pShadow[reg];
+			offset += pMap->pRegs[reg].width;
+		}
+	}
+	return HAL_OK;
+}
+
+/**
+ * @brief Write count registers from firstReg, only those that change, in bursts.
+ * <pre>
+ *	A register that is not I2CREG_VOLATILE and whose shadow already holds
+ *	its value is skipped, and ends a burst.  Read only registers in the
+ *	range are left alone.
+ * </pre>
+ *
+ * @param pValues - count values, pValues[0] for firstReg.
+ *
+ * @returns HAL_OK, HAL_ERROR for a range past the table, else as sEEPromOpWait(..) for the failed burst.
+ */
+HAL_StatusTypeDef i2cRegWriteMany(i2cRegMap *pMap, uint16_t firstReg, uint16_t count, const uint32_t *pValues)
+{
+	uint16_t		  end = firstReg + count;
+	uint16_t		  reg = firstReg;
+	uint16_t		  burstEnd;
+	uint16_t		  burstBytes;
+	HAL_StatusTypeDef status;
+
+	if ((count == 0) || (end > pMap->regCount))
+	{
+		return HAL_ERROR;
+	}
+
+	while (reg < end)
+	{
+		if (!(pMap->pRegs[reg].access & I2CREG_W))
+		{
+			reg++;
+			continue;
+		}
+		if (!(pMap->pRegs[reg].access & I2CREG_VOLATILE) && shadowValid(pMap, reg) &&
+			(pMap->pShadow[reg] == pValues[reg - firstReg]))
+		{
+			pMap->skippedWrites++;
+			reg++;
+			continue;
+		}
+
+		if (op.xfer.errorCode == I2CBUS_XFER_PENDING)
+		{
+			return HAL_BUSY;
+		}
+		encode(pMap, reg, pValues[reg - firstReg], burst);
+		burstBytes = pMap->pRegs[reg].width;
+		for (burstEnd = reg + 1; (burstEnd < end) && followsOn(pMap, burstEnd, I2CREG_W, burstBytes); burstEnd++)
+		{
+			if (!(pMap->pRegs[burstEnd].access & I2CREG_VOLATILE) && shadowValid(pMap, burstEnd) &&
+				(pMap->pShadow[burstEnd] == pValues[burstEnd - firstReg]))
+			{
+				break;
+			}
+			encode(pMap, burstEnd, pValues[burstEnd - firstReg], &burst[burstBytes]);
+			burstBytes += pMap->pRegs[burstEnd].width;
+		}
+
+		status = transfer(pMap, reg, false, burstBytes);
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+		for (; reg < burstEnd; reg++)
+		{
+			shadowSet(pMap, reg, pValues[reg - firstReg]);
+		}
+	}
+	return HAL_OK;
+}
@@ -0,0 +1,94 @@
+/**
+  @file i2cRetry.c
+  @brief Retry policy for failed I2C transfers, see i2cRetry.h
+<pre>
+	Only decides and counts, the caller starts the transfer again.  Called
+	from the I2C error callback, (interrupt context), and main context, the
+	counters are only ever incremented.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/26/2018
+
+*/
+#include <string.h>
+#include "i2cRetry.h"
+
+/// Per class policy, in enumI2CRetryClass order.
+i2cRetryPolicyStruct i2cRetryPolicy[I2CRETRY_CLASSES];
+
+i2cRetryStateStruct i2cRetryState;
+
+
+/**
+ * @brief Default policies, counters cleared, call once at startup.
+ */
+void i2cRetryInit(void)
+{
+	i2cRetryPolicy[I2CRETRY_NACK] = (i2cRetryPolicyStruct){ I2CRETRY_NACK_RETRIES, I2CRETRY_NACK_BACKOFF_US, I2CRETRY_NACK_MAX_US };
+	i2cRetryPolicy[I2CRETRY_ARLO] = (i2cRetryPolicyStruct){ I2CRETRY_ARLO_RETRIES, I2CRETRY_ARLO_BACKOFF_US, I2CRETRY_ARLO_MAX_US };
+	i2cRetryPolicy[I2CRETRY_BERR] = (i2cRetryPolicyStruct){ I2CRETRY_BERR_RETRIES, I2CRETRY_BERR_BACKOFF_US, I2CRETRY_BERR_MAX_US };
+	memset(&i2cRetryState, 0, sizeof(i2cRetryState));
+}
+
+/**
+ * @brief Class of a HAL I2C error code, I2CRETRY_CLASSES if it is not retried.
+ */
+enumI2CRetryClass i2cRetryClassOf(uint32_t errorCode)
+{
+	if ((errorCode & ~(HAL_I2C_ERROR_AF | HAL_I2C_ERROR_ARLO | HAL_I2C_ERROR_BERR)) != 0)
+	{
+		return I2CRETRY_CLASSES;
+	}
+	if (errorCode & HAL_I2C_ERROR_BERR)
+	{
+		return I2CRETRY_BERR;
+	}
+	if (errorCode & HAL_I2C_ERROR_ARLO)
+	{
+		return I2CRETRY_ARLO;
+	}
+	return (errorCode & HAL_I2C_ERROR_AF) ? I2CRETRY_NACK : I2CRETRY_CLASSES;
+}
+
+/**
+ * @brief Should a transfer that ended with errorCode be started again.
+ *
+ * @param errorCode	 - hi2c->ErrorCode it ended with.
+ * @param retries	 - Times it has already been started again.
+ * @param pBackoffUs - Wait before starting it, 0 for at once.
+ *
+ * @returns true to retry, (counted), false to give up, (counted).
+ */
+bool i2cRetryNext(uint32_t errorCode, uint32_t retries, uint32_t *pBackoffUs)
+{
+	enumI2CRetryClass		   retryClass = i2cRetryClassOf(errorCode);
+	const i2cRetryPolicyStruct *pPolicy;
+	uint32_t				   backoffUs;
+
+	if (retryClass == I2CRETRY_CLASSES)
+	{
+		if (errorCode != HAL_I2C_ERROR_NONE)
+		{
+			i2cRetryState.notRetried++;
+		}
+		return false;
+	}
+
+	pPolicy = &i2cRetryPolicy[retryClass];
+	if (retries >= pPolicy->maxRetries)
+	{
+		i2cRetryState.giveUps[retryClass]++;
+		return false;
+	}
+
+	backoffUs = pPolicy->backoffUs;
+	while ((retries-- != 0) && (backoffUs < pPolicy->maxBackoffUs))
+	{
+		backoffUs <<= 1;
+	}
+	*pBackoffUs = (backoffUs > pPolicy->maxBackoffUs) ? pPolicy->maxBackoffUs : backoffUs;
+
+	i2cRetryState.retries[retryClass]++;
+	return true;
+}
@@ -0,0 +1,315 @@
+/**
+  @file i2cScan.c
+  @brief I2C bus scan and AT24C capacity detect, see i2cScan.h
+<pre>
+	Flow, all after i2cScanStart(..) runs in I2C interrupt context:
+
+		i2cScanStart		- probe first address.
+		MasterTxCplt		- ACK, note it, probe next address.
+		Error, AF			- NACK, probe next address.
+		Error, other		- bus fault, scan failed.
+
+	The HAL waits for the bus BUSY flag before each start, (the STOP of the
+	previous probe going out, about one bit time), that wait is inside the
+	callback.
+
+	Probes are not put in the I2C trace, a scan would push every other
+	record out of the ring.
+
+	AT24C capacity: the memory address is 2 bytes on every AT24C32..512
+	and the unused upper bits are don't care, so on a part of N bytes
+	address N reads address 0.  Candidate sizes 4K..32K are tried smallest
+	first: if the I2CSCAN_DETECT_BYTES at the candidate differ from those
+	at 0 it is not the size.  If they match, (the real size, an erased or
+	pattern filled part, or chance), one byte is written inverted at the
+	candidate and address 0 read back, then the byte is put back as it
+	was.  So a part is written only where its contents repeat, one byte
+	twice, and is left as it was found.  A 64K part has no spare address
+	bit, it is never written.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/21/2018
+
+*/
+#include <string.h>
+#include "i2cScan.h"
+#include "i2cTrace.h"
+#include "led.h"
+
+/// Scan in progress, or last one run.
+i2cScanStateStruct i2cScanState;
+
+/// HAL wants a buffer even for 0 bytes.
+static uint8_t probeByte;
+
+
+static void scanFinished(enumI2CScanState state)
+{
+	i2cScanState.endCycles = i2cTraceNow();
+	i2cScanState.state	   = state;
+}
+
+/**
+ * @brief Start the address only transaction for i2cScanState.addr.
+ */
+static void probeAddress(void)
+{
+	HAL_StatusTypeDef status;
+
+	i2cScanState.probeCycles = i2cTraceNow();
+	status = HAL_I2C_Master_Transmit_IT(i2cScanState.hi2c, (uint16_t)i2cScanState.addr << 1, &probeByte, 0);
+	if (status != HAL_OK)
+	{
+		// BUSY flag never cleared, something is holding the bus.
+		i2cScanState.errorCode = (i2cScanState.hi2c->ErrorCode != HAL_I2C_ERROR_NONE) ?
+								 i2cScanState.hi2c->ErrorCode : HAL_I2C_ERROR_TIMEOUT;
+		scanFinished(I2CSCAN_FAILED);
+	}
+}
+
+/**
+ * @brief Probe of i2cScanState.addr ended, note it and go on to the next.
+ */
+static void probeDone(bool acknowledged)
+{
+	uint8_t	 addr	= i2cScanState.addr;
+	uint32_t cycles = i2cTraceNow() - i2cScanState.probeCycles;
+
+	i2cScanState.latencyCycles[addr] = (cycles > 0xFFFF) ? 0xFFFF : (uint16_t)cycles;
+	if (acknowledged)
+	{
+		i2cScanState.found[addr / 32] |= (1UL << (addr % 32));
+		i2cScanState.foundCount++;
+	}
+
+	if (addr >= i2cScanState.lastAddr)
+	{
+		scanFinished(I2CSCAN_DONE);
+		return;
+	}
+	i2cScanState.addr = addr + 1;
+	probeAddress();
+}
+
+/**
+ * @brief Start a background scan of firstAddr..lastAddr on hi2c.
+ * <pre>
+ *	Results so far are cleared, (AT24C sizes too).  Wait for i2cScanBusy(..)
+ *	false, the handle is busy until then.
+ * </pre>
+ *
+ * @param hi2c		- I2C handle, must be ready, (not listening as a slave).
+ * @param firstAddr	- 7 bit addresses, firstAddr <= lastAddr <= 0x7F.
+ * @param lastAddr
+ *
+ * @returns true if started.
+ */
+bool i2cScanStart(I2C_HandleTypeDef *hi2c, uint8_t firstAddr, uint8_t lastAddr)
+{
+	if (i2cScanBusy() || (firstAddr > lastAddr) || (lastAddr >= I2CSCAN_ADDRESSES) ||
+		(hi2c->State != HAL_I2C_STATE_READY))
+	{
+		return false;
+	}
+
+	memset(&i2cScanState, 0, sizeof(i2cScanState));
+	i2cScanState.hi2c		 = hi2c;
+	i2cScanState.firstAddr	 = firstAddr;
+	i2cScanState.lastAddr	 = lastAddr;
+	i2cScanState.addr		 = firstAddr;
+	i2cScanState.startCycles = i2cTraceNow();
+	i2cScanState.state		 = I2CSCAN_RUNNING;
+
+	probeAddress();
+	return (i2cScanState.state == I2CSCAN_RUNNING);
+}
+
+bool i2cScanBusy(void)
+{
+	return (i2cScanState.state == I2CSCAN_RUNNING);
+}
+
+/**
+ * @brief true if addr7Bit acknowledged in the last scan.
+ */
+bool i2cScanFound(uint8_t addr7Bit)
+{
+	return (addr7Bit < I2CSCAN_ADDRESSES) && ((i2cScanState.found[addr7Bit / 32] & (1UL << (addr7Bit % 32))) != 0);
+}
+
+/**
+ * @brief Scan and wait for it, then optionally size every AT24C found, (boot time discovery).
+ *
+ * @param hi2c		  - I2C handle.
+ * @param firstAddr	  - 7 bit address range, see i2cScanStart(..)
+ * @param lastAddr
+ * @param detectAT24C - Also run i2cScanDetectAT24C(..) on each of 0x50..0x57 that answered.
+ *
+ * @returns Addresses that acknowledged, 0 if the scan failed.
+ */
+uint16_t i2cScanRun(I2C_HandleTypeDef *hi2c, uint8_t firstAddr, uint8_t lastAddr, bool detectAT24C)
+{
+	uint32_t startTick = HAL_GetTick();
+	uint8_t	 addr;
+
+	if (!i2cScanStart(hi2c, firstAddr, lastAddr))
+	{
+		return 0;
+	}
+	while (i2cScanBusy())
+	{
+		if ((HAL_GetTick() - startTick) > I2CSCAN_TIMEOUT_MS)
+		{
+			// Lost interrupt, (the sEEProm functions recover the bus next time they wait on it).
+			i2cScanState.errorCode = HAL_I2C_ERROR_TIMEOUT;
+			scanFinished(I2CSCAN_FAILED);
+			return 0;
+		}
+		STM32vldisc_LEDToggle(LED3);
+	}
+	if (i2cScanState.state != I2CSCAN_DONE)
+	{
+		return 0;
+	}
+
+	for (addr = I2CSCAN_AT24C_FIRST; detectAT24C && (addr <= I2CSCAN_AT24C_LAST); addr++)
+	{
+		if (i2cScanFound(addr))
+		{
+			i2cScanState.at24cBytes[addr - I2CSCAN_AT24C_FIRST] = i2cScanDetectAT24C(hi2c, (enumAT24C_7BitAddr)addr);
+		}
+	}
+	return i2cScanState.foundCount;
+}
+
+/**
+ * @brief Read length bytes at EEaddress and wait for them.
+ */
+static bool readBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pBytes,
+					  uint8_t length)
+{
+	return (sEEPromAckPoll(hi2c, addr7Bit) == HAL_OK) &&
+		   (sEEPromRandomAddrReadBytes(hi2c, addr7Bit, EEaddress, pBytes, length) == HAL_OK) &&
+		   (sEEPromWaitForIdle(hi2c) == HAL_OK);
+}
+
+/**
+ * @brief Write one byte at EEaddress and wait for it.
+ */
+static bool writeByte(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t byte)
+{
+	return (sEEPromAckPoll(hi2c, addr7Bit) == HAL_OK) &&
+		   (sEEPromByteWrite(hi2c, addr7Bit, EEaddress, &byte) == HAL_OK) &&
+		   (sEEPromWaitForIdle(hi2c) == HAL_OK);
+}
+
+/**
+ * @brief Does address capacity land on address 0?  Marker byte test, (see top of file).
+ *
+ * @param byte0 - Present contents of address 0, (and of address capacity).
+ *
+ * @returns 1 if it does, 0 if not, -1 on an I2C failure.
+ */
+static int markerAliases(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t capacity, uint8_t byte0)
+{
+	uint8_t marker = (uint8_t)~byte0;		// Differs from byte0 in every bit.
+	uint8_t readBack;
+	bool	aliases;
+
+	if (!writeByte(hi2c, addr7Bit, capacity, marker) || !readBytes(hi2c, addr7Bit, 0, &readBack, 1))
+	{
+		// Put back what may have been written, best effort.
+		writeByte(hi2c, addr7Bit, capacity, byte0);
+		return -1;
+	}
+
+	aliases = (readBack == marker);
+
+	// And wait out its tWR, a part in its write cycle would be missing from the next scan.
+	if (!writeByte(hi2c, addr7Bit, aliases ? 0 : capacity, byte0) || (sEEPromAckPoll(hi2c, addr7Bit) != HAL_OK))
+	{
+		return -1;
+	}
+	return aliases ? 1 : 0;
+}
+
+/**
+ * @brief Size of the AT24Cxx at addr7Bit, from where its memory address wraps.
+ *
+ * @param hi2c		- I2C handle.
+ * @param addr7Bit	- 7 bit eeprom device address.
+ *
+ * @returns Bytes, AT24C32_CAPACITY .. AT24C512_CAPACITY, or 0 if it could not be read.
+ */
+uint32_t i2cScanDetectAT24C(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit)
+{
+	uint8_t	 bytes0[I2CSCAN_DETECT_BYTES];
+	uint8_t	 bytesN[I2CSCAN_DETECT_BYTES];
+	uint32_t capacity;
+	int		 aliases;
+
+	if (!readBytes(hi2c, addr7Bit, 0, bytes0, I2CSCAN_DETECT_BYTES))
+	{
+		return 0;
+	}
+
+	// A 64K part has no address bit left over to wrap on, it is what is left.
+	for (capacity = AT24C32_CAPACITY; capacity < AT24C512_CAPACITY; capacity <<= 1)
+	{
+		if (!readBytes(hi2c, addr7Bit, (uint16_t)capacity, bytesN, I2CSCAN_DETECT_BYTES))
+		{
+			return 0;
+		}
+		if (memcmp(bytes0, bytesN, I2CSCAN_DETECT_BYTES) != 0)
+		{
+			continue;
+		}
+
+		aliases = markerAliases(hi2c, addr7Bit, (uint16_t)capacity, bytes0[0]);
+		if (aliases < 0)
+		{
+			return 0;
+		}
+		if (aliases)
+		{
+			return capacity;
+		}
+	}
+	return AT24C512_CAPACITY;
+}
+
+/**
+ * @brief Address acknowledged, (address only transmit complete, STOP sent).
+ */
+bool i2cScanOnTxCplt(I2C_HandleTypeDef *hi2c)
+{
+	if ((hi2c != i2cScanState.hi2c) || !i2cScanBusy())
+	{
+		return false;
+	}
+	probeDone(true);
+	return true;
+}
+
+/**
+ * @brief Address not acknowledged, (AF), or the bus failed.
+ */
+bool i2cScanOnError(I2C_HandleTypeDef *hi2c)
+{
+	if ((hi2c != i2cScanState.hi2c) || !i2cScanBusy())
+	{
+		return false;
+	}
+
+	if (hi2c->ErrorCode == HAL_I2C_ERROR_AF)
+	{
+		probeDone(false);
+	}
+	else
+	{
+		i2cScanState.errorCode = hi2c->ErrorCode;
+		scanFinished(I2CSCAN_FAILED);
+	}
+	return true;
+}
@@ -0,0 +1,442 @@
+/**
+  @file i2cSlaveEE.c
+  @brief STM32 as an I2C slave "EEPROM simulator", see i2cSlaveEE.h
+<pre>
+	HAL V1.1.1 slave flow, listen mode, one byte armed at a time:
+
+		AddrCallback, master writes	- arm 1 byte receive, (the address).
+		SlaveRxCplt					- address, or data byte to region, arm next.
+		AddrCallback, master reads	- arm 1 byte transmit from region.
+		SlaveTxCplt					- byte loaded into DR, arm next.
+		ListenCplt					- STOP, (or NACK ending a read), listen again.
+
+	The I2C data register is loaded one byte ahead of the one on the bus,
+	so when the master NACKs the last byte it wants, one more byte has
+	been loaded than sent, and the address is moved back by one.
+
+	A transfer still armed at STOP, (always so for a write), makes the HAL
+	report an AF error before ListenCplt, that is the normal end and is
+	not counted as an error.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/19/2018
+
+*/
+#include <string.h>
+#include "i2cSlaveEE.h"
+#include "i2cTrace.h"
+
+typedef char i2cSlaveEEBlocksCheck[(I2CSLAVEEE_MAX_SIZE / I2CSLAVEEE_BLOCK_SIZE <= 32) ? 1 : -1];
+
+/// Where the slave is in the transaction.
+typedef enum { PHASE_IDLE, PHASE_RX_ADDRESS, PHASE_RX_DATA, PHASE_TX } slavePhase;
+
+i2cSlaveEEStateStruct i2cSlaveEEState;
+
+/// Default region, (PIC demo board sized), for callers without their own.
+uint8_t i2cSlaveEEMem[I2CSLAVEEE_MAX_SIZE];
+
+static __IO slavePhase phase;
+static __IO bool	   rxArmed;			// 1 byte receive armed and not yet completed.
+static uint8_t		   rxByte;
+
+
+/**
+ * @brief Keep the longest callback, from its entry cycle count.
+ */
+static void noteIsrCycles(uint32_t startCycles)
+{
+	uint32_t cycles = i2cTraceNow() - startCycles;
+
+	if (cycles > i2cSlaveEEState.maxIsrCycles)
+	{
+		i2cSlaveEEState.maxIsrCycles = cycles;
+	}
+}
+
+static void nextAddress(void)
+{
+	if (++i2cSlaveEEState.address >= i2cSlaveEEState.size)
+	{
+		i2cSlaveEEState.address = 0;
+	}
+}
+
+static void armReceive(I2C_HandleTypeDef *hi2c)
+{
+	rxArmed = true;
+	HAL_I2C_Slave_Sequential_Receive_IT(hi2c, &rxByte, 1, I2C_NEXT_FRAME);
+}
+
+static void armTransmit(I2C_HandleTypeDef *hi2c)
+{
+	HAL_I2C_Slave_Sequential_Transmit_IT(hi2c, &i2cSlaveEEState.pMem[i2cSlaveEEState.address], 1, I2C_NEXT_FRAME);
+}
+
+/**
+ * @brief Byte received from the master, the address if first, else data for the region.
+ */
+static void byteReceived(void)
+{
+	rxArmed = false;
+
+	if (phase == PHASE_RX_ADDRESS)
+	{
+		i2cSlaveEEState.address = rxByte % i2cSlaveEEState.size;
+		phase = PHASE_RX_DATA;
+		return;
+	}
+
+	i2cSlaveEEState.pMem[i2cSlaveEEState.address] = rxByte;
+	i2cSlaveEEState.dirtyBlocks |= 1UL << (i2cSlaveEEState.address / I2CSLAVEEE_BLOCK_SIZE);
+	i2cSlaveEEState.bytesRx++;
+	nextAddress();
+}
+
+/**
+ * @brief Start answering as an eeprom at ownAddr7Bit on hi2c.
+ * <pre>
+ *	Waits for any master transfer on hi2c to finish, sets the peripheral's
+ *	own address and enables listen mode.  Returns straight away, everything
+ *	else runs from the I2C interrupts.
+ * </pre>
+ *
+ * @param hi2c		  - I2C handle to listen on, I2C2 or I2C1.
+ * @param ownAddr7Bit - 7 bit slave address, I2CSLAVEEE_DEFAULT_ADDR as the PIC.
+ * @param pMem		  - Region, i2cSlaveEEMem or the caller's, must stay valid until stopped.
+ * @param size		  - Region bytes, 1 .. I2CSLAVEEE_MAX_SIZE, addresses wrap at size.
+ *
+ * @returns true if listening.
+ */
+bool i2cSlaveEEStart(I2C_HandleTypeDef *hi2c, uint8_t ownAddr7Bit, uint8_t *pMem, uint16_t size)
+{
+	if (i2cSlaveEEState.listening || (pMem == NULL) || (size == 0) || (size > I2CSLAVEEE_MAX_SIZE) ||
+		(ownAddr7Bit > 0x7F))
+	{
+		return false;
+	}
+	if (sEEPromWaitForReady(hi2c) != HAL_OK)
+	{
+		return false;
+	}
+
+	memset(&i2cSlaveEEState, 0, sizeof(i2cSlaveEEState));
+	i2cSlaveEEState.hi2c		= hi2c;
+	i2cSlaveEEState.ownAddr7Bit = ownAddr7Bit;
+	i2cSlaveEEState.pMem		= pMem;
+	i2cSlaveEEState.size		= size;
+	phase	= PHASE_IDLE;
+	rxArmed = false;
+
+	hi2c->Init.OwnAddress1 = (uint32_t)ownAddr7Bit << 1;
+	if ((HAL_I2C_Init(hi2c) != HAL_OK) || (HAL_I2C_EnableListen_IT(hi2c) != HAL_OK))
+	{
+		return false;
+	}
+	i2cSlaveEEState.lastStopTick = HAL_GetTick();
+	i2cSlaveEEState.listening	 = true;
+	return true;
+}
+
+/**
+ * @brief Back the running region with an AT24C range: load it now, write master writes back later.
+ * <pre>
+ *	If the AT24C is on the bus the slave listens on, listening is paused
+ *	while it is read, (and later while written back).
+ * </pre>
+ *
+ * @param hi2cEE	 - I2C handle of the bus the AT24C is on.
+ * @param eeAddr7Bit - 7 bit AT24C device address.
+ * @param eeAddress	 - First AT24C byte, I2CSLAVEEE_BLOCK_SIZE aligned, range must fit in the part.
+ *
+ * @returns true if loaded.
+ */
+bool i2cSlaveEELoad(I2C_HandleTypeDef *hi2cEE, enumAT24C_7BitAddr eeAddr7Bit, uint16_t eeAddress)
+{
+	bool	 sameBus = (hi2cEE == i2cSlaveEEState.hi2c);
+	uint16_t offset;
+	uint16_t length;
+	bool	 loaded = true;
+
+	if (!i2cSlaveEEState.listening || ((eeAddress % I2CSLAVEEE_BLOCK_SIZE) != 0) ||
+		(((uint32_t)eeAddress + i2cSlaveEEState.size) > AT24C_DEVICE_BYTES))
+	{
+		return false;
+	}
+	if (sameBus && (HAL_I2C_DisableListen_IT(hi2cEE) != HAL_OK))
+	{
+		return false;
+	}
+
+	// Driver reads are at most 255 bytes.
+	for (offset = 0; loaded && (offset < i2cSlaveEEState.size); offset += length)
+	{
+		length = i2cSlaveEEState.size - offset;
+		if (length > 128)
+		{
+			length = 128;
+		}
+		loaded = (sEEPromAckPoll(hi2cEE, eeAddr7Bit) == HAL_OK) &&
+				 (sEEPromRandomAddrReadBytes(hi2cEE, eeAddr7Bit, eeAddress + offset, &i2cSlaveEEState.pMem[offset],
+											 (uint8_t)length) == HAL_OK) &&
+				 (sEEPromWaitForIdle(hi2cEE) == HAL_OK);
+	}
+
+	if (loaded)
+	{
+		i2cSlaveEEState.hi2cEE		= hi2cEE;
+		i2cSlaveEEState.eeAddr7Bit	= eeAddr7Bit;
+		i2cSlaveEEState.eeAddress	= eeAddress;
+		i2cSlaveEEState.dirtyBlocks = 0;
+	}
+	if (sameBus)
+	{
+		HAL_I2C_EnableListen_IT(hi2cEE);
+	}
+	return loaded;
+}
+
+/**
+ * @brief Stop answering, write back anything the master wrote, (AT24C backed).
+ * <pre>
+ *	A transaction in progress is finished first, listening just is not
+ *	enabled again after it.
+ * </pre>
+ */
+void i2cSlaveEEStop(void)
+{
+	I2C_HandleTypeDef *hi2c = i2cSlaveEEState.hi2c;
+	uint32_t		   start;
+
+	if (!i2cSlaveEEState.listening)
+	{
+		return;
+	}
+	i2cSlaveEEState.listening = false;
+	if (hi2c->State == HAL_I2C_STATE_LISTEN)
+	{
+		HAL_I2C_DisableListen_IT(hi2c);
+	}
+	else
+	{
+		// Let the transaction end, ListenCplt sees we are no longer listening.
+		start = HAL_GetTick();
+		while ((hi2c->State != HAL_I2C_STATE_READY) && ((HAL_GetTick() - start) <= I2CSLAVEEE_FLUSH_QUIET_MS))
+		{
+		}
+		if (hi2c->State != HAL_I2C_STATE_READY)
+		{
+			// Master went away mid transaction, take the peripheral back.
+			HAL_I2C_Init(hi2c);
+		}
+	}
+	phase = PHASE_IDLE;
+
+	if (i2cSlaveEEState.hi2cEE != NULL)
+	{
+		i2cSlaveEEFlush();
+	}
+}
+
+/**
+ * @brief Write blocks the master has written back to the AT24C.
+ * <pre>
+ *	Listening on the AT24C's bus is paused while writing, so nothing is
+ *	done while a transaction is in progress there, try again later.
+ * </pre>
+ *
+ * @returns Blocks written.
+ */
+uint32_t i2cSlaveEEFlush(void)
+{
+	I2C_HandleTypeDef *hi2cEE  = i2cSlaveEEState.hi2cEE;
+	bool			   paused  = false;
+	uint32_t		   written = 0;
+	uint32_t		   block;
+	uint32_t		   primask;
+
+	if ((hi2cEE == NULL) || (i2cSlaveEEState.dirtyBlocks == 0))
+	{
+		return 0;
+	}
+	if (i2cSlaveEEState.listening && (hi2cEE == i2cSlaveEEState.hi2c))
+	{
+		if ((hi2cEE->State != HAL_I2C_STATE_LISTEN) || (HAL_I2C_DisableListen_IT(hi2cEE) != HAL_OK))
+		{
+			return 0;
+		}
+		paused = true;
+	}
+
+	for (block = 0; block < (i2cSlaveEEState.size + I2CSLAVEEE_BLOCK_SIZE - 1) / I2CSLAVEEE_BLOCK_SIZE; block++)
+	{
+		if ((i2cSlaveEEState.dirtyBlocks & (1UL << block)) == 0)
+		{
+			continue;
+		}
+		// Clear first, a master write landing during the eeprom write marks it again.
+		primask = __get_PRIMASK();
+		__disable_irq();
+		i2cSlaveEEState.dirtyBlocks &= ~(1UL << block);
+		__set_PRIMASK(primask);
+
+		if ((sEEPromAckPoll(hi2cEE, i2cSlaveEEState.eeAddr7Bit) == HAL_OK) &&
+			(sEEPromBytesWrite(hi2cEE, i2cSlaveEEState.eeAddr7Bit,
+							   i2cSlaveEEState.eeAddress + (uint16_t)(block * I2CSLAVEEE_BLOCK_SIZE),
+							   &i2cSlaveEEState.pMem[block * I2CSLAVEEE_BLOCK_SIZE],
+							   I2CSLAVEEE_BLOCK_SIZE) == HAL_OK) &&
+			(sEEPromWaitForIdle(hi2cEE) == HAL_OK))
+		{
+			written++;
+		}
+		else
+		{
+			i2cSlaveEEState.dirtyBlocks |= 1UL << block;
+			i2cSlaveEEState.flushErrors++;
+			break;
+		}
+	}
+	i2cSlaveEEState.blocksFlushed += written;
+
+	if (paused)
+	{
+		// Last write's tWR runs on, the master is only NACKed by the AT24C, not by us.
+		HAL_I2C_EnableListen_IT(hi2cEE);
+	}
+	return written;
+}
+
+/**
+ * @brief Call from the main loop, writes back to the AT24C once the master has been quiet a while.
+ */
+void i2cSlaveEEService(void)
+{
+	if (i2cSlaveEEState.listening && (i2cSlaveEEState.dirtyBlocks != 0) && (phase == PHASE_IDLE) &&
+		((HAL_GetTick() - i2cSlaveEEState.lastStopTick) >= I2CSLAVEEE_FLUSH_QUIET_MS))
+	{
+		i2cSlaveEEFlush();
+	}
+}
+
+/**
+ * @brief Own address matched, arm the first byte of the transaction.
+ * <pre>
+ *	A repeated START, (address write then read), arrives with the next
+ *	address byte receive still armed, the HAL only arms from LISTEN so the
+ *	state is put back to it.
+ * </pre>
+ *
+ * @param hi2c				- I2C handle.
+ * @param transferDirection - I2C_DIRECTION_TRANSMIT for a master write, (HAL naming is from the master's side).
+ */
+bool i2cSlaveEEOnAddr(I2C_HandleTypeDef *hi2c, uint8_t transferDirection)
+{
+	uint32_t start = i2cTraceNow();
+
+	if (hi2c != i2cSlaveEEState.hi2c)
+	{
+		return false;
+	}
+
+	hi2c->State = HAL_I2C_STATE_LISTEN;
+	rxArmed = false;
+	if (transferDirection == I2C_DIRECTION_TRANSMIT)
+	{
+		i2cSlaveEEState.writes++;
+		phase = PHASE_RX_ADDRESS;
+		armReceive(hi2c);
+	}
+	else
+	{
+		i2cSlaveEEState.reads++;
+		phase = PHASE_TX;
+		armTransmit(hi2c);
+	}
+	noteIsrCycles(start);
+	return true;
+}
+
+bool i2cSlaveEEOnRxCplt(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t start = i2cTraceNow();
+
+	if ((hi2c != i2cSlaveEEState.hi2c) || (phase == PHASE_IDLE))
+	{
+		return false;
+	}
+	byteReceived();
+	armReceive(hi2c);
+	noteIsrCycles(start);
+	return true;
+}
+
+/**
+ * @brief Byte loaded into the data register, (sent once the previous one has gone).
+ */
+bool i2cSlaveEEOnTxCplt(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t start = i2cTraceNow();
+
+	if ((hi2c != i2cSlaveEEState.hi2c) || (phase != PHASE_TX))
+	{
+		return false;
+	}
+	i2cSlaveEEState.bytesTx++;
+	nextAddress();
+	armTransmit(hi2c);
+	noteIsrCycles(start);
+	return true;
+}
+
+/**
+ * @brief Transaction over, (STOP, or NACK ending a read), listen for the next one.
+ */
+bool i2cSlaveEEOnListenCplt(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t start = i2cTraceNow();
+
+	if (hi2c != i2cSlaveEEState.hi2c)
+	{
+		return false;
+	}
+
+	if (phase == PHASE_TX)
+	{
+		// The byte loaded after the last one the master took was never sent.
+		i2cSlaveEEState.address = (i2cSlaveEEState.address == 0) ? (i2cSlaveEEState.size - 1)
+																  : (i2cSlaveEEState.address - 1);
+		i2cSlaveEEState.bytesTx--;
+	}
+	else if (rxArmed && (hi2c->XferCount == 0))
+	{
+		// Last byte picked up by the HAL at STOP, without a SlaveRxCplt.
+		byteReceived();
+	}
+	phase	= PHASE_IDLE;
+	rxArmed = false;
+	i2cSlaveEEState.lastStopTick = HAL_GetTick();
+
+	if (i2cSlaveEEState.listening)
+	{
+		HAL_I2C_EnableListen_IT(hi2c);
+	}
+	noteIsrCycles(start);
+	return true;
+}
+
+/**
+ * @brief Slave side error.  AF is the normal end of a transaction, ListenCplt follows it.
+ */
+bool i2cSlaveEEOnError(I2C_HandleTypeDef *hi2c)
+{
+	if ((hi2c != i2cSlaveEEState.hi2c) || (hi2c->Mode != HAL_I2C_MODE_SLAVE))
+	{
+		return false;
+	}
+	if ((hi2c->ErrorCode & ~HAL_I2C_ERROR_AF) != 0)
+	{
+		i2cSlaveEEState.errors++;
+	}
+	return true;
+}
@@ -0,0 +1,414 @@
+/**
+  @file i2cTrace.c
+  @brief Always on trace of I2C transactions, see i2cTrace.h
+<pre>
+	RAM use: I2CTRACE_RECORDS x 16 bytes, (512), plus a few counters.
+
+	Records are started from main context and ended from the I2C
+	callbacks, (interrupt context), and a background fill does both from
+	interrupt context, so every update of the ring is done with
+	interrupts off.  Each is only a handful of stores.
+
+	One transaction can be open per bus, I2C1 and I2C2 each have their own
+	open record, so slave or second bus traffic does not end the wrong one.
+
+	Device counters: I2CTRACE_DEVICES x 44 bytes, updated as each record ends.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/17/2018
+
+*/
+#include <string.h>
+#include "i2cTrace.h"
+
+typedef char i2cTraceRecordSizeCheck[(sizeof(i2cTraceRecord) == 16) ? 1 : -1];
+typedef char i2cTraceRecordsCheck[((I2CTRACE_RECORDS & (I2CTRACE_RECORDS - 1)) == 0) ? 1 : -1];
+
+#define TRACE_MASK		(I2CTRACE_RECORDS - 1)
+#define TRACE_BUSES		2
+#define NO_RECORD		0xFFFFFFFF
+
+i2cTraceStateStruct	 i2cTraceState;
+i2cTraceDeviceStruct i2cTraceDevices[I2CTRACE_DEVICES];
+
+static i2cTraceRecord	ring[I2CTRACE_RECORDS];
+static uint32_t			ringTotal;					// Records begun, (sequence of next one).
+static uint32_t			openSeq[TRACE_BUSES];		// Record in progress per bus, or NO_RECORD.
+static uint32_t			lastSeq[TRACE_BUSES];		// Last record begun per bus, or NO_RECORD.
+
+
+/**
+ * @brief 0 for I2C2, (eeprom bus), 1 for I2C1.
+ */
+static uint32_t busIndex(I2C_HandleTypeDef *hi2c)
+{
+	return (hi2c->Instance == I2C1) ? 1 : 0;
+}
+
+/**
+ * @brief Record with sequence seq, NULL if it has been overwritten.
+ */
+static i2cTraceRecord *recordAt(uint32_t seq)
+{
+	if ((seq == NO_RECORD) || ((ringTotal - seq) > I2CTRACE_RECORDS))
+	{
+		return NULL;
+	}
+	return &ring[seq & TRACE_MASK];
+}
+
+/**
+ * @brief Counters of the device a record is for, NULL if the table is full, (interrupts off).
+ */
+static i2cTraceDeviceStruct *deviceOf(const i2cTraceRecord *pRecord)
+{
+	uint8_t	 bus = (pRecord->kind & I2CTRACE_BUS1) ? 1 : 0;
+	uint32_t i;
+
+	for (i = 0; i < I2CTRACE_DEVICES; i++)
+	{
+		if (i2cTraceDevices[i].devAddr7Bit == 0)
+		{
+			i2cTraceDevices[i].devAddr7Bit = pRecord->devAddr7Bit;
+			i2cTraceDevices[i].bus		   = bus;
+			return &i2cTraceDevices[i];
+		}
+		if ((i2cTraceDevices[i].devAddr7Bit == pRecord->devAddr7Bit) && (i2cTraceDevices[i].bus == bus))
+		{
+			return &i2cTraceDevices[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Upper limit of a histogram bucket, us, (0 for the last, it has none).
+ */
+uint32_t i2cTraceHistLimitUs(uint32_t bucket)
+{
+	return (bucket < (I2CTRACE_HIST_BUCKETS - 1)) ? ((uint32_t)I2CTRACE_HIST_FIRST_US << bucket) : 0;
+}
+
+/**
+ * @brief Count an ended record against its device, (interrupts off).
+ */
+static void deviceNoteEnd(const i2cTraceRecord *pRecord, uint32_t errorCode, uint32_t cycles)
+{
+	i2cTraceDeviceStruct *pDevice = deviceOf(pRecord);
+	uint32_t			  us;
+	uint32_t			  bucket;
+
+	if (pDevice == NULL)
+	{
+		return;
+	}
+	pDevice->attempts++;
+	if (errorCode == HAL_I2C_ERROR_NONE)
+	{
+		us = i2cTraceCyclesToUs(cycles);
+		for (bucket = 0; (bucket < (I2CTRACE_HIST_BUCKETS - 1)) && (us >= i2cTraceHistLimitUs(bucket)); bucket++)
+		{
+		}
+		if (pDevice->hist[bucket] != 0xFFFF)
+		{
+			pDevice->hist[bucket]++;
+		}
+	}
+	else if (errorCode & HAL_I2C_ERROR_BERR)
+	{
+		pDevice->berr++;
+	}
+	else if (errorCode & HAL_I2C_ERROR_ARLO)
+	{
+		pDevice->arlo++;
+	}
+	else if (errorCode == HAL_I2C_ERROR_AF)
+	{
+		pDevice->nacks++;
+	}
+	else
+	{
+		pDevice->otherErrors++;
+	}
+}
+
+/**
+ * @brief Start the DWT cycle counter and clear the trace, call once at startup.
+ */
+void i2cTraceInit(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	i2cTraceClear();
+}
+
+/**
+ * @brief Drop all records and counters.
+ */
+void i2cTraceClear(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(ring, 0, sizeof(ring));
+	memset(&i2cTraceState, 0, sizeof(i2cTraceState));
+	memset(i2cTraceDevices, 0, sizeof(i2cTraceDevices));
+	ringTotal  = 0;
+	openSeq[0] = openSeq[1] = NO_RECORD;
+	lastSeq[0] = lastSeq[1] = NO_RECORD;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief DWT cycle counter, (SystemCoreClock per second).
+ */
+uint32_t i2cTraceNow(void)
+{
+	return DWT->CYCCNT;
+}
+
+uint32_t i2cTraceCyclesToUs(uint32_t cycles)
+{
+	return cycles / (SystemCoreClock / 1000000);
+}
+
+/**
+ * @brief A transaction is about to be started on hi2c.
+ * <pre>
+ *	A record still open on the bus, (its end was never seen), is closed
+ *	as a timeout first.
+ * </pre>
+ *
+ * @param hi2c		  - I2C handle it will run on.
+ * @param kind		  - enumI2CTraceKind.
+ * @param HAL_DevAddr - 7 bit device address << 1, as the HAL takes it.
+ * @param memAddress  - Memory address in the device, 0 if none.
+ * @param length	  - Bytes.
+ */
+void i2cTraceBegin(I2C_HandleTypeDef *hi2c, enumI2CTraceKind kind, uint16_t HAL_DevAddr, uint16_t memAddress,
+				   uint16_t length)
+{
+	uint32_t		bus = busIndex(hi2c);
+	uint32_t		primask;
+	i2cTraceRecord *pRecord;
+
+	if (openSeq[bus] != NO_RECORD)
+	{
+		i2cTraceEnd(hi2c, HAL_I2C_ERROR_TIMEOUT);
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	pRecord = &ring[ringTotal & TRACE_MASK];
+	pRecord->startCycles = DWT->CYCCNT;
+	pRecord->endCycles	 = pRecord->startCycles;
+	pRecord->memAddress	 = memAddress;
+	pRecord->length		 = length;
+	pRecord->devAddr7Bit = (uint8_t)(HAL_DevAddr >> 1);
+	pRecord->kind		 = (uint8_t)kind | ((bus == 1) ? I2CTRACE_BUS1 : 0);
+	pRecord->result		 = I2CTRACE_RUNNING;
+	pRecord->ackPolls	 = 0;
+	openSeq[bus] = lastSeq[bus] = ringTotal++;
+	i2cTraceState.transactions++;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief The last transaction on hi2c failed and is being started again.
+ * <pre>
+ *	A NACKed one has its record reopened with one more ack poll, so a page
+ *	write that waited out tWR shows as one transaction from first try to
+ *	completion.  Any other error, (arbitration lost, bus error), keeps its
+ *	record and the retry gets a new one for the same device and address.
+ *	If that record is gone nothing is done, the caller's next
+ *	i2cTraceBegin(..) makes a new one.
+ * </pre>
+ *
+ * @returns nothing, see i2cTraceBegin(..)
+ */
+void i2cTraceRetry(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t			  bus	  = busIndex(hi2c);
+	uint32_t			  primask = __get_PRIMASK();
+	i2cTraceRecord		 *pRecord;
+	i2cTraceRecord		 *pRetry;
+	i2cTraceDeviceStruct *pDevice;
+
+	__disable_irq();
+	pRecord = recordAt(lastSeq[bus]);
+	if ((pRecord != NULL) && (openSeq[bus] == NO_RECORD) && (pRecord->result != I2CTRACE_RUNNING))
+	{
+		pDevice = deviceOf(pRecord);
+		if (pDevice != NULL)
+		{
+			pDevice->retries++;
+		}
+		if (pRecord->result == HAL_I2C_ERROR_AF)
+		{
+			pRecord->result = I2CTRACE_RUNNING;
+			if (pRecord->ackPolls < 0xFF)
+			{
+				pRecord->ackPolls++;
+			}
+			openSeq[bus] = lastSeq[bus];
+			i2cTraceState.errors--;
+		}
+		else if (pRecord->result != HAL_I2C_ERROR_NONE)
+		{
+			pRetry				 = &ring[ringTotal & TRACE_MASK];
+			*pRetry				 = *pRecord;
+			pRetry->startCycles	 = DWT->CYCCNT;
+			pRetry->endCycles	 = pRetry->startCycles;
+			pRetry->result		 = I2CTRACE_RUNNING;
+			pRetry->ackPolls	 = 0;
+			openSeq[bus] = lastSeq[bus] = ringTotal++;
+			i2cTraceState.transactions++;
+		}
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Transaction on hi2c has ended, call from the HAL I2C callbacks.
+ *
+ * @param hi2c		- I2C handle.
+ * @param errorCode	- HAL_I2C_ERROR_NONE, or hi2c->ErrorCode.
+ */
+void i2cTraceEnd(I2C_HandleTypeDef *hi2c, uint32_t errorCode)
+{
+	uint32_t		bus		= busIndex(hi2c);
+	uint32_t		now		= DWT->CYCCNT;
+	uint32_t		primask = __get_PRIMASK();
+	uint32_t		cycles;
+	i2cTraceRecord *pRecord;
+
+	__disable_irq();
+	pRecord = recordAt(openSeq[bus]);
+	openSeq[bus] = NO_RECORD;
+	if (pRecord != NULL)
+	{
+		pRecord->endCycles = now;
+		pRecord->result	   = (uint8_t)errorCode;
+		if (errorCode != HAL_I2C_ERROR_NONE)
+		{
+			i2cTraceState.errors++;
+		}
+
+		cycles = now - pRecord->startCycles;
+		deviceNoteEnd(pRecord, errorCode, cycles);
+		if (cycles > i2cTraceState.maxCycles)
+		{
+			i2cTraceState.maxCycles		 = cycles;
+			i2cTraceState.maxMemAddress	 = pRecord->memAddress;
+			i2cTraceState.maxDevAddr7Bit = pRecord->devAddr7Bit;
+			i2cTraceState.maxKind		 = pRecord->kind;
+		}
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Blocking transaction returned, or a non blocking one failed to start.
+ * <pre>
+ *	A non blocking start that returned HAL_OK is still running, its record
+ *	is ended by the callbacks, so this does nothing for HAL_OK then.  Call
+ *	it only for HAL_OK from blocking transactions.
+ * </pre>
+ *
+ * @param hi2c	 - I2C handle.
+ * @param status - What the HAL call returned.
+ */
+void i2cTraceDone(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef status)
+{
+	uint32_t errorCode = hi2c->ErrorCode;
+
+	if (status == HAL_OK)
+	{
+		errorCode = HAL_I2C_ERROR_NONE;
+	}
+	else if (errorCode == HAL_I2C_ERROR_NONE)
+	{
+		// HAL_BUSY / HAL_TIMEOUT waiting for a flag leave ErrorCode clear.
+		errorCode = HAL_I2C_ERROR_TIMEOUT;
+	}
+	i2cTraceEnd(hi2c, errorCode);
+}
+
+/**
+ * @brief Set the ack poll count of the transaction open on hi2c, (saturates at 255).
+ */
+void i2cTraceAckPolls(I2C_HandleTypeDef *hi2c, uint32_t polls)
+{
+	uint32_t		primask = __get_PRIMASK();
+	i2cTraceRecord *pRecord;
+
+	__disable_irq();
+	pRecord = recordAt(openSeq[busIndex(hi2c)]);
+	if (pRecord != NULL)
+	{
+		pRecord->ackPolls = (polls > 0xFF) ? 0xFF : (uint8_t)polls;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Records held, I2CTRACE_RECORDS once the ring has wrapped.
+ */
+uint16_t i2cTraceCount(void)
+{
+	return (ringTotal < I2CTRACE_RECORDS) ? (uint16_t)ringTotal : I2CTRACE_RECORDS;
+}
+
+/**
+ * @brief Header for a binary dump of the records held now.
+ */
+void i2cTraceHeader(i2cTraceDumpHeader *pHeader)
+{
+	pHeader->magic			 = I2CTRACE_DUMP_MAGIC;
+	pHeader->version		 = I2CTRACE_DUMP_VERSION;
+	pHeader->recordSize		 = sizeof(i2cTraceRecord);
+	pHeader->count			 = i2cTraceCount();
+	pHeader->cyclesPerSecond = SystemCoreClock;
+	pHeader->nowCycles		 = DWT->CYCCNT;
+}
+
+/**
+ * @brief Hand the records to handler, oldest first.
+ * <pre>
+ *	Each record is copied with interrupts off, then handed over, so the
+ *	handler may take its time, (UART output).  Transactions started while
+ *	it runs may replace the oldest records still to be sent, they are sent
+ *	as found.
+ * </pre>
+ *
+ * @param handler	 - Called with the sequence number, (since boot or clear), and a copy of each record.
+ * @param maxRecords - At most this many, (the oldest ones), I2CTRACE_RECORDS for all.
+ *
+ * @returns Records handed over.
+ */
+uint16_t i2cTraceQuery(i2cTraceRecordHandler handler, uint16_t maxRecords)
+{
+	uint16_t	   count = i2cTraceCount();
+	uint32_t	   seq	 = ringTotal - count;
+	uint32_t	   primask;
+	uint16_t	   sent;
+	i2cTraceRecord record;
+
+	if (count > maxRecords)
+	{
+		count = maxRecords;
+	}
+	for (sent = 0; sent < count; sent++, seq++)
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+		record = ring[seq & TRACE_MASK];
+		__set_PRIMASK(primask);
+
+		handler(seq, &record);
+	}
+	return sent;
+}
@@ -0,0 +1,186 @@
+/**
+  @file idleSleep.c
+  @brief Tickless idle for the main loop, see idleSleep.h
+<pre>
+	Called with interrupts off, (PRIMASK), from mainEventWait(..), and
+	returns with them still off: the WFI ends on any pending interrupt
+	but none runs until the caller turns them on, so the tick is made
+	right, and SysTick restarted, before any handler looks at it.
+
+	SysTick is stopped for a few instructions each side of the sleep, the
+	ms are a few cycles long per tickless sleep, well inside HSI's 1%.
+
+	The arithmetic is idleSleepAccount(..), no registers, so hostBench
+	checks it, the host has no SysTick to stretch.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/07/2018
+
+*/
+#include "idleSleep.h"
+#include "taskSched.h"
+#include "i2cBus.h"
+
+/// HAL tick, (stm32f1xx_hal.c), HAL_IncTick() once per ms skipped is too slow with interrupts off.
+extern __IO uint32_t uwTick;
+
+/// Counts, on / off.
+idleSleepStateStruct idleSleepState;
+
+
+/**
+ * @brief Tickless on or off, stats started again.
+ */
+void idleSleepInit(bool enabled)
+{
+	idleSleepState.enabled		= enabled;
+	idleSleepState.tickless		= 0;
+	idleSleepState.tickKept		= 0;
+	idleSleepState.early		= 0;
+	idleSleepState.ticksSkipped	= 0;
+	idleSleepState.maxSleepMs	= 0;
+	idleSleepState.sleptUs		= 0;
+	idleSleepState.sinceTick	= HAL_GetTick();
+}
+
+/**
+ * @brief Whole ms the core may sleep with SysTick stopped, 0 if the tick must be kept.
+ */
+static uint32_t idleMs(uint32_t maxMs)
+{
+	uint32_t ms = maxMs;
+	uint32_t bus;
+
+	if (!idleSleepState.enabled)
+	{
+		return 0;
+	}
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		if (i2cBusState[bus].retryWaiting)
+		{
+			return 0;
+		}
+	}
+	if (taskSchedState.armed)
+	{
+		if ((int32_t)(taskSchedState.nextDueMs - HAL_GetTick()) < IDLESLEEP_MIN_MS)
+		{
+			return 0;
+		}
+		if ((taskSchedState.nextDueMs - HAL_GetTick()) < ms)
+		{
+			ms = taskSchedState.nextDueMs - HAL_GetTick();
+		}
+	}
+	return ms;
+}
+
+/**
+ * @brief ms slept and where the ms in progress ends, from SysTick's count after a tickless sleep.
+ * <pre>
+ *	SysTick was loaded with val + msCycles * (ms - 1), val being what was
+ *	left of the ms in progress, and valNow is its count once stopped again:
+ *
+ *		counted out		it reached 0, (SysTick_Handler(..) pending, it
+ *						counts the last ms), reloaded and went on to valNow
+ *		woke early		counted down from the load to valNow
+ *
+ *	A nextCycles under 2 would load SysTick with 0, which never counts
+ *	down to an interrupt, that ms is taken now and the next one loaded.
+ * </pre>
+ */
+void idleSleepAccount(uint32_t msCycles, uint32_t ms, uint32_t val, uint32_t valNow, bool countedOut,
+					  idleSleepAccountStruct *pAccount)
+{
+	uint32_t reload	 = val + msCycles * (ms - 1);
+	uint32_t elapsed = reload - valNow;
+
+	if (countedOut)
+	{
+		pAccount->ticks		  = ms - 1;
+		pAccount->nextCycles  = (elapsed < msCycles) ? (msCycles - elapsed) : 1;
+		pAccount->sleptCycles = reload + elapsed;
+	}
+	else if (elapsed < val)
+	{
+		pAccount->ticks		  = 0;
+		pAccount->nextCycles  = val - elapsed;
+		pAccount->sleptCycles = elapsed;
+	}
+	else
+	{
+		pAccount->ticks		  = 1 + ((elapsed - val) / msCycles);
+		pAccount->nextCycles  = msCycles - ((elapsed - val) % msCycles);
+		pAccount->sleptCycles = elapsed;
+	}
+
+	if (pAccount->nextCycles < 2)
+	{
+		pAccount->ticks++;
+		pAccount->nextCycles += msCycles;
+	}
+}
+
+/**
+ * @brief Sleep until the next task is due or an interrupt, SysTick stopped, (idleSleep.h), interrupts off.
+ */
+void idleSleepEnter(void)
+{
+	uint32_t msCycles = SysTick->LOAD + 1;		// One ms at the clock in use, (clockProfile.h).
+	uint32_t ms		  = idleMs(SysTick_LOAD_RELOAD_Msk / msCycles);
+	uint32_t val;
+	bool	 countedOut;
+	idleSleepAccountStruct account;
+
+	if (ms < IDLESLEEP_MIN_MS)
+	{
+		idleSleepState.tickKept++;
+		__WFI();
+		return;
+	}
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		// A ms ended just now, let SysTick_Handler(..) have it first.
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		idleSleepState.tickKept++;
+		__WFI();
+		return;
+	}
+
+	// The ms in progress ends in val, then ms - 1 whole ones, the last ends at nextDueMs.
+	val			  = SysTick->VAL;
+	SysTick->LOAD = val + msCycles * (ms - 1);
+	SysTick->VAL  = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	countedOut = ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0);
+	idleSleepAccount(msCycles, ms, val, SysTick->VAL, countedOut, &account);
+	uwTick += account.ticks;
+
+	// To the end of the ms in progress, then whole ms again, (LOAD is taken at the next reload).
+	SysTick->LOAD = account.nextCycles - 1;
+	SysTick->VAL  = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = msCycles - 1;
+
+	idleSleepState.tickless++;
+	if (!countedOut)
+	{
+		idleSleepState.early++;
+	}
+	idleSleepState.ticksSkipped += account.ticks;
+	idleSleepState.sleptUs		+= account.sleptCycles / (SystemCoreClock / 1000000);
+	if ((account.sleptCycles / msCycles) > idleSleepState.maxSleepMs)
+	{
+		idleSleepState.maxSleepMs = account.sleptCycles / msCycles;
+	}
+}
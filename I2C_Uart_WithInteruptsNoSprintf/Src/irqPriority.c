@@ -0,0 +1,133 @@
+/**
+  @file irqPriority.c
+  @brief NVIC priority tiers and ISR run time / latency stats, see irqPriority.h
+<pre>
+	The stats are written only by the handler they belong to, (a handler
+	does not preempt itself), and read by S[0x1E] a word at a time, so
+	nothing here turns interrupts off.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/05/2018
+
+*/
+#include <string.h>
+#include "irqPriority.h"
+
+/// Per instrumented handler: its IRQ, tier and name for S[0x1E].
+static const struct {
+	IRQn_Type	irqn;
+	uint8_t		priority;
+	const char	*name;
+} irqTable[IRQSTAT_COUNT] = {
+	{ USART1_IRQn,			IRQPRIO_UART,		"USART1"	},
+	{ I2C2_EV_IRQn,			IRQPRIO_I2C,		"I2C2_EV"	},
+	{ I2C2_ER_IRQn,			IRQPRIO_I2C,		"I2C2_ER"	},
+	{ I2C1_EV_IRQn,			IRQPRIO_I2C,		"I2C1_EV"	},
+	{ I2C1_ER_IRQn,			IRQPRIO_I2C,		"I2C1_ER"	},
+	{ DMA1_Channel4_IRQn,	IRQPRIO_I2C,		"DMA1_CH4"	},
+	{ DMA1_Channel5_IRQn,	IRQPRIO_I2C,		"DMA1_CH5"	},
+	{ DMA1_Channel6_IRQn,	IRQPRIO_I2C,		"DMA1_CH6"	},
+	{ DMA1_Channel7_IRQn,	IRQPRIO_I2C,		"DMA1_CH7"	},
+	{ DMA1_Channel1_IRQn,	IRQPRIO_ADC,		"DMA1_CH1"	},
+	{ ADC1_IRQn,			IRQPRIO_ADC,		"ADC1"		},
+	{ EXTI0_IRQn,			IRQPRIO_ADC,		"EXTI0"		},
+	{ SysTick_IRQn,			IRQPRIO_SYSTICK,	"SysTick"	},
+	{ PendSV_IRQn,			IRQPRIO_DEFERRED,	"PendSV"	}
+};
+
+/// Counts and worst runs.
+irqPriorityStateStruct irqPriorityState;
+
+
+/**
+ * @brief Set every interrupt used to its tier, (irqPriority.h).
+ * <pre>
+ *	Call after the MX_xxx_Init()'s, and again after each clock change,
+ *	HAL_InitTick(..) sets SysTick to TICK_INT_PRIORITY.
+ * </pre>
+ */
+void irqPriorityApply(void)
+{
+	uint32_t irq;
+
+	HAL_NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
+	for (irq = 0; irq < IRQSTAT_COUNT; irq++)
+	{
+		HAL_NVIC_SetPriority(irqTable[irq].irqn, irqTable[irq].priority, 0);
+	}
+}
+
+/**
+ * @brief Last thing in a handler, after IRQPRIO_ENTER(irq).
+ */
+void irqPriorityExit(enumIrqStat irq)
+{
+	uint32_t cycles = DWT->CYCCNT - irqPriorityState.entryCycles[irq];
+
+	irqPriorityState.count[irq]++;
+	if (cycles > irqPriorityState.maxRunCycles[irq])
+	{
+		irqPriorityState.maxRunCycles[irq] = cycles;
+	}
+}
+
+/**
+ * @brief SysTick fired to now, first thing in SysTick_Handler(..), (the counter reloaded and counts down from LOAD).
+ */
+void irqPriorityTickEntry(void)
+{
+	uint32_t cycles = SysTick->LOAD - SysTick->VAL;
+
+	IRQPRIO_ENTER(IRQSTAT_SYSTICK);
+	if (cycles > irqPriorityState.maxTickEntryCycles)
+	{
+		irqPriorityState.maxTickEntryCycles = cycles;
+	}
+}
+
+uint8_t irqPriorityOf(enumIrqStat irq)
+{
+	return irqTable[irq].priority;
+}
+
+const char *irqPriorityName(enumIrqStat irq)
+{
+	return irqTable[irq].name;
+}
+
+/**
+ * @brief Worst entry latency of irq, DWT cycles, from the runs seen so far, (irqPriority.h).
+ */
+uint32_t irqPriorityBoundCycles(enumIrqStat irq)
+{
+	uint32_t sameTier = 0;
+	uint32_t higher	  = 0;
+	uint32_t other;
+
+	for (other = 0; other < IRQSTAT_COUNT; other++)
+	{
+		if (irqTable[other].priority == irqTable[irq].priority)
+		{
+			if (irqPriorityState.maxRunCycles[other] > sameTier)
+			{
+				sameTier = irqPriorityState.maxRunCycles[other];
+			}
+		}
+		else if (irqTable[other].priority < irqTable[irq].priority)
+		{
+			higher += irqPriorityState.maxRunCycles[other];
+		}
+	}
+	return sameTier + higher;
+}
+
+/**
+ * @brief Start the counts and worst runs again.
+ */
+void irqPriorityClear(void)
+{
+	memset(irqPriorityState.count, 0, sizeof(irqPriorityState.count));
+	memset(irqPriorityState.maxRunCycles, 0, sizeof(irqPriorityState.maxRunCycles));
+	irqPriorityState.maxTickEntryCycles = 0;
+}
@@ -1,540 +1,776 @@
-/**
-* @file main.c
-* @brief Main program body
-*
-* This source file is where top level of control for this demo firmware resides.
-* The target platform is STM32VLDISCOVERY demo board with STM Arm Cortex M3
-* p/n STM32F100RBT6B.
-*
-* @author Joe Kuss (JMK)
-*
-* @date 03/01/2018
-*/
-
-/*
-  ******************************************************************************
-  * File Name          : main.c
-  * REGARDING HAL CODE, AUTO GENERATED OR PROVIDED AS EXAMPLES.
-  ******************************************************************************
-  ** This notice applies to any and all portions of this file that are
-  *  autogenerated or modified from STM designed application examples.
-  *
-  * COPYRIGHT(c) 2017 STMicroelectronics
-  *
-  * Redistribution and use in source and binary forms, with or without modification,
-  * are permitted provided that the following conditions are met:
-  *   1. Redistributions of source code must retain the above copyright notice,
-  *      this list of conditions and the following disclaimer.
-  *   2. Redistributions in binary form must reproduce the above copyright notice,
-  *      this list of conditions and the following disclaimer in the documentation
-  *      and/or other materials provided with the distribution.
-  *   3. Neither the name of STMicroelectronics nor the names of its contributors
-  *      may be used to endorse or promote products derived from this software
-  *      without specific prior written permission.
-  *
-  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
-  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
-  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
-  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
-  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
-  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
-  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
-  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  *
-  ******************************************************************************
-  */
-/* Includes ------------------------------------------------------------------*/
-#include <string.h>
-#include <stdbool.h>
-#include "main.h"
-
-// STM HAL code:
-#include "stm32f1xx_hal.h"
-#include "stm32f1xx_hal_uart.h"
-
-
-// JMK code:
-#include "i2c_jmk.h"
-#include "uart_jmk.h"
-#include "led.h"
-#include "pushButton.h"
-#include "serialCmdParser.h"
-#include "serialEEProm.h"
-
-
-/* External Variables ------------------------------------------------------- */
-// JMK code:
-extern uint8_t		Rx_data[2];
-extern char			buffer[256];
-extern uint8_t		Rx_Buffer[256];
-extern bool			Transfer_cplt;
-
-/* Private variables ---------------------------------------------------------*/
-// STM HAL types utilized by JMK:
-ADC_HandleTypeDef hadc1;
-I2C_HandleTypeDef hi2c2;
-UART_HandleTypeDef huart1;
-
-// JMK code:
-/// count of 100 mS intervals, for blinking LED.
-uint32_t count = 0;
-/// Blink rate code for LED:
-uint32_t BlinkSpeed = 0;
-/// Previous blue button pressed state, 1 == pressed.
-uint32_t KeyState = 0;
-
-
-/// Header msg displayed at startup
-//char msg[] = "Serial Command Interpreter: v0.02 Copyright" + __DATE__ + ", J.M. Kuss \r\n\r\n"; // does not like + here.
-char msg1[] = "Serial Command Interpreter: v0.02 Copyright ";
-char msg2[] = __DATE__;
-char msg3[] = " , J.M. Kuss \r\n\r\n";
-
-uint8_t returnedByte;
-
-HAL_StatusTypeDef I2C_HAL_Status;
-
-
-/* Private function prototypes -----------------------------------------------*/
-// STM code, and or modified by JMK:
-static void SystemClock_Config(void); // added "static"
-static void MX_GPIO_Init(void);
-static void MX_USART1_UART_Init(void);
-static void MX_I2C2_Init(void);
-static void MX_ADC1_Init(void);
-
-int main(void)
-{
-	uint32_t demoMode = 1;	// allow 1..3
-
-	// STM HAL  and initialization code:
-	/* MCU Configuration */
-
-	/** Reset of all peripherals, Initializes the Flash interface and the Systick. */
-	HAL_Init();
-	/** Configure the system clock */
-	SystemClock_Config();
-
-	/** Initialize all configured peripherals */
-	MX_GPIO_Init();
-	MX_USART1_UART_Init();
-	MX_I2C2_Init();
-	MX_ADC1_Init();
-
-	/// Activate non blocking UART rx interrupt every time get 1 byte..
-	HAL_UART_Receive_IT(&huart1, Rx_data, 1);
-
-	// STM example code modified by JMK:
-	STM32vldisc_LEDOff(LED3);
-	STM32vldisc_LEDOff(LED4);
-
-	// JMK code:
-
-	// Introductory HW string ==========================
-	UartPutString(msg1, true);    // Blocking.
-	UartPutString(msg2, true);    // Blocking.
-	UartPutString(msg3, true);    // Blocking.
-
-	while (1)
-	{
-		/// Respond to any serial commands sent via "cmdHandler"
-		// Cmd_Recievd will be true if we receive the code 0x0D <13-Carriage Return>, in
-		// the data stream indicating end of cmd msg. (It will also be true if we have
-		// seen 255 bytes in the data stream since last Cmd_Recieved, as a back up,
-		// to check incoming bytes before overflow data buffer.)
-
-		if (Cmd_Recieved == true)
-		{
-			/// Go parse and execute latest command:
-			cmdHandler(cmdBuffer);
-
-			// Look for next "Transfer":
-			Cmd_Recieved = false;
-		}
-
-		//================================
-
-		/// Utilize LEDs and pushbuttons on STM32VLDISCOVERY demo board
-		/// as alternative to serial commands, control panel human interface.
-
-		if	( 0 == STM32vldisc_PBGetState(BUTTON_USER)	)  // 0 == USER BUTTON not pressed.
-		{
-			if(KeyState == 1)
-			{
-				// If previously pressed, and now continues not pressed:
-				if(0 == STM32vldisc_PBGetState(BUTTON_USER)) // If not pressed.
-				{
-					/* USER Button released */
-					// Finally set previous blue button state to released.
-					KeyState = 0;
-					/* Turn Off LED4 */
-					STM32vldisc_LEDOff(LED4);
-				}
-			}
-		}
-		else if(STM32vldisc_PBGetState(BUTTON_USER)) // 1 == USER BUTON is pressed
-		{
-			if(KeyState == 0)
-			{
-				// If previously not pressed but now continues as pressed.
-				if(STM32vldisc_PBGetState(BUTTON_USER))
-				{
-					// A new button pressed down transition
-					// has occurred:
-
-					/* USER Button pressed */
-					// Finally set previous state to pressed.
-					KeyState = 1;
-					/* Turn ON LED4 - Indicate button pressed ! */
-					STM32vldisc_LEDOn(LED4);
-
-					// ########## Upon button push, execute these tests of sEEProm routines:
-
-					// T1: I2C_HAL_Status = sEEPromCurrentAddrReadByte(&hi2c2, A0A1_00, &eePromByteRead);
-					// T2: I2C_HAL_Status = sEEPromCurrentAddrReadBytes(&hi2c2, A0A1_00, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
-					// T3: I2C_HAL_Status = sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, &eePromByteRead);
-					// T4: I2C_HAL_Status = sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0000, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
-
-					// Note: For testing the Writes, there is a 10ms max deadtime "tWR"
-					// This is also known as the write cycle time tWR is the time from a valid stop condition of a
-					// write sequence to the end of the internal clear/write cycle.
-					/* T5:
-					eePromByteToBeWritten = 0x77;
-					I2C_HAL_Status = sEEPromByteWrite(&hi2c2, A0A1_00, 0x0000,&eePromByteToBeWritten); // Write a byte to a page, page 0 byte 0.
-					// Delay for tWR of 10ms:
-
-					STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
-					HAL_Delay(10); 				// Delay 10ms, -  toggle port LED4 (PC8) pin to measure delay
-					STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
-
-					// Read back from same place to check for successful write:
-					I2C_HAL_Status = sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, &eePromByteRead);
-					*/
-
-					/*
-					// T6 & T7. Write lowest page all 64 bytes, then read back.:
-					I2C_HAL_Status =  sEEPromBytesWrite(&hi2c2, A0A1_00, 0x0000,  eePromWritePageBytes.array, (uint16_t) eePromWritePageBytes.bytesInPage);
-
-					STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
-					HAL_Delay(10); 				// Delay 10ms, -  toggle port LED4 (PC8) pin to measure delay
-					STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
-
-					I2C_HAL_Status = sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0000, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
-
-					// T7 Write highest page all 64 bytes, then read back.:
-					// Reset the read array struct so that we know that read really loaded the array.
-					sEEPromPageBufferFill(&eePromReadPageBytes, FILL_0 );
-					// Reset the write array struct so that we now count down rather than up, now from 63 to 0.
-					sEEPromPageBufferFill(&eePromWritePageBytes, FILL_REVERSE_INDEX );
-
-					I2C_HAL_Status =  sEEPromBytesWrite(&hi2c2, A0A1_00, 0x7FC0,  eePromWritePageBytes.array, (uint16_t) eePromWritePageBytes.bytesInPage);
-
-					STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
-					HAL_Delay(10); 				// Delay 10ms, -  toggle port LED4 (PC8) pin to measure delay
-					STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
-
-					I2C_HAL_Status = sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x7FC0, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
-
-					// *** Or do some kind of ACKNOWLEDGE POLLING:, do a 1 byte read,
-					// try sEEPromCurrentAddrReadByte(..) and see if we can repeat this command while I2C_HAL_Status
-					// is not ok for no ack, and hope that repeat does not hang up the HAL or the i2c prom.
-					// Once we see ok then it gave an ack and the busy period for page write is over.
-					// May need to experiment to see if this works.
-
-					*/
-
-					/// Every time pushbutton is pressed, cycle among
-					/// demoModes (test cases) : 1, 2, 3.
-
-					switch (demoMode) {
-
-					case 1:
-						// This time do test case 1:
-
-						// Next time do demo/test #2
-						demoMode++;
-						break;
-
-					case 2:
-						// This time do test case 2:
-
-						// Next time do demo/test #3
-						demoMode++;
-						break;
-					case 3:
-						// This time do test case 3:
-
-						// Next time do demo/test #1
-						demoMode = 1;
-						break;
-					default:
-						// backstop:
-						demoMode = 1;
-						break;
-					}
-
-					// Delay for 1 second after reacting to keypress down,
-					// good for debouncing..
-
-					HAL_Delay(1000);
-
-					/* LED4 on for at least 1 sec after blue button down */
-					STM32vldisc_LEDOff(LED4);
-
-					// Presently expect BlinkSpeed 0,1,2, to follow demoMode 1->2->3.
-					BlinkSpeed++ ;
-
-				}	// if(STM32vldisc_PBGetState(BUTTON_USER))
-			}	// if(KeyState == 0)
-		}	// else if(STM32vldisc_PBGetState(BUTTON_USER))
-
-		/// Final part of while loop will exec and blink LED continually
-		/// depending on demo mode, except when in 1 sec delay after blue button down
-		/// Blink speed has 3 rates:
-		/// 1.25 Hz (DemoMode 1)
-		/// 2.5 Hz  (DemoMode 2)
-		/// 5 Hz    (DemoMode 3).
-
-		count++;
-		HAL_Delay(100);
-
-		/* BlinkSpeed: 0 */
-		if(BlinkSpeed == 0)
-		{
-			// While looking at count of 0..7, repeating:
-			// Toggle LED as counts of 0 and 4:
-			// When BlinkSpeed = 0 then LED is on 400mS , off 400mS.
-			if(4 == (count % 8))
-				STM32vldisc_LEDOn(LED3);
-			if(0 == (count % 8))
-				STM32vldisc_LEDOff(LED3);
-		}
-
-		/* BlinkSpeed: 1 */
-		if(BlinkSpeed == 1)
-		{
-			// While looking at count of 0..3 repeating,
-			// Toggle LED at counts of counts of 0 and 2
-			// When BlinkSpeed = 1 then LED is on 200mS, off 200mS
-			if(2 == (count % 4))
-				STM32vldisc_LEDOn(LED3);
-			if(0 == (count % 4))
-				STM32vldisc_LEDOff(LED3);
-		}
-		/* BlinkSpeed: 2 */
-		if(BlinkSpeed == 2)
-		{
-			// While looking at count of 0 to 1 repeating,
-			// Toggle LED at counts of 0 and 1
-			// When BlinkSpeed = 2 then LED is on 100mS, off 100mS
-			if(0 == (count % 2))
-				STM32vldisc_LEDOn(LED3);
-			else
-				STM32vldisc_LEDOff(LED3);
-		}
-		/* BlinkSpeed: 3 - Only have 3 speeds 0,1,2 actually. */
-		else if(BlinkSpeed == 3)
-		{
-			BlinkSpeed = 0;
-		}
-
-  } // End while (1)
-
-} // End main()
-
-//##########################################################
-//	Note: SystemClock_Config(void) and
-//	MX_xxx functions below are all auto-generated by  "STM32CubeMX.exe"
-//
-//##########################################################
-
-/** 	System Clock Configuration
-*/
-void SystemClock_Config(void)
-{
-  RCC_OscInitTypeDef RCC_OscInitStruct;
-  RCC_ClkInitTypeDef RCC_ClkInitStruct;
-  RCC_PeriphCLKInitTypeDef PeriphClkInit;
-
-  /**	Initializes the CPU, AHB and APB busses clocks
-  */
-  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
-  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
-  RCC_OscInitStruct.HSICalibrationValue = 16;
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
-  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-
-  /**Initializes the CPU, AHB and APB busses clocks
-  */
-  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
-                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
-  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
-  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
-  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
-  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
-
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-
-  PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_ADC;
-  PeriphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV2;
-  if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-
-  /**Configure the Systick interrupt time
-  */
-  HAL_SYSTICK_Config(HAL_RCC_GetHCLKFreq()/1000);
-
-  /**Configure the Systick
-  */
-  HAL_SYSTICK_CLKSourceConfig(SYSTICK_CLKSOURCE_HCLK);
-
-  /** Configure the SysTick_IRQn interrupt */
-  HAL_NVIC_SetPriority(SysTick_IRQn, 0, 0);
-}
-
-/** ADC1 init function */
-static void MX_ADC1_Init(void)
-{
-
-  ADC_ChannelConfTypeDef sConfig;
-
-  /**Common config
-  */
-  hadc1.Instance = ADC1;
-  hadc1.Init.ScanConvMode = ADC_SCAN_DISABLE;
-  hadc1.Init.ContinuousConvMode = DISABLE;
-  hadc1.Init.DiscontinuousConvMode = DISABLE;
-  hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
-  hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
-  hadc1.Init.NbrOfConversion = 1;
-  if (HAL_ADC_Init(&hadc1) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-
-  /**Configure Regular Channel
-  */
-  sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
-  sConfig.Rank = 1;
-  sConfig.SamplingTime = ADC_SAMPLETIME_1CYCLE_5;
-  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-}
-
-/** I2C2 init function */
-static void MX_I2C2_Init(void)
-{
-
-  hi2c2.Instance = I2C2;
-  hi2c2.Init.ClockSpeed = 100000;
-  hi2c2.Init.DutyCycle = I2C_DUTYCYCLE_2;
-  hi2c2.Init.OwnAddress1 = 0;
-  hi2c2.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
-  hi2c2.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
-  hi2c2.Init.OwnAddress2 = 0;
-  hi2c2.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
-  hi2c2.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
-  if (HAL_I2C_Init(&hi2c2) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-
-}
-
-/** USART1 init function */
-static void MX_USART1_UART_Init(void)
-{
-
-  huart1.Instance = USART1;
-  huart1.Init.BaudRate = 115200;
-  huart1.Init.WordLength = UART_WORDLENGTH_8B;
-  huart1.Init.StopBits = UART_STOPBITS_1;
-  huart1.Init.Parity = UART_PARITY_NONE;
-  huart1.Init.Mode = UART_MODE_TX_RX;
-  huart1.Init.HwFlowCtl = UART_HWCONTROL_NONE;
-  huart1.Init.OverSampling = UART_OVERSAMPLING_16;
-  if (HAL_UART_Init(&huart1) != HAL_OK)
-  {
-    _Error_Handler(__FILE__, __LINE__);
-  }
-
-}
-
-/** Configure pins as 
-        * Analog 
-        * Input 
-        * Output
-        * EVENT_OUT
-        * EXTI
-*/
-static void MX_GPIO_Init(void)
-{
-
-  GPIO_InitTypeDef GPIO_InitStruct;
-
-  /** GPIO Ports Clock Enable */
-  __HAL_RCC_GPIOA_CLK_ENABLE();
-  __HAL_RCC_GPIOB_CLK_ENABLE();
-  __HAL_RCC_GPIOC_CLK_ENABLE();
-
-  /** Configure GPIO pin Output Level */
-  HAL_GPIO_WritePin(GPIOC, LD4_Blue_Pin|LD3_Green_Pin, GPIO_PIN_RESET);
-
-  /** Configure GPIO pins : LD4_Blue_Pin LD3_Green_Pin */
-  GPIO_InitStruct.Pin = LD4_Blue_Pin|LD3_Green_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-  HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
-
-}
-
-/**
-  * @brief  This function is executed in case of error occurrence.
-  * @param  None
-  * @retval None
-  */
-void _Error_Handler(char * file, int line)
-{
-  /// User can add his own implementation to report the HAL error return state */
-  /// ==> Right here:
-  while(1) 
-  {
-	  // A way of ensuring a NOP, even if code optimizer is on:
-	  // http://www.ethernut.de/en/documents/arm-inline-asm.html
-	  asm volatile("mov r0, r0");
-  }
-  /* USER CODE END Error_Handler_Debug */ 
-}
-
-#ifdef USE_FULL_ASSERT
-
-/**
-   * @brief Reports the name of the source file and the source line number
-   * where the assert_param error has occurred.
-   * @param file: pointer to the source file name
-   * @param line: assert_param error line source number
-   * @retval None
-   */
-void assert_failed(uint8_t* file, uint32_t line)
-{
-  /* USER CODE BEGIN 6 */
-  /* User can add his own implementation to report the file name and line number,
-    ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
-  /* USER CODE END 6 */
-
-}
-
-#endif
-
+/**
+* @file main.c
+* @brief Main program body
+*
+* This source file is where top level of control for this demo firmware resides.
+* The target platform is STM32VLDISCOVERY demo board with STM Arm Cortex M3
+* p/n STM32F100RBT6B.
+*
+* @author Joe Kuss (JMK)
+*
+* @date 03/01/2018
+*/
+
+/*
+  ******************************************************************************
+  * File Name          : main.c
+  * REGARDING HAL CODE, AUTO GENERATED OR PROVIDED AS EXAMPLES.
+  ******************************************************************************
+  ** This notice applies to any and all portions of this file that are
+  *  autogenerated or modified from STM designed application examples.
+  *
+  * COPYRIGHT(c) 2017 STMicroelectronics
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <stdbool.h>
+#include "main.h"
+
+// STM HAL code:
+#include "stm32f1xx_hal.h"
+#include "stm32f1xx_hal_uart.h"
+
+
+// JMK code:
+#include "i2c_jmk.h"
+#include "uart_jmk.h"
+#include "led.h"
+#include "pushButton.h"
+#include "serialCmdParser.h"
+#include "serialEEProm.h"
+#include "eePromLog.h"
+#include "eePromCrc.h"
+#include "i2cTrace.h"
+#include "i2cSlaveEE.h"
+#include "i2cScan.h"
+#include "i2cBus.h"
+#include "i2cRetry.h"
+#include "adcSampler.h"
+#include "adcFilter.h"
+#include "adcAlarm.h"
+#include "adcTemp.h"
+#include "mainEvent.h"
+#include "taskSched.h"
+#include "irqPriority.h"
+#include "clockProfile.h"
+#include "idleSleep.h"
+
+
+/* External Variables ------------------------------------------------------- */
+// JMK code:
+extern uint8_t		Rx_data[2];
+extern char			buffer[256];
+extern bool			Transfer_cplt;
+
+/* Private variables ---------------------------------------------------------*/
+// STM HAL types utilized by JMK:
+ADC_HandleTypeDef hadc1;
+I2C_HandleTypeDef hi2c1;
+I2C_HandleTypeDef hi2c2;
+DMA_HandleTypeDef hdma_i2c1_tx;
+DMA_HandleTypeDef hdma_i2c1_rx;
+DMA_HandleTypeDef hdma_i2c2_tx;
+DMA_HandleTypeDef hdma_i2c2_rx;
+DMA_HandleTypeDef hdma_adc1;
+TIM_HandleTypeDef htim3;
+UART_HandleTypeDef huart1;
+
+// JMK code:
+/// count of LED3 toggles, (blinkTask).
+uint32_t count = 0;
+/// Blink rate code for LED:
+uint32_t BlinkSpeed = 0;
+/// Previous blue button pressed state, 1 == pressed.
+uint32_t KeyState = 0;
+
+/// LED3 toggle period per BlinkSpeed, 1.25 Hz, 2.5 Hz, 5 Hz.
+static const uint32_t blinkPeriodMs[3] = { 400, 200, 100 };
+
+/// Log a temperature sample this often.
+#define TEMP_LOG_MS			1000
+
+/// Bus timeouts and handle busy restarts, SS[x] resends, slave eeprom write back, this often.
+#define SERVICE_MS			100
+
+/// Blue button edges this close after a release are bounce, presses this close after a press are ignored, (LED4 stays on).
+#define BUTTON_DEBOUNCE_MS	50
+#define BUTTON_HOLDOFF_MS	1000
+
+/// Tasks run by taskSchedRun(..), (taskSched.h), in the main loop.
+static uint8_t commandTaskId;
+static uint8_t alarmTaskId;
+static uint8_t i2cTaskId;
+static uint8_t buttonTaskId;
+static uint8_t blinkTaskId;
+static uint8_t led4TaskId;
+
+/// Blue button, demo mode 1..3, last edges.
+static uint32_t demoMode	= 1;
+static uint32_t pressTick	= 0;
+static uint32_t releaseTick = 0;
+
+/// Header msg displayed at startup
+//char msg[] = "Serial Command Interpreter: v0.02 Copyright" + __DATE__ + ", J.M. Kuss \r\n\r\n"; // does not like + here.
+char msg1[] = "Serial Command Interpreter: v0.02 Copyright ";
+char msg2[] = __DATE__;
+char msg3[] = " , J.M. Kuss \r\n\r\n";
+
+uint8_t returnedByte;
+
+HAL_StatusTypeDef I2C_HAL_Status;
+
+
+/* Private function prototypes -----------------------------------------------*/
+// STM code, and or modified by JMK:
+static void SystemClock_Config(void); // added "static"
+static void MX_GPIO_Init(void);
+static void MX_USART1_UART_Init(void);
+static void MX_DMA_Init(void);
+static void MX_I2C1_Init(void);
+static void MX_I2C2_Init(void);
+static void MX_ADC1_Init(void);
+static void MX_TIM3_Init(void);
+
+// JMK code, main loop tasks:
+static void commandTask(void);
+static void buttonTask(void);
+static void blinkTask(void);
+static void led4OffTask(void);
+static void tempLogTask(void);
+static void addTasks(void);
+
+int main(void)
+{
+	uint32_t events;		// MAINEVT_BIT's posted since the last pass.
+
+	// STM HAL  and initialization code:
+	/* MCU Configuration */
+
+	/** Reset of all peripherals, Initializes the Flash interface and the Systick. */
+	HAL_Init();
+	/** Configure the system clock */
+	SystemClock_Config();
+
+	/** Initialize all configured peripherals */
+	MX_GPIO_Init();
+	MX_DMA_Init();
+	MX_USART1_UART_Init();
+	MX_I2C1_Init();
+	MX_I2C2_Init();
+
+	/// Transfer queue per bus, I2C2 (AT24C) and I2C1 run side by side, failed transfers retried per i2cRetry.h.
+	i2cRetryInit();
+	i2cBusInit();
+	MX_ADC1_Init();
+	MX_TIM3_Init();
+
+	/// Interrupt tiers, UART above I2C above ADC above SysTick above PendSV, (irqPriority.h), S[0x1E] shows the ISR times.
+	irqPriorityApply();
+
+	/// HSI 8 MHz to the PLL at 24 MHz, UART, I2C, TIM3, ADC, SysTick re-timed, (clockProfile.h), S[0x1F] shows it, C[0x2B] changes it.
+	clockProfileSet(CLOCKPROFILE_BOOT);
+
+	/// Temperature, Vrefint, PA2, PA3 scanned by TIM3 / DMA from here on, S[0x18] reads them, C[0x22] changes the list.
+	/// Each block also through a 4th order 10 Hz low pass, out of the interrupt, S[0x19] reads it, C[0x24] changes it.
+	adcFilterConfigure(ADCFILTER_BIQUAD, 2);
+	adcSamplerStart(&hadc1, &htim3, ADCSAMPLER_DEFAULT_CHANNELS);
+
+	/// Chip temperature on the analog watchdog, Vdda from the blocks, S[0x1A] reads them, C[0x25..0x27] change them.
+	adcAlarmInit(&hadc1);
+	adcAlarmSet(ADC_CHANNEL_TEMPSENSOR, ADCALARM_TEMP_HOT, ADCALARM_TEMP_COLD);
+	adcAlarmSet(ADC_CHANNEL_VREFINT, ADCALARM_VDDA_HIGH, ADCALARM_VDDA_LOW);
+
+	/// Activate non blocking UART rx interrupt every time get 1 byte..
+	HAL_UART_Receive_IT(&huart1, Rx_data, 1);
+
+	// STM example code modified by JMK:
+	STM32vldisc_LEDOff(LED3);
+	STM32vldisc_LEDOff(LED4);
+
+	// JMK code:
+
+	// Introductory HW string ==========================
+	UartPutString(msg1, true);    // Blocking.
+	UartPutString(msg2, true);    // Blocking.
+	UartPutString(msg3, true);    // Blocking.
+
+	/// Trace every I2C transaction from here on, (DWT cycle counter timestamps).
+	i2cTraceInit();
+
+	/// See what is on I2C2, (~13ms at 100 KHz), S[0x15] lists it, C[0x1E] scans again and sizes the AT24Cs.
+	i2cScanRun(&hi2c2, I2CSCAN_FIRST_ADDR, I2CSCAN_LAST_ADDR, false);
+
+	/// Find head/tail of the eeprom record log, load the page CRCs, and note that we booted.
+	eeLogInit();
+	eeCrcInit();
+	/// Temperature sensor calibration, (C[0x28]), or the data sheet line, S[0x1B] reads the temperature.
+	adcTempInit();
+	eeLogAppend(EELOG_TYPE_EVENT, EELOG_EVT_BOOT, 0);
+
+	/// LED blink, button, commands, temperature log, ... as tasks from here on, S[0x1D] shows their run times.
+	addTasks();
+
+	/// Sleep with SysTick stopped until the next task is due, (idleSleep.h), S[0x20] shows it, C[0x2C] turns it off.
+	idleSleepInit(true);
+
+	while (1)
+	{
+		/// Sleep until an interrupt posts an event, (mainEvent.h), or a task is due, (MAINEVT_TICK).
+		events = mainEventWait();
+
+		/// Respond to any serial commands sent via "cmdHandler"
+		// Cmd_Recievd will be true if we receive the code 0x0D <13-Carriage Return>, in
+		// the data stream indicating end of cmd msg. (It will also be true if we have
+		// seen 255 bytes in the data stream since last Cmd_Recieved, as a back up,
+		// to check incoming bytes before overflow data buffer.)
+		if (events & MAINEVT_BIT(MAINEVT_COMMAND))
+		{
+			taskSchedReady(commandTaskId);
+		}
+
+		/// Log and send the ADC alarms raised or cleared since last time, (interrupts queue them).
+		if (events & MAINEVT_BIT(MAINEVT_ALARM))
+		{
+			taskSchedReady(alarmTaskId);
+		}
+
+		/// Restart bus queues that found their handle in use, when a transfer ends.
+		if (events & MAINEVT_BIT(MAINEVT_I2C))
+		{
+			taskSchedReady(i2cTaskId);
+		}
+
+		/// Either edge of the blue button, EXTI0.
+		if (events & MAINEVT_BIT(MAINEVT_BUTTON))
+		{
+			taskSchedReady(buttonTaskId);
+		}
+
+		/// Everything ready or due, highest priority first.
+		taskSchedRun();
+
+  } // End while (1)
+
+} // End main()
+
+/**
+ * @brief Add the main loop's tasks, start the timed ones.
+ * <pre>
+ *	Deadlines and budgets only count misses and overruns, (S[0x1D]), the
+ *	commands and SS[x] send blocking, they have no budget.
+ * </pre>
+ */
+static void addTasks(void)
+{
+	uint8_t id;
+
+	taskSchedInit();
+	commandTaskId = taskSchedAdd("cmd", commandTask, TASKSCHED_PRIO_COMMAND, 0, 0);
+	alarmTaskId	  = taskSchedAdd("alarm", cmdAlarmService, TASKSCHED_PRIO_ALARM, 0, 0);
+	i2cTaskId	  = taskSchedAdd("i2c", i2cBusService, TASKSCHED_PRIO_I2C, 10, 200);
+	taskSchedPeriodic(i2cTaskId, SERVICE_MS, SERVICE_MS);
+	buttonTaskId  = taskSchedAdd("button", buttonTask, TASKSCHED_PRIO_BUTTON, 0, 1000);
+	led4TaskId	  = taskSchedAdd("led4", led4OffTask, TASKSCHED_PRIO_BACKGROUND, 10, 50);
+	blinkTaskId	  = taskSchedAdd("blink", blinkTask, TASKSCHED_PRIO_BACKGROUND, 10, 50);
+	taskSchedPeriodic(blinkTaskId, blinkPeriodMs[BlinkSpeed], blinkPeriodMs[BlinkSpeed]);
+
+	id = taskSchedAdd("stream", cmdStreamService, TASKSCHED_PRIO_BACKGROUND, 50, 0);
+	taskSchedPeriodic(id, SERVICE_MS, SERVICE_MS);
+	id = taskSchedAdd("slaveEE", i2cSlaveEEService, TASKSCHED_PRIO_BACKGROUND, 50, 0);
+	taskSchedPeriodic(id, SERVICE_MS, SERVICE_MS);
+	id = taskSchedAdd("tempLog", tempLogTask, TASKSCHED_PRIO_BACKGROUND, 100, 2000);
+	taskSchedPeriodic(id, TEMP_LOG_MS, TEMP_LOG_MS);
+}
+
+/**
+ * @brief A command line is in, (MAINEVT_COMMAND), go parse and execute it.
+ */
+static void commandTask(void)
+{
+	if (Cmd_Recieved == true)
+	{
+		/// Go parse and execute latest command:
+		cmdHandler(cmdBuffer);
+
+		// Look for next "Transfer":
+		Cmd_Recieved = false;
+	}
+}
+
+/**
+ * @brief Blue button edge, (MAINEVT_BUTTON), debounced.
+ * <pre>
+ *	Utilize LEDs and pushbuttons on STM32VLDISCOVERY demo board
+ *	as alternative to serial commands, control panel human interface.
+ * </pre>
+ */
+static void buttonTask(void)
+{
+	if	( 0 == STM32vldisc_PBGetState(BUTTON_USER)	)  // 0 == USER BUTTON not pressed.
+	{
+		if(KeyState == 1)
+		{
+			/* USER Button released */
+			// Finally set previous blue button state to released.
+			KeyState = 0;
+			releaseTick = HAL_GetTick();
+		}
+	}
+	else if(KeyState == 0) // 1 == USER BUTON is pressed
+	{
+		// If previously not pressed, and not bounce from the last release or press.
+		if(((HAL_GetTick() - releaseTick) >= BUTTON_DEBOUNCE_MS) &&
+		   ((HAL_GetTick() - pressTick) >= BUTTON_HOLDOFF_MS))
+		{
+			// A new button pressed down transition
+			// has occurred:
+
+			/* USER Button pressed */
+			// Finally set previous state to pressed.
+			KeyState = 1;
+			/* Turn ON LED4 - Indicate button pressed ! */
+			STM32vldisc_LEDOn(LED4);
+
+			// ########## Upon button push, execute these tests of sEEProm routines:
+
+			// T1: I2C_HAL_Status = sEEPromCurrentAddrReadByte(&hi2c2, A0A1_00, &eePromByteRead);
+			// T2: I2C_HAL_Status = sEEPromCurrentAddrReadBytes(&hi2c2, A0A1_00, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
+			// T3: I2C_HAL_Status = sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, &eePromByteRead);
+			// T4: I2C_HAL_Status = sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0000, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
+
+			// Note: For testing the Writes, there is a 10ms max deadtime "tWR"
+			// This is also known as the write cycle time tWR is the time from a valid stop condition of a
+			// write sequence to the end of the internal clear/write cycle.
+			/* T5:
+			eePromByteToBeWritten = 0x77;
+			I2C_HAL_Status = sEEPromByteWrite(&hi2c2, A0A1_00, 0x0000,&eePromByteToBeWritten); // Write a byte to a page, page 0 byte 0.
+			// Delay for tWR of 10ms:
+
+			STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
+			HAL_Delay(10); 				// Delay 10ms, -  toggle port LED4 (PC8) pin to measure delay
+			STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
+
+			// Read back from same place to check for successful write:
+			I2C_HAL_Status = sEEPromRandomAddrByteRead(&hi2c2, A0A1_00, 0x0000, &eePromByteRead);
+			*/
+
+			/*
+			// T6 & T7. Write lowest page all 64 bytes, then read back.:
+			I2C_HAL_Status =  sEEPromBytesWrite(&hi2c2, A0A1_00, 0x0000,  eePromWritePageBytes.array, (uint16_t) eePromWritePageBytes.bytesInPage);
+
+			STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
+			HAL_Delay(10); 				// Delay 10ms, -  toggle port LED4 (PC8) pin to measure delay
+			STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
+
+			I2C_HAL_Status = sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x0000, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
+
+			// T7 Write highest page all 64 bytes, then read back.:
+			// Reset the read array struct so that we know that read really loaded the array.
+			sEEPromPageBufferFill(&eePromReadPageBytes, FILL_0 );
+			// Reset the write array struct so that we now count down rather than up, now from 63 to 0.
+			sEEPromPageBufferFill(&eePromWritePageBytes, FILL_REVERSE_INDEX );
+
+			I2C_HAL_Status =  sEEPromBytesWrite(&hi2c2, A0A1_00, 0x7FC0,  eePromWritePageBytes.array, (uint16_t) eePromWritePageBytes.bytesInPage);
+
+			STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
+			HAL_Delay(10); 				// Delay 10ms, -  toggle port LED4 (PC8) pin to measure delay
+			STM32vldisc_LEDToggle(LED4);// Toggle - pulse start.
+
+			I2C_HAL_Status = sEEPromRandomAddrReadBytes(&hi2c2, A0A1_00, 0x7FC0, eePromReadPageBytes.array, (uint16_t) eePromReadPageBytes.bytesInPage);
+
+			// *** Or do some kind of ACKNOWLEDGE POLLING:, do a 1 byte read,
+			// try sEEPromCurrentAddrReadByte(..) and see if we can repeat this command while I2C_HAL_Status
+			// is not ok for no ack, and hope that repeat does not hang up the HAL or the i2c prom.
+			// Once we see ok then it gave an ack and the busy period for page write is over.
+			// May need to experiment to see if this works.
+
+			*/
+
+			/// Every time pushbutton is pressed, cycle among
+			/// demoModes (test cases) : 1, 2, 3.
+
+			switch (demoMode) {
+
+			case 1:
+				// This time do test case 1:
+
+				// Next time do demo/test #2
+				demoMode++;
+				break;
+
+			case 2:
+				// This time do test case 2:
+
+				// Next time do demo/test #3
+				demoMode++;
+				break;
+			case 3:
+				// This time do test case 3:
+
+				// Next time do demo/test #1
+				demoMode = 1;
+				break;
+			default:
+				// backstop:
+				demoMode = 1;
+				break;
+			}
+
+			// LED4 on for 1 second after blue button down, (led4OffTask turns it
+			// off), presses in that second are ignored, good for debouncing..
+			pressTick = HAL_GetTick();
+			taskSchedOnce(led4TaskId, BUTTON_HOLDOFF_MS);
+
+			// Presently expect BlinkSpeed 0,1,2, to follow demoMode 1->2->3.
+			BlinkSpeed = (BlinkSpeed + 1) % 3;
+			taskSchedPeriodic(blinkTaskId, blinkPeriodMs[BlinkSpeed], 0);
+
+			eeLogAppend(EELOG_TYPE_EVENT, EELOG_EVT_BUTTON, (uint16_t)demoMode);
+		}
+	}
+}
+
+/**
+ * @brief Toggle LED3, every blinkPeriodMs[BlinkSpeed].
+ * <pre>
+ *	Blink speed has 3 rates:
+ *	1.25 Hz (DemoMode 1)
+ *	2.5 Hz  (DemoMode 2)
+ *	5 Hz    (DemoMode 3).
+ * </pre>
+ */
+static void blinkTask(void)
+{
+	count++;
+	STM32vldisc_LEDToggle(LED3);
+}
+
+/**
+ * @brief LED4 off, BUTTON_HOLDOFF_MS after the blue button went down.
+ */
+static void led4OffTask(void)
+{
+	STM32vldisc_LEDOff(LED4);
+}
+
+/**
+ * @brief Temperature sample into the eeprom log, batched a page at a time, (Q8 degrees C, filtered, adcFilter.c if on).
+ */
+static void tempLogTask(void)
+{
+	int16_t tempQ8;		// Chip temperature, 1/256 C.
+
+	if (adcTempRead(&tempQ8))
+	{
+		eeLogAppend(EELOG_TYPE_TEMP_Q8, (uint8_t)ADC_CHANNEL_TEMPSENSOR, (uint16_t)tempQ8);
+	}
+}
+
+//##########################################################
+//	Note: SystemClock_Config(void) and
+//	MX_xxx functions below are all auto-generated by  "STM32CubeMX.exe"
+//
+//##########################################################
+
+/** 	System Clock Configuration
+*/
+void SystemClock_Config(void)
+{
+  RCC_OscInitTypeDef RCC_OscInitStruct;
+  RCC_ClkInitTypeDef RCC_ClkInitStruct;
+  RCC_PeriphCLKInitTypeDef PeriphClkInit;
+
+  /**	Initializes the CPU, AHB and APB busses clocks
+  */
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+  RCC_OscInitStruct.HSICalibrationValue = 16;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+  /**Initializes the CPU, AHB and APB busses clocks
+  */
+  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
+                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+  PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+  PeriphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV2;
+  if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+  /**Configure the Systick interrupt time
+  */
+  HAL_SYSTICK_Config(HAL_RCC_GetHCLKFreq()/1000);
+
+  /**Configure the Systick
+  */
+  HAL_SYSTICK_CLKSourceConfig(SYSTICK_CLKSOURCE_HCLK);
+
+  /** Configure the SysTick_IRQn interrupt */
+  HAL_NVIC_SetPriority(SysTick_IRQn, 0, 0);
+}
+
+/** ADC1 init function */
+static void MX_ADC1_Init(void)
+{
+
+  ADC_ChannelConfTypeDef sConfig;
+
+  /**Common config
+  */
+  hadc1.Instance = ADC1;
+  hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;		// JMK, the sequence is set by adcSamplerStart(..)
+  hadc1.Init.ContinuousConvMode = DISABLE;
+  hadc1.Init.DiscontinuousConvMode = DISABLE;
+  hadc1.Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T3_TRGO;	// JMK, one conversion per TIM3 update, (adcSampler.c).
+  hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+  hadc1.Init.NbrOfConversion = 1;
+  if (HAL_ADC_Init(&hadc1) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+  /**Configure Regular Channel
+  */
+  sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
+  sConfig.Rank = 1;
+  sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5;	// JMK, temp sensor needs >= 17.1us, 1.5 cycles was 0.4us.
+  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+}
+
+/** TIM3 init function, JMK: update event is the ADC1 trigger, ADCSAMPLER_RATE_HZ. */
+static void MX_TIM3_Init(void)
+{
+
+  TIM_ClockConfigTypeDef sClockSourceConfig;
+  TIM_MasterConfigTypeDef sMasterConfig;
+
+  htim3.Instance = TIM3;
+  htim3.Init.Prescaler = (HAL_RCC_GetPCLK1Freq() / 1000000) - 1;	// 1 MHz count, (APB1 prescaler 1).
+  htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim3.Init.Period = (1000000 / ADCSAMPLER_RATE_HZ) - 1;
+  htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim3, &sClockSourceConfig) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+}
+
+/** I2C1 init function */
+static void MX_I2C1_Init(void)
+{
+
+  hi2c1.Instance = I2C1;
+  hi2c1.Init.ClockSpeed = 100000;
+  hi2c1.Init.DutyCycle = I2C_DUTYCYCLE_2;
+  hi2c1.Init.OwnAddress1 = 0;
+  hi2c1.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+  hi2c1.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+  hi2c1.Init.OwnAddress2 = 0;
+  hi2c1.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+  hi2c1.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+  if (HAL_I2C_Init(&hi2c1) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+}
+
+/** I2C2 init function */
+static void MX_I2C2_Init(void)
+{
+
+  hi2c2.Instance = I2C2;
+  hi2c2.Init.ClockSpeed = 100000;
+  hi2c2.Init.DutyCycle = I2C_DUTYCYCLE_2;
+  hi2c2.Init.OwnAddress1 = 0;
+  hi2c2.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+  hi2c2.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+  hi2c2.Init.OwnAddress2 = 0;
+  hi2c2.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+  hi2c2.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+  if (HAL_I2C_Init(&hi2c2) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+}
+
+/** 
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void) 
+{
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel1_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+  /* DMA1_Channel4_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel4_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+  /* DMA1_Channel5_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel5_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+  /* DMA1_Channel6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+  /* DMA1_Channel7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+
+}
+
+/** USART1 init function */
+static void MX_USART1_UART_Init(void)
+{
+
+  huart1.Instance = USART1;
+  huart1.Init.BaudRate = 115200;
+  huart1.Init.WordLength = UART_WORDLENGTH_8B;
+  huart1.Init.StopBits = UART_STOPBITS_1;
+  huart1.Init.Parity = UART_PARITY_NONE;
+  huart1.Init.Mode = UART_MODE_TX_RX;
+  huart1.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+  huart1.Init.OverSampling = UART_OVERSAMPLING_16;
+  if (HAL_UART_Init(&huart1) != HAL_OK)
+  {
+    _Error_Handler(__FILE__, __LINE__);
+  }
+
+}
+
+/** Configure pins as 
+        * Analog 
+        * Input 
+        * Output
+        * EVENT_OUT
+        * EXTI
+*/
+static void MX_GPIO_Init(void)
+{
+
+  GPIO_InitTypeDef GPIO_InitStruct;
+
+  /** GPIO Ports Clock Enable */
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+
+  /** Configure GPIO pin Output Level */
+  HAL_GPIO_WritePin(GPIOC, LD4_Blue_Pin|LD3_Green_Pin, GPIO_PIN_RESET);
+
+  /** Configure GPIO pins : LD4_Blue_Pin LD3_Green_Pin */
+  GPIO_InitStruct.Pin = LD4_Blue_Pin|LD3_Green_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+  /** Configure GPIO pin : BlueButton_Pin */
+  GPIO_InitStruct.Pin = BlueButton_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(BlueButton_GPIO_Port, &GPIO_InitStruct);
+
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI0_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+
+}
+
+/**
+  * @brief  This function is executed in case of error occurrence.
+  * @param  None
+  * @retval None
+  */
+void _Error_Handler(char * file, int line)
+{
+  /// User can add his own implementation to report the HAL error return state */
+  /// ==> Right here:
+  while(1) 
+  {
+	  // A way of ensuring a NOP, even if code optimizer is on:
+	  // http://www.ethernut.de/en/documents/arm-inline-asm.html
+	  asm volatile("mov r0, r0");
+  }
+  /* USER CODE END Error_Handler_Debug */ 
+}
+
+#ifdef USE_FULL_ASSERT
+
+/**
+   * @brief Reports the name of the source file and the source line number
+   * where the assert_param error has occurred.
+   * @param file: pointer to the source file name
+   * @param line: assert_param error line source number
+   * @retval None
+   */
+void assert_failed(uint8_t* file, uint32_t line)
+{
+  /* USER CODE BEGIN 6 */
+  /* User can add his own implementation to report the file name and line number,
+    ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
+  /* USER CODE END 6 */
+
+}
+
+#endif
+
@@ -0,0 +1,84 @@
+/**
+  @file mainEvent.c
+  @brief Interrupts wake the main loop with events, see mainEvent.h
+<pre>
+	mainEventWait(..) looks at the pending word and sleeps with interrupts
+	off, (PRIMASK), so an event posted between the look and the WFI can
+	not be missed: a pending interrupt still ends the WFI, and runs as soon
+	as interrupts are back on, before the word is looked at again.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/02/2018
+
+*/
+#include "mainEvent.h"
+#include "i2cTrace.h"
+#include "idleSleep.h"
+
+/// Pending events, counts and latencies.
+mainEventStateStruct mainEventState;
+
+
+/**
+ * @brief Wake the main loop for event, any context.
+ */
+void mainEventPost(enumMainEvent event)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (mainEventState.pending & MAINEVT_BIT(event))
+	{
+		mainEventState.coalesced[event]++;
+	}
+	else
+	{
+		mainEventState.pending			 |= MAINEVT_BIT(event);
+		mainEventState.postCycles[event] = i2cTraceNow();
+	}
+	mainEventState.posted[event]++;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Take every pending event, sleeping until there is one, main loop only.
+ *
+ * @returns MAINEVT_BIT of each event taken.
+ */
+uint32_t mainEventWait(void)
+{
+	uint32_t events;
+	uint32_t now;
+	uint32_t latency;
+	uint32_t event;
+
+	for (;;)
+	{
+		__disable_irq();
+		events = mainEventState.pending;
+		if (events != 0)
+		{
+			mainEventState.pending = 0;
+			__enable_irq();
+			break;
+		}
+		mainEventState.sleeps++;
+		idleSleepEnter();	// WFI, ends on any interrupt, which runs here, as soon as they are on.
+		__enable_irq();
+	}
+
+	now = i2cTraceNow();
+	for (event = 0; event < MAINEVT_COUNT; event++)
+	{
+		if (events & MAINEVT_BIT(event))
+		{
+			latency = now - mainEventState.postCycles[event];
+			if (latency > mainEventState.maxLatencyCycles[event])
+			{
+				mainEventState.maxLatencyCycles[event] = latency;
+			}
+		}
+	}
+	return events;
+}
@@ -0,0 +1,103 @@
+/**
+  @file pendWork.c
+  @brief Interrupt work deferred to PendSV, see pendWork.h
+<pre>
+	Slots are freed by tail counting up, the full check in pendWorkPost(..)
+	reads tail, so a slot is only reused once PendSV has taken the item out.
+	posted and overflows are counted with LDREX / STREX as well, they may
+	be counted from interrupts of any priority.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/04/2018
+
+*/
+#include "pendWork.h"
+#include "i2cTrace.h"
+
+typedef char pendWorkQueueCheck[((PENDWORK_QUEUE & (PENDWORK_QUEUE - 1)) == 0) ? 1 : -1];
+
+#define QUEUE_MASK		(PENDWORK_QUEUE - 1)
+
+/// Work queue and counts.
+pendWorkStateStruct pendWorkState;
+
+
+static void countUp(__IO uint32_t *pCount)
+{
+	do
+	{
+	} while (__STREXW(__LDREXW(pCount) + 1, pCount) != 0);
+}
+
+/**
+ * @brief Have PendSV run func(pArg), any context, no interrupts off.
+ *
+ * @returns false if the queue is full, nothing posted, (call func yourself).
+ */
+bool pendWorkPost(pendWorkFunc func, void *pArg)
+{
+	pendWorkItem *pItem;
+	uint32_t	  head;
+
+	do
+	{
+		head = __LDREXW(&pendWorkState.head);
+		if ((head - pendWorkState.tail) >= PENDWORK_QUEUE)
+		{
+			__CLREX();
+			countUp(&pendWorkState.overflows);
+			return false;
+		}
+	} while (__STREXW(head + 1, &pendWorkState.head) != 0);
+
+	pItem		= &pendWorkState.items[head & QUEUE_MASK];
+	pItem->pArg = pArg;
+	__DMB();
+	pItem->func = func;			// Slot is full.
+	countUp(&pendWorkState.posted);
+	SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	return true;
+}
+
+/**
+ * @brief Run the items posted, oldest first, call from PendSV_Handler(..)
+ */
+void pendWorkService(void)
+{
+	pendWorkItem *pItem;
+	pendWorkFunc  func;
+	void		 *pArg;
+	uint32_t	  depth;
+	uint32_t	  start;
+	uint32_t	  cycles;
+
+	depth = pendWorkState.head - pendWorkState.tail;
+	if (depth > pendWorkState.maxDepth)
+	{
+		pendWorkState.maxDepth = depth;
+	}
+
+	while (pendWorkState.tail != pendWorkState.head)
+	{
+		pItem = &pendWorkState.items[pendWorkState.tail & QUEUE_MASK];
+		func  = pItem->func;
+		if (func == NULL)
+		{
+			break;				// Reserved, its poster pends PendSV again once it is written.
+		}
+		pArg		= pItem->pArg;
+		pItem->func = NULL;
+		__DMB();
+		pendWorkState.tail++;
+
+		start = i2cTraceNow();
+		func(pArg);
+		cycles = i2cTraceNow() - start;
+		pendWorkState.ran++;
+		if (cycles > pendWorkState.maxRunCycles)
+		{
+			pendWorkState.maxRunCycles = cycles;
+		}
+	}
+}
@@ -0,0 +1,315 @@
+/**
+  @file picEEBatch.c
+  @brief Batched access to the PIC "EEPROM simulator", see picEEBatch.h
+<pre>
+	Planning, (main context, picEEBatchStart):
+
+		mark		- every byte of every window in need[], writes also
+					  put their data in image[], in list order.
+		spans		- walk the region once from the end of its longest
+					  gap, so a span may wrap but never needs joining to
+					  the one that ends the walk.
+
+	Running, each after the first in I2C interrupt context:
+
+		span done	- reads: bytes to image[], start the next span.
+		last done	- reads: every window copied out of image[].
+
+	One transfer struct and one span buffer, so one batch at a time.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/27/2018
+
+*/
+#include <string.h>
+#include "picEEBatch.h"
+#include "i2cTrace.h"
+#include "led.h"
+
+#define WRAP(addr)		SEE_WRAP(PICEE, (addr))
+
+/// Batch in progress, or last one run.
+picEEBatchStateStruct picEEBatchState;
+
+static bool		  need[PICEE_CAPACITY];			// Byte is in a window.
+static uint8_t	  image[PICEE_CAPACITY];		// Region as read, or as it is to be written.
+static uint8_t	  spanData[PICEE_CAPACITY];		// Span on the bus, (from its start, wrapped).
+static i2cBusXfer xfer;
+
+
+static void batchFinished(enumPicEEBatchState state)
+{
+	picEEBatchState.endCycles = i2cTraceNow();
+	picEEBatchState.state	  = state;
+}
+
+/**
+ * @brief true if every window lies within the region and has somewhere to go.
+ */
+static bool windowsValid(const picEEWindow *pWindows, uint16_t windowCount)
+{
+	uint16_t i;
+
+	if ((pWindows == NULL) || (windowCount == 0))
+	{
+		return false;
+	}
+	for (i = 0; i < windowCount; i++)
+	{
+		if ((pWindows[i].address >= PICEE_CAPACITY) || (pWindows[i].length == 0) ||
+			(pWindows[i].length > PICEE_CAPACITY) || (pWindows[i].pData == NULL))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Mark the bytes of every window in need[], and with fillImage their data in image[].
+ */
+static void markWindows(const picEEWindow *pWindows, uint16_t windowCount, bool fillImage)
+{
+	uint16_t i;
+	uint16_t n;
+
+	memset(need, 0, sizeof(need));
+	for (i = 0; i < windowCount; i++)
+	{
+		for (n = 0; n < pWindows[i].length; n++)
+		{
+			need[WRAP(pWindows[i].address + n)] = true;
+			if (fillImage)
+			{
+				image[WRAP(pWindows[i].address + n)] = pWindows[i].pData[n];
+			}
+		}
+	}
+}
+
+/**
+ * @brief Spans covering need[], joined across gaps of up to gapBytes.
+ *
+ * @returns Spans, at most PICEE_BATCH_MAX_SPANS, (gapBytes 0 with every other byte needed).
+ */
+static uint16_t planSpans(picEESpan *pSpans, uint16_t gapBytes)
+{
+	uint16_t run		= 0;
+	uint16_t longestRun = 0;
+	uint16_t longestEnd = 0;
+	uint16_t spanCount	= 0;
+	uint16_t gap		= 0;
+	uint16_t i;
+	uint16_t addr;
+
+	// Longest run of unneeded bytes, going round twice so one across the end counts whole.
+	for (i = 0; i < 2 * PICEE_CAPACITY; i++)
+	{
+		run = need[WRAP(i)] ? 0 : (uint16_t)(run + 1);
+		if ((run > longestRun) && (run <= PICEE_CAPACITY))
+		{
+			longestRun = run;
+			longestEnd = i;
+		}
+	}
+	if (longestRun == PICEE_CAPACITY)
+	{
+		return 0;
+	}
+
+	// Walk from just after it, a gap wider than gapBytes ends a span.
+	for (i = 0; i < PICEE_CAPACITY; i++)
+	{
+		addr = WRAP(longestEnd + 1 + i);
+		if (!need[addr])
+		{
+			gap++;
+			continue;
+		}
+		if ((spanCount != 0) && (gap <= gapBytes))
+		{
+			pSpans[spanCount - 1].length += (uint8_t)(gap + 1);
+		}
+		else
+		{
+			pSpans[spanCount].start	 = (uint8_t)addr;
+			pSpans[spanCount].length = 1;
+			spanCount++;
+		}
+		gap = 0;
+	}
+	return spanCount;
+}
+
+/**
+ * @brief Transactions a batch of these windows would take, (nothing is started).
+ */
+uint16_t picEEBatchPlan(const picEEWindow *pWindows, uint16_t windowCount, bool isWrite)
+{
+	picEESpan spans[PICEE_BATCH_MAX_SPANS];
+
+	if (picEEBatchBusy() || !windowsValid(pWindows, windowCount))
+	{
+		return 0;
+	}
+	markWindows(pWindows, windowCount, false);
+	return planSpans(spans, isWrite ? 0 : PICEE_BATCH_GAP_BYTES);
+}
+
+static void spanDone(i2cBusXfer *pXfer);
+
+/**
+ * @brief Queue the transfer of the next span, the batch fails if the queue is full.
+ */
+static void startSpan(void)
+{
+	const picEESpan *pSpan = &picEEBatchState.spans[picEEBatchState.spanNext++];
+	uint16_t		 n;
+
+	if (picEEBatchState.isWrite)
+	{
+		for (n = 0; n < pSpan->length; n++)
+		{
+			spanData[n] = image[WRAP(pSpan->start + n)];
+		}
+	}
+
+	xfer.devAddr7Bit = picEEBatchState.devAddr7Bit;
+	xfer.isRead		 = !picEEBatchState.isWrite;
+	xfer.memAddSize	 = SEE_MEMADD_SIZE(PICEE);
+	xfer.memAddress	 = pSpan->start;
+	xfer.pData		 = spanData;
+	xfer.size		 = pSpan->length;
+	xfer.done		 = spanDone;
+	xfer.pContext	 = NULL;
+
+	picEEBatchState.transactions++;
+	if (!i2cBusSubmit(picEEBatchState.bus, &xfer))
+	{
+		picEEBatchState.errorCode = HAL_I2C_ERROR_OVR;
+		batchFinished(PICEE_BATCH_FAILED);
+	}
+}
+
+/**
+ * @brief i2cBus done handler, for every span.
+ */
+static void spanDone(i2cBusXfer *pXfer)
+{
+	const picEESpan	  *pSpan = &picEEBatchState.spans[picEEBatchState.spanNext - 1];
+	const picEEWindow *pWindow;
+	uint16_t		   i;
+	uint16_t		   n;
+
+	if (pXfer->errorCode != HAL_I2C_ERROR_NONE)
+	{
+		picEEBatchState.errorCode = pXfer->errorCode;
+		batchFinished(PICEE_BATCH_FAILED);
+		return;
+	}
+	picEEBatchState.bytes += pXfer->size;
+
+	if (!picEEBatchState.isWrite)
+	{
+		for (n = 0; n < pSpan->length; n++)
+		{
+			image[WRAP(pSpan->start + n)] = spanData[n];
+		}
+	}
+	if (picEEBatchState.spanNext < picEEBatchState.spanCount)
+	{
+		startSpan();
+		return;
+	}
+
+	for (i = 0; !picEEBatchState.isWrite && (i < picEEBatchState.windowCount); i++)
+	{
+		pWindow = &picEEBatchState.pWindows[i];
+		for (n = 0; n < pWindow->length; n++)
+		{
+			pWindow->pData[n] = image[WRAP(pWindow->address + n)];
+		}
+	}
+	batchFinished(PICEE_BATCH_DONE);
+}
+
+/**
+ * @brief Start a batch, progress in picEEBatchState.
+ *
+ * @param bus		  - Bus the PIC is on, (I2CBUS_EE).
+ * @param devAddr7Bit - PIC address, PICEE_BATCH_ADDR.
+ * @param isWrite	  - Write the windows' data, else read into them.
+ * @param pWindows	  - Windows, valid until the batch is done, may overlap and be in any order.
+ * @param windowCount
+ *
+ * @returns true if started.
+ */
+bool picEEBatchStart(enumI2CBus bus, uint8_t devAddr7Bit, bool isWrite, const picEEWindow *pWindows,
+					 uint16_t windowCount)
+{
+	uint32_t primask;
+
+	if (picEEBatchBusy() || (bus >= I2CBUS_COUNT) || !windowsValid(pWindows, windowCount))
+	{
+		return false;
+	}
+
+	picEEBatchState.bus			= bus;
+	picEEBatchState.devAddr7Bit = devAddr7Bit;
+	picEEBatchState.isWrite		= isWrite;
+	picEEBatchState.pWindows	= pWindows;
+	picEEBatchState.windowCount = windowCount;
+	picEEBatchState.spanNext	= 0;
+	picEEBatchState.errorCode	= HAL_I2C_ERROR_NONE;
+	markWindows(pWindows, windowCount, isWrite);
+	picEEBatchState.spanCount = planSpans(picEEBatchState.spans, isWrite ? 0 : PICEE_BATCH_GAP_BYTES);
+
+	picEEBatchState.batches++;
+	picEEBatchState.windows += windowCount;
+	picEEBatchState.startCycles = i2cTraceNow();
+	picEEBatchState.state		= PICEE_BATCH_RUNNING;
+
+	// The first span may end before startSpan returns, spanNext is shared with the callback.
+	primask = __get_PRIMASK();
+	__disable_irq();
+	startSpan();
+	__set_PRIMASK(primask);
+
+	return (picEEBatchState.state != PICEE_BATCH_FAILED);
+}
+
+bool picEEBatchBusy(void)
+{
+	return (picEEBatchState.state == PICEE_BATCH_RUNNING);
+}
+
+/**
+ * @brief Run a batch and wait for it.
+ *
+ * @returns HAL_OK when every window is done, HAL_ERROR if a transfer failed, (or the batch
+ *			could not start), HAL_TIMEOUT if it took over PICEE_BATCH_TIMEOUT_MS.
+ */
+HAL_StatusTypeDef picEEBatchRun(enumI2CBus bus, uint8_t devAddr7Bit, bool isWrite, const picEEWindow *pWindows,
+								uint16_t windowCount)
+{
+	uint32_t startTick = HAL_GetTick();
+
+	if (!picEEBatchStart(bus, devAddr7Bit, isWrite, pWindows, windowCount))
+	{
+		return HAL_ERROR;
+	}
+	while (picEEBatchBusy())
+	{
+		if (((HAL_GetTick() - startTick) > PICEE_BATCH_TIMEOUT_MS) ||
+			(sEEPromWaitForReady(i2cBusState[bus].hi2c) == HAL_TIMEOUT))
+		{
+			// Still busy until the bus queue hands the span back, (its own timeout).
+			return picEEBatchBusy() ? HAL_TIMEOUT : ((picEEBatchState.state == PICEE_BATCH_DONE) ? HAL_OK : HAL_ERROR);
+		}
+		// Queue waiting for the handle, (another user had it).
+		i2cBusService();
+		STM32vldisc_LEDToggle(LED3);
+	}
+	return (picEEBatchState.state == PICEE_BATCH_DONE) ? HAL_OK : HAL_ERROR;
+}
@@ -1,719 +1,1893 @@
-/**
-  @file serialCmdParser.c
-  @brief Serial Command processor
-<pre>
-  This is a generic command processor.
-  These commands are kept as as simple as possible, mildly cryptic,
-  but in easily expandable format to allow rapid implementation and
-  modification.
-
-  Table lookup can interpret these into English readable.
-
-  c[x] - "do this" command 					(may include parameters)
-  s[x] - "status set"   		        	(no parameters, read only)
-  d[x] - "data set", R/W 					(when W command is followed by = data.)
-  m[xxxx] - "Generic I/O,SFR, memory, R/W   (when W command is followed by = uint8_t.)
-  h[x] - "Display a help page"				(Page# = x)
-
-  h - A single "h" or "H" halts (and resets) the system.
-
-  Notes:
-
-  x 	= uint_8t , index range 0 to 255.
-  xxxx	= uint_32t, address range 0x00000000 to 0xFFFFFFFF
-
-  Codes c,s and d are made more specific by adding [x].
-  Exactly what they do will be determined by enumeration of [x].
-
-  Code m directly reads/writes the address space of the processor,
-  (possibly with some restrictions).
-
-  "help y[x]" returns usage page for command y[x].
-
-  h[x] displays sections of complete command set manual,
-  presently this is only h[1].
-  </pre>
-
-   @author 	Joe Kuss (JMK)
-   @date 	2/14/2018
-
-   \pagebreak
-*/
-
-
-#include <stdint.h>
-#include <string.h>
-#include <stdbool.h>
-#include <ctype.h>
-#include "uart_jmk.h"
-#include "strUtilities.h"
-
-// Delay counter
-#define DELAY_COUNT   500000
-
-extern bool Cmd_Recieved;
-
-/// Command Response Codes Enumeration.
-enum commandResponse
-{
-	eOK,
-	eUnknownCmd,
-	eGotC,
-	eGotD,
-	eGotH,
-	eGotM,
-	eUintExpected,
-	eNoFurtherComment,
-	eAttachReadOnly,
-	eIndexRangeExceeded,
-	eIndexError
-};
-typedef enum commandResponse eCOMMAND_RESPONSE;
-
-/// Holds latest command response
-eCOMMAND_RESPONSE cmdResponse;
-
-
-#define strEQUALITY 0
-
-// Ref:
-// https://stackoverflow.com/questions/797318/how-to-split-a-string-literal-across-multiple-lines-in-c-objective-c
-/// Help page displayed on terminal in response to "h[1]"
-char  * help_1_str = "\r\n"
-                "Help page #1 - Command Interpreter Overview: ----------- \r\n\r\n"
-                "c[x]    - \"Execute Command #x\"       (may include parameters)\r\n"
-                "s[x]    - \"Read a Status Set\"        (no parameters, read only)\r\n"
-                "d[x]    - \"Data Set\", R/W            (if W, command followed by = data.)\r\n"
-                "m[xxxx] - \"I/O,SFR,Mem.,@[addr],\"R/W (if W, command followed by = uint8_t.)\r\n"
-                "h[x]    - \"Display help page\"        (Page# = x)\r\n"
-                "\r\n"
-                "h       - \"h\" or \"H\" halts (and resets) the system.\r\n"
-                "\r\n"
-                "Notes:\r\n"
-                "\r\n"
-                "x 	= uint_8t , index range 0 to 255.\r\n"
-                "xxxx	= uint_32t, address range 0x00000000 to 0xFFFFFFFF\r\n"
-                "\r\n"
-                "Codes c,s and d are made more specific by adding [x].\r\n"
-                "Exactly what they do will be determined by enumeration of [x].\r\n"
-                "\r\n"
-                "Code m directly reads/writes the address space of the processor,\r\n"
-                "(possibly with some restrictions).\r\n"
-                "------------------------------------------------------------- \r\n\r\n";
-
-
-/**
- * <pre>
- * Scans MainString, and returns pointer to
- * start of Data section of message via subString.
- * Data section is delimited by the "=" symbol.
- * Will return false if can not find data section
- * (characters) following a single "=".
- * </pre>
- *
- * @param subString 	Points to start of data section.
- * @param MainString 	Points to start of input string.
- * @retval 				True if found "=" indicating data.
- *
- */
-// We use char ** because we want to output the result
-// to an external variable that is char*, in order to do
-// this we must use a pointer to char*, thus char**
-bool getDataInputString(char **subString, char * MainString)
-{
-	char * findItPtr;
-	size_t strLen1;
-
-	// Get length of substring delimited by "="
-	strLen1 = strcspn(MainString, "=");
-
-	if (strLen1 != strlen(MainString))
-	{
-		// Delimiter "=" found, the substring is shorter:
-
-		strLen1++; // to skip past the "="
-		findItPtr = &(MainString[strLen1]);
-	}
-	else
-	{
-		// delimiter "=" not found,
-		findItPtr = NULL;
-	}
-
-	// Reject for no "="
-	if (findItPtr == NULL)
-	{
-		// Just as a backstop (or we could return NULL...)
-		*subString = MainString;
-		return false;
-	}
-	else
-	{
-		// Q: Do this dereference just because variable
-		// was defined as char ** ?
-		// A: No, it is done because we want the parameter
-		//    To of an "out" type that can write to an external
-		//    variable location of type char* from this function.
-		*subString = findItPtr;
-		return true;
-	}
-}
-
-// FUNCTION:	bool convStringToUint(uint_32t *uInt32Ptr, char *strPtr) ===
-/**
- * <pre>
- * Convert  string via "strPtr" to  uint_32t if possible.
- * Return false if string is invalid format for uint_32t
- *
- * Numerical value is returned via pointer "uInt32Ptr"
- *</pre>
- * Will be able to, also, interpret the hex 0x00000 format, and accept
- * 8, 16, and 32 bit hex values
- *
- * @param uInt32Ptr 	External location of uint_32t result.
- * @param strPtr		String to convert, if possible.
- * @retval 				True if string holds valid uint_32t.
- *
- */
-bool convStringToUint(uint32_t *uInt32Ptr, char *strPtr)
-{
-	unsigned long ulData;		// Note Arm compiler says uint_32t same as ulong.
-	bool   bValidStringConversion;
-
-	//### using "stroul"
-	//ulData = strtoul(strPtr, &strPtr, 0); // "0" = base can be dec,oct or hex, nice !
-
-	// Using "suStringToU32" assume string was HEX
-	bValidStringConversion = suStringToU32(strPtr, suHEX, &ulData);
-
-	if (bValidStringConversion == false)
-	{
-		// If not Hex, try decimal..
-		bValidStringConversion = suStringToU32(strPtr, suDECIMAL, &ulData);
-	}
-
-
-	*uInt32Ptr = ulData;	// put the result in the loc pointed to.
-
-
-	return bValidStringConversion;
-}
-
-
-// Function:	bool getU32Index(uint32_t *numberPtr, char *strPtr) ==========
-/**
- * <pre>
- * Scan a string and convert the index xxxx located in between
- * the delimiters [ and ], into a numeric uint32_t.
- *
- * This index may be represented as hex: 0x0 to 0xFFFFFFFF or as
- * an unsigned decimal up to 32 bits.
- *
- * If no index exists or improper numerical format (to large etc)
- * then function will return false.
- * </pre>
- *
- * @param uInt32Ptr 	External location of uint_32t result.
- * @param strPtr		String to convert, if possible.
- * @retval 				True if converted index into valid uint_32t.
- *
- */
-bool getU32Index(uint32_t *uInt32Ptr, char *strPtr)
-{
-	char separator1[] = "[";
-	char separator2[] = "]";
-	unsigned long  ul;
-	bool bValidStringConversion;
-	size_t strLen1;
-	size_t strLen2;
-	char savedChar;
-	char *ptr;
-
-	bValidStringConversion = false;
-
-	// Get number of chars (span) before "["
-	// this will be full length of string if do not see "["
-	strLen1 = strcspn(strPtr, separator1);
-
-	if (strLen1 != strlen(strPtr))
-	{
-		// did see the first '['.
-
-		// "+1" to skip '['
-		strLen1++;
-		strLen2 = strcspn(&(strPtr[strLen1]), separator2);
-
-		if (strLen2 != strlen( &(strPtr[strLen1]) ))
-		{
-			// did see the second ']'
-			// Now we know substring spans from
-			// strPtr[strLen1] to strPtr[strLen1 + strLen2 - 1]
-
-			// We expect to see digit right away after the '[', this makes
-			// coding simpler and less bug prone..
-
-			if ( isdigit(strPtr[strLen1]) )
-			{
-				// Save char where the next delimiter is: ']'
-				savedChar = strPtr[strLen1+strLen2];
-				// Put a null there to facilitate strtoul:
-				strPtr[strLen1+strLen2] = '\0';
-
-				ptr = &(strPtr[strLen1]);
-
-				//ul = strtoul(ptr, &ptr, 0);
-
-				// Using "suStringToU32" assume string was HEX
-
-				bValidStringConversion = suStringToU32(ptr, suHEX, &ul);
-
-				if (bValidStringConversion == false)
-				{
-					// If not Hex, try decimal..
-					bValidStringConversion = suStringToU32(ptr, suDECIMAL, &ul);
-				}
-
-
-				*uInt32Ptr = ul;
-
-				// Restore char where the end of index delimiter is s.b. ']'
-				strPtr[strLen1+strLen2] = savedChar;
-			}
-		}
-	}
-
-	return bValidStringConversion;
-}
-
-// Function:	bool getU8Index(uint8_t *uInt8Ptr, char *strPtr) ==========
-/**
- * <pre>
- * Scan a string and convert the index xx located in between
- * the delimiters [ and ], into a numeric uint8_t.
- *
- * This index may be represented as hex: 0x0 to 0xFF or as
- * an unsigned decimal up to 8 bits.
- *
- * If no index exists or improper numerical format (to large etc)
- * then function will return false.
- * </pre>
- *
- * @param uInt8Ptr 		External location of uint_8t result.
- * @param strPtr		String to convert, if possible.
- * @retval 				True if converted index into valid uint_8t.
- *
- */
-bool getU8Index(uint8_t *uInt8Ptr, char *strPtr)
-{
-	char separator1[] = "[";
-	char separator2[] = "]";
-	unsigned long  ul;
-	bool result;
-	bool bValidStringConversion;
-	size_t strLen1;
-	size_t strLen2;
-	char savedChar;
-	char *ptr;
-
-	result = false;
-
-	// Get number of chars (span) before "["
-	// this will be full length of string if do not see "["
-	strLen1 = strcspn(strPtr, separator1);
-
-	if (strLen1 != strlen(strPtr))
-	{
-		// did see the first '['.
-
-		// "+1" to skip '['
-		strLen1++;
-		strLen2 = strcspn(&(strPtr[strLen1]), separator2);
-
-		if (strLen2 != strlen( &(strPtr[strLen1]) ))
-		{
-			// did see the second ']'
-			// Now we know substring spans from
-			// strPtr[strLen1] to strPtr[strLen1 + strLen2 - 1]
-
-			// We expect to see digit right away after the '[', this makes
-			// coding simpler and less bug prone..
-
-			if ( isdigit(strPtr[strLen1]) )
-			{
-				// Save char where the next delimiter is: ']'
-				savedChar = strPtr[strLen1+strLen2];
-				// Put a null there to facilitate strtoul:
-				strPtr[strLen1+strLen2] = '\0';
-
-				// We are assured strtoul will be successful by isdigit..
-				// ( ###  Assumes that chars after first digit are also digits.. )
-				// ( ###  Any value > 0xFF will be rejected. )
-				ptr = &(strPtr[strLen1]);
-
-				//ul = strtoul(ptr, &ptr, 0);
-
-				// Using "suStringToU32" assume string was HEX
-
-				bValidStringConversion = suStringToU32(ptr, suHEX, &ul);
-
-				if (bValidStringConversion == false)
-				{
-					// If not Hex, try decimal..
-					bValidStringConversion = suStringToU32(ptr, suDECIMAL, &ul);
-				}
-
-				if ((ul <= 255) && (bValidStringConversion == true))
-				{
-					*uInt8Ptr = (uint8_t) ul;
-					result = true;
-				}
-				// Restore char where the end of index delimiter is s.b. ']'
-				strPtr[strLen1+strLen2] = savedChar;
-			}
-		}
-	}
-		return result;
-}
-
-
-// The received bytes are picked up by ISR, and handled by the callback
-// routine "HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)", in uart_jmk.c
-// This routine will flag "Transfer_cplt" which occurs every time terminal
-// sends a CR 0x0D charactor.
-
-/**
- * <pre>
- * Interpret and execute the latest command string, from the input terminal.
- * This will also send back the appropriate response for the particular
- * command.
- * </pre>
- *
- * @param cmdStr		Command string to parse, interpret, execute.
- *
- */
-
-void cmdHandler(char * cmdStr)
-{
-	bool	isU8Index;
-	bool	isU32Index;
-	bool	isInputDataStr;
-	bool	isUintData;
-
-	unsigned int strLength;
-	unsigned int cmdLength;
-
-	uint32_t 	uIntData;
-	uint32_t	index,i;
-
-	char * dataStrPtr;
-
-    char letter1;
-    char cmdToken[] = "12345";
-
-    cmdResponse = eOK;
-
-	strLength = strlen(cmdStr);
-
-	/**
-	 * <b>Flow of Control - </b> <br>
-	 * */
-	///
-	/// <pre>Get numerical index in command string "cmd[index]", if it exists:
-	/// Typically the index is expected to be < 256. </pre>
-
-	isU32Index = getU32Index(&index, cmdStr);
-	isU8Index  = ((index <= 255) && (isU32Index == true));
-
-
-
-	/// <pre>Get the length of cmdToken "cmd" - max 5 chars.., min 0 chars.
-	/// <em>Note: If "[" is not seen then cmdLength will be same as command string
-	/// If length of cmdToken is > 5 we look at only first 5 chars, max.</em> </pre>
-	cmdLength = strcspn(cmdStr, "[");
-
-	if (cmdLength > 5) cmdLength = 5;
-	if (cmdLength)
-	{
-		for (i=0; i<cmdLength; i++)
-		{
-			cmdToken[i] = toupper(cmdStr[i]); // make all upper case..
-		}
-		// Add in the null char to end the string..
-		cmdToken[i] = '\0';
-	}
-
-	letter1 = cmdToken[0];
-
-	//-----------------------------------------------------------
-
-	/// <pre>Get Str pointer for input data after single equals sign, if it exists.
-	/// <em> Example: for d[xxx]=yyyy, we provide input data "yyyy" </em> </pre>
-	isInputDataStr = getDataInputString(&dataStrPtr, cmdStr);
-
-
-	// See if this data qualifies for unsigned integer data (32 bit unsigned)
-	/// If input data exists, then attempt to convert it to numeric.
-	if (isInputDataStr)
-	{
-		isUintData = convStringToUint(&uIntData, dataStrPtr);
-	}
-
-
-	/// <pre>cmdToken is first 5 chars of command string, at most.
-	/// i.e. chars that come before the [xx], if index exists.</pre>
-
-	// Assume default..
-	cmdResponse = eUnknownCmd;
-
-	/// <pre>Look at first char of cmdToken
-	/// For valid first char, parse out the command and what to do with it. <br></pre>
-	/**
-	 * <b> Flow of Control - Parse Cases:</b> <br>
-	 */
-	switch (letter1)
-	{
-		/// 'C[xx]' indicates a command "xx".
-		case 'C':
-			if (cmdLength == 1)
-			{
-				cmdResponse = eIndexError; // assume worst, hope  best:
-				if ( isU8Index  )
-				{
-					// with no data to be input (written)
-					// Read out the current data
-
-					// ### Previously used sprintf to convert u32 to decimal value text
-					// sprintf(respBuffer, "Received C[%u]\r\n", (unsigned int)index);
-
-					// Now convert u32 to string and build up a total string as response:
-					suU32ToString( index, suDECIMAL, suStringToFill );
-					strcpy(respBuffer, "Command requested: C[");
-					strcat(respBuffer,suStringToFill);
-					strcat(respBuffer, "]\r\n");
-
-
-					cmdResponse = eNoFurtherComment;
-					//cmdResponse = eGotC;
-				}
-				else if (isU32Index)
-				{
-					cmdResponse = eIndexRangeExceeded;
-				}
-
-			}
-			break;
-
-		/// 'D[xx]' indicates a data set read/write.
-		case 'D':
-			if (cmdLength == 1)
-			{
-				cmdResponse = eIndexError;
-				if ( isU8Index )
-				{
-					// with no data to be input (written)
-					// Read out the current data
-					//sprintf(respBuffer, "Received D[%u]\r\n", (unsigned int)index);
-
-					// Now convert u32 to string and build up a total string as response:
-					suU32ToString( index, suDECIMAL, suStringToFill );
-					strcpy(respBuffer, "Data set requested: D[");
-					strcat(respBuffer,suStringToFill);
-					strcat(respBuffer, "]\r\n");
-
-					cmdResponse = eNoFurtherComment;
-					//cmdResponse = eGotD;
-				}
-				else if (isU32Index)
-				{
-					cmdResponse = eIndexRangeExceeded;
-				}
-
-			}
-			break;
-
-		/// 'H[xx]' indicates help page request. <br>
-		/// 'H' by itself indicates, system halt/restart request.
-		case 'H':	// "help" or "halt" ?
-			if (strLength == 1)
-			{
-				// Halt command !
-				strcpy(respBuffer, "System Halted !\r\n");
-				cmdResponse = eNoFurtherComment;
-			}
-			else if (cmdLength == 1)
-			{
-				cmdResponse = eIndexError; // assume worst, hope  best:
-				if ( isU8Index  )
-				{
-					//
-					if (index == 1)
-					{
-					  // This is h[1] , our very first help page !
-					  strcpy(respBuffer,help_1_str);
-					}
-					else
-					{
-						// with no data to be input (written)
-						// Read out the current data
-						//sprintf(respBuffer, "Received H[%u]\r\n", (unsigned int)index);
-						// Now convert u32 to string and build up a total string as response:
-						suU32ToString( index, suDECIMAL, suStringToFill );
-						strcpy(respBuffer, "Help page requested: H[");
-						strcat(respBuffer,suStringToFill);
-						strcat(respBuffer, "]");
-						strcat(respBuffer, " - does not exist !\r\n");
-					}
-
-					cmdResponse = eNoFurtherComment;
-					//cmdResponse = eGotH;
-				}
-				else if (isU32Index)
-				{
-					cmdResponse = eIndexRangeExceeded;
-				}
-			}
-			break;
-
-		/// 'S[xx]' indicates status of type "xx" request.
-		case 'S':	// "Status", "Streaming Status" ?
-			if (cmdLength == 1)
-			{	// Must be the S command.
-				cmdResponse = eIndexError; // assume worst, hope  best:
-				if ( isU8Index  )
-				{
-					// with no data to be input (written)
-					// Read out the current data
-					//sprintf(respBuffer, "Received status request: S[%u]\r\n", (unsigned int)index);
-					// Now convert u32 to string and build up a total string as response:
-					suU32ToString( index, suDECIMAL, suStringToFill );
-					strcpy(respBuffer, "Status requested: S[");
-					strcat(respBuffer,suStringToFill);
-					strcat(respBuffer, "]\r\n");
-					cmdResponse = eNoFurtherComment;
-
-				}
-				else if (isU32Index)
-				{
-					cmdResponse = eIndexRangeExceeded;
-				}
-			}
-			/// 'SS[xx]' indicates  streaming (repeating) status of type "xx" request.
-			else if (strcmp(cmdToken, "SS") == strEQUALITY)
-			{
-				cmdResponse = eIndexError; // assume worst, hope  best:
-				if ( isU8Index  )
-				{
-					// with no data to be input (written)
-					// Read out the current data
-					//sprintf(respBuffer, "Received streaming status request: SS[%u]\r\n", (unsigned int)index);
-					// Now convert u32 to string and build up a total string as response:
-					suU32ToString( index, suDECIMAL, suStringToFill );
-					strcpy(respBuffer, "Streaming status requested: SS[");
-					strcat(respBuffer,suStringToFill);
-					strcat(respBuffer, "]\r\n");
-					cmdResponse = eNoFurtherComment;
-				}
-				else if (isU32Index)
-				{
-					cmdResponse = eIndexRangeExceeded;
-				}
-			}
-			break;
-		/// 'M[xxxxxxxx]' or 'M[xx..]=yy..' => Memory/IO/SFR read or write.
-		case 'M':	// Report any 4 bytes worth of memory/IO/SFR's
-			if (cmdLength == 1)
-			{	// Must be the M command.
-				cmdResponse = eIndexError; // assume worst, hope  best:
-
-				// if the "index" found in [xxxxxxxx] is a valid U32 index:
-				if ( isU32Index  )
-				{
-					uint32_t *MemorySpacePtr;
-
-					// Get the address (pointer) selected via the index M[xxxxxxxx]
-					MemorySpacePtr = (uint32_t *)index;
-
-					// Now convert index of u32 to back to string to use as part of response:
-					// sprintf(respBuffer, "Memory M[0x%08X]", (unsigned int)index);
-					suU32ToString( index, suHEX, suStringToFill );
-
-					// Check flags to see:
-					// 1) if an "=" sign after the index, which indicates data to write.
-					// 2) The data to write is a valid number and was converted to Uint.
-					if (isInputDataStr && isUintData)
-					{
-						// We requested a write to memory/IO/SFR, so let's do it !
-						// Take uIntData and write it to loc. pointed to by MemorySpacePtr.
-						*MemorySpacePtr = uIntData;
-						strcpy(respBuffer, "Memory/IO write: M[0x");
-						strcat(respBuffer,suStringToFill);
-						strcat(respBuffer, "]");
-						strcat(respBuffer, " <== 0x");
-						suU32ToString( uIntData, suHEX, suStringToFill );
-						strcat(respBuffer,suStringToFill);
-						strcat(respBuffer, "\r\n");
-						cmdResponse = eNoFurtherComment;
-					}
-					else
-					{
-						// We requested a read from a memory/IO/SFR location
-						strcpy(respBuffer, "Memory/IO query: M[0x");
-						strcat(respBuffer,suStringToFill);
-						strcat(respBuffer, "]");
-						// Translate what we read via MemorySpacePtr, to hex string
-						//sprintf(strOf20CharsMax, " = 0x%08X \r\n", (unsigned int)*MemorySpacePtr);
-						suU32ToString( (unsigned int)*MemorySpacePtr, suHEX, suStringToFill );
-						strcat(respBuffer, " = 0x");
-						strcat(respBuffer,suStringToFill);
-						strcat(respBuffer, "\r\n");
-						cmdResponse = eNoFurtherComment;
-						//cmdResponse = eGotM;
-					}
-				}
-			}
-			break;
-	}
-
-    switch (cmdResponse)
-    {
-    case eOK:
-        strcpy(respBuffer, "Ok\r\n");
-    	break;
-    case eUnknownCmd:
-    	strcpy(respBuffer, "Unknown command !\r\n");
-    	break;
-    case eGotC:
-        strcpy(respBuffer, "Stub cmd C, Ok\r\n");
-    	break;
-    case eGotD:
-        strcpy(respBuffer, "Stub cmd D, Ok\r\n");
-    	break;
-    case eGotH:
-        strcpy(respBuffer, "Stub cmd H, Ok\r\n");
-    	break;
-    case eGotM:
-        strcpy(respBuffer, "Stub cmd M, Ok\r\n");
-    	break;
-    case eNoFurtherComment:
-        break;
-    case eAttachReadOnly:
-    	strcat(respBuffer, " is read only..");
-		break;
-    case eUintExpected:
-        strcpy(respBuffer, "Unsigned int format expected.\r\n");
-    	break;
-    case eIndexRangeExceeded:
-        strcpy(respBuffer, "Index range Exceeded.\r\n");
-    	break;
-    case eIndexError:
-    	strcpy(respBuffer, "Index Expected.\r\n");
-    	break;
-    }
-
-      //UartPutString(crlf_msg, false);
-
-      /// <br> Finally send response based on what command received back to terminal.
-      UartPutString(respBuffer, false);
-      ///  \pagebreak
-      //UartPutString(crlf_msg, false);
-}
+/**
+  @file serialCmdParser.c
+  @brief Serial Command processor
+<pre>
+  This is a generic command processor.
+  These commands are kept as as simple as possible, mildly cryptic,
+  but in easily expandable format to allow rapid implementation and
+  modification.
+
+  Table lookup can interpret these into English readable.
+
+  c[x] - "do this" command 					(may include parameters)
+  s[x] - "status set"   		        	(no parameters, read only)
+  d[x] - "data set", R/W 					(when W command is followed by = data.)
+  m[xxxx] - "Generic I/O,SFR, memory, R/W   (when W command is followed by = uint8_t.)
+  h[x] - "Display a help page"				(Page# = x)
+
+  h - A single "h" or "H" halts (and resets) the system.
+
+  Notes:
+
+  x 	= uint_8t , index range 0 to 255.
+  xxxx	= uint_32t, address range 0x00000000 to 0xFFFFFFFF
+
+  Codes c,s and d are made more specific by adding [x].
+  Exactly what they do will be determined by enumeration of [x].
+
+  Code m directly reads/writes the address space of the processor,
+  (possibly with some restrictions).
+
+  "help y[x]" returns usage page for command y[x].
+
+  h[x] displays sections of complete command set manual,
+  presently this is only h[1].
+  </pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	2/14/2018
+
+   \pagebreak
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "serialCmdParser.h"
+#include "uart_jmk.h"
+#include "strUtilities.h"
+#include "eePromLog.h"
+#include "eePromFill.h"
+#include "eePromCrc.h"
+#include "i2cTrace.h"
+#include "i2cSlaveEE.h"
+#include "i2cScan.h"
+#include "i2cBus.h"
+#include "eePromCopy.h"
+#include "i2cRetry.h"
+#include "adcSampler.h"
+#include "adcFilter.h"
+#include "adcAlarm.h"
+#include "adcTemp.h"
+#include "mainEvent.h"
+#include "taskSched.h"
+#include "pendWork.h"
+#include "irqPriority.h"
+#include "clockProfile.h"
+#include "idleSleep.h"
+
+// Delay counter
+#define DELAY_COUNT   500000
+
+/// SS[x] resends status x this often, until the next command.
+#define CMD_STREAM_MS	1000
+
+/// Status being streamed, 0 for none, and when it was last sent.
+static uint32_t streamIndex;
+static uint32_t streamLastTick;
+
+extern bool Cmd_Recieved;
+
+/// Command Response Codes Enumeration.
+enum commandResponse
+{
+	eOK,
+	eUnknownCmd,
+	eGotC,
+	eGotD,
+	eGotH,
+	eGotM,
+	eUintExpected,
+	eNoFurtherComment,
+	eAttachReadOnly,
+	eIndexRangeExceeded,
+	eIndexError
+};
+typedef enum commandResponse eCOMMAND_RESPONSE;
+
+/// Command numbers for C[x], (x may be given as decimal or 0x hex).
+enum commandNumber
+{
+	cmdEELogFlush		= 0x10,		///< C[0x10]			- Commit log records waiting in RAM.
+	cmdEELogQuery		= 0x11,		///< C[0x11]=start,end	- List log records, log time ms.
+	cmdEEFill0			= 0x12,		///< C[0x12]=start,len	- Background fill with 0x00, (whole device if no data).
+	cmdEEErase			= 0x13,		///< C[0x13]=start,len	- Background fill with 0xFF, (erase).
+	cmdEEFillIndex		= 0x14,		///< C[0x14]=start,len	- Background fill with page index pattern 0..63.
+	cmdEEFillRevIndex	= 0x15,		///< C[0x15]=start,len	- Background fill with page index pattern 63..0.
+	cmdEECrcScan		= 0x16,		///< C[0x16]			- Check every page against its CRC, list bad pages.
+	cmdEECrcCheck		= 0x17,		///< C[0x17]			- Check only pages written since their last check.
+	cmdEECrcRelearn		= 0x18,		///< C[0x18]			- Take present contents as good, learn all CRCs.
+	cmdI2CTraceText		= 0x19,		///< C[0x19]			- List I2C trace records, oldest first.
+	cmdI2CTraceBinary	= 0x1A,		///< C[0x1A]			- Send I2C trace as binary, i2cTraceDumpHeader + records.
+	cmdI2CTraceClear	= 0x1B,		///< C[0x1B]			- Clear I2C trace records and counters.
+	cmdI2CSlaveStart	= 0x1C,		///< C[0x1C]=eeAddr		- Answer on I2C2 as the PIC eeprom simulator, RAM, (or cached from eeAddr).
+	cmdI2CSlaveStop		= 0x1D,		///< C[0x1D]			- Stop the eeprom simulator, write back to the AT24C.
+	cmdI2CScan			= 0x1E,		///< C[0x1E]=first,last	- Scan I2C2 for devices, size AT24Cs found, (0x08..0x77 if no data).
+	cmdEECopyToAux		= 0x1F,		///< C[0x1F]=start,len	- Background copy AT24C on I2C2 to AT24C on I2C1, (whole device if no data).
+	cmdI2CRetryCount	= 0x20,		///< C[0x20]=class,n	- I2C retries for class 0 NACK, 1 ARLO, 2 BERR, (0 no retry).
+	cmdI2CRetryBackoff	= 0x21,		///< C[0x21]=class,us	- I2C backoff before the first retry of a class, doubles per retry.
+	cmdADCChannels		= 0x22,		///< C[0x22]=mask		- ADC channel list, bit per channel 0..17, (0x3000C temp, Vrefint, PA2, PA3).
+	cmdADCStatsClear	= 0x23,		///< C[0x23]			- Start the ADC channel statistics again.
+	cmdADCFilter		= 0x24,		///< C[0x24]=type,n		- ADC block filter, 0 off, 1 average 2^n, 2 FIR 50 Hz, 3 biquad 10 Hz n stages.
+	cmdADCAlarmSet		= 0x25,		///< C[0x25]=ch,lo,hi	- ADC alarm window of channel, raw counts, (the first set has the analog watchdog).
+	cmdADCAlarmRemove	= 0x26,		///< C[0x26]=ch			- Remove the ADC alarm window of channel.
+	cmdADCAlarmOutputs	= 0x27,		///< C[0x27]=log,notify	- ADC alarms to the eeprom log, to the terminal, 1 on 0 off.
+	cmdTempCalibrate	= 0x28,		///< C[0x28]=pt,centiC	- Chip temperature now is centiC/100 C, point 1 then 2 saves the line, 0,0 data sheet.
+	cmdTaskStatsClear	= 0x29,		///< C[0x29]			- Start the main loop task statistics again.
+	cmdIrqStatsClear	= 0x2A,		///< C[0x2A]			- Start the interrupt run time statistics again.
+	cmdClockProfile		= 0x2B,		///< C[0x2B]=profile	- System clock 0 HSI 8MHz, 1 HSI PLL 24MHz, 2 HSE PLL 24MHz, buses re-timed.
+	cmdIdleTickless		= 0x2C		///< C[0x2C]=on			- Idle with SysTick stopped until the next task, 1 on 0 off, idle statistics start again.
+};
+
+/// Status numbers for S[x].
+enum statusNumber
+{
+	statEELog			= 0x10,		///< S[0x10]	- Log head, tail, page count, sequence.
+	statEEFill			= 0x11,		///< S[0x11]	- Background fill progress and verify result.
+	statEECrc			= 0x12,		///< S[0x12]	- Page CRC changed/unknown counts, last scan result.
+	statI2CTrace		= 0x13,		///< S[0x13]	- I2C transactions, errors, slowest one.
+	statI2CSlave		= 0x14,		///< S[0x14]	- Eeprom simulator address, traffic, longest callback.
+	statI2CScan			= 0x15,		///< S[0x15]	- Devices found by the last scan, response time, AT24C size.
+	statI2CBus			= 0x16,		///< S[0x16]	- Per bus queue traffic, DMA use, busy time, copy progress.
+	statI2CDevices		= 0x17,		///< S[0x17]	- Per I2C device errors, retries, latency histogram, retry policy.
+	statADC				= 0x18,		///< S[0x18]	- Per ADC channel filtered value, min, max, mean, variance, blocks.
+	statADCFilter		= 0x19,		///< S[0x19]	- ADC block filter outputs, cycles per block, dropped and late blocks.
+	statADCAlarm		= 0x1A,		///< S[0x1A]	- ADC alarm windows, alarm state and counts, event queue.
+	statTemp			= 0x1B,		///< S[0x1B]	- Chip temperature, calibration line and where it came from.
+	statMainLoop		= 0x1C,		///< S[0x1C]	- Main loop events posted, coalesced, worst post to handled latency, sleeps, PendSV work.
+	statTasks			= 0x1D,		///< S[0x1D]	- Per main loop task runs, run time, overruns, deadline misses.
+	statIrq				= 0x1E,		///< S[0x1E]	- Per interrupt priority, count, longest run, worst entry latency, UART byte time check.
+	statClock			= 0x1F,		///< S[0x1F]	- Clock profile, SYSCLK, bus and ADC clocks, UART baud, switches.
+	statIdle			= 0x20		///< S[0x20]	- Tickless sleeps, ticks skipped, longest sleep, time asleep.
+};
+
+/// Holds latest command response
+eCOMMAND_RESPONSE cmdResponse;
+
+
+#define strEQUALITY 0
+
+// Ref:
+// https://stackoverflow.com/questions/797318/how-to-split-a-string-literal-across-multiple-lines-in-c-objective-c
+/// Help page displayed on terminal in response to "h[1]"
+char  * help_1_str = "\r\n"
+                "Help page #1 - Command Interpreter Overview: ----------- \r\n\r\n"
+                "c[x]    - \"Execute Command #x\"       (may include parameters)\r\n"
+                "s[x]    - \"Read a Status Set\"        (no parameters, read only)\r\n"
+                "d[x]    - \"Data Set\", R/W            (if W, command followed by = data.)\r\n"
+                "m[xxxx] - \"I/O,SFR,Mem.,@[addr],\"R/W (if W, command followed by = uint8_t.)\r\n"
+                "h[x]    - \"Display help page\"        (Page# = x)\r\n"
+                "\r\n"
+                "h       - \"h\" or \"H\" halts (and resets) the system.\r\n"
+                "\r\n"
+                "Notes:\r\n"
+                "\r\n"
+                "x 	= uint_8t , index range 0 to 255.\r\n"
+                "xxxx	= uint_32t, address range 0x00000000 to 0xFFFFFFFF\r\n"
+                "\r\n"
+                "Codes c,s and d are made more specific by adding [x].\r\n"
+                "Exactly what they do will be determined by enumeration of [x].\r\n"
+                "\r\n"
+                "Code m directly reads/writes the address space of the processor,\r\n"
+                "(possibly with some restrictions).\r\n"
+                "------------------------------------------------------------- \r\n\r\n";
+
+
+/**
+ * <pre>
+ * Scans MainString, and returns pointer to
+ * start of Data section of message via subString.
+ * Data section is delimited by the "=" symbol.
+ * Will return false if can not find data section
+ * (characters) following a single "=".
+ * </pre>
+ *
+ * @param subString 	Points to start of data section.
+ * @param MainString 	Points to start of input string.
+ * @retval 				True if found "=" indicating data.
+ *
+ */
+// We use char ** because we want to output the result
+// to an external variable that is char*, in order to do
+// this we must use a pointer to char*, thus char**
+bool getDataInputString(char **subString, char * MainString)
+{
+	char * findItPtr;
+	size_t strLen1;
+
+	// Get length of substring delimited by "="
+	strLen1 = strcspn(MainString, "=");
+
+	if (strLen1 != strlen(MainString))
+	{
+		// Delimiter "=" found, the substring is shorter:
+
+		strLen1++; // to skip past the "="
+		findItPtr = &(MainString[strLen1]);
+	}
+	else
+	{
+		// delimiter "=" not found,
+		findItPtr = NULL;
+	}
+
+	// Reject for no "="
+	if (findItPtr == NULL)
+	{
+		// Just as a backstop (or we could return NULL...)
+		*subString = MainString;
+		return false;
+	}
+	else
+	{
+		// Q: Do this dereference just because variable
+		// was defined as char ** ?
+		// A: No, it is done because we want the parameter
+		//    To of an "out" type that can write to an external
+		//    variable location of type char* from this function.
+		*subString = findItPtr;
+		return true;
+	}
+}
+
+// FUNCTION:	bool convStringToUint(uint_32t *uInt32Ptr, char *strPtr) ===
+/**
+ * <pre>
+ * Convert  string via "strPtr" to  uint_32t if possible.
+ * Return false if string is invalid format for uint_32t
+ *
+ * Numerical value is returned via pointer "uInt32Ptr"
+ *</pre>
+ * Will be able to, also, interpret the hex 0x00000 format, and accept
+ * 8, 16, and 32 bit hex values
+ *
+ * @param uInt32Ptr 	External location of uint_32t result.
+ * @param strPtr		String to convert, if possible.
+ * @retval 				True if string holds valid uint_32t.
+ *
+ */
+bool convStringToUint(uint32_t *uInt32Ptr, char *strPtr)
+{
+	unsigned long ulData;		// Note Arm compiler says uint_32t same as ulong.
+	bool   bValidStringConversion;
+
+	//### using "stroul"
+	//ulData = strtoul(strPtr, &strPtr, 0); // "0" = base can be dec,oct or hex, nice !
+
+	// Using "suStringToU32" assume string was HEX
+	bValidStringConversion = suStringToU32(strPtr, suHEX, &ulData);
+
+	if (bValidStringConversion == false)
+	{
+		// If not Hex, try decimal..
+		bValidStringConversion = suStringToU32(strPtr, suDECIMAL, &ulData);
+	}
+
+
+	*uInt32Ptr = ulData;	// put the result in the loc pointed to.
+
+
+	return bValidStringConversion;
+}
+
+
+// Function:	bool getU32Index(uint32_t *numberPtr, char *strPtr) ==========
+/**
+ * <pre>
+ * Scan a string and convert the index xxxx located in between
+ * the delimiters [ and ], into a numeric uint32_t.
+ *
+ * This index may be represented as hex: 0x0 to 0xFFFFFFFF or as
+ * an unsigned decimal up to 32 bits.
+ *
+ * If no index exists or improper numerical format (to large etc)
+ * then function will return false.
+ * </pre>
+ *
+ * @param uInt32Ptr 	External location of uint_32t result.
+ * @param strPtr		String to convert, if possible.
+ * @retval 				True if converted index into valid uint_32t.
+ *
+ */
+bool getU32Index(uint32_t *uInt32Ptr, char *strPtr)
+{
+	char separator1[] = "[";
+	char separator2[] = "]";
+	unsigned long  ul;
+	bool bValidStringConversion;
+	size_t strLen1;
+	size_t strLen2;
+	char savedChar;
+	char *ptr;
+
+	bValidStringConversion = false;
+
+	// Get number of chars (span) before "["
+	// this will be full length of string if do not see "["
+	strLen1 = strcspn(strPtr, separator1);
+
+	if (strLen1 != strlen(strPtr))
+	{
+		// did see the first '['.
+
+		// "+1" to skip '['
+		strLen1++;
+		strLen2 = strcspn(&(strPtr[strLen1]), separator2);
+
+		if (strLen2 != strlen( &(strPtr[strLen1]) ))
+		{
+			// did see the second ']'
+			// Now we know substring spans from
+			// strPtr[strLen1] to strPtr[strLen1 + strLen2 - 1]
+
+			// We expect to see digit right away after the '[', this makes
+			// coding simpler and less bug prone..
+
+			if ( isdigit(strPtr[strLen1]) )
+			{
+				// Save char where the next delimiter is: ']'
+				savedChar = strPtr[strLen1+strLen2];
+				// Put a null there to facilitate strtoul:
+				strPtr[strLen1+strLen2] = '\0';
+
+				ptr = &(strPtr[strLen1]);
+
+				//ul = strtoul(ptr, &ptr, 0);
+
+				// Using "suStringToU32" assume string was HEX
+
+				bValidStringConversion = suStringToU32(ptr, suHEX, &ul);
+
+				if (bValidStringConversion == false)
+				{
+					// If not Hex, try decimal..
+					bValidStringConversion = suStringToU32(ptr, suDECIMAL, &ul);
+				}
+
+
+				*uInt32Ptr = ul;
+
+				// Restore char where the end of index delimiter is s.b. ']'
+				strPtr[strLen1+strLen2] = savedChar;
+			}
+		}
+	}
+
+	return bValidStringConversion;
+}
+
+// Function:	bool getU8Index(uint8_t *uInt8Ptr, char *strPtr) ==========
+/**
+ * <pre>
+ * Scan a string and convert the index xx located in between
+ * the delimiters [ and ], into a numeric uint8_t.
+ *
+ * This index may be represented as hex: 0x0 to 0xFF or as
+ * an unsigned decimal up to 8 bits.
+ *
+ * If no index exists or improper numerical format (to large etc)
+ * then function will return false.
+ * </pre>
+ *
+ * @param uInt8Ptr 		External location of uint_8t result.
+ * @param strPtr		String to convert, if possible.
+ * @retval 				True if converted index into valid uint_8t.
+ *
+ */
+bool getU8Index(uint8_t *uInt8Ptr, char *strPtr)
+{
+	char separator1[] = "[";
+	char separator2[] = "]";
+	unsigned long  ul;
+	bool result;
+	bool bValidStringConversion;
+	size_t strLen1;
+	size_t strLen2;
+	char savedChar;
+	char *ptr;
+
+	result = false;
+
+	// Get number of chars (span) before "["
+	// this will be full length of string if do not see "["
+	strLen1 = strcspn(strPtr, separator1);
+
+	if (strLen1 != strlen(strPtr))
+	{
+		// did see the first '['.
+
+		// "+1" to skip '['
+		strLen1++;
+		strLen2 = strcspn(&(strPtr[strLen1]), separator2);
+
+		if (strLen2 != strlen( &(strPtr[strLen1]) ))
+		{
+			// did see the second ']'
+			// Now we know substring spans from
+			// strPtr[strLen1] to strPtr[strLen1 + strLen2 - 1]
+
+			// We expect to see digit right away after the '[', this makes
+			// coding simpler and less bug prone..
+
+			if ( isdigit(strPtr[strLen1]) )
+			{
+				// Save char where the next delimiter is: ']'
+				savedChar = strPtr[strLen1+strLen2];
+				// Put a null there to facilitate strtoul:
+				strPtr[strLen1+strLen2] = '\0';
+
+				// We are assured strtoul will be successful by isdigit..
+				// ( ###  Assumes that chars after first digit are also digits.. )
+				// ( ###  Any value > 0xFF will be rejected. )
+				ptr = &(strPtr[strLen1]);
+
+				//ul = strtoul(ptr, &ptr, 0);
+
+				// Using "suStringToU32" assume string was HEX
+
+				bValidStringConversion = suStringToU32(ptr, suHEX, &ul);
+
+				if (bValidStringConversion == false)
+				{
+					// If not Hex, try decimal..
+					bValidStringConversion = suStringToU32(ptr, suDECIMAL, &ul);
+				}
+
+				if ((ul <= 255) && (bValidStringConversion == true))
+				{
+					*uInt8Ptr = (uint8_t) ul;
+					result = true;
+				}
+				// Restore char where the end of index delimiter is s.b. ']'
+				strPtr[strLen1+strLen2] = savedChar;
+			}
+		}
+	}
+		return result;
+}
+
+
+// Function:	bool getTwoU32Data(uint32_t *pFirst, uint32_t *pSecond, char *strPtr) ==========
+/**
+ * <pre>
+ * Convert a data section of form "first,second" into two uint32_t.
+ * Each may be hex 0x.. or decimal, as for convStringToUint(..).
+ * </pre>
+ *
+ * @param pFirst	External location of first uint_32t.
+ * @param pSecond	External location of second uint_32t.
+ * @param strPtr	Data section string, (after the "=").
+ * @retval			True if both converted.
+ *
+ */
+bool getTwoU32Data(uint32_t *pFirst, uint32_t *pSecond, char *strPtr)
+{
+	size_t strLen1;
+	bool   bValid = false;
+
+	strLen1 = strcspn(strPtr, ",");
+
+	if (strLen1 != strlen(strPtr))
+	{
+		// Split the string at the ',' for the conversion, then restore it.
+		strPtr[strLen1] = '\0';
+		bValid = convStringToUint(pFirst, strPtr) &&
+				 convStringToUint(pSecond, &(strPtr[strLen1 + 1]));
+		strPtr[strLen1] = ',';
+	}
+	return bValid;
+}
+
+// Function:	bool getThreeU32Data(uint32_t *pFirst, uint32_t *pSecond, uint32_t *pThird, char *strPtr) ==
+/**
+ * <pre>
+ * Convert a data section of form "first,second,third" into three uint32_t,
+ * as getTwoU32Data(..)
+ * </pre>
+ *
+ * @retval			True if all three converted.
+ *
+ */
+bool getThreeU32Data(uint32_t *pFirst, uint32_t *pSecond, uint32_t *pThird, char *strPtr)
+{
+	size_t strLen1;
+	bool   bValid = false;
+
+	strLen1 = strcspn(strPtr, ",");
+
+	if (strLen1 != strlen(strPtr))
+	{
+		strPtr[strLen1] = '\0';
+		bValid = convStringToUint(pFirst, strPtr) &&
+				 getTwoU32Data(pSecond, pThird, &(strPtr[strLen1 + 1]));
+		strPtr[strLen1] = ',';
+	}
+	return bValid;
+}
+
+// Function:	bool getU32IntData(uint32_t *pFirst, int32_t *pSecond, char *strPtr) ==
+/**
+ * <pre>
+ * Convert a data section of form "first,second" as getTwoU32Data(..),
+ * second may be negative, "-" then decimal or 0x hex magnitude.
+ * </pre>
+ *
+ * @retval			True if both converted, (second -2^31 .. 2^31 - 1).
+ *
+ */
+bool getU32IntData(uint32_t *pFirst, int32_t *pSecond, char *strPtr)
+{
+	size_t	 strLen1;
+	uint32_t magnitude;
+	bool	 negative;
+	bool	 bValid = false;
+
+	strLen1 = strcspn(strPtr, ",");
+
+	if (strLen1 != strlen(strPtr))
+	{
+		strPtr[strLen1] = '\0';
+		negative = (strPtr[strLen1 + 1] == '-');
+		bValid	 = convStringToUint(pFirst, strPtr) &&
+				   convStringToUint(&magnitude, &(strPtr[strLen1 + (negative ? 2 : 1)])) &&
+				   (magnitude <= (negative ? 0x80000000UL : 0x7FFFFFFFUL));
+		*pSecond = negative ? (int32_t)(0U - magnitude) : (int32_t)magnitude;
+		strPtr[strLen1] = ',';
+	}
+	return bValid;
+}
+
+/**
+ * <pre>
+ * eeLogQuery(..) handler, sends one log record to the terminal as:
+ * "t=<ms> type=<type> code=<code> value=<value>"
+ * </pre>
+ *
+ * @param pRecord	Record to send.
+ */
+static void cmdSendLogRecord(const eeLogRecord *pRecord)
+{
+	strcpy(respBuffer, "t=");
+	suU32ToString(pRecord->time, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " type=");
+	suU32ToString(pRecord->type, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " code=");
+	suU32ToString(pRecord->code, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " value=");
+	suU32ToString(pRecord->value, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	if (pRecord->type == EELOG_TYPE_TEMP_Q8)
+	{
+		strcat(respBuffer, " C=");
+		adcTempToString((int16_t)pRecord->value, ADCTEMP_MAX_DECIMALS, suStringToFill);
+		strcat(respBuffer, suStringToFill);
+	}
+	strcat(respBuffer, "\r\n");
+
+	UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next record.
+}
+
+/**
+ * <pre>
+ * eeCrcScan(..) handler, sends one bad page to the terminal as:
+ * "bad page=<page> expected=<crc> read=<crc>"
+ * </pre>
+ */
+static void cmdSendBadPage(uint16_t page, uint16_t expectedCrc, uint16_t actualCrc)
+{
+	strcpy(respBuffer, "bad page=");
+	suU32ToString(page, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " expected=0x");
+	suU32ToString(expectedCrc, suHEX, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " read=0x");
+	suU32ToString(actualCrc, suHEX, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, "\r\n");
+
+	UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next page.
+}
+
+/**
+ * <pre>
+ * Append " name=value" (decimal) to respBuffer.
+ * </pre>
+ */
+static void cmdAppendU32(char *name, uint32_t value)
+{
+	strcat(respBuffer, " ");
+	strcat(respBuffer, name);
+	strcat(respBuffer, "=");
+	suU32ToString(value, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+}
+
+/**
+ * <pre>
+ * i2cTraceQuery(..) handler, sends one I2C trace record to the terminal as:
+ * "seq=<n> dev=0x<addr> kind=<kind> mem=0x<addr> len=<n> us=<n> start=<cycles> acks=<n> result=0x<code>"
+ * kind is enumI2CTraceKind, + 128 for I2C1, result 0xFF is still running.
+ * </pre>
+ */
+static void cmdSendTraceRecord(uint32_t seq, const i2cTraceRecord *pRecord)
+{
+	strcpy(respBuffer, "seq=");
+	suU32ToString(seq, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " dev=0x");
+	suU32ToString(pRecord->devAddr7Bit, suHEX, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " kind=");
+	suU32ToString(pRecord->kind, suDECIMAL, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, " mem=0x");
+	suU32ToString(pRecord->memAddress, suHEX, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	cmdAppendU32("len", pRecord->length);
+	cmdAppendU32("us", i2cTraceCyclesToUs(pRecord->endCycles - pRecord->startCycles));
+	cmdAppendU32("start", pRecord->startCycles);
+	cmdAppendU32("acks", pRecord->ackPolls);
+	strcat(respBuffer, " result=0x");
+	suU32ToString(pRecord->result, suHEX, suStringToFill);
+	strcat(respBuffer, suStringToFill);
+	strcat(respBuffer, "\r\n");
+
+	UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next record.
+}
+
+/**
+ * <pre>
+ * i2cTraceQuery(..) handler for the binary dump, sends the record as is.
+ * </pre>
+ */
+static void cmdSendTraceBinary(uint32_t seq, const i2cTraceRecord *pRecord)
+{
+	UartPutBytes((const uint8_t *)pRecord, sizeof(i2cTraceRecord));
+}
+
+/**
+ * <pre>
+ * Send one line per device found by the last bus scan:
+ * "dev=0x<addr> us=<probe time> bytes=<AT24C size>", bytes only for a sized AT24C.
+ * </pre>
+ */
+static void cmdSendScanDevices(void)
+{
+	uint32_t addr;
+
+	for (addr = i2cScanState.firstAddr; addr <= i2cScanState.lastAddr; addr++)
+	{
+		if (!i2cScanFound((uint8_t)addr))
+		{
+			continue;
+		}
+		strcpy(respBuffer, "dev=0x");
+		suU32ToString(addr, suHEX, suStringToFill);
+		strcat(respBuffer, suStringToFill);
+		cmdAppendU32("us", i2cTraceCyclesToUs(i2cScanState.latencyCycles[addr]));
+		if ((addr >= I2CSCAN_AT24C_FIRST) && (addr <= I2CSCAN_AT24C_LAST) &&
+			(i2cScanState.at24cBytes[addr - I2CSCAN_AT24C_FIRST] != 0))
+		{
+			cmdAppendU32("bytes", i2cScanState.at24cBytes[addr - I2CSCAN_AT24C_FIRST]);
+		}
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next device.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per I2C bus instance, queued traffic since start:
+ * "I2C: bus=<n> xfers=.. errors=.. retries=.. dma=.. bytes=.. busyUs=.. maxQueued=..".
+ * </pre>
+ */
+static void cmdSendI2CBuses(void)
+{
+	uint32_t bus;
+
+	for (bus = 0; bus < I2CBUS_COUNT; bus++)
+	{
+		strcpy(respBuffer, "I2C:");
+		cmdAppendU32("bus", bus);
+		cmdAppendU32("xfers", i2cBusState[bus].xfers);
+		cmdAppendU32("errors", i2cBusState[bus].errors);
+		cmdAppendU32("retries", i2cBusState[bus].retries);
+		cmdAppendU32("dma", i2cBusState[bus].dmaXfers);
+		cmdAppendU32("bytes", i2cBusState[bus].bytes);
+		cmdAppendU32("busyUs", i2cTraceCyclesToUs(i2cBusState[bus].busyCycles));
+		cmdAppendU32("maxQueued", i2cBusState[bus].maxQueued);
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next bus.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per I2C device seen, (i2cTraceDevices), then one per retry class:
+ * "Dev: dev=0x<addr> bus=<n> xfers=.. nacks=.. arlo=.. berr=.. other=.. retries=.. hist=<b0>,<b1>,..",
+ * hist bucket n counts transactions under 128us << n, the last one the rest.
+ * "Retry: class=<n> max=.. backoffUs=.. retries=.. giveUps=..".
+ * </pre>
+ */
+static void cmdSendI2CDevices(void)
+{
+	uint32_t dev;
+	uint32_t bucket;
+
+	for (dev = 0; (dev < I2CTRACE_DEVICES) && (i2cTraceDevices[dev].devAddr7Bit != 0); dev++)
+	{
+		strcpy(respBuffer, "Dev: dev=0x");
+		suU32ToString(i2cTraceDevices[dev].devAddr7Bit, suHEX, suStringToFill);
+		strcat(respBuffer, suStringToFill);
+		cmdAppendU32("bus", i2cTraceDevices[dev].bus);
+		cmdAppendU32("xfers", i2cTraceDevices[dev].attempts);
+		cmdAppendU32("nacks", i2cTraceDevices[dev].nacks);
+		cmdAppendU32("arlo", i2cTraceDevices[dev].arlo);
+		cmdAppendU32("berr", i2cTraceDevices[dev].berr);
+		cmdAppendU32("other", i2cTraceDevices[dev].otherErrors);
+		cmdAppendU32("retries", i2cTraceDevices[dev].retries);
+		strcat(respBuffer, " hist=");
+		for (bucket = 0; bucket < I2CTRACE_HIST_BUCKETS; bucket++)
+		{
+			suU32ToString(i2cTraceDevices[dev].hist[bucket], suDECIMAL, suStringToFill);
+			strcat(respBuffer, suStringToFill);
+			strcat(respBuffer, (bucket < (I2CTRACE_HIST_BUCKETS - 1)) ? "," : "\r\n");
+		}
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next device.
+	}
+
+	for (dev = 0; dev < I2CRETRY_CLASSES; dev++)
+	{
+		strcpy(respBuffer, "Retry:");
+		cmdAppendU32("class", dev);
+		cmdAppendU32("max", i2cRetryPolicy[dev].maxRetries);
+		cmdAppendU32("backoffUs", i2cRetryPolicy[dev].backoffUs);
+		cmdAppendU32("retries", i2cRetryState.retries[dev]);
+		cmdAppendU32("giveUps", i2cRetryState.giveUps[dev]);
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next class.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per ADC channel sampled:
+ * "ch=<n> filt=<oversampled counts> latest=.. min=.. max=.. mean16=.. var16=.. n=<samples>",
+ * filt and latest are 15 bit, min and max 12 bit, mean and variance 1/16 counts.
+ * </pre>
+ */
+static void cmdSendADCChannels(void)
+{
+	adcSamplerStatsStruct stats;
+	uint8_t				  index;
+
+	for (index = 0; index < adcSamplerState.channelCount; index++)
+	{
+		strcpy(respBuffer, "ADC:");
+		cmdAppendU32("ch", adcSamplerState.channels[index].channel);
+		cmdAppendU32("filt", adcSamplerFiltered(index));
+		cmdAppendU32("latest", adcSamplerState.channels[index].latest);
+		if (adcSamplerStats(index, &stats))
+		{
+			cmdAppendU32("min", stats.min);
+			cmdAppendU32("max", stats.max);
+			cmdAppendU32("mean16", stats.meanQ4);
+			cmdAppendU32("var16", stats.varianceQ4);
+			cmdAppendU32("n", stats.samples);
+		}
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next channel.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per ADC alarm window:
+ * "Alarm: ch=<n> lo=<counts> hi=<counts> on=<in alarm> alarms=<n> awd=<1 if the analog watchdog has it>"
+ * </pre>
+ */
+static void cmdSendADCAlarms(void)
+{
+	uint8_t w;
+
+	for (w = 0; w < adcAlarmState.windowCount; w++)
+	{
+		strcpy(respBuffer, "Alarm:");
+		cmdAppendU32("ch", adcAlarmState.windows[w].channel);
+		cmdAppendU32("lo", adcAlarmState.windows[w].low);
+		cmdAppendU32("hi", adcAlarmState.windows[w].high);
+		cmdAppendU32("on", adcAlarmState.windows[w].inAlarm);
+		cmdAppendU32("alarms", adcAlarmState.windows[w].alarms);
+		cmdAppendU32("awd", (w == adcAlarmState.awdWindow));
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next window.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per main loop event, (mainEvent.h):
+ * "Event: n=<enumMainEvent> posted=<n> coalesced=<n> maxUs=<posted to handled>"
+ * </pre>
+ */
+static void cmdSendMainEvents(void)
+{
+	uint32_t event;
+
+	for (event = 0; event < MAINEVT_COUNT; event++)
+	{
+		strcpy(respBuffer, "Event:");
+		cmdAppendU32("n", event);
+		cmdAppendU32("posted", mainEventState.posted[event]);
+		cmdAppendU32("coalesced", mainEventState.coalesced[event]);
+		cmdAppendU32("maxUs", i2cTraceCyclesToUs(mainEventState.maxLatencyCycles[event]));
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next event.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per main loop task, (taskSched.h):
+ * "Task: <name> prio=<n> periodMs=<0 one shot> runs=<n> avgUs=.. maxUs=.. overruns=<over budgetUs> misses=<late past deadlineMs> maxLateMs=.."
+ * </pre>
+ */
+static void cmdSendTasks(void)
+{
+	const taskSchedTaskStruct *pTask;
+	uint8_t					   id;
+
+	for (id = 0; id < taskSchedState.count; id++)
+	{
+		pTask = &taskSchedState.tasks[id];
+		strcpy(respBuffer, "Task: ");
+		strcat(respBuffer, pTask->name);
+		cmdAppendU32("prio", pTask->priority);
+		cmdAppendU32("periodMs", pTask->timed ? pTask->periodMs : 0);
+		cmdAppendU32("runs", pTask->runs);
+		cmdAppendU32("avgUs", (pTask->runs == 0) ? 0 : i2cTraceCyclesToUs((uint32_t)(pTask->totalCycles / pTask->runs)));
+		cmdAppendU32("maxUs", i2cTraceCyclesToUs(pTask->maxCycles));
+		cmdAppendU32("budgetUs", pTask->budgetUs);
+		cmdAppendU32("overruns", pTask->overruns);
+		cmdAppendU32("misses", pTask->misses);
+		cmdAppendU32("maxLateMs", pTask->maxLateMs);
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next task.
+	}
+}
+
+/**
+ * <pre>
+ * Send one line per instrumented interrupt, (irqPriority.h):
+ * "IRQ: <name> prio=<n> n=<count> maxRun=<cycles> bound=<worst entry latency, cycles>"
+ * </pre>
+ */
+static void cmdSendIrqs(void)
+{
+	uint32_t irq;
+
+	for (irq = 0; irq < IRQSTAT_COUNT; irq++)
+	{
+		strcpy(respBuffer, "IRQ: ");
+		strcat(respBuffer, irqPriorityName((enumIrqStat)irq));
+		cmdAppendU32("prio", irqPriorityOf((enumIrqStat)irq));
+		cmdAppendU32("n", irqPriorityState.count[irq]);
+		cmdAppendU32("maxRun", irqPriorityState.maxRunCycles[irq]);
+		cmdAppendU32("bound", irqPriorityBoundCycles((enumIrqStat)irq));
+		strcat(respBuffer, "\r\n");
+
+		UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for next interrupt.
+	}
+}
+
+/**
+ * <pre>
+ * adcAlarmService(..) handler, sends one alarm event, unsolicited, as:
+ * "ALARM: ch=<n> high|low|clear value=<raw counts> t=<tick ms>"
+ * </pre>
+ */
+static void cmdSendAlarm(const adcAlarmEvent *pEvent)
+{
+	strcpy(respBuffer, "ALARM:");
+	cmdAppendU32("ch", pEvent->channel);
+	strcat(respBuffer, (pEvent->kind == ADCALARM_HIGH) ? " high" : ((pEvent->kind == ADCALARM_LOW) ? " low" : " clear"));
+	cmdAppendU32("value", pEvent->value);
+	cmdAppendU32("t", pEvent->tick);
+	strcat(respBuffer, "\r\n");
+
+	UartPutString(respBuffer, true);		// Blocking, respBuffer is reused for next event.
+}
+
+/**
+ * <pre>
+ * Log and send the ADC alarm events queued since the last call, call from the main loop.
+ * </pre>
+ */
+void cmdAlarmService(void)
+{
+	adcAlarmService(cmdSendAlarm);
+}
+
+/**
+ * <pre>
+ * Resend the status asked for by SS[x] every CMD_STREAM_MS, call from the main loop.
+ * </pre>
+ */
+void cmdStreamService(void)
+{
+	char	 cmdStr[16];
+	uint32_t index = streamIndex;
+
+	if ((index == 0) || ((HAL_GetTick() - streamLastTick) < CMD_STREAM_MS))
+	{
+		return;
+	}
+	streamLastTick = HAL_GetTick();
+
+	strcpy(cmdStr, "S[");
+	suU32ToString(index, suDECIMAL, suStringToFill);
+	strcat(cmdStr, suStringToFill);
+	strcat(cmdStr, "]");
+	cmdHandler(cmdStr);
+	streamIndex = index;	// cmdHandler(..) stops streaming, as any command does.
+}
+
+// The received bytes are picked up by ISR, and handled by the callback
+// routine "HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)", in uart_jmk.c
+// This routine will flag "Transfer_cplt" which occurs every time terminal
+// sends a CR 0x0D charactor.
+
+/**
+ * <pre>
+ * Interpret and execute the latest command string, from the input terminal.
+ * This will also send back the appropriate response for the particular
+ * command.
+ * </pre>
+ *
+ * @param cmdStr		Command string to parse, interpret, execute.
+ *
+ */
+
+void cmdHandler(char * cmdStr)
+{
+	bool	isU8Index;
+	bool	isU32Index;
+	bool	isInputDataStr;
+	bool	isUintData;
+
+	unsigned int strLength;
+	unsigned int cmdLength;
+
+	uint32_t 	uIntData;
+	uint32_t	index,i;
+	uint32_t	third;
+	int32_t		signedData;
+	int16_t		tempQ8;
+
+	char * dataStrPtr;
+
+    char letter1;
+    char cmdToken[] = "12345";
+
+    cmdResponse = eOK;
+
+    // Any command stops SS[x] streaming.
+    streamIndex = 0;
+
+	strLength = strlen(cmdStr);
+
+	/**
+	 * <b>Flow of Control - </b> <br>
+	 * */
+	///
+	/// <pre>Get numerical index in command string "cmd[index]", if it exists:
+	/// Typically the index is expected to be < 256. </pre>
+
+	isU32Index = getU32Index(&index, cmdStr);
+	isU8Index  = ((index <= 255) && (isU32Index == true));
+
+
+
+	/// <pre>Get the length of cmdToken "cmd" - max 5 chars.., min 0 chars.
+	/// <em>Note: If "[" is not seen then cmdLength will be same as command string
+	/// If length of cmdToken is > 5 we look at only first 5 chars, max.</em> </pre>
+	cmdLength = strcspn(cmdStr, "[");
+
+	if (cmdLength > 5) cmdLength = 5;
+	if (cmdLength)
+	{
+		for (i=0; i<cmdLength; i++)
+		{
+			cmdToken[i] = toupper(cmdStr[i]); // make all upper case..
+		}
+		// Add in the null char to end the string..
+		cmdToken[i] = '\0';
+	}
+
+	letter1 = cmdToken[0];
+
+	//-----------------------------------------------------------
+
+	/// <pre>Get Str pointer for input data after single equals sign, if it exists.
+	/// <em> Example: for d[xxx]=yyyy, we provide input data "yyyy" </em> </pre>
+	isInputDataStr = getDataInputString(&dataStrPtr, cmdStr);
+
+
+	// See if this data qualifies for unsigned integer data (32 bit unsigned)
+	/// If input data exists, then attempt to convert it to numeric.
+	if (isInputDataStr)
+	{
+		isUintData = convStringToUint(&uIntData, dataStrPtr);
+	}
+
+
+	/// <pre>cmdToken is first 5 chars of command string, at most.
+	/// i.e. chars that come before the [xx], if index exists.</pre>
+
+	// Assume default..
+	cmdResponse = eUnknownCmd;
+
+	/// <pre>Look at first char of cmdToken
+	/// For valid first char, parse out the command and what to do with it. <br></pre>
+	/**
+	 * <b> Flow of Control - Parse Cases:</b> <br>
+	 */
+	switch (letter1)
+	{
+		/// 'C[xx]' indicates a command "xx".
+		case 'C':
+			if (cmdLength == 1)
+			{
+				cmdResponse = eIndexError; // assume worst, hope  best:
+				if ( isU8Index  )
+				{
+					cmdResponse = eNoFurtherComment;
+
+					switch (index)
+					{
+					case cmdEELogFlush:
+						strcpy(respBuffer, eeLogFlush() ? "Log flushed.\r\n" : "Log flush failed !\r\n");
+						break;
+
+					case cmdEELogQuery:
+						// C[0x11]=start,end with log times in ms, or C[0x11] for all records.
+						if (isInputDataStr)
+						{
+							if (getTwoU32Data(&uIntData, &i, dataStrPtr) == false)
+							{
+								cmdResponse = eUintExpected;
+								break;
+							}
+						}
+						else
+						{
+							uIntData = 0;
+							i = 0xFFFFFFFF;
+						}
+						uIntData = eeLogQuery(uIntData, i, cmdSendLogRecord);
+						strcpy(respBuffer, "Log records:");
+						cmdAppendU32("count", uIntData);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdEEFill0:
+					case cmdEEErase:
+					case cmdEEFillIndex:
+					case cmdEEFillRevIndex:
+						// C[0x12..0x15]=start,length or whole device.  Pattern follows
+						// enumArrayFillType order, always verified.  Progress via S[0x11].
+						if (isInputDataStr)
+						{
+							if (getTwoU32Data(&uIntData, &i, dataStrPtr) == false)
+							{
+								cmdResponse = eUintExpected;
+								break;
+							}
+						}
+						else
+						{
+							uIntData = 0;
+							i = AT24C_DEVICE_BYTES;
+						}
+						if (eeFillStart(EELOG_I2C_HANDLE, EELOG_DEV_ADDR, uIntData, i,
+										(enumArrayFillType)(index - cmdEEFill0), true))
+						{
+							strcpy(respBuffer, "Fill started:");
+							cmdAppendU32("chunks", eeFillState.chunksTotal);
+							strcat(respBuffer, "\r\n");
+						}
+						else
+						{
+							strcpy(respBuffer, eeFillBusy() ? "Fill already running !\r\n" : "Fill not started !\r\n");
+						}
+						break;
+
+					case cmdEECrcScan:
+					case cmdEECrcCheck:
+						// Blocking, a full scan is ~0.8s at 400KHz.
+						eeCrcScan((index == cmdEECrcCheck), cmdSendBadPage);
+						strcpy(respBuffer, "CRC scan:");
+						cmdAppendU32("pages", eeCrcState.lastScanPages);
+						cmdAppendU32("bad", eeCrcState.lastScanBad);
+						cmdAppendU32("learned", eeCrcState.lastScanLearned);
+						cmdAppendU32("ms", eeCrcState.lastScanMs);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdEECrcRelearn:
+						strcpy(respBuffer, "CRC relearned:");
+						cmdAppendU32("pages", eeCrcRelearn());
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdI2CTraceText:
+						uIntData = i2cTraceQuery(cmdSendTraceRecord, I2CTRACE_RECORDS);
+						strcpy(respBuffer, "I2C trace:");
+						cmdAppendU32("count", uIntData);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdI2CTraceBinary:
+						{
+							// Header count is what is held now, send exactly that many records.
+							i2cTraceDumpHeader header;
+
+							i2cTraceHeader(&header);
+							UartPutBytes((const uint8_t *)&header, sizeof(header));
+							uIntData = i2cTraceQuery(cmdSendTraceBinary, header.count);
+						}
+						strcpy(respBuffer, "\r\nI2C trace:");
+						cmdAppendU32("count", uIntData);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdI2CTraceClear:
+						i2cTraceClear();
+						strcpy(respBuffer, "I2C trace cleared.\r\n");
+						break;
+
+					case cmdI2CSlaveStart:
+						// Master use of I2C2, (log, CRC), gets HAL_BUSY until C[0x1D].
+						if (isInputDataStr && !isUintData)
+						{
+							cmdResponse = eUintExpected;
+							break;
+						}
+						if (!i2cSlaveEEStart(&hi2c2, I2CSLAVEEE_DEFAULT_ADDR, i2cSlaveEEMem, I2CSLAVEEE_DEFAULT_SIZE))
+						{
+							strcpy(respBuffer, "Slave not started !\r\n");
+						}
+						else if (isInputDataStr && !i2cSlaveEELoad(EELOG_I2C_HANDLE, EELOG_DEV_ADDR, (uint16_t)uIntData))
+						{
+							strcpy(respBuffer, "Slave started, RAM only, eeprom load failed !\r\n");
+						}
+						else
+						{
+							strcpy(respBuffer, "Slave started:");
+							cmdAppendU32("addr", I2CSLAVEEE_DEFAULT_ADDR);
+							cmdAppendU32("size", I2CSLAVEEE_DEFAULT_SIZE);
+							strcat(respBuffer, "\r\n");
+						}
+						break;
+
+					case cmdI2CSlaveStop:
+						i2cSlaveEEStop();
+						strcpy(respBuffer, "Slave stopped:");
+						cmdAppendU32("flushed", i2cSlaveEEState.blocksFlushed);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdI2CScan:
+						// C[0x1E]=first,last 7 bit addresses, or C[0x1E] for all but the reserved ones.
+						if (isInputDataStr)
+						{
+							if ((getTwoU32Data(&uIntData, &i, dataStrPtr) == false) || (uIntData > i) ||
+								(i >= I2CSCAN_ADDRESSES))
+							{
+								cmdResponse = eUintExpected;
+								break;
+							}
+						}
+						else
+						{
+							uIntData = I2CSCAN_FIRST_ADDR;
+							i = I2CSCAN_LAST_ADDR;
+						}
+						if ((sEEPromWaitForReady(&hi2c2) != HAL_OK) ||
+							((i2cScanRun(&hi2c2, (uint8_t)uIntData, (uint8_t)i, true) == 0) &&
+							 (i2cScanState.state != I2CSCAN_DONE)))
+						{
+							strcpy(respBuffer, "Scan failed !\r\n");
+							break;
+						}
+						cmdSendScanDevices();
+						strcpy(respBuffer, "Scan:");
+						cmdAppendU32("found", i2cScanState.foundCount);
+						cmdAppendU32("us", i2cTraceCyclesToUs(i2cScanState.endCycles - i2cScanState.startCycles));
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdEECopyToAux:
+						// C[0x1F]=start,length or whole device, same range on both parts.
+						// Reads on I2C2 overlap writes on I2C1, progress via S[0x16].
+						if (isInputDataStr)
+						{
+							if (getTwoU32Data(&uIntData, &i, dataStrPtr) == false)
+							{
+								cmdResponse = eUintExpected;
+								break;
+							}
+						}
+						else
+						{
+							uIntData = 0;
+							i = AT24C_DEVICE_BYTES;
+						}
+						if (eeCopyStart(I2CBUS_EE, EELOG_DEV_ADDR, uIntData, I2CBUS_AUX, A0A1_00, uIntData, i))
+						{
+							strcpy(respBuffer, "Copy started:");
+							cmdAppendU32("bytes", i);
+							strcat(respBuffer, "\r\n");
+						}
+						else
+						{
+							strcpy(respBuffer, eeCopyBusy() ? "Copy already running !\r\n" : "Copy not started !\r\n");
+						}
+						break;
+
+					case cmdADCChannels:
+						// C[0x22]=mask, restarts sampling, values and statistics start again.
+						if (!isInputDataStr || !isUintData ||
+							!adcSamplerStart(adcSamplerState.hadc, adcSamplerState.htim, uIntData))
+						{
+							strcpy(respBuffer, "ADC channels not set, 1..4 of channels 0..17 !\r\n");
+							break;
+						}
+						strcpy(respBuffer, "ADC:");
+						cmdAppendU32("channels", adcSamplerState.channelCount);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdADCStatsClear:
+						adcSamplerStatsClear();
+						strcpy(respBuffer, "ADC statistics cleared\r\n");
+						break;
+
+					case cmdADCFilter:
+						// C[0x24]=type,n, type 0 off, 1 average of 2^n, (n 0..6), 2 FIR, 3 biquad of n stages, (1..2).
+						if (!isInputDataStr || (getTwoU32Data(&uIntData, &i, dataStrPtr) == false) ||
+							(uIntData > ADCFILTER_BIQUAD) || (i > 0xFF) ||
+							!adcFilterConfigure((enumAdcFilterType)uIntData, (uint8_t)i))
+						{
+							strcpy(respBuffer, "ADC filter not set, type 0..3, average n 0..6, biquad n 1..2 !\r\n");
+							break;
+						}
+						strcpy(respBuffer, "ADC filter:");
+						cmdAppendU32("type", adcFilterState.type);
+						cmdAppendU32("n", adcFilterState.param);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdADCAlarmSet:
+						// C[0x25]=ch,lo,hi, raw 12 bit counts, in window if lo <= reading <= hi.
+						if (!isInputDataStr || !getThreeU32Data(&uIntData, &i, &third, dataStrPtr) ||
+							(uIntData > 0xFF) || (i > 0xFFFF) || (third > 0xFFFF) ||
+							!adcAlarmSet((uint8_t)uIntData, (uint16_t)i, (uint16_t)third))
+						{
+							strcpy(respBuffer, "ADC alarm not set, ch 0..17, lo + 16 < hi <= 4095, 4 windows !\r\n");
+							break;
+						}
+						strcpy(respBuffer, "ADC alarm:");
+						cmdAppendU32("windows", adcAlarmState.windowCount);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdADCAlarmRemove:
+						if (!isInputDataStr || !isUintData || (uIntData > 0xFF) || !adcAlarmRemove((uint8_t)uIntData))
+						{
+							strcpy(respBuffer, "No ADC alarm on that channel !\r\n");
+							break;
+						}
+						strcpy(respBuffer, "ADC alarm removed\r\n");
+						break;
+
+					case cmdADCAlarmOutputs:
+						// C[0x27]=log,notify
+						if (!isInputDataStr || (getTwoU32Data(&uIntData, &i, dataStrPtr) == false))
+						{
+							cmdResponse = eUintExpected;
+							break;
+						}
+						adcAlarmState.logToEEProm = (uIntData != 0);
+						adcAlarmState.notify	  = (i != 0);
+						strcpy(respBuffer, "ADC alarm:");
+						cmdAppendU32("log", adcAlarmState.logToEEProm);
+						cmdAppendU32("notify", adcAlarmState.notify);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdTempCalibrate:
+						// C[0x28]=point,centiC, point 1 or 2 at centiC / 100 degrees, 0 back to the data sheet line.
+						if (!isInputDataStr || !getU32IntData(&uIntData, &signedData, dataStrPtr) || (uIntData > 2) ||
+							!adcTempCalPoint((uint8_t)uIntData, signedData))
+						{
+							strcpy(respBuffer, "Temperature point not taken, 1,2 -4000..12500 apart 5C, sensor sampled, eeprom !\r\n");
+							break;
+						}
+						strcpy(respBuffer, "Temp:");
+						cmdAppendU32("taken", adcTempState.pointsTaken);
+						cmdAppendU32("points", adcTempState.cal.points);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdTaskStatsClear:
+						taskSchedClearStats();
+						strcpy(respBuffer, "Task statistics cleared\r\n");
+						break;
+
+					case cmdIrqStatsClear:
+						irqPriorityClear();
+						strcpy(respBuffer, "Interrupt statistics cleared\r\n");
+						break;
+
+					case cmdClockProfile:
+						// C[0x2B]=profile, the response goes out at the new clock, same baud.
+						if (!isInputDataStr || !isUintData || (uIntData >= CLOCKPROFILE_COUNT) ||
+							!clockProfileSet((enumClockProfile)uIntData))
+						{
+							strcpy(respBuffer, "Clock not changed, 0..2, I2C idle, HSE fitted !\r\n");
+							break;
+						}
+						strcpy(respBuffer, "Clock: ");
+						strcat(respBuffer, clockProfileName(clockProfileState.profile));
+						cmdAppendU32("sysclk", HAL_RCC_GetSysClockFreq());
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdIdleTickless:
+						// C[0x2C]=1 tickless, 0 the SysTick ms wakes the core as before.
+						if (!isInputDataStr || !isUintData || (uIntData > 1))
+						{
+							cmdResponse = eUintExpected;
+							break;
+						}
+						idleSleepInit(uIntData == 1);
+						strcpy(respBuffer, "Idle:");
+						cmdAppendU32("tickless", idleSleepState.enabled);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case cmdI2CRetryCount:
+					case cmdI2CRetryBackoff:
+						// C[0x20]=class,retries  C[0x21]=class,us, class 0 NACK, 1 ARLO, 2 BERR.
+						if (!isInputDataStr || (getTwoU32Data(&uIntData, &i, dataStrPtr) == false) ||
+							(uIntData >= I2CRETRY_CLASSES) || (i > 0xFFFF))
+						{
+							cmdResponse = eUintExpected;
+							break;
+						}
+						if (index == cmdI2CRetryCount)
+						{
+							i2cRetryPolicy[uIntData].maxRetries = (uint16_t)i;
+						}
+						else
+						{
+							i2cRetryPolicy[uIntData].backoffUs = (uint16_t)i;
+							if (i2cRetryPolicy[uIntData].maxBackoffUs < i)
+							{
+								i2cRetryPolicy[uIntData].maxBackoffUs = (uint16_t)i;
+							}
+						}
+						strcpy(respBuffer, "Retry:");
+						cmdAppendU32("class", uIntData);
+						cmdAppendU32("max", i2cRetryPolicy[uIntData].maxRetries);
+						cmdAppendU32("backoffUs", i2cRetryPolicy[uIntData].backoffUs);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					default:
+						// with no data to be input (written)
+						// Read out the current data
+
+						// ### Previously used sprintf to convert u32 to decimal value text
+						// sprintf(respBuffer, "Received C[%u]\r\n", (unsigned int)index);
+
+						// Now convert u32 to string and build up a total string as response:
+						suU32ToString( index, suDECIMAL, suStringToFill );
+						strcpy(respBuffer, "Command requested: C[");
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "]\r\n");
+						break;
+					}
+					//cmdResponse = eGotC;
+				}
+				else if (isU32Index)
+				{
+					cmdResponse = eIndexRangeExceeded;
+				}
+
+			}
+			break;
+
+		/// 'D[xx]' indicates a data set read/write.
+		case 'D':
+			if (cmdLength == 1)
+			{
+				cmdResponse = eIndexError;
+				if ( isU8Index )
+				{
+					// with no data to be input (written)
+					// Read out the current data
+					//sprintf(respBuffer, "Received D[%u]\r\n", (unsigned int)index);
+
+					// Now convert u32 to string and build up a total string as response:
+					suU32ToString( index, suDECIMAL, suStringToFill );
+					strcpy(respBuffer, "Data set requested: D[");
+					strcat(respBuffer,suStringToFill);
+					strcat(respBuffer, "]\r\n");
+
+					cmdResponse = eNoFurtherComment;
+					//cmdResponse = eGotD;
+				}
+				else if (isU32Index)
+				{
+					cmdResponse = eIndexRangeExceeded;
+				}
+
+			}
+			break;
+
+		/// 'H[xx]' indicates help page request. <br>
+		/// 'H' by itself indicates, system halt/restart request.
+		case 'H':	// "help" or "halt" ?
+			if (strLength == 1)
+			{
+				// Halt command !
+				strcpy(respBuffer, "System Halted !\r\n");
+				cmdResponse = eNoFurtherComment;
+			}
+			else if (cmdLength == 1)
+			{
+				cmdResponse = eIndexError; // assume worst, hope  best:
+				if ( isU8Index  )
+				{
+					//
+					if (index == 1)
+					{
+					  // This is h[1] , our very first help page !
+					  strcpy(respBuffer,help_1_str);
+					}
+					else
+					{
+						// with no data to be input (written)
+						// Read out the current data
+						//sprintf(respBuffer, "Received H[%u]\r\n", (unsigned int)index);
+						// Now convert u32 to string and build up a total string as response:
+						suU32ToString( index, suDECIMAL, suStringToFill );
+						strcpy(respBuffer, "Help page requested: H[");
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "]");
+						strcat(respBuffer, " - does not exist !\r\n");
+					}
+
+					cmdResponse = eNoFurtherComment;
+					//cmdResponse = eGotH;
+				}
+				else if (isU32Index)
+				{
+					cmdResponse = eIndexRangeExceeded;
+				}
+			}
+			break;
+
+		/// 'S[xx]' indicates status of type "xx" request.
+		case 'S':	// "Status", "Streaming Status" ?
+			if (cmdLength == 1)
+			{	// Must be the S command.
+				cmdResponse = eIndexError; // assume worst, hope  best:
+				if ( isU8Index  )
+				{
+					// with no data to be input (written)
+					// Read out the current data
+					switch (index)
+					{
+					case statEELog:
+						strcpy(respBuffer, "Log:");
+						cmdAppendU32("mounted", eeLogState.mounted);
+						cmdAppendU32("head", eeLogState.headPage);
+						cmdAppendU32("tail", eeLogState.tailPage);
+						cmdAppendU32("pages", eeLogState.pageCount);
+						cmdAppendU32("seq", eeLogState.nextSeq);
+						cmdAppendU32("pending", eeLogPendingRecords());
+						cmdAppendU32("errors", eeLogState.commitErrors);
+						cmdAppendU32("now", eeLogNow());
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statEEFill:
+						strcpy(respBuffer, "Fill:");
+						cmdAppendU32("state", eeFillState.state);
+						cmdAppendU32("percent", eeFillPercentDone());
+						cmdAppendU32("done", eeFillState.chunksDone);
+						cmdAppendU32("of", eeFillState.chunksTotal);
+						cmdAppendU32("acks", eeFillState.ackPolls);
+						cmdAppendU32("bad", eeFillState.verifyErrors);
+						cmdAppendU32("firstBad", eeFillState.firstBadAddr);
+						cmdAppendU32("error", eeFillState.errorCode);
+						cmdAppendU32("ms", eeFillElapsedMs());
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statEECrc:
+						strcpy(respBuffer, "CRC:");
+						cmdAppendU32("changed", eeCrcChangedPages());
+						cmdAppendU32("unknown", eeCrcUnknownPages());
+						cmdAppendU32("lastPages", eeCrcState.lastScanPages);
+						cmdAppendU32("lastBad", eeCrcState.lastScanBad);
+						cmdAppendU32("lastMs", eeCrcState.lastScanMs);
+						cmdAppendU32("readErrors", eeCrcState.readErrors);
+						cmdAppendU32("tableSaves", eeCrcState.tablePagesSaved);
+						cmdAppendU32("tableSaveErrors", eeCrcState.tableSaveErrors);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statI2CTrace:
+						strcpy(respBuffer, "I2C trace:");
+						cmdAppendU32("transactions", i2cTraceState.transactions);
+						cmdAppendU32("errors", i2cTraceState.errors);
+						cmdAppendU32("held", i2cTraceCount());
+						cmdAppendU32("maxUs", i2cTraceCyclesToUs(i2cTraceState.maxCycles));
+						cmdAppendU32("maxDev", i2cTraceState.maxDevAddr7Bit);
+						cmdAppendU32("maxKind", i2cTraceState.maxKind);
+						cmdAppendU32("maxMem", i2cTraceState.maxMemAddress);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statI2CSlave:
+						strcpy(respBuffer, "Slave:");
+						cmdAppendU32("on", i2cSlaveEEState.listening);
+						cmdAppendU32("address", i2cSlaveEEState.address);
+						cmdAppendU32("writes", i2cSlaveEEState.writes);
+						cmdAppendU32("reads", i2cSlaveEEState.reads);
+						cmdAppendU32("rx", i2cSlaveEEState.bytesRx);
+						cmdAppendU32("tx", i2cSlaveEEState.bytesTx);
+						cmdAppendU32("errors", i2cSlaveEEState.errors);
+						cmdAppendU32("maxIsrUs", i2cTraceCyclesToUs(i2cSlaveEEState.maxIsrCycles));
+						cmdAppendU32("dirty", i2cSlaveEEState.dirtyBlocks);
+						cmdAppendU32("flushed", i2cSlaveEEState.blocksFlushed);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statI2CScan:
+						cmdSendScanDevices();
+						strcpy(respBuffer, "Scan:");
+						cmdAppendU32("state", i2cScanState.state);
+						cmdAppendU32("first", i2cScanState.firstAddr);
+						cmdAppendU32("last", i2cScanState.lastAddr);
+						cmdAppendU32("found", i2cScanState.foundCount);
+						cmdAppendU32("us", i2cTraceCyclesToUs(i2cScanState.endCycles - i2cScanState.startCycles));
+						cmdAppendU32("error", i2cScanState.errorCode);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statI2CBus:
+						cmdSendI2CBuses();
+						strcpy(respBuffer, "Copy:");
+						cmdAppendU32("state", eeCopyState.state);
+						cmdAppendU32("copied", eeCopyState.bytesCopied);
+						cmdAppendU32("of", eeCopyState.length);
+						cmdAppendU32("ms", eeCopyElapsedMs());
+						cmdAppendU32("error", eeCopyState.errorCode);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statI2CDevices:
+						cmdSendI2CDevices();
+						strcpy(respBuffer, "Retry:");
+						cmdAppendU32("notRetried", i2cRetryState.notRetried);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statADC:
+						cmdSendADCChannels();
+						strcpy(respBuffer, "ADC:");
+						cmdAppendU32("on", adcSamplerState.running);
+						cmdAppendU32("mask", adcSamplerState.channelMask);
+						cmdAppendU32("bits", 12 + ADCSAMPLER_EXTRA_BITS);
+						cmdAppendU32("blocks", adcSamplerState.blocks);
+						cmdAppendU32("missed", adcSamplerState.missed);
+						cmdAppendU32("maxIsrUs", i2cTraceCyclesToUs(adcSamplerState.maxIsrCycles));
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statADCAlarm:
+						cmdSendADCAlarms();
+						strcpy(respBuffer, "Alarm:");
+						cmdAppendU32("awdIrqs", adcAlarmState.awdIrqs);
+						cmdAppendU32("queued", (adcAlarmState.head - adcAlarmState.tail + ADCALARM_QUEUE) % ADCALARM_QUEUE);
+						cmdAppendU32("overflows", adcAlarmState.overflows);
+						cmdAppendU32("maxDelayMs", adcAlarmState.maxDelayMs);
+						cmdAppendU32("log", adcAlarmState.logToEEProm);
+						cmdAppendU32("notify", adcAlarmState.notify);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statMainLoop:
+						cmdSendMainEvents();
+						strcpy(respBuffer, "Defer:");
+						cmdAppendU32("posted", pendWorkState.posted);
+						cmdAppendU32("ran", pendWorkState.ran);
+						cmdAppendU32("overflows", pendWorkState.overflows);
+						cmdAppendU32("maxDepth", pendWorkState.maxDepth);
+						cmdAppendU32("maxUs", i2cTraceCyclesToUs(pendWorkState.maxRunCycles));
+						strcat(respBuffer, "\r\n");
+						UartPutString(respBuffer, true);	// Blocking, respBuffer is reused for the loop line.
+						strcpy(respBuffer, "Loop:");
+						cmdAppendU32("sleeps", mainEventState.sleeps);
+						cmdAppendU32("nextDueMs", taskSchedState.armed ? (taskSchedState.nextDueMs - HAL_GetTick()) : 0);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statIrq:
+						// A received byte is read by the end of the USART1 handler at worst
+						// bound + maxRun after it is in, it must be before the next one is.
+						cmdSendIrqs();
+						strcpy(respBuffer, "UART:");
+						cmdAppendU32("byte", UartByteCycles());
+						cmdAppendU32("worst", irqPriorityBoundCycles(IRQSTAT_USART1) +
+											  irqPriorityState.maxRunCycles[IRQSTAT_USART1]);
+						cmdAppendU32("ok", (irqPriorityBoundCycles(IRQSTAT_USART1) +
+											irqPriorityState.maxRunCycles[IRQSTAT_USART1]) < UartByteCycles());
+						cmdAppendU32("overruns", Rx_overruns);
+						cmdAppendU32("errors", Rx_errors);
+						cmdAppendU32("tickEntry", irqPriorityState.maxTickEntryCycles);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statClock:
+						strcpy(respBuffer, "Clock: ");
+						strcat(respBuffer, clockProfileName(clockProfileState.profile));
+						cmdAppendU32("sysclk", HAL_RCC_GetSysClockFreq());
+						cmdAppendU32("pclk1", HAL_RCC_GetPCLK1Freq());
+						cmdAppendU32("pclk2", HAL_RCC_GetPCLK2Freq());
+						cmdAppendU32("adc", clockProfileState.adcHz);
+						cmdAppendU32("baud", UartBaud());
+						cmdAppendU32("switches", clockProfileState.switches);
+						cmdAppendU32("refused", clockProfileState.refused);
+						cmdAppendU32("hseFailures", clockProfileState.hseFailures);
+						cmdAppendU32("maxSwitchMs", clockProfileState.maxSwitchMs);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statIdle:
+						// Time asleep tickless, per mille of the time since the stats started.
+						strcpy(respBuffer, "Idle:");
+						cmdAppendU32("tickless", idleSleepState.enabled);
+						cmdAppendU32("sleeps", mainEventState.sleeps);
+						cmdAppendU32("ticklessSleeps", idleSleepState.tickless);
+						cmdAppendU32("tickKept", idleSleepState.tickKept);
+						cmdAppendU32("early", idleSleepState.early);
+						cmdAppendU32("ticksSkipped", idleSleepState.ticksSkipped);
+						cmdAppendU32("maxSleepMs", idleSleepState.maxSleepMs);
+						cmdAppendU32("asleepPermille", (HAL_GetTick() == idleSleepState.sinceTick) ? 0 :
+									 (uint32_t)(idleSleepState.sleptUs / (HAL_GetTick() - idleSleepState.sinceTick)));
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statTasks:
+						cmdSendTasks();
+						strcpy(respBuffer, "Tasks:");
+						cmdAppendU32("count", taskSchedState.count);
+						cmdAppendU32("passes", taskSchedState.passes);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statTemp:
+						strcpy(respBuffer, "Temp: C=");
+						if (adcTempRead(&tempQ8))
+						{
+							adcTempToString(tempQ8, ADCTEMP_MAX_DECIMALS, suStringToFill);
+							strcat(respBuffer, suStringToFill);
+						}
+						else
+						{
+							strcat(respBuffer, "none");
+						}
+						cmdAppendU32("refCounts", adcTempState.cal.refCounts);
+						strcat(respBuffer, " refC=");
+						adcTempToString(adcTempState.cal.refTempQ8, ADCTEMP_MAX_DECIMALS, suStringToFill);
+						strcat(respBuffer, suStringToFill);
+						strcat(respBuffer, " gainQ16=-");
+						suU32ToString((uint32_t)(-adcTempState.cal.gainQ16), suDECIMAL, suStringToFill);
+						strcat(respBuffer, suStringToFill);
+						cmdAppendU32("points", adcTempState.cal.points);
+						cmdAppendU32("eeprom", adcTempState.loaded);
+						cmdAppendU32("taken", adcTempState.pointsTaken);
+						cmdAppendU32("saveErrors", adcTempState.saveErrors);
+						strcat(respBuffer, "\r\n");
+						break;
+
+					case statADCFilter:
+						strcpy(respBuffer, "DSP:");
+						cmdAppendU32("type", adcFilterState.type);
+						cmdAppendU32("n", adcFilterState.param);
+						cmdAppendU32("blocks", adcFilterState.blocks);
+						cmdAppendU32("dropped", adcFilterState.dropped);
+						cmdAppendU32("late", adcFilterState.late);
+						cmdAppendU32("cycles", adcFilterState.lastCycles);
+						cmdAppendU32("maxCycles", adcFilterState.maxCycles);
+						cmdAppendU32("maxUs", i2cTraceCyclesToUs(adcFilterState.maxCycles));
+						strcat(respBuffer, " out=");
+						for (i = 0; i < adcSamplerState.channelCount; i++)
+						{
+							suU32ToString(adcFilterValue((uint8_t)i), suDECIMAL, suStringToFill);
+							strcat(respBuffer, suStringToFill);
+							strcat(respBuffer, (i < (adcSamplerState.channelCount - 1U)) ? "," : "");
+						}
+						strcat(respBuffer, "\r\n");
+						break;
+
+					default:
+						//sprintf(respBuffer, "Received status request: S[%u]\r\n", (unsigned int)index);
+						// Now convert u32 to string and build up a total string as response:
+						suU32ToString( index, suDECIMAL, suStringToFill );
+						strcpy(respBuffer, "Status requested: S[");
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "]\r\n");
+						break;
+					}
+					cmdResponse = eNoFurtherComment;
+
+				}
+				else if (isU32Index)
+				{
+					cmdResponse = eIndexRangeExceeded;
+				}
+			}
+			/// 'SS[xx]' indicates  streaming (repeating) status of type "xx" request.
+			else if (strcmp(cmdToken, "SS") == strEQUALITY)
+			{
+				cmdResponse = eIndexError; // assume worst, hope  best:
+				if ( isU8Index  )
+				{
+					// with no data to be input (written)
+					// Read out the current data
+					//sprintf(respBuffer, "Received streaming status request: SS[%u]\r\n", (unsigned int)index);
+					// Now convert u32 to string and build up a total string as response:
+					// S[x] is sent from cmdStreamService(..) every CMD_STREAM_MS, until the next command.
+					suU32ToString( index, suDECIMAL, suStringToFill );
+					strcpy(respBuffer, "Streaming status: SS[");
+					strcat(respBuffer,suStringToFill);
+					strcat(respBuffer, "], any command stops\r\n");
+					streamIndex	   = index;
+					streamLastTick = HAL_GetTick() - CMD_STREAM_MS;
+					cmdResponse = eNoFurtherComment;
+				}
+				else if (isU32Index)
+				{
+					cmdResponse = eIndexRangeExceeded;
+				}
+			}
+			break;
+		/// 'M[xxxxxxxx]' or 'M[xx..]=yy..' => Memory/IO/SFR read or write.
+		case 'M':	// Report any 4 bytes worth of memory/IO/SFR's
+			if (cmdLength == 1)
+			{	// Must be the M command.
+				cmdResponse = eIndexError; // assume worst, hope  best:
+
+				// if the "index" found in [xxxxxxxx] is a valid U32 index:
+				if ( isU32Index  )
+				{
+					uint32_t *MemorySpacePtr;
+
+					// Get the address (pointer) selected via the index M[xxxxxxxx]
+					MemorySpacePtr = (uint32_t *)index;
+
+					// Now convert index of u32 to back to string to use as part of response:
+					// sprintf(respBuffer, "Memory M[0x%08X]", (unsigned int)index);
+					suU32ToString( index, suHEX, suStringToFill );
+
+					// Check flags to see:
+					// 1) if an "=" sign after the index, which indicates data to write.
+					// 2) The data to write is a valid number and was converted to Uint.
+					if (isInputDataStr && isUintData)
+					{
+						// We requested a write to memory/IO/SFR, so let's do it !
+						// Take uIntData and write it to loc. pointed to by MemorySpacePtr.
+						*MemorySpacePtr = uIntData;
+						strcpy(respBuffer, "Memory/IO write: M[0x");
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "]");
+						strcat(respBuffer, " <== 0x");
+						suU32ToString( uIntData, suHEX, suStringToFill );
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "\r\n");
+						cmdResponse = eNoFurtherComment;
+					}
+					else
+					{
+						// We requested a read from a memory/IO/SFR location
+						strcpy(respBuffer, "Memory/IO query: M[0x");
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "]");
+						// Translate what we read via MemorySpacePtr, to hex string
+						//sprintf(strOf20CharsMax, " = 0x%08X \r\n", (unsigned int)*MemorySpacePtr);
+						suU32ToString( (unsigned int)*MemorySpacePtr, suHEX, suStringToFill );
+						strcat(respBuffer, " = 0x");
+						strcat(respBuffer,suStringToFill);
+						strcat(respBuffer, "\r\n");
+						cmdResponse = eNoFurtherComment;
+						//cmdResponse = eGotM;
+					}
+				}
+			}
+			break;
+	}
+
+    switch (cmdResponse)
+    {
+    case eOK:
+        strcpy(respBuffer, "Ok\r\n");
+    	break;
+    case eUnknownCmd:
+    	strcpy(respBuffer, "Unknown command !\r\n");
+    	break;
+    case eGotC:
+        strcpy(respBuffer, "Stub cmd C, Ok\r\n");
+    	break;
+    case eGotD:
+        strcpy(respBuffer, "Stub cmd D, Ok\r\n");
+    	break;
+    case eGotH:
+        strcpy(respBuffer, "Stub cmd H, Ok\r\n");
+    	break;
+    case eGotM:
+        strcpy(respBuffer, "Stub cmd M, Ok\r\n");
+    	break;
+    case eNoFurtherComment:
+        break;
+    case eAttachReadOnly:
+    	strcat(respBuffer, " is read only..");
+		break;
+    case eUintExpected:
+        strcpy(respBuffer, "Unsigned int format expected.\r\n");
+    	break;
+    case eIndexRangeExceeded:
+        strcpy(respBuffer, "Index range Exceeded.\r\n");
+    	break;
+    case eIndexError:
+    	strcpy(respBuffer, "Index Expected.\r\n");
+    	break;
+    }
+
+      //UartPutString(crlf_msg, false);
+
+      /// <br> Finally send response based on what command received back to terminal.
+      UartPutString(respBuffer, false);
+      ///  \pagebreak
+      //UartPutString(crlf_msg, false);
+}
@@ -1,620 +1,1253 @@
-/**
-  @file serialEEProm.c
-  @brief Functions to support read//write to serial eeproms.
-<pre>
-	Presently the target device is Atmel AT24C256.
-	Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
-
-</pre>
-
-   @author 	Joe Kuss (JMK)
-   @date 	03/01/2018
-
-*/
-#include "serialEEProm.h"
-#include "led.h"
-#include "main.h"
-#include <stddef.h>
-
-/// Device Addr needed by HAL I2C routines (7bit addr << 1)
-uint16_t targetAddressU16;
-
-/// Single eePromByte that has just been read.
-uint8_t eePromByteRead;
-
-//############ Just for expermental purposes:
-pageByteArrayStruct bas1;
-
-// But here is a possible trick:
-// https://www.embedded.com/design/prototyping-and-development/4024941/Learn-a-new-trick-with-the-offsetof--macro
-// "the offsetof() macro returns the number of bytes of offset before a particular element of a struct or union. "
-// In the case below the array is of bytes in the page, so bytes in page (size of array is just this offset).
-pageByteArrayStruct bas2 = { .array={0},.bytesInPage = offsetof(pageByteArrayStruct,bytesInPage)};
-//################
-
-/// Mutiple eePromBytes, <= page size, just read.
-pageByteArrayStruct eePromReadPageBytes = { .array={0},.bytesInPage = AT24C_PAGE_SIZE };
-
-/// Single eePromByte to be written.
-uint8_t eePromByteToBeWritten;
-
-/// Mutiple eePromBytes, <= page size, to be written
-
-uint8_t value = sizeof(pageByteArrayStruct);
-
-pageByteArrayStruct eePromWritePageBytes = { .array={0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,
-		   	   	   	   	   	   	   	   	   	   	  0x08,0x09,0x0A,0x0B,0x0C,0x0D,0x0E,0x0F,
-												  0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,
-												  0x18,0x19,0x1A,0x1B,0x1C,0x1D,0x1E,0x1F,
-												  0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,
-												  0x28,0x29,0x2A,0x2B,0x2C,0x2D,0x2E,0x2F,
-												  0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,
-												  0x38,0x39,0x3A,0x3B,0x3C,0x3D,0x3E,0x3F},
-												  //.bytesInPage=sizeof(pageByteArrayStruct.array) }; //
-												  .bytesInPage=sizeof(eePromReadPageBytes.array) };
-
-// Note for previous line: you can not do sizeof an inner component of a struct via the structure
-// typedef name, instead you must use a previous instantiaton of the struct, which here is
-// eePromReadPageBytes - This is a work around for something that would be better if it
-// was allowed... ###### We still have problems since we really need to have even an
-// un-initialized version of pageByteArrayStruct to have .bytesInPage = size of array, but this is
-// chicken before the egg problem.
-
-// But here is a possible trick:
-// https://www.embedded.com/design/prototyping-and-development/4024941/Learn-a-new-trick-with-the-offsetof--macro
-
-
-void sEEPromPageBufferFill(pageByteArrayStruct* pByteArrayStruct, enumArrayFillType fillType )
-{
-	int i;
-
-	for (i=0; i < pByteArrayStruct->bytesInPage; i++)
-	{
-		switch ( fillType ){
-			case FILL_0:
-				pByteArrayStruct->array[i] = 0x00;
-				break;
-			case FILL_FF:
-				pByteArrayStruct->array[i] = 0xFF;
-				break;
-			case FILL_INDEX:
-				pByteArrayStruct->array[i] = (uint8_t)i;
-				break;
-			case FILL_REVERSE_INDEX:
-				pByteArrayStruct->array[i] = (pByteArrayStruct->bytesInPage -1) - (uint8_t)i; //presently 63 down to 0..
-				break;
-		}
-	}
-}
-
-/*  >>>>>>>>> Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
-Part is organized as 32,768 x 8
-
-which is k bits of 256
-
-For AT24C256
-1 MHz (5V), 400 kHz (2.7V, 2.5V) and 100 kHz (1.8V) Compatibility
-
-64-byte Page Write Mode (Partial Page Writes Allowed)
-
-
-Self-timed Write Cycle (5 ms Typical, 10ms Max @ 5 or 2.5 volts)  - not exactly blazing speed writes !
-
-High Reliability
- Endurance: 100,000 Write Cycles, But for AT24C256C it is 1,000,000 Write Cycles
- Data Retention: 40 Years
-
-
-The SCL input is used to positive edge clock data into each
-EEPROM device and negative edge clock data out of each device.
-
-
-The SDA pin is bidirectional for serial data transfer. This pin is opendrain
-driven and may be wire-ORed with any number of other open-drain or open collector
-devices.
-
-
-The 128K/256K is internally organized as 256/512 pages of 64-bytes each.
-Random word addressing requires a 14/15-bit data word address.
-
-512 pages of 64 bytes or 512 bits, 512^^2 bits == 256K bits
-
-Write cycle time for 5 or 2.5 volts Vcc is 10ms
-
-Basic I2C rules:
-
-The SDA pin is normally pulled high with an external
-device. Data on the SDA pin may change only during SCL low time periods (refer to Data
-Validity timing diagram). Data changes during SCL high periods will indicate a start or stop
-condition as defined below.
-
-START CONDITION: A high-to-low transition of SDA with SCL high is a start condition which
-must precede any other command (refer to Start and Stop Definition timing diagram).
-
-STOP CONDITION: A low-to-high transition of SDA with SCL high is a stop condition. After a
-read sequence, the stop command will place the EEPROM in a standby power mode (refer to
-Start and Stop Definition timing diagram).
-
-All addresses and data words are serially transmitted to and from the
-EEPROM in 8-bit words. The EEPROM sends a zero during the ninth clock cycle to acknowledge
-that it has received each word.<< when it is being written to..>>
-
-MEMORY RESET: After an interruption in protocol, power loss or system reset, any 2-wire
-part can be reset by following these steps: (a) Clock up to 9 cycles, (b) look for SDA high in
-each cycle while SCL is high and then (c) create a start condition as SDA is high.
-
-
-Note: 1. The write cycle time tWR is the time from a valid stop condition of a
-write sequence to the end of the internal clear/write cycle. This is 10ms max - Slow !
-
-The A1 and A0 pins use an internal proprietary circuit that biases them to a logic low condition if the
-pins are allowed to float.
-
-How to talk to read/write Memory:
-
-==========================================================================================
-BYTE WRITE: A write operation requires two 8-bit data word addresses following the device
-address word and acknowledgment. Upon receipt of this address, the EEPROM will again
-respond with a zero and then clock in the first 8-bit data word. Following receipt of the 8-bit
-data word, the EEPROM will output a zero. The addressing device, such as a microcontroller,
-then must terminate the write sequence with a stop condition. At this time the EEPROM
-enters an internally-timed write cycle, tWR, to the nonvolatile memory. All inputs are disabled
-during this write cycle and the EEPROM will not respond until the write is complete (refer to
-Figure 2).
-
-Refering to Figure 2: Looks like word address can be 0 to 7FFF i.e. 0 to 32767 for 256K bit part,
-so we can write any byte address directly it seems, but then we must delay tWR to do the next byte
-tWR =  10ms
-==========================================================================================
-PAGE WRITE: The 128K/256K EEPROM is capable of 64-byte page writes.
-A page write is initiated the same way as a byte write, but the microcontroller does not send a
-stop condition after the first data word is clocked in. Instead, after the EEPROM acknowledges
-receipt of the first data word, the microcontroller can transmit up to 63 more data words. The
-EEPROM will respond with a zero after each data word received. The microcontroller must
-terminate the page write sequence with a stop condition (refer to Figure 3).
-
-The data word address lower 6 bits are internally incremented following the receipt of each
-data word. The higher data word address bits are not incremented, retaining the memory page
-row location. When the word address, internally generated, reaches the page boundary, the
-following byte is placed at the beginning of the same page. If more than 64 data words are
-transmitted to the EEPROM, the data word address will roll over and previous data will be
-overwritten. The address roll over during write is from the last byte of the current page to the
-first byte of the same page.
-
-<<So it looks like a page write could be used to update a string of bytes starting
-anywhere in the 64 byte page, but the internal hardware will, cause the 6 lower bits
-of the address (representing locations in the page) to increment once for each consecutive
-byte to be written sent,so if we keep writing we will end up overflowing and going
-back to byte addr 0 of this page. For max efficiency we might want to update
-64 bytes at a time.>>
-
-ACKNOWLEDGE POLLING: Once the internally-timed write cycle has started and the
-EEPROM inputs are disabled, acknowledge polling can be initiated. This involves sending a
-start condition followed by the device address word. The read/write bit is representative of the
-operation desired. Only if the internal write cycle has completed will the EEPROM respond
-with a zero, allowing the read or write sequence to continue.
-
-So one might estimate the fastest time to write out all 32K bytes would be (32K/64 * 10mS)
-+ time to clock out the 64 bytes x 512 pages: (tck64 * 32K/64) = 512*10ms (5.12 seconds + 512*tck64)
-Note: 32K/64 = 512 pages of 64 bytes in a 256Kbit eeprom.
-==========================================================================================
-
-Read
-Operations
-Read operations are initiated the same way as write operations with the exception that the
-read/write select bit in the device address word is set to one. There are three read operations:
-current address read, random address read and sequential read.
-
-CURRENT ADDRESS READ: The internal data word address counter maintains the last
-address accessed during the last read or write operation, incremented by one. This address
-stays valid between operations as long as the chip power is maintained. The address roll
-over during read is from the last byte of the last memory page, to the first byte of the first
-page.
-
-Once the device address with the read/write select bit set to one is clocked in and acknowledged
-by the EEPROM, the current address data word is serially clocked out. The
-microcontroller does not respond with an input zero but does generate a following stop condition
-
-<< Nice thing aboout this is that the CURRENT ADDRESS READ does not require sending
-   the device address byte twice (2nd time with repeated start condx) to change the modality
-   from write (first send the eeprom two bytes of internal starting address), to  then read
-   (recieve the byte or bytes from the eeprom.>>
-
-(refer to Figure 4).
-
-RANDOM READ: A random read requires a dummy byte write sequence to load in the data
-word address. Once the device address word and data word address are clocked in and
-acknowledged by the EEPROM, the microcontroller must generate another start condition.
-The microcontroller now initiates a current address read by sending a device address with the
-read/write select bit high. The EEPROM acknowledges the device address and serially clocks
-out the data word. The microcontroller does not respond with a zero <ack> but does generate a following
-stop condition (refer to Figure 5).
-
-SEQUENTIAL READ: Sequential reads are initiated by either a current address read or a random
-address read. After the microcontroller receives a data word, it responds with an
-acknowledge. As long as the EEPROM receives an acknowledge, it will continue to increment
-the data word address and serially clock out sequential data words. When the memory
-address limit is reached, the data word address will roll over and the sequential read will continue.
-The sequential read operation is terminated when the microcontroller does not respond
-with a zero <ack> but does generate a following stop condition (refer to Figure 6).
-
-Note reads are available upon completion of I2C clocking sequence and no further
-tWR delay is needed in between reads.
-
- */
-
-/* Type reference only
-HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
-HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
-*/
-
-
-/**
- * @brief Write a single byte into the serial EEprom.
- * <pre>
- *	This function will write a single byte to a particular eeprom device
- *	specified by DevAddress, into its memory at location EEaddress.
- *
- *	This function is "non blocking", so it just starts this process running, by
- *	passing in for the I2C_Handle structure the desired communications information,
- *	and then calling the HAL initiation function: HAL_I2C_Mem_Write_IT(..),
- *	which updates the I2C_Handle structure for the duration this process will run.
- *
- *	The total process is expected to run as follows:
- *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
- *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
- *  @li Send one I2C byte to write data to EEaddress. (Low Ack bit seen if ok)
- *  @li Send Stop condx.
- *
- *  @note Expected return status will be "HAL_BUSY" ??? I believe ???
- *  @note Some time in future status will be "HAL_OK" once above 4 step process is complete.
- *  @note IMPORTANT - Write process is not actually complete until tWR time after "HAL_OK"
- *  				  tWR is specified as a worst case of 10ms. We must either:
- *  				  1) Setup a timer to prevent future writes until tWR is elapsed, or
- *  				  2) Implement "ACKNOWLEDGE POLLING" as mentioned in the data sheet
- *						 ("ACKNOWLEDGE POLLING" method will allow faster response.)
- * </pre>
- *
- * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
- * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
- * @param pByteBuffer - Pointer to 1 byte transmission buffer, external to this function.
- *
- * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- */
-HAL_StatusTypeDef sEEPromByteWrite(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer) {
-
-	HAL_StatusTypeDef I2CWriteStatus;
-
-	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
-	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
-
-	while (hi2c->State != HAL_I2C_STATE_READY)
-	{
-		// While transfer count from previous is not zero we are still sending bytes..
-		// asm("nop");
-
-		STM32vldisc_LEDToggle(LED3);
-	}
-	// Non blocking (interrupt based) call to write one byte.
-	I2CWriteStatus = HAL_I2C_Mem_Write_IT(hi2c, HAL_DevAddr, EEaddress, (uint16_t)2, pByteBuffer, (uint16_t) 1);
-
-	return I2CWriteStatus;
-}
-
-/**
- * @brief Write a multiple bytes, max of 64 (page size) into serial EEprom.
- * <pre>
- *	This function will write a multiple bytes to a particular eeprom device
- *	specified by DevAddress, Starting at memory at location EEaddress.
- *
- *	Optimal use for this function is to write a full page at a time.
- *	This requires 64 bytes always sent, and EEaddress to always have
- *	lower 6 bits as 0, to start at selected page boundary.
- *
- *	Other uses allow less than 64 bytes to be written, but then
- *	"last 6 bits of EEaddress" + "bufferlength"  must be <= 64.
- *	If this rule is not followed, upper bytes of data written
- *	will fill into areas before the starting EEaddress starting
- *	with last 6 bytes of EEaddress at zero.
- *
- *	This function is "non blocking", so it just starts this process running, by
- *	passing in for the I2C_Handle structure the desired communications information,
- *	and then calling the HAL initiation function: HAL_I2C_Mem_Write_IT(..),
- *	which updates the I2C_Handle structure for the duration this process will run.
- *
- *	The total process is expected to run as follows:
- *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
- *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
- *  @li Send 1 to 64 I2C bytes to write data to EEaddress. (Low Ack for each byte, expected.)
- *  @li Send Stop condx.
- *
- *  @note Expected return status will be "HAL_BUSY" ??? I believe ???
- *  @note Some time in future status will be "HAL_OK" once above 4 step process is complete.
- *  @note IMPORTANT - Write process is not actually complete upon "HAL_OK" until aftertWR time.
- *  				  tWR is specified as a worst case of 10ms to complete full 64 byte or less
- *  				  write.  We must either:
- *  				  1) Setup a timer to prevent future writes until tWR is elapsed, or
- *  				  2) Implement "ACKNOWLEDGE POLLING" as mentioned in the data sheet
- *						 ("ACKNOWLEDGE POLLING" method will allow faster response.)
- * </pre>
- *
- * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
- * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
- * @param pByteBuffer - Pointer to multi-byte transmission buffer, external to this function.
- * @param bufferLength - Number of bytes to be sent, 1 to 64 presently.
- *
- * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- */
-HAL_StatusTypeDef sEEPromBytesWrite(I2C_HandleTypeDef *hi2c,  enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint16_t bufferLength) {
-
-	HAL_StatusTypeDef I2CWriteStatus;
-
-	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
-	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
-
-	while (hi2c->State != HAL_I2C_STATE_READY)
-	{
-		// While transfer count from previous is not zero we are still sending bytes..
-		// asm("nop");
-
-		STM32vldisc_LEDToggle(LED3);
-	}
-	// Non blocking (interrupt based) call to write multiple bytes.
-	// Note: The ATMEL 24C256 / 24C128 has 64 byte pages and the max that can be
-	//       written on any given call to this function is one full page, 64 bytes, worth.
-	//       after that there is a max 10 ms delay (tWR) before we can talk to the eeprom again.
-
-	// So if we use a starting EEaddress that is not a multiple of 64 bytes, then any part of the
-	// buffer to be sent that exceeds the next multiple of 64 bytes will fold back to continue
-	// at the previous multiple of 64 bytes's starting address. << VERIFY THIS IS TRUE >>
-
-	I2CWriteStatus = HAL_I2C_Mem_Write_IT(hi2c, HAL_DevAddr, EEaddress, (uint16_t)2, pByteBuffer, bufferLength);
-
-	return I2CWriteStatus;
-}
-
-/**
- * @brief Read one byte serial eeprom's current address.
- * <pre>
- *	This function does not require a parameter specifying EEaddress.
- *
- *	The internally determined current address, depends on
- *	eeprom initialization/reset (will set it to 0) or previous
- *	eeprom activity where internally determined current address
- *	will be last previously accessed read or write address + 1.
- *
- *	If last previously accessed read or write address was at maximum
- *	for the part then current address will return to 0.
- *
- *	The total process is expected to run as follows:
- *  @li Send Start condx. Send one byte Device address, with R/W* bit as R.
- *  @li Read One I2C bytes at internally determined address ( Respond with Ack* bit high.)
- *  @li Send Stop condx.
- *
- *  @note Expected return status will be "HAL_BUSY" ??? I believe ???
- *  @note Some time in future status will be "HAL_OK" once 3 step process is complete.
- *  @note Read process is complete upon "HAL_OK".
- *
- * </pre>
- *
- * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
- * @param pByteRcvd  - Pointer to  single byte receive buffer, external to this function.
- *
- * @returns retVal	  - HAL_StatusTypeDef, One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- */
-HAL_StatusTypeDef sEEPromCurrentAddrReadByte(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint8_t *pByteRcvd)
-{
-	HAL_StatusTypeDef I2CWriteStatus;
-	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
-	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
-
-
-	// This function can not use HAL_I2C_Mem_Read_IT(..) since we do not have an EEaddress.
-
-	// We just do a quick start, Dev Address, and Read a Byte, this is blocking but will be quick:
-	// ### Check if HAL has non-blocking version ??? ###
-	I2CWriteStatus = HAL_I2C_Master_Receive(hi2c, HAL_DevAddr, pByteRcvd, (uint16_t) SIZE_OF_ONE_BYTE, (uint32_t)TIMEOUT_100MS);
-
-	return I2CWriteStatus;
-}
-
-/**
- * @brief Read multiple bytes starting at serial eeprom's current address.
- * <pre>
- *	This function does not have a parameter specifying EEaddress.
- *
- *	The internally determined current address, depends on
- *	eeprom initialization/reset (will set it to 0) or previous
- *	eeprom activity where internally determined current address
- *	will be last previously accessed read or write address + 1.
- *
- *	If last previously accessed read or write address was at maximum
- *	for the part then current address will revert to to 0.
- *
- *	The total process is expected to run as follows:
- *  @li Send Start condx. Send one byte Device address, with R/W* bit as R.
- *  @li Read Multiple I2C bytes starting at internally determined address ( Respond with Ack* bit high.)
- *  @li Send Stop condx.
- * </pre>
- *
- * @param hi2c 		 		- pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress 		- I2C device address to load into *hi2c. (normally only use 8 bits or less)
- * @param pBytesRcvd  		- Pointer to  single byte receive buffer, external to this function.
- * @param expectedByteCount - Bytes expected to be read.
- *
- * @returns retVal	  - HAL_StatusTypeDef, One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- * ####### Could ensure expectedByteCount will never be  > sizeof buffer for pBytesRcvd
- *
- */
-HAL_StatusTypeDef sEEPromCurrentAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint8_t *pBytesRcvd, uint16_t expectedByteCount)
-{
-	HAL_StatusTypeDef I2CWriteStatus;
-	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
-	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
-
-	// This function can not use HAL_I2C_Mem_Read_IT(..) since we do not have an EEaddress.
-	// ### Check if HAL has non-blocking version of HAL_I2C_Master_Receive ??? ###
-	I2CWriteStatus = HAL_I2C_Master_Receive(hi2c, HAL_DevAddr, pBytesRcvd, expectedByteCount, (uint32_t)TIMEOUT_100MS);
-
-	return I2CWriteStatus;
-}
-
-/**
- * @brief Read single byte, max of 64 (page size) from serial EEprom.
- * <pre>
- *	This function reads a single byte in particular eeprom device
- *	specified by DevAddress, at selected EEaddress inside the device.
- *
- *	This function is "non blocking", so it just starts this process running, by
- *	passing in for the I2C_Handle structure the desired communications information,
- *	and then calling the HAL initiation function: HAL_I2C_Mem_Read_IT(..),
- *	which updates the I2C_Handle structure for the duration this process will run.
- *
- *	The total process is expected to run as follows:
- *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
- *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
- *  @li Send Second Start condx. Send same one byte Device address, with R/W* bit as R.
- *  @li Recieve one I2C byte of read data at EEaddress.
- *  @li Send High Ack after single byte to be read.
- *  @li Send Stop condx.
- *
- *  @note Expected return status will be "HAL_BUSY"
- *  @note Some time in future status will be "HAL_OK" once receive process is complete.
- *
- * </pre>
- *
- * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
- * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
- * @param pByteBuffer - Pointer to  single byte rx buffer, external to this function.
- *
- * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- */
-
-HAL_StatusTypeDef sEEPromRandomAddrByteRead(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer)
-{
-	HAL_StatusTypeDef I2CWriteStatus;
-	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
-	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
-
-	while (hi2c->State != HAL_I2C_STATE_READY)
-	{
-		// While transfer count from previous is not zero we are still doing bytes
-		// from previous EERead or Write...
-		//asm("nop");
-		STM32vldisc_LEDToggle(LED3);
-	}
-	// Non blocking (interrupt based) call to read some bytes.
-	// EEaddress is supplied as a parameter - so would use "HAL_I2C_Mem_Read_IT(..)"
-	I2CWriteStatus = HAL_I2C_Mem_Read_IT(hi2c, HAL_DevAddr, EEaddress, (uint16_t)2, pByteBuffer, (uint16_t) 1);
-
-	return I2CWriteStatus;
-}
-
-
-/**
- * @brief Read multiple bytes, max of 64 (page size) from serial EEprom.
- * <pre>
- *	This function reads multiple bytes to a particular eeprom device
- *	specified by DevAddress, Starting at memory at location EEaddress.
- *
- *	When less than 64 bytes to be read,
- *	"last 6 bits of EEaddress" + "bufferlength"  must be <= 64.
- *	otherwise, upper bytes of data read will come from areas before
- *	the starting EEaddress when last 6 bytes of EEaddress increment
- *	beyond page boundry.
- *
- *	This function is "non blocking", so it just starts this process running, by
- *	passing in for the I2C_Handle structure the desired communications information,
- *	and then calling the HAL initiation function: HAL_I2C_Mem_Read_IT(..),
- *	which updates the I2C_Handle structure for the duration this process will run.
- *
- *	The total process is expected to run as follows:
- *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
- *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
- *  @li Send Second Start condx. Send same one byte Device address, with R/W* bit as R.
- *  @li Recieve 1 to 64 I2C bytes of read data starting at EEaddress. ( Send Low Ack to start next byte.)
- *  @li Send High Ack after final byte to be read.
- *  @li Send Stop condx.
- *
- *  @note Expected return status will be "HAL_BUSY"
- *  @note Some time in future status will be "HAL_OK" once receive process is complete.
- * </pre>
- *
- * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
- * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
- * @param pByteBuffer - Pointer to multi-byte rx buffer, external to this function.
- * @param bufferLength - Number of bytes to be sent, 1 to 64 presently.
- *
- * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- * ####### Could ensure expectedByteCount will never be  > sizeof buffer for pBytesRcvd
- *
- */
-
-HAL_StatusTypeDef sEEPromRandomAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint8_t bufferLength)
-{
-	HAL_StatusTypeDef I2CWriteStatus;
-	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
-	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
-
-	while (hi2c->State != HAL_I2C_STATE_READY)
-	{
-		// While transfer count from previous is not zero we are still doing bytes
-		// from previous EERead or Write...
-		//asm("nop");
-		STM32vldisc_LEDToggle(LED3);
-	}
-	// Non blocking (interrupt based) call to read some bytes.
-	// EEaddress is supplied as a parameter - so would use "HAL_I2C_Mem_Read_IT(..)"
-	I2CWriteStatus = HAL_I2C_Mem_Read_IT(hi2c, HAL_DevAddr, EEaddress, (uint16_t)2, pByteBuffer, (uint16_t) bufferLength);
-
-	return I2CWriteStatus;
-}
-
-
-/**
- * @brief Reset the I2C serial eeprom by this I2C transmission.
- * <pre>
- *   Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
- *
- *	 MEMORY RESET: After an interruption in protocol, power loss or system reset, any 2-wire
- *	 part can be reset by following these steps: (a) Clock up to 9 cycles, (b) look for SDA high in
- *	 each cycle while SCL is high and then (c) create a start condition as SDA is high.
- *
- *	The total process is expected to run as follows:
- *
- *  @li 1)
- *  @li 2)
- *  @li 3)
- *  @li 4)
- *
- *  @note Expected return status will be #########
- *  @note Parameters for this function are TBD ##########
- * </pre>
- *
- * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
- * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
- *
- * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
- *
- * ####### Could ensure expectedByteCount will never be  > sizeof buffer for pBytesRcvd
- *
- */
-HAL_StatusTypeDef  sEE_I2C_PartReset(I2C_HandleTypeDef *hi2c)
-{
-	HAL_StatusTypeDef I2CWriteStatus = HAL_OK; //#############
-
-	/// Not implemented yet !
-
-	return I2CWriteStatus;
-}
+/**
+  @file serialEEProm.c
+  @brief Functions to support read//write to serial eeproms.
+<pre>
+	Presently the target device is Atmel AT24C256.
+	Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
+
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	03/01/2018
+
+*/
+#include "serialEEProm.h"
+#include "eePromCrc.h"
+#include "i2cTrace.h"
+#include "i2cRetry.h"
+#include "led.h"
+#include "main.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+/// Device Addr needed by HAL I2C routines (7bit addr << 1)
+uint16_t targetAddressU16;
+
+/// Single eePromByte that has just been read.
+uint8_t eePromByteRead;
+
+//############ Just for expermental purposes:
+pageByteArrayStruct bas1;
+
+// But here is a possible trick:
+// https://www.embedded.com/design/prototyping-and-development/4024941/Learn-a-new-trick-with-the-offsetof--macro
+// "the offsetof() macro returns the number of bytes of offset before a particular element of a struct or union. "
+// In the case below the array is of bytes in the page, so bytes in page (size of array is just this offset).
+pageByteArrayStruct bas2 = { .array={0},.bytesInPage = offsetof(pageByteArrayStruct,bytesInPage)};
+//################
+
+/// Mutiple eePromBytes, <= page size, just read.
+pageByteArrayStruct eePromReadPageBytes = { .array={0},.bytesInPage = AT24C_PAGE_SIZE };
+
+/// Single eePromByte to be written.
+uint8_t eePromByteToBeWritten;
+
+/// Mutiple eePromBytes, <= page size, to be written
+
+uint8_t value = sizeof(pageByteArrayStruct);
+
+#if (AT24C_PAGE_SIZE >= 64)
+pageByteArrayStruct eePromWritePageBytes = { .array={0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,
+		   	   	   	   	   	   	   	   	   	   	  0x08,0x09,0x0A,0x0B,0x0C,0x0D,0x0E,0x0F,
+												  0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,
+												  0x18,0x19,0x1A,0x1B,0x1C,0x1D,0x1E,0x1F,
+												  0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,
+												  0x28,0x29,0x2A,0x2B,0x2C,0x2D,0x2E,0x2F,
+												  0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,
+												  0x38,0x39,0x3A,0x3B,0x3C,0x3D,0x3E,0x3F},
+												  //.bytesInPage=sizeof(pageByteArrayStruct.array) }; //
+												  .bytesInPage=sizeof(eePromReadPageBytes.array) };
+#else
+// Smaller page parts, (AT24C32/64), sEEPromPageBufferFill(..) it before use.
+pageByteArrayStruct eePromWritePageBytes = { .array={0}, .bytesInPage = AT24C_PAGE_SIZE };
+#endif
+
+// Note for previous line: you can not do sizeof an inner component of a struct via the structure
+// typedef name, instead you must use a previous instantiaton of the struct, which here is
+// eePromReadPageBytes - This is a work around for something that would be better if it
+// was allowed... ###### We still have problems since we really need to have even an
+// un-initialized version of pageByteArrayStruct to have .bytesInPage = size of array, but this is
+// chicken before the egg problem.
+
+// But here is a possible trick:
+// https://www.embedded.com/design/prototyping-and-development/4024941/Learn-a-new-trick-with-the-offsetof--macro
+
+
+void sEEPromPageBufferFill(pageByteArrayStruct* pByteArrayStruct, enumArrayFillType fillType )
+{
+	int i;
+
+	for (i=0; i < pByteArrayStruct->bytesInPage; i++)
+	{
+		switch ( fillType ){
+			case FILL_0:
+				pByteArrayStruct->array[i] = 0x00;
+				break;
+			case FILL_FF:
+				pByteArrayStruct->array[i] = 0xFF;
+				break;
+			case FILL_INDEX:
+				pByteArrayStruct->array[i] = (uint8_t)i;
+				break;
+			case FILL_REVERSE_INDEX:
+				pByteArrayStruct->array[i] = (pByteArrayStruct->bytesInPage -1) - (uint8_t)i; //presently 63 down to 0..
+				break;
+		}
+	}
+}
+
+/*  >>>>>>>>> Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
+Part is organized as 32,768 x 8
+
+which is k bits of 256
+
+For AT24C256
+1 MHz (5V), 400 kHz (2.7V, 2.5V) and 100 kHz (1.8V) Compatibility
+
+64-byte Page Write Mode (Partial Page Writes Allowed)
+
+
+Self-timed Write Cycle (5 ms Typical, 10ms Max @ 5 or 2.5 volts)  - not exactly blazing speed writes !
+
+High Reliability
+ Endurance: 100,000 Write Cycles, But for AT24C256C it is 1,000,000 Write Cycles
+ Data Retention: 40 Years
+
+
+The SCL input is used to positive edge clock data into each
+EEPROM device and negative edge clock data out of each device.
+
+
+The SDA pin is bidirectional for serial data transfer. This pin is opendrain
+driven and may be wire-ORed with any number of other open-drain or open collector
+devices.
+
+
+The 128K/256K is internally organized as 256/512 pages of 64-bytes each.
+Random word addressing requires a 14/15-bit data word address.
+
+512 pages of 64 bytes or 512 bits, 512^^2 bits == 256K bits
+
+Write cycle time for 5 or 2.5 volts Vcc is 10ms
+
+Basic I2C rules:
+
+The SDA pin is normally pulled high with an external
+device. Data on the SDA pin may change only during SCL low time periods (refer to Data
+Validity timing diagram). Data changes during SCL high periods will indicate a start or stop
+condition as defined below.
+
+START CONDITION: A high-to-low transition of SDA with SCL high is a start condition which
+must precede any other command (refer to Start and Stop Definition timing diagram).
+
+STOP CONDITION: A low-to-high transition of SDA with SCL high is a stop condition. After a
+read sequence, the stop command will place the EEPROM in a standby power mode (refer to
+Start and Stop Definition timing diagram).
+
+All addresses and data words are serially transmitted to and from the
+EEPROM in 8-bit words. The EEPROM sends a zero during the ninth clock cycle to acknowledge
+that it has received each word.<< when it is being written to..>>
+
+MEMORY RESET: After an interruption in protocol, power loss or system reset, any 2-wire
+part can be reset by following these steps: (a) Clock up to 9 cycles, (b) look for SDA high in
+each cycle while SCL is high and then (c) create a start condition as SDA is high.
+
+
+Note: 1. The write cycle time tWR is the time from a valid stop condition of a
+write sequence to the end of the internal clear/write cycle. This is 10ms max - Slow !
+
+The A1 and A0 pins use an internal proprietary circuit that biases them to a logic low condition if the
+pins are allowed to float.
+
+How to talk to read/write Memory:
+
+==========================================================================================
+BYTE WRITE: A write operation requires two 8-bit data word addresses following the device
+address word and acknowledgment. Upon receipt of this address, the EEPROM will again
+respond with a zero and then clock in the first 8-bit data word. Following receipt of the 8-bit
+data word, the EEPROM will output a zero. The addressing device, such as a microcontroller,
+then must terminate the write sequence with a stop condition. At this time the EEPROM
+enters an internally-timed write cycle, tWR, to the nonvolatile memory. All inputs are disabled
+during this write cycle and the EEPROM will not respond until the write is complete (refer to
+Figure 2).
+
+Refering to Figure 2: Looks like word address can be 0 to 7FFF i.e. 0 to 32767 for 256K bit part,
+so we can write any byte address directly it seems, but then we must delay tWR to do the next byte
+tWR =  10ms
+==========================================================================================
+PAGE WRITE: The 128K/256K EEPROM is capable of 64-byte page writes.
+A page write is initiated the same way as a byte write, but the microcontroller does not send a
+stop condition after the first data word is clocked in. Instead, after the EEPROM acknowledges
+receipt of the first data word, the microcontroller can transmit up to 63 more data words. The
+EEPROM will respond with a zero after each data word received. The microcontroller must
+terminate the page write sequence with a stop condition (refer to Figure 3).
+
+The data word address lower 6 bits are internally incremented following the receipt of each
+data word. The higher data word address bits are not incremented, retaining the memory page
+row location. When the word address, internally generated, reaches the page boundary, the
+following byte is placed at the beginning of the same page. If more than 64 data words are
+transmitted to the EEPROM, the data word address will roll over and previous data will be
+overwritten. The address roll over during write is from the last byte of the current page to the
+first byte of the same page.
+
+<<So it looks like a page write could be used to update a string of bytes starting
+anywhere in the 64 byte page, but the internal hardware will, cause the 6 lower bits
+of the address (representing locations in the page) to increment once for each consecutive
+byte to be written sent,so if we keep writing we will end up overflowing and going
+back to byte addr 0 of this page. For max efficiency we might want to update
+64 bytes at a time.>>
+
+ACKNOWLEDGE POLLING: Once the internally-timed write cycle has started and the
+EEPROM inputs are disabled, acknowledge polling can be initiated. This involves sending a
+start condition followed by the device address word. The read/write bit is representative of the
+operation desired. Only if the internal write cycle has completed will the EEPROM respond
+with a zero, allowing the read or write sequence to continue.
+
+So one might estimate the fastest time to write out all 32K bytes would be (32K/64 * 10mS)
++ time to clock out the 64 bytes x 512 pages: (tck64 * 32K/64) = 512*10ms (5.12 seconds + 512*tck64)
+Note: 32K/64 = 512 pages of 64 bytes in a 256Kbit eeprom.
+==========================================================================================
+
+Read
+Operations
+Read operations are initiated the same way as write operations with the exception that the
+read/write select bit in the device address word is set to one. There are three read operations:
+current address read, random address read and sequential read.
+
+CURRENT ADDRESS READ: The internal data word address counter maintains the last
+address accessed during the last read or write operation, incremented by one. This address
+stays valid between operations as long as the chip power is maintained. The address roll
+over during read is from the last byte of the last memory page, to the first byte of the first
+page.
+
+Once the device address with the read/write select bit set to one is clocked in and acknowledged
+by the EEPROM, the current address data word is serially clocked out. The
+microcontroller does not respond with an input zero but does generate a following stop condition
+
+<< Nice thing aboout this is that the CURRENT ADDRESS READ does not require sending
+   the device address byte twice (2nd time with repeated start condx) to change the modality
+   from write (first send the eeprom two bytes of internal starting address), to  then read
+   (recieve the byte or bytes from the eeprom.>>
+
+(refer to Figure 4).
+
+RANDOM READ: A random read requires a dummy byte write sequence to load in the data
+word address. Once the device address word and data word address are clocked in and
+acknowledged by the EEPROM, the microcontroller must generate another start condition.
+The microcontroller now initiates a current address read by sending a device address with the
+read/write select bit high. The EEPROM acknowledges the device address and serially clocks
+out the data word. The microcontroller does not respond with a zero <ack> but does generate a following
+stop condition (refer to Figure 5).
+
+SEQUENTIAL READ: Sequential reads are initiated by either a current address read or a random
+address read. After the microcontroller receives a data word, it responds with an
+acknowledge. As long as the EEPROM receives an acknowledge, it will continue to increment
+the data word address and serially clock out sequential data words. When the memory
+address limit is reached, the data word address will roll over and the sequential read will continue.
+The sequential read operation is terminated when the microcontroller does not respond
+with a zero <ack> but does generate a following stop condition (refer to Figure 6).
+
+Note reads are available upon completion of I2C clocking sequence and no further
+tWR delay is needed in between reads.
+
+ */
+
+/* Type reference only
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+*/
+
+
+/**
+ * @brief Write a single byte into the serial EEprom.
+ * <pre>
+ *	This function will write a single byte to a particular eeprom device
+ *	specified by DevAddress, into its memory at location EEaddress.
+ *
+ *	This function is "non blocking", so it just starts this process running, by
+ *	passing in for the I2C_Handle structure the desired communications information,
+ *	and then calling the HAL initiation function: HAL_I2C_Mem_Write_IT(..),
+ *	which updates the I2C_Handle structure for the duration this process will run.
+ *
+ *	The total process is expected to run as follows:
+ *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
+ *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
+ *  @li Send one I2C byte to write data to EEaddress. (Low Ack bit seen if ok)
+ *  @li Send Stop condx.
+ *
+ *  @note Expected return status will be "HAL_BUSY" ??? I believe ???
+ *  @note Some time in future status will be "HAL_OK" once above 4 step process is complete.
+ *  @note IMPORTANT - Write process is not actually complete until tWR time after "HAL_OK"
+ *  				  tWR is specified as a worst case of 10ms. We must either:
+ *  				  1) Setup a timer to prevent future writes until tWR is elapsed, or
+ *  				  2) Implement "ACKNOWLEDGE POLLING" as mentioned in the data sheet
+ *						 ("ACKNOWLEDGE POLLING" method will allow faster response.)
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
+ * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
+ * @param pByteBuffer - Pointer to 1 byte transmission buffer, external to this function.
+ *
+ * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
+ *
+ */
+HAL_StatusTypeDef sEEPromByteWrite(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer) {
+
+	HAL_StatusTypeDef I2CWriteStatus;
+
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+
+	// Non blocking (interrupt based) call to write one byte, once the previous transfer is done.
+	I2CWriteStatus = sEE_I2C_StartXfer(hi2c, SEE_XFER_MEM_WRITE, HAL_DevAddr, EEaddress, AT24C_MEMADD_SIZE, pByteBuffer, (uint16_t) 1);
+	if (I2CWriteStatus == HAL_OK)
+	{
+		eeCrcNoteWrite(addr7Bit, EEaddress, pByteBuffer, 1);
+	}
+
+	return I2CWriteStatus;
+}
+
+/**
+ * @brief Write a multiple bytes, max of 64 (page size) into serial EEprom.
+ * <pre>
+ *	This function will write a multiple bytes to a particular eeprom device
+ *	specified by DevAddress, Starting at memory at location EEaddress.
+ *
+ *	Optimal use for this function is to write a full page at a time.
+ *	This requires 64 bytes always sent, and EEaddress to always have
+ *	lower 6 bits as 0, to start at selected page boundary.
+ *
+ *	Other uses allow less than 64 bytes to be written, but then
+ *	"last 6 bits of EEaddress" + "bufferlength"  must be <= 64.
+ *	If this rule is not followed, upper bytes of data written
+ *	will fill into areas before the starting EEaddress starting
+ *	with last 6 bytes of EEaddress at zero.
+ *
+ *	This function is "non blocking", so it just starts this process running, by
+ *	passing in for the I2C_Handle structure the desired communications information,
+ *	and then calling the HAL initiation function: HAL_I2C_Mem_Write_IT(..),
+ *	which updates the I2C_Handle structure for the duration this process will run.
+ *
+ *	The total process is expected to run as follows:
+ *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
+ *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
+ *  @li Send 1 to 64 I2C bytes to write data to EEaddress. (Low Ack for each byte, expected.)
+ *  @li Send Stop condx.
+ *
+ *  @note Expected return status will be "HAL_BUSY" ??? I believe ???
+ *  @note Some time in future status will be "HAL_OK" once above 4 step process is complete.
+ *  @note IMPORTANT - Write process is not actually complete upon "HAL_OK" until aftertWR time.
+ *  				  tWR is specified as a worst case of 10ms to complete full 64 byte or less
+ *  				  write.  We must either:
+ *  				  1) Setup a timer to prevent future writes until tWR is elapsed, or
+ *  				  2) Implement "ACKNOWLEDGE POLLING" as mentioned in the data sheet
+ *						 ("ACKNOWLEDGE POLLING" method will allow faster response.)
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
+ * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
+ * @param pByteBuffer - Pointer to multi-byte transmission buffer, external to this function.
+ * @param bufferLength - Number of bytes to be sent, 1 to 64 presently.
+ *
+ * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
+ *
+ */
+HAL_StatusTypeDef sEEPromBytesWrite(I2C_HandleTypeDef *hi2c,  enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint16_t bufferLength) {
+
+	HAL_StatusTypeDef I2CWriteStatus;
+
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+
+	// Non blocking (interrupt based) call to write multiple bytes, once the previous transfer is done.
+	// Note: The ATMEL 24C256 / 24C128 has 64 byte pages and the max that can be
+	//       written on any given call to this function is one full page, 64 bytes, worth.
+	//       after that there is a max 10 ms delay (tWR) before we can talk to the eeprom again.
+
+	// So if we use a starting EEaddress that is not a multiple of 64 bytes, then any part of the
+	// buffer to be sent that exceeds the next multiple of 64 bytes will fold back to continue
+	// at the previous multiple of 64 bytes's starting address. << VERIFY THIS IS TRUE >>
+
+	I2CWriteStatus = sEE_I2C_StartXfer(hi2c, SEE_XFER_MEM_WRITE, HAL_DevAddr, EEaddress, AT24C_MEMADD_SIZE, pByteBuffer, bufferLength);
+	if (I2CWriteStatus == HAL_OK)
+	{
+		eeCrcNoteWrite(addr7Bit, EEaddress, pByteBuffer, bufferLength);
+	}
+
+	return I2CWriteStatus;
+}
+
+/**
+ * @brief Read one byte serial eeprom's current address.
+ * <pre>
+ *	This function does not require a parameter specifying EEaddress.
+ *
+ *	The internally determined current address, depends on
+ *	eeprom initialization/reset (will set it to 0) or previous
+ *	eeprom activity where internally determined current address
+ *	will be last previously accessed read or write address + 1.
+ *
+ *	If last previously accessed read or write address was at maximum
+ *	for the part then current address will return to 0.
+ *
+ *	The total process is expected to run as follows:
+ *  @li Send Start condx. Send one byte Device address, with R/W* bit as R.
+ *  @li Read One I2C bytes at internally determined address ( Respond with Ack* bit high.)
+ *  @li Send Stop condx.
+ *
+ *  @note Expected return status will be "HAL_BUSY" ??? I believe ???
+ *  @note Some time in future status will be "HAL_OK" once 3 step process is complete.
+ *  @note Read process is complete upon "HAL_OK".
+ *
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
+ * @param pByteRcvd  - Pointer to  single byte receive buffer, external to this function.
+ *
+ * @returns retVal	  - HAL_StatusTypeDef, One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
+ *
+ */
+HAL_StatusTypeDef sEEPromCurrentAddrReadByte(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint8_t *pByteRcvd)
+{
+	HAL_StatusTypeDef I2CWriteStatus;
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+
+
+	// This function can not use HAL_I2C_Mem_Read_IT(..) since we do not have an EEaddress.
+
+	// We just do a quick start, Dev Address, and Read a Byte, this is blocking but will be quick:
+	// ### Check if HAL has non-blocking version ??? ###
+	sEEPromWaitForReady(hi2c);
+	i2cTraceBegin(hi2c, I2CTRACE_READ, HAL_DevAddr, 0, SIZE_OF_ONE_BYTE);
+	I2CWriteStatus = HAL_I2C_Master_Receive(hi2c, HAL_DevAddr, pByteRcvd, (uint16_t) SIZE_OF_ONE_BYTE, (uint32_t)TIMEOUT_100MS);
+	i2cTraceDone(hi2c, I2CWriteStatus);
+	if (I2CWriteStatus == HAL_TIMEOUT)
+	{
+		// Slave stopped mid byte, leave the bus free for the next caller.
+		sEE_I2C_PartReset(hi2c);
+	}
+
+	return I2CWriteStatus;
+}
+
+/**
+ * @brief Read multiple bytes starting at serial eeprom's current address.
+ * <pre>
+ *	This function does not have a parameter specifying EEaddress.
+ *
+ *	The internally determined current address, depends on
+ *	eeprom initialization/reset (will set it to 0) or previous
+ *	eeprom activity where internally determined current address
+ *	will be last previously accessed read or write address + 1.
+ *
+ *	If last previously accessed read or write address was at maximum
+ *	for the part then current address will revert to to 0.
+ *
+ *	The total process is expected to run as follows:
+ *  @li Send Start condx. Send one byte Device address, with R/W* bit as R.
+ *  @li Read Multiple I2C bytes starting at internally determined address ( Respond with Ack* bit high.)
+ *  @li Send Stop condx.
+ * </pre>
+ *
+ * @param hi2c 		 		- pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param DevAddress 		- I2C device address to load into *hi2c. (normally only use 8 bits or less)
+ * @param pBytesRcvd  		- Pointer to  single byte receive buffer, external to this function.
+ * @param expectedByteCount - Bytes expected to be read.
+ *
+ * @returns retVal	  - HAL_StatusTypeDef, One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
+ *
+ * ####### Could ensure expectedByteCount will never be  > sizeof buffer for pBytesRcvd
+ *
+ */
+HAL_StatusTypeDef sEEPromCurrentAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint8_t *pBytesRcvd, uint16_t expectedByteCount)
+{
+	HAL_StatusTypeDef I2CWriteStatus;
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+
+	// This function can not use HAL_I2C_Mem_Read_IT(..) since we do not have an EEaddress.
+	// ### Check if HAL has non-blocking version of HAL_I2C_Master_Receive ??? ###
+	sEEPromWaitForReady(hi2c);
+	i2cTraceBegin(hi2c, I2CTRACE_READ, HAL_DevAddr, 0, expectedByteCount);
+	I2CWriteStatus = HAL_I2C_Master_Receive(hi2c, HAL_DevAddr, pBytesRcvd, expectedByteCount, (uint32_t)TIMEOUT_100MS);
+	i2cTraceDone(hi2c, I2CWriteStatus);
+	if (I2CWriteStatus == HAL_TIMEOUT)
+	{
+		// Slave stopped mid byte, leave the bus free for the next caller.
+		sEE_I2C_PartReset(hi2c);
+	}
+
+	return I2CWriteStatus;
+}
+
+/**
+ * @brief Read single byte, max of 64 (page size) from serial EEprom.
+ * <pre>
+ *	This function reads a single byte in particular eeprom device
+ *	specified by DevAddress, at selected EEaddress inside the device.
+ *
+ *	This function is "non blocking", so it just starts this process running, by
+ *	passing in for the I2C_Handle structure the desired communications information,
+ *	and then calling the HAL initiation function: HAL_I2C_Mem_Read_IT(..),
+ *	which updates the I2C_Handle structure for the duration this process will run.
+ *
+ *	The total process is expected to run as follows:
+ *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
+ *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
+ *  @li Send Second Start condx. Send same one byte Device address, with R/W* bit as R.
+ *  @li Recieve one I2C byte of read data at EEaddress.
+ *  @li Send High Ack after single byte to be read.
+ *  @li Send Stop condx.
+ *
+ *  @note Expected return status will be "HAL_BUSY"
+ *  @note Some time in future status will be "HAL_OK" once receive process is complete.
+ *
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
+ * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
+ * @param pByteBuffer - Pointer to  single byte rx buffer, external to this function.
+ *
+ * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
+ *
+ */
+
+HAL_StatusTypeDef sEEPromRandomAddrByteRead(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer)
+{
+	HAL_StatusTypeDef I2CWriteStatus;
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+
+	// Non blocking (interrupt based) call to read some bytes, once the previous transfer is done.
+	// EEaddress is supplied as a parameter - so would use "HAL_I2C_Mem_Read_IT(..)"
+	I2CWriteStatus = sEE_I2C_StartXfer(hi2c, SEE_XFER_MEM_READ, HAL_DevAddr, EEaddress, AT24C_MEMADD_SIZE, pByteBuffer, (uint16_t) 1);
+
+	return I2CWriteStatus;
+}
+
+
+/**
+ * @brief Read multiple bytes, max of 64 (page size) from serial EEprom.
+ * <pre>
+ *	This function reads multiple bytes to a particular eeprom device
+ *	specified by DevAddress, Starting at memory at location EEaddress.
+ *
+ *	When less than 64 bytes to be read,
+ *	"last 6 bits of EEaddress" + "bufferlength"  must be <= 64.
+ *	otherwise, upper bytes of data read will come from areas before
+ *	the starting EEaddress when last 6 bytes of EEaddress increment
+ *	beyond page boundry.
+ *
+ *	This function is "non blocking", so it just starts this process running, by
+ *	passing in for the I2C_Handle structure the desired communications information,
+ *	and then calling the HAL initiation function: HAL_I2C_Mem_Read_IT(..),
+ *	which updates the I2C_Handle structure for the duration this process will run.
+ *
+ *	The total process is expected to run as follows:
+ *  @li Send Start condx. Send one byte Device address, with R/W* bit as W*.
+ *  @li Send Two I2C bytes for two byte EEaddress. (Low Ack bit returned after each byte.)
+ *  @li Send Second Start condx. Send same one byte Device address, with R/W* bit as R.
+ *  @li Recieve 1 to 64 I2C bytes of read data starting at EEaddress. ( Send Low Ack to start next byte.)
+ *  @li Send High Ack after final byte to be read.
+ *  @li Send Stop condx.
+ *
+ *  @note Expected return status will be "HAL_BUSY"
+ *  @note Some time in future status will be "HAL_OK" once receive process is complete.
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param DevAddress - I2C device address to load into *hi2c. (normally only use 8 bits or less)
+ * @param EEaddress  - EE memory address to load into *hi2c. (0-0x7FFF, 32K 24C256K bit part)
+ * @param pByteBuffer - Pointer to multi-byte rx buffer, external to this function.
+ * @param bufferLength - Number of bytes to be sent, 1 to 64 presently.
+ *
+ * @returns retVal	  - One of: {HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT}
+ *
+ * ####### Could ensure expectedByteCount will never be  > sizeof buffer for pBytesRcvd
+ *
+ */
+
+HAL_StatusTypeDef sEEPromRandomAddrReadBytes(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress, uint8_t *pByteBuffer, uint8_t bufferLength)
+{
+	HAL_StatusTypeDef I2CWriteStatus;
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+
+	// Non blocking (interrupt based) call to read some bytes, once the previous transfer is done.
+	// EEaddress is supplied as a parameter - so would use "HAL_I2C_Mem_Read_IT(..)"
+	I2CWriteStatus = sEE_I2C_StartXfer(hi2c, SEE_XFER_MEM_READ, HAL_DevAddr, EEaddress, AT24C_MEMADD_SIZE, pByteBuffer, (uint16_t) bufferLength);
+
+	return I2CWriteStatus;
+}
+
+
+/// Bus recovery counters, (see S[x] status).
+sEEBusRecoveryStruct sEEBusRecovery;
+
+/// Last transfer started by sEE_I2C_StartXfer(..), started again if it gets stuck.
+typedef struct {
+	I2C_HandleTypeDef	*hi2c;
+	enumSEEXferKind		kind;
+	uint16_t			HAL_DevAddr;
+	uint16_t			memAddress;
+	uint16_t			memAddSize;
+	uint8_t				*pData;
+	uint16_t			size;
+	uint32_t			retries;			// Started again after an I2C error, (i2cRetry.h).
+} sEEXferStruct;
+
+static sEEXferStruct lastXfer;
+
+/**
+ * @brief Start lastXfer, retry when it failed and is being started again, (same trace record).
+ */
+static HAL_StatusTypeDef startLastXfer(bool retry)
+{
+	HAL_StatusTypeDef status;
+
+	if (retry)
+	{
+		i2cTraceRetry(lastXfer.hi2c);
+	}
+	if (lastXfer.kind == SEE_XFER_MEM_WRITE)
+	{
+		if (!retry)
+		{
+			i2cTraceBegin(lastXfer.hi2c, I2CTRACE_MEM_WRITE, lastXfer.HAL_DevAddr, lastXfer.memAddress, lastXfer.size);
+		}
+		status = HAL_I2C_Mem_Write_IT(lastXfer.hi2c, lastXfer.HAL_DevAddr, lastXfer.memAddress, lastXfer.memAddSize,
+									  lastXfer.pData, lastXfer.size);
+	}
+	else
+	{
+		if (!retry)
+		{
+			i2cTraceBegin(lastXfer.hi2c, I2CTRACE_MEM_READ, lastXfer.HAL_DevAddr, lastXfer.memAddress, lastXfer.size);
+		}
+		status = HAL_I2C_Mem_Read_IT(lastXfer.hi2c, lastXfer.HAL_DevAddr, lastXfer.memAddress, lastXfer.memAddSize,
+									 lastXfer.pData, lastXfer.size);
+	}
+	if (status != HAL_OK)
+	{
+		i2cTraceDone(lastXfer.hi2c, status);
+	}
+	return status;
+}
+
+/**
+ * @brief true if the transfer running on hi2c is the last one sEE_I2C_StartXfer(..) started.
+ *        (A background fill, or other user of the bus, starts its own.)
+ */
+static bool lastXferRunning(I2C_HandleTypeDef *hi2c)
+{
+	return (lastXfer.hi2c == hi2c) && (hi2c->State != HAL_I2C_STATE_READY) &&
+		   (hi2c->Devaddress == lastXfer.HAL_DevAddr) && (hi2c->Memaddress == lastXfer.memAddress) &&
+		   (hi2c->XferSize == lastXfer.size);
+}
+
+/**
+ * @brief true if the transfer that just ended on hi2c, with an error, was the last one sEE_I2C_StartXfer(..) started.
+ */
+static bool lastXferFailed(I2C_HandleTypeDef *hi2c)
+{
+	return (lastXfer.hi2c == hi2c) && (hi2c->State == HAL_I2C_STATE_READY) &&
+		   (hi2c->ErrorCode != HAL_I2C_ERROR_NONE) && (hi2c->Devaddress == lastXfer.HAL_DevAddr) &&
+		   (hi2c->Memaddress == lastXfer.memAddress) && (hi2c->XferSize == lastXfer.size);
+}
+
+/**
+ * @brief Spin for a retry backoff, on the DWT cycle counter, (i2cTrace.c starts it).
+ */
+static void retryBackoff(uint32_t backoffUs)
+{
+	uint32_t start	= i2cTraceNow();
+	uint32_t cycles = backoffUs * (SystemCoreClock / 1000000U);
+
+	while ((i2cTraceNow() - start) < cycles)
+	{
+		STM32vldisc_LEDToggle(LED3);
+	}
+}
+
+/**
+ * @brief true while hi2c is an I2C slave in listen mode, (i2cSlaveEE.c), not ours to use or recover.
+ */
+static bool slaveListening(I2C_HandleTypeDef *hi2c)
+{
+	return (hi2c->State & HAL_I2C_STATE_LISTEN) == HAL_I2C_STATE_LISTEN;
+}
+
+/**
+ * @brief Spin until the handle is ready and the bus is free, or the bus is stuck.
+ * <pre>
+ *	Stuck is one of:
+ *	@li Transfer running, but no byte moved for SEE_I2C_STUCK_MS, (lost
+ *		interrupt, slave holding SCL low).
+ *	@li Handle ready, but the BUSY flag still set after SEE_I2C_BUSY_FLAG_MS,
+ *		(slave holding SDA low after a transfer was cut off mid byte).
+ *
+ *	A transfer that keeps moving bytes is never stuck, however long it runs
+ *	(background fill), and tWR ack polling, 10ms max, is inside the limit.
+ *	Nor is a bus queue, (i2cBus.c), while its transfers end or are retried.
+ * </pre>
+ *
+ * @returns HAL_OK once ready, HAL_TIMEOUT if stuck.
+ */
+static HAL_StatusTypeDef waitBusFree(I2C_HandleTypeDef *hi2c)
+{
+	HAL_I2C_StateTypeDef lastState = hi2c->State;
+	uint16_t			 lastCount	= hi2c->XferCount;
+	uint32_t			 lastEvents = i2cBusEvents(hi2c);
+	uint32_t			 lastTick	= HAL_GetTick();
+	HAL_I2C_StateTypeDef state;
+	uint16_t			 count;
+	uint32_t			 events;
+
+	for (;;)
+	{
+		state  = hi2c->State;
+		count  = hi2c->XferCount;
+		events = i2cBusEvents(hi2c);
+
+		if ((state == HAL_I2C_STATE_READY) && (__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY) == RESET))
+		{
+			return HAL_OK;
+		}
+
+		if ((state != lastState) || (count != lastCount) || (events != lastEvents))
+		{
+			// Progress, restart the clock.
+			lastState  = state;
+			lastCount  = count;
+			lastEvents = events;
+			lastTick   = HAL_GetTick();
+		}
+		else if ((HAL_GetTick() - lastTick) > ((state == HAL_I2C_STATE_READY) ? SEE_I2C_BUSY_FLAG_MS : SEE_I2C_STUCK_MS))
+		{
+			if (state == HAL_I2C_STATE_READY)
+			{
+				sEEBusRecovery.busyFlagHeld++;
+			}
+			else
+			{
+				sEEBusRecovery.stuckTransfers++;
+			}
+			return HAL_TIMEOUT;
+		}
+
+		// Transfer still running in the I2C ISR's.
+		STM32vldisc_LEDToggle(LED3);
+	}
+}
+
+/**
+ * @brief Bus is stuck: recover it, and if the stuck transfer was ours start it again.
+ *
+ * @returns HAL_OK with the bus free, (and any replay finished), else HAL_ERROR.
+ */
+static HAL_StatusTypeDef recoverAndReplay(I2C_HandleTypeDef *hi2c)
+{
+	bool replay = lastXferRunning(hi2c);
+
+	if (sEE_I2C_PartReset(hi2c) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+	if (!replay)
+	{
+		return HAL_OK;
+	}
+
+	sEEBusRecovery.replays++;
+	if ((startLastXfer(false) != HAL_OK) || (waitBusFree(hi2c) != HAL_OK))
+	{
+		// Stuck again straight away, give up on it, but leave the bus usable.
+		sEE_I2C_PartReset(hi2c);
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+/**
+ * @brief Wait for the previous non blocking I2C transfer to finish.
+ * <pre>
+ *	The sEEProm functions above return as soon as the transfer has been
+ *	started.  This spins (as those functions do before starting) until the
+ *	HAL I2C state machine is back to ready, then reports how it ended.
+ *
+ *	If the transfer gets stuck the bus is recovered, (sEE_I2C_PartReset),
+ *	and the transfer is started again, so the caller only sees the delay.
+ *	If it ends with NACK, arbitration lost or bus error it is started again
+ *	after its backoff, as often as i2cRetry.h allows, so a read while the
+ *	part is still in tWR just takes longer.
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ *
+ * @returns retVal	  - HAL_OK if transfer completed, HAL_ERROR if it ended with an I2C error (NACK etc.)
+ *						HAL_TIMEOUT if the bus stayed stuck, HAL_BUSY if hi2c is listening as a slave.
+ *
+ */
+HAL_StatusTypeDef sEEPromWaitForIdle(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t backoffUs;
+
+	if (slaveListening(hi2c))
+	{
+		return HAL_BUSY;
+	}
+	if ((waitBusFree(hi2c) != HAL_OK) && (recoverAndReplay(hi2c) != HAL_OK))
+	{
+		return HAL_TIMEOUT;
+	}
+
+	while (lastXferFailed(hi2c) && i2cRetryNext(hi2c->ErrorCode, lastXfer.retries, &backoffUs))
+	{
+		lastXfer.retries++;
+		retryBackoff(backoffUs);
+		if (startLastXfer(true) != HAL_OK)
+		{
+			return HAL_ERROR;
+		}
+		if ((waitBusFree(hi2c) != HAL_OK) && (recoverAndReplay(hi2c) != HAL_OK))
+		{
+			return HAL_TIMEOUT;
+		}
+	}
+
+	return (hi2c->ErrorCode == HAL_I2C_ERROR_NONE) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Wait until a new transfer can be started on hi2c.
+ * <pre>
+ *	As sEEPromWaitForIdle(..), but how the previous transfer ended does not
+ *	matter.  Use this in place of spinning on hi2c->State, which never ends
+ *	if the bus is stuck.
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ *
+ * @returns retVal	  - HAL_OK when ready, HAL_TIMEOUT if the bus could not be recovered,
+ *						HAL_BUSY if hi2c is listening as a slave.
+ *
+ */
+HAL_StatusTypeDef sEEPromWaitForReady(I2C_HandleTypeDef *hi2c)
+{
+	if (slaveListening(hi2c))
+	{
+		return HAL_BUSY;
+	}
+	if ((waitBusFree(hi2c) != HAL_OK) && (recoverAndReplay(hi2c) != HAL_OK))
+	{
+		return HAL_TIMEOUT;
+	}
+	return HAL_OK;
+}
+
+/**
+ * @brief Start a non blocking memory read or write once the bus is free, kept for replay.
+ * <pre>
+ *	If the HAL gives up on the start because the bus BUSY flag stayed set,
+ *	(it waits 25ms for it), the bus is recovered and the start tried again.
+ * </pre>
+ *
+ * @param hi2c 		  - pointer to I2C_HandleTypeDef.
+ * @param kind		  - Memory write or read.
+ * @param HAL_DevAddr - 7 bit device address << 1.
+ * @param memAddress  - Memory address in the device.
+ * @param memAddSize  - I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT.
+ * @param pData		  - Data to write, or buffer for data read, must stay valid until the transfer is done.
+ * @param size		  - Bytes.
+ *
+ * @returns retVal	  - As HAL_I2C_Mem_Write_IT(..) / HAL_I2C_Mem_Read_IT(..), HAL_BUSY if the bus is stuck.
+ *
+ */
+HAL_StatusTypeDef sEE_I2C_StartXfer(I2C_HandleTypeDef *hi2c, enumSEEXferKind kind, uint16_t HAL_DevAddr, uint16_t memAddress,
+									uint16_t memAddSize, uint8_t *pData, uint16_t size)
+{
+	HAL_StatusTypeDef status;
+
+	if (sEEPromWaitForReady(hi2c) != HAL_OK)
+	{
+		return HAL_BUSY;
+	}
+
+	lastXfer.hi2c		 = hi2c;
+	lastXfer.kind		 = kind;
+	lastXfer.HAL_DevAddr = HAL_DevAddr;
+	lastXfer.memAddress	 = memAddress;
+	lastXfer.memAddSize	 = memAddSize;
+	lastXfer.pData		 = pData;
+	lastXfer.size		 = size;
+	lastXfer.retries	 = 0;
+
+	status = startLastXfer(false);
+	if ((status == HAL_BUSY) && (hi2c->State == HAL_I2C_STATE_READY))
+	{
+		sEEBusRecovery.busyFlagHeld++;
+		if (sEE_I2C_PartReset(hi2c) == HAL_OK)
+		{
+			status = startLastXfer(false);
+		}
+	}
+	return status;
+}
+
+/**
+ * @brief Wait out the eeprom internal write cycle tWR by ACKNOWLEDGE POLLING.
+ * <pre>
+ *	After a write STOP the AT24C256 ignores its address until the internal
+ *	write cycle is over (10ms max).  Rather than always delaying 10ms, keep
+ *	sending the device address until it is acknowledged.
+ *
+ *	Also waits for any non blocking transfer still in progress, so this is
+ *	safe to call before any eeprom access.
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ * @param addr7Bit	 - 7 bit eeprom device address.
+ *
+ * @returns retVal	  - HAL_OK once device acknowledges, else HAL_ERROR / HAL_TIMEOUT / HAL_BUSY.
+ *
+ */
+HAL_StatusTypeDef sEEPromAckPoll(I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit)
+{
+	// The HAL device addr is u16, (7 bit addr shifted 1 bit left).
+	uint16_t		  HAL_DevAddr = ((uint16_t)addr7Bit << 1);
+	uint32_t		  startTick;
+	uint32_t		  polls = 0;
+	HAL_StatusTypeDef retVal;
+
+	sEEPromWaitForReady(hi2c);
+	i2cTraceBegin(hi2c, I2CTRACE_ACK_POLL, HAL_DevAddr, 0, 0);
+
+	// A trial is one START + device address, ~25us at 400KHz, so a fixed
+	// trial count does not cover tWR at every bus speed.  Poll by time,
+	// 1 tick extra for the partial tick at start.
+	startTick = HAL_GetTick();
+	do
+	{
+		retVal = HAL_I2C_IsDeviceReady(hi2c, HAL_DevAddr, AT24C_ACK_POLL_TRIALS, (uint32_t)AT24C_TWR_MAX_MS);
+		if (retVal == HAL_ERROR)
+		{
+			polls += AT24C_ACK_POLL_TRIALS;
+		}
+	} while ((retVal == HAL_ERROR) && ((HAL_GetTick() - startTick) <= AT24C_TWR_MAX_MS));
+
+	i2cTraceAckPolls(hi2c, polls);
+	i2cTraceDone(hi2c, retVal);
+	return retVal;
+}
+
+
+/**
+ * @brief SCL / SDA pins of an I2C peripheral, (as HAL_I2C_MspInit sets them up).
+ */
+static bool busPins(I2C_HandleTypeDef *hi2c, GPIO_TypeDef **pPort, uint16_t *pScl, uint16_t *pSda)
+{
+	if (hi2c->Instance == I2C2)
+	{
+		*pPort = GPIOB;
+		*pScl  = GPIO_PIN_10;
+		*pSda  = GPIO_PIN_11;
+		return true;
+	}
+	if (hi2c->Instance == I2C1)
+	{
+		*pPort = GPIOB;
+		*pScl  = GPIO_PIN_6;
+		*pSda  = GPIO_PIN_7;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Half an SCL period while clocking the bus by hand, (loop count, at least SEE_I2C_RECOVER_HALF_US).
+ */
+static void recoverDelay(void)
+{
+	__IO uint32_t loops = (SystemCoreClock / 1000000U) * SEE_I2C_RECOVER_HALF_US / 4U;
+
+	while (loops != 0)
+	{
+		loops--;
+	}
+}
+
+/**
+ * @brief Reset the I2C serial eeprom by this I2C transmission.
+ * <pre>
+ *   Ref: AT24C128/256 data sheets - 0670FSEEPR2/02
+ *
+ *	 MEMORY RESET: After an interruption in protocol, power loss or system reset, any 2-wire
+ *	 part can be reset by following these steps: (a) Clock up to 9 cycles, (b) look for SDA high in
+ *	 each cycle while SCL is high and then (c) create a start condition as SDA is high.
+ *
+ *	A slave cut off in the middle of a byte it is sending holds SDA low
+ *	until it has clocked out the rest of it.  The STM32 I2C can not make
+ *	those clocks, so the pins are taken over as GPIO for the reset.
+ *
+ *	The total process is expected to run as follows:
+ *
+ *  @li 1) HAL_I2C_DeInit, peripheral and its interrupts off, (a transfer in progress is dropped).
+ *  @li 2) SCL / SDA as open drain GPIO, both released high.
+ *  @li 3) Up to 9 SCL pulses, stopping as soon as SDA reads high with SCL high.
+ *  @li 4) START then STOP, every slave is now idle waiting for a START.
+ *  @li 5) HAL_I2C_Init, pins back to the peripheral.  If the BUSY flag is still
+ *		   set, (F1 errata, glitch seen on the pins), software reset the peripheral and init again.
+ *  @li 6) A dropped transfer gets HAL_I2C_ErrorCallback with HAL_I2C_ERROR_TIMEOUT,
+ *		   so its owner, (e.g. background fill), knows it will never complete.
+ *
+ *	About 100us at 100 KHz plus the init, no board reset needed.  Whether the
+ *	dropped transfer is started again is up to the caller, see sEEPromWaitForIdle(..)
+ * </pre>
+ *
+ * @param hi2c 		 - pointer to I2C_HandleTypeDef, (info struct for this I2C transaction in process).
+ *
+ * @returns retVal	  - HAL_OK if the bus is free again, HAL_ERROR if SDA is still held low,
+ *						or hi2c is not a peripheral with known pins.
+ *
+ */
+HAL_StatusTypeDef  sEE_I2C_PartReset(I2C_HandleTypeDef *hi2c)
+{
+	GPIO_InitTypeDef GPIO_InitStruct;
+	GPIO_TypeDef	*port;
+	uint16_t		 sclPin;
+	uint16_t		 sdaPin;
+	uint32_t		 clocks;
+	bool			 dropped = (hi2c->State != HAL_I2C_STATE_READY);
+	bool			 sdaReleased;
+
+	if (!busPins(hi2c, &port, &sclPin, &sdaPin))
+	{
+		return HAL_ERROR;
+	}
+	sEEBusRecovery.recoveries++;
+
+	// 1) Peripheral off.
+	HAL_I2C_DeInit(hi2c);
+
+	// 2) Pins as open drain outputs, released.
+	HAL_GPIO_WritePin(port, sclPin | sdaPin, GPIO_PIN_SET);
+	GPIO_InitStruct.Pin	  = sclPin | sdaPin;
+	GPIO_InitStruct.Mode  = GPIO_MODE_OUTPUT_OD;
+	GPIO_InitStruct.Pull  = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	HAL_GPIO_Init(port, &GPIO_InitStruct);
+	recoverDelay();
+
+	// 3) Clock the slave through the rest of its byte until it lets go of SDA.
+	for (clocks = 0; (clocks < SEE_I2C_RECOVER_CLOCKS) && (HAL_GPIO_ReadPin(port, sdaPin) == GPIO_PIN_RESET); clocks++)
+	{
+		HAL_GPIO_WritePin(port, sclPin, GPIO_PIN_RESET);
+		recoverDelay();
+		HAL_GPIO_WritePin(port, sclPin, GPIO_PIN_SET);
+		recoverDelay();
+	}
+	sEEBusRecovery.lastRecoverClocks = clocks;
+	sdaReleased = (HAL_GPIO_ReadPin(port, sdaPin) == GPIO_PIN_SET);
+
+	// 4) START, (SDA falls with SCL high), then STOP, (SDA rises with SCL high).
+	HAL_GPIO_WritePin(port, sdaPin, GPIO_PIN_RESET);
+	recoverDelay();
+	HAL_GPIO_WritePin(port, sdaPin, GPIO_PIN_SET);
+	recoverDelay();
+
+	// 5) Peripheral back on, HAL_I2C_MspInit gives it the pins again.
+	HAL_I2C_Init(hi2c);
+	if (__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY) != RESET)
+	{
+		SET_BIT(hi2c->Instance->CR1, I2C_CR1_SWRST);
+		CLEAR_BIT(hi2c->Instance->CR1, I2C_CR1_SWRST);
+		HAL_I2C_Init(hi2c);
+	}
+
+	// 6) Tell the owner of a dropped transfer.
+	if (dropped)
+	{
+		hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+		HAL_I2C_ErrorCallback(hi2c);
+	}
+
+	if (!sdaReleased || (__HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY) != RESET))
+	{
+		sEEBusRecovery.recoverFailed++;
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+/*
+ * Non blocking operations, see serialEEProm.h.
+ */
+
+/**
+ * @brief i2cBus done handler of every op, passes the end on to the op's own handler.
+ */
+static void opXferDone(i2cBusXfer *pXfer)
+{
+	sEEPromOp *pOp = (sEEPromOp *)pXfer->pContext;
+
+	if (pOp->done != NULL)
+	{
+		pOp->done(pOp);
+	}
+}
+
+/**
+ * @brief Fill in pOp and queue it on the bus of hi2c.
+ *
+ * @returns HAL_OK if queued, HAL_ERROR if hi2c is not a bus instance or length 0, HAL_BUSY if its queue is full.
+ */
+static HAL_StatusTypeDef opSubmit(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, bool isRead,
+								  uint16_t memAddSize, uint16_t EEaddress, uint8_t *pData, uint16_t length,
+								  sEEPromOpDoneHandler done, void *pContext)
+{
+	pOp->bus = i2cBusOfHandle(hi2c);
+	if ((pOp->bus == I2CBUS_COUNT) || (length == 0))
+	{
+		return HAL_ERROR;
+	}
+	pOp->done	  = done;
+	pOp->pContext = pContext;
+
+	pOp->xfer.devAddr7Bit = addr7Bit;
+	pOp->xfer.isRead	  = isRead;
+	pOp->xfer.memAddSize  = memAddSize;
+	pOp->xfer.memAddress  = EEaddress;
+	pOp->xfer.pData		  = pData;
+	pOp->xfer.size		  = length;
+	pOp->xfer.done		  = opXferDone;
+	pOp->xfer.pContext	  = pOp;
+
+	return i2cBusSubmit(pOp->bus, &pOp->xfer) ? HAL_OK : HAL_BUSY;
+}
+
+/**
+ * @brief Queue a write of up to one page, as sEEPromBytesWrite(..) but returns at once.
+ * <pre>
+ *	A write started while the part is still in tWR from an earlier one is
+ *	NACKed and started again by the bus queue, so ops can be queued back
+ *	to back without ack polling in between.
+ * </pre>
+ *
+ * @param pOp		 - Op to fill in, must stay put until sEEPromOpDone(..), (or its done handler).
+ * @param hi2c		 - I2C handle, &hi2c2 or &hi2c1.
+ * @param addr7Bit	 - 7 bit eeprom device address.
+ * @param EEaddress	 - First byte, writes past the page end wrap to the page start.
+ * @param pData		 - Bytes to write, must not change until done.
+ * @param length	 - 1 .. AT24C_PAGE_SIZE.
+ * @param done		 - Called in interrupt context when the op ends, NULL for none.
+ * @param pContext	 - For done, (pOp->pContext).
+ *
+ * @returns retVal	  - HAL_OK if queued, HAL_BUSY if the queue is full, HAL_ERROR for bad parameters.
+ */
+HAL_StatusTypeDef sEEPromOpWrite(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress,
+								 uint8_t *pData, uint16_t length, sEEPromOpDoneHandler done, void *pContext)
+{
+	HAL_StatusTypeDef status;
+
+	if (length > AT24C_PAGE_SIZE)
+	{
+		return HAL_ERROR;
+	}
+	status = opSubmit(pOp, hi2c, addr7Bit, false, AT24C_MEMADD_SIZE, EEaddress, pData, length, done, pContext);
+	if ((status == HAL_OK) && (pOp->bus == I2CBUS_EE))
+	{
+		eeCrcNoteWrite(addr7Bit, EEaddress, pData, length);
+	}
+	return status;
+}
+
+/**
+ * @brief Queue a random address read, as sEEPromRandomAddrReadBytes(..) but returns at once.
+ * <pre>
+ *	pData is only valid once sEEPromOpStatus(..) is HAL_OK, until then the
+ *	caller is free to get on with anything that does not touch it.
+ * </pre>
+ *
+ * @param pOp		 - Op to fill in, must stay put until done.
+ * @param hi2c		 - I2C handle, &hi2c2 or &hi2c1.
+ * @param addr7Bit	 - 7 bit eeprom device address.
+ * @param EEaddress	 - First byte, reads wrap at the end of the part.
+ * @param pData		 - Buffer for the bytes read.
+ * @param length	 - Bytes, any number.
+ * @param done		 - Called in interrupt context when the op ends, NULL for none.
+ * @param pContext	 - For done, (pOp->pContext).
+ *
+ * @returns retVal	  - HAL_OK if queued, HAL_BUSY if the queue is full, HAL_ERROR for bad parameters.
+ */
+HAL_StatusTypeDef sEEPromOpRead(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit, uint16_t EEaddress,
+								uint8_t *pData, uint16_t length, sEEPromOpDoneHandler done, void *pContext)
+{
+	return opSubmit(pOp, hi2c, addr7Bit, true, AT24C_MEMADD_SIZE, EEaddress, pData, length, done, pContext);
+}
+
+/**
+ * @brief Queue a current address read, as sEEPromCurrentAddrReadBytes(..) but returns at once.
+ *
+ * @returns retVal	  - HAL_OK if queued, HAL_BUSY if the queue is full, HAL_ERROR for bad parameters.
+ */
+HAL_StatusTypeDef sEEPromOpCurrentAddrRead(sEEPromOp *pOp, I2C_HandleTypeDef *hi2c, enumAT24C_7BitAddr addr7Bit,
+										   uint8_t *pData, uint16_t length, sEEPromOpDoneHandler done, void *pContext)
+{
+	return opSubmit(pOp, hi2c, addr7Bit, true, 0, 0, pData, length, done, pContext);
+}
+
+/**
+ * @brief true once the op has ended, ok or not, (never blocks).
+ */
+bool sEEPromOpDone(const sEEPromOp *pOp)
+{
+	return i2cBusXferDone(&pOp->xfer);
+}
+
+/**
+ * @brief How the op ended, HAL_BUSY while it has not, see serialEEProm.h.
+ */
+HAL_StatusTypeDef sEEPromOpStatus(const sEEPromOp *pOp)
+{
+	switch (pOp->xfer.errorCode)
+	{
+	case I2CBUS_XFER_PENDING:		return HAL_BUSY;
+	case HAL_I2C_ERROR_NONE:		return HAL_OK;
+	case HAL_I2C_ERROR_TIMEOUT:		return HAL_TIMEOUT;
+	default:						return HAL_ERROR;
+	}
+}
+
+/**
+ * @brief Spin until the op has ended, recovering a stuck bus on the way.
+ * <pre>
+ *	A stuck transfer ahead of the op, (or the op itself), is dropped by the
+ *	bus recovery and ends as HAL_TIMEOUT, the queue then carries on.
+ * </pre>
+ *
+ * @returns retVal	  - Final status of the op, or HAL_TIMEOUT with the op still
+ *						queued after SEE_OP_WAIT_MS, (it must not be reused until done).
+ */
+HAL_StatusTypeDef sEEPromOpWait(sEEPromOp *pOp)
+{
+	I2C_HandleTypeDef *hi2c		 = i2cBusState[pOp->bus].hi2c;
+	uint32_t		   startTick = HAL_GetTick();
+
+	while (!sEEPromOpDone(pOp))
+	{
+		if (((HAL_GetTick() - startTick) > SEE_OP_WAIT_MS) || (sEEPromWaitForReady(hi2c) == HAL_TIMEOUT))
+		{
+			return sEEPromOpDone(pOp) ? sEEPromOpStatus(pOp) : HAL_TIMEOUT;
+		}
+		// Queue waiting for the handle, (another user had it).
+		i2cBusService();
+		STM32vldisc_LEDToggle(LED3);
+	}
+	return sEEPromOpStatus(pOp);
+}
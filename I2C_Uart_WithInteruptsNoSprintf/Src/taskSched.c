@@ -0,0 +1,271 @@
+/**
+  @file taskSched.c
+  @brief Run to completion task scheduler, see taskSched.h
+<pre>
+	The table is only changed and run from the main loop, SysTick reads
+	just armed and nextDueMs, which arm(..) writes with interrupts off.
+	Due times compare as (int32_t)(now - due) >= 0, good across the
+	HAL_GetTick() wrap for anything due within 24 days.
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	04/03/2018
+
+*/
+#include <string.h>
+#include "taskSched.h"
+#include "mainEvent.h"
+#include "i2cTrace.h"
+
+/// Task table and stats.
+taskSchedStateStruct taskSchedState;
+
+
+static bool isDue(const taskSchedTaskStruct *pTask, uint32_t now)
+{
+	return pTask->timed && ((int32_t)(now - pTask->dueMs) >= 0);
+}
+
+/**
+ * @brief Have SysTick wake the main loop at the earliest due time, (the next tick if it has passed).
+ */
+static void arm(void)
+{
+	uint32_t primask;
+	uint32_t next	= 0;
+	bool	 timed	= false;
+	uint8_t	 id;
+
+	for (id = 0; id < taskSchedState.count; id++)
+	{
+		if (taskSchedState.tasks[id].timed && (!timed || ((int32_t)(taskSchedState.tasks[id].dueMs - next) < 0)))
+		{
+			next  = taskSchedState.tasks[id].dueMs;
+			timed = true;
+		}
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	taskSchedState.nextDueMs = next;
+	taskSchedState.armed	 = timed;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Empty table, nothing armed.
+ */
+void taskSchedInit(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	memset(&taskSchedState, 0, sizeof(taskSchedState));
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Add a task, it does not run until scheduled or made ready.
+ *
+ * @param name		 - For S[0x1D], kept as a pointer.
+ * @param priority	 - 0 highest.
+ * @param deadlineMs - Starting later than this after due counts a miss, 0 none.
+ * @param budgetUs	 - Running longer than this counts an overrun, 0 none.
+ *
+ * @returns id for the other calls, TASKSCHED_NONE if the table is full.
+ */
+uint8_t taskSchedAdd(const char *name, taskSchedFunc func, uint8_t priority, uint32_t deadlineMs, uint32_t budgetUs)
+{
+	taskSchedTaskStruct *pTask;
+
+	if ((taskSchedState.count == TASKSCHED_MAX) || (func == NULL))
+	{
+		return TASKSCHED_NONE;
+	}
+	pTask = &taskSchedState.tasks[taskSchedState.count];
+	memset(pTask, 0, sizeof(taskSchedTaskStruct));
+	pTask->name		  = name;
+	pTask->func		  = func;
+	pTask->priority	  = priority;
+	pTask->deadlineMs = deadlineMs;
+	pTask->budgetUs	  = budgetUs;
+	return taskSchedState.count++;
+}
+
+/**
+ * @brief Run id every periodMs, the first time firstMs from now, (a new period restarts the phase).
+ */
+void taskSchedPeriodic(uint8_t id, uint32_t periodMs, uint32_t firstMs)
+{
+	if ((id >= taskSchedState.count) || (periodMs == 0))
+	{
+		return;
+	}
+	taskSchedState.tasks[id].periodMs = periodMs;
+	taskSchedState.tasks[id].dueMs	  = HAL_GetTick() + firstMs;
+	taskSchedState.tasks[id].timed	  = true;
+	arm();
+}
+
+/**
+ * @brief Run id once, delayMs from now, (replaces any period or one shot pending).
+ */
+void taskSchedOnce(uint8_t id, uint32_t delayMs)
+{
+	if (id >= taskSchedState.count)
+	{
+		return;
+	}
+	taskSchedState.tasks[id].periodMs = 0;
+	taskSchedState.tasks[id].dueMs	  = HAL_GetTick() + delayMs;
+	taskSchedState.tasks[id].timed	  = true;
+	arm();
+}
+
+/**
+ * @brief Run id on the next pass, as well as when it is due, main loop only.
+ */
+void taskSchedReady(uint8_t id)
+{
+	if (id < taskSchedState.count)
+	{
+		taskSchedState.tasks[id].ready = true;
+	}
+}
+
+/**
+ * @brief No more runs of id until it is scheduled or made ready again.
+ */
+void taskSchedStop(uint8_t id)
+{
+	if (id >= taskSchedState.count)
+	{
+		return;
+	}
+	taskSchedState.tasks[id].timed = false;
+	taskSchedState.tasks[id].ready = false;
+	arm();
+}
+
+/**
+ * @brief Run every task due or ready, highest priority first, each once, main loop only.
+ * <pre>
+ *	Due times are looked at again after each task, one that comes due while
+ *	a lower priority task runs goes ahead of the rest.
+ * </pre>
+ *
+ * @returns tasks run.
+ */
+uint32_t taskSchedRun(void)
+{
+	taskSchedTaskStruct *pTask;
+	uint32_t			 ranMask = 0;
+	uint32_t			 ran	 = 0;
+	uint32_t			 now;
+	uint32_t			 lateMs;
+	uint32_t			 start;
+	uint32_t			 cycles;
+	uint8_t				 best;
+	uint8_t				 id;
+
+	for (;;)
+	{
+		now	 = HAL_GetTick();
+		best = TASKSCHED_NONE;
+		for (id = 0; id < taskSchedState.count; id++)
+		{
+			pTask = &taskSchedState.tasks[id];
+			if (((ranMask & (1UL << id)) == 0) && (pTask->ready || isDue(pTask, now)) &&
+				((best == TASKSCHED_NONE) || (pTask->priority < taskSchedState.tasks[best].priority)))
+			{
+				best = id;
+			}
+		}
+		if (best == TASKSCHED_NONE)
+		{
+			break;
+		}
+		pTask	 = &taskSchedState.tasks[best];
+		ranMask |= 1UL << best;
+
+		if (isDue(pTask, now))
+		{
+			lateMs = now - pTask->dueMs;
+			if (lateMs > pTask->maxLateMs)
+			{
+				pTask->maxLateMs = lateMs;
+			}
+			if ((pTask->deadlineMs != 0) && (lateMs > pTask->deadlineMs))
+			{
+				pTask->misses++;
+			}
+			if (pTask->periodMs == 0)
+			{
+				pTask->timed = false;
+			}
+			else
+			{
+				pTask->dueMs += pTask->periodMs;
+				if (isDue(pTask, now))
+				{
+					pTask->dueMs = now + pTask->periodMs;		// A whole period behind, skip to now.
+				}
+			}
+		}
+		pTask->ready = false;
+
+		start = i2cTraceNow();
+		pTask->func();
+		cycles = i2cTraceNow() - start;
+
+		pTask->runs++;
+		pTask->totalCycles += cycles;
+		if (cycles > pTask->maxCycles)
+		{
+			pTask->maxCycles = cycles;
+		}
+		if ((pTask->budgetUs != 0) && (i2cTraceCyclesToUs(cycles) > pTask->budgetUs))
+		{
+			pTask->overruns++;
+		}
+		ran++;
+	}
+
+	if (ran != 0)
+	{
+		taskSchedState.passes++;
+	}
+	arm();
+	return ran;
+}
+
+/**
+ * @brief Start the stats again, runs, times, overruns, misses.
+ */
+void taskSchedClearStats(void)
+{
+	uint8_t id;
+
+	for (id = 0; id < taskSchedState.count; id++)
+	{
+		taskSchedState.tasks[id].runs		 = 0;
+		taskSchedState.tasks[id].overruns	 = 0;
+		taskSchedState.tasks[id].misses		 = 0;
+		taskSchedState.tasks[id].maxLateMs	 = 0;
+		taskSchedState.tasks[id].maxCycles	 = 0;
+		taskSchedState.tasks[id].totalCycles = 0;
+	}
+	taskSchedState.passes = 0;
+}
+
+/**
+ * @brief Post MAINEVT_TICK when the earliest due time is reached, call from SysTick_Handler.
+ */
+void taskSchedOnTick(void)
+{
+	if (taskSchedState.armed && ((int32_t)(HAL_GetTick() - taskSchedState.nextDueMs) >= 0))
+	{
+		taskSchedState.armed = false;
+		mainEventPost(MAINEVT_TICK);
+	}
+}
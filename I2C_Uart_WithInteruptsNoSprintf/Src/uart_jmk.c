@@ -1,157 +1,249 @@
-/**
-  @file uart_jmk.c
-  @brief
-<pre>
-
-</pre>
-
-   @author 	Joe Kuss (JMK)
-   @date 	11/08/2017 - Original.
-   @date 	2/19/2018  - Added Doxygen comments, etc.
-
-*/
-#include <stdbool.h>
-#include <string.h>
-#include "stm32f100xb.h"
-#include "stm32f1xx_hal.h"
-#include "stm32f1xx_hal_uart.h"
-#include "uart_jmk.h"
-
-
-
-extern UART_HandleTypeDef huart1;
-
-/* Globally available buffers ------------------------------ */
-
-/// Incoming Data as picked up in "HAL_UART_Receive_IT" isr.
-uint8_t	Rx_data[2];
-
-/// Buffer holding latest incoming command.
-char	cmdBuffer[MSG_MAX_CHARS +1];
-
-/// Buffer holding outgoing response to command.
-char 	respBuffer[MSG_MAX_CHARS+1];
-
-char	strOf20CharsMax[21];
-char 	*crlf_msg = "\r\n";
-
-/// Flag indicating Command received, but not yet parsed/executed.
-bool	Cmd_Recieved = false;
-
-/* Private variables --------------------------------------- */
-int 	i=0;
-
-
-
-uint8_t	Rx_index=0;
-
-uint8_t	Rx_Buffer[MSG_MAX_CHARS +1]; // >= 1 of 0x00 to terminate msg string.
-
-
-
-//  HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
-/**
- * @brief Called upon reception of incoming UART data
- * <pre>
- * This routine is called by "UART_Receive_IT" which is
- * Called by HAL_UART_IRQHandler upon UART interrupt.
- *
- * Upon completion this routine calls HAL_UART_Receive_IT
- * which re activates UART interrupts to pick up the next byte.
- *
- * This routine replaces the "__weak " version of this routine,
- * located in stm32f1xx_hal_uart.c
- * </pre>
- *
- * @param huart - pointer to UART_HandleTypeDef
- *
- */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
-{
-	uint32_t i;
-	if (huart->Instance == USART1) // Current UART
-	{
-		if (Rx_index == 0)
-		{
-			for (i=0; i<256; i++)
-			{
-				Rx_Buffer[i]=0; // Clear buffer before getting new data.
-								// This assures that it is 0 terminated.
-			}
-		}
-
-		// We presently require that end of line from "Enter" key,
-		// produces only a <CR> (0x0D) and not a <LF> (0x0A).
-		// This received byte <CR> is presently used as the end of message flag,
-		// and is not put into Rx_Buffer.
-
-		if ((Rx_data[0] != 0x0D) && (Rx_index<255))// If received data different than 13 <CR>
-		{										   // and we are not about to overflow buffer,
-												   // presently limit msg to 255 chars.
-												   // index 0..254 so Rx_Buffer[255] remains 0
-			Rx_Buffer[Rx_index++] = Rx_data[0];	   // to terminate string.
-
-		}
-		else
-		{
-			// If we receive Rx_data[0] == 0x0D, this byte will be ignored it is only a flag.
-			// Also if Rx_index == 255 we will also end up here to attempt to parse
-			// what we have so far since we will loose data if we go any further.
-
-			// Rx_index is set to zero for next time that we come back to get more
-			// incoming bytes.
-			Rx_index = 0;
-
-			strcpy(cmdBuffer, (char *) Rx_Buffer); // Save the raw buffer into cmd buffer.
-
-			Cmd_Recieved = true;	// Indicate  potential command received
-		}
-		HAL_UART_Receive_IT(&huart1, Rx_data, 1); // Activate UART rx interrupt every time get 1 byte..
-	}
-}		// end HAL_UART_RxCpltCallback
-
-
-/**
- * @brief Called when sending a string via the UART
- * <pre>
- *
- *	Note:	Blocking TX means that routine will not exit
- *			until all bytes are sent.
- *			Not blocking TX means that routine sets up
- *			Interrupts to send individual bytes but can
- *			exit after that.
- *
- *			Not blocking allows other processing to resume
- *		    before all bytes are sent, but it may NOT mean
- *		    it is ok to attempt to send another message before
- *		    all bytes are sent.
- *
- *
- * </pre>
- *
- * @param strToTransmit - pointer to null terminated character array to TX.
- * @param isBlocking - true for blocking TX of all bytes, false for non blocking.
- *
- *
- */
-void UartPutString(char *strToTransmit, bool isBlocking)
-{
-	HAL_StatusTypeDef eHAL_Status;
-	size_t 			  len;
-
-	len = 			strlen(strToTransmit);
-
-	if (isBlocking == true)
-	{
-		eHAL_Status = 	HAL_UART_Transmit(&huart1, (uint8_t *)strToTransmit, len, 1000); // Blocking.
-		// Will and wait inside this call up to 1000ms, for transmission of all bytes to complete
-	}
-	else
-	{
-		eHAL_Status = HAL_UART_Transmit_IT(&huart1, (uint8_t *)strToTransmit, len); // Non-Blocking.
-		// Will not wait for transmission of all bytes to complete, ISR's handle all needed bytes
-		HAL_Delay(100); // May need this delay, Especially if we attempt to initiate
-						// another transmission before this one has completed.
-						// Might expect to be able to send 1000 chars in 100 ms at 115Kb...
-	}
-}
+/**
+  @file uart_jmk.c
+  @brief
+<pre>
+
+</pre>
+
+   @author 	Joe Kuss (JMK)
+   @date 	11/08/2017 - Original.
+   @date 	2/19/2018  - Added Doxygen comments, etc.
+
+*/
+#include <stdbool.h>
+#include <string.h>
+#include "stm32f100xb.h"
+#include "stm32f1xx_hal.h"
+#include "stm32f1xx_hal_uart.h"
+#include "uart_jmk.h"
+#include "mainEvent.h"
+#include "pendWork.h"
+
+
+
+extern UART_HandleTypeDef huart1;
+
+/* Globally available buffers ------------------------------ */
+
+/// Incoming Data as picked up in "HAL_UART_Receive_IT" isr.
+uint8_t	Rx_data[2];
+
+/// Buffer holding latest incoming command.
+char	cmdBuffer[MSG_MAX_CHARS +1];
+
+/// Buffer holding outgoing response to command.
+char 	respBuffer[MSG_MAX_CHARS+1];
+
+char	strOf20CharsMax[21];
+char 	*crlf_msg = "\r\n";
+
+/// Flag indicating Command received, but not yet parsed/executed.
+bool	Cmd_Recieved = false;
+
+/* Private variables --------------------------------------- */
+int 	i=0;
+
+
+
+uint8_t	Rx_index=0;
+
+/// Two, one filling while the line in the other waits to be copied to cmdBuffer.
+uint8_t	Rx_Buffer[2][MSG_MAX_CHARS +1]; // >= 1 of 0x00 to terminate msg string.
+
+/// Rx_Buffer being filled.
+uint8_t	Rx_fill=0;
+
+/// Receive errors, HAL_UART_ErrorCallback(..)
+uint32_t Rx_overruns=0;
+uint32_t Rx_errors=0;
+
+
+/**
+ * @brief A line is in, PendSV work, (pendWork.h), posted by HAL_UART_RxCpltCallback(..)
+ *
+ * @param pLine - The Rx_Buffer it is in, null terminated.
+ */
+static void cmdLineIn(void *pLine)
+{
+	strcpy(cmdBuffer, (char *) pLine); // Save the raw buffer into cmd buffer.
+
+	Cmd_Recieved = true;	// Indicate  potential command received
+	mainEventPost(MAINEVT_COMMAND);		// Wake the main loop for it.
+}
+
+
+
+//  HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+/**
+ * @brief Called upon reception of incoming UART data
+ * <pre>
+ * This routine is called by "UART_Receive_IT" which is
+ * Called by HAL_UART_IRQHandler upon UART interrupt.
+ *
+ * Upon completion this routine calls HAL_UART_Receive_IT
+ * which re activates UART interrupts to pick up the next byte.
+ *
+ * Only the byte is stored here, the line is copied to cmdBuffer by
+ * cmdLineIn(..), PendSV work, so this takes tens of cycles rather than
+ * clearing and copying 256 byte buffers in the interrupt.
+ *
+ * This routine replaces the "__weak " version of this routine,
+ * located in stm32f1xx_hal_uart.c
+ * </pre>
+ *
+ * @param huart - pointer to UART_HandleTypeDef
+ *
+ */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if (huart->Instance == USART1) // Current UART
+	{
+		// We presently require that end of line from "Enter" key,
+		// produces only a <CR> (0x0D) and not a <LF> (0x0A).
+		// This received byte <CR> is presently used as the end of message flag,
+		// and is not put into Rx_Buffer.
+
+		if ((Rx_data[0] != 0x0D) && (Rx_index<255))// If received data different than 13 <CR>
+		{										   // and we are not about to overflow buffer,
+												   // presently limit msg to 255 chars.
+												   // index 0..254 so Rx_Buffer[255] remains 0
+			Rx_Buffer[Rx_fill][Rx_index++] = Rx_data[0];	// to terminate string.
+
+		}
+		else
+		{
+			// If we receive Rx_data[0] == 0x0D, this byte will be ignored it is only a flag.
+			// Also if Rx_index == 255 we will also end up here to attempt to parse
+			// what we have so far since we will loose data if we go any further.
+
+			// Terminate it, (rather than clearing the whole buffer first), Rx_index
+			// is set to zero for next time that we come back to get more
+			// incoming bytes.
+			Rx_Buffer[Rx_fill][Rx_index] = 0;
+			Rx_index = 0;
+
+			// The next line goes in the other buffer while this one is copied.
+			// Queue full, (never seen), the line is lost, the buffer reused.
+			if (pendWorkPost(cmdLineIn, Rx_Buffer[Rx_fill]))
+			{
+				Rx_fill ^= 1;
+			}
+		}
+		HAL_UART_Receive_IT(&huart1, Rx_data, 1); // Activate UART rx interrupt every time get 1 byte..
+	}
+}		// end HAL_UART_RxCpltCallback
+
+
+/**
+ * @brief Called upon a UART receive error, (HAL_UART_IRQHandler).
+ * <pre>
+ * The HAL has stopped the receive, so a byte lost to an overrun would
+ * otherwise end all command input.  Count it and start again, the line
+ * it was in is most likely bad and will get an error response.
+ *
+ * This routine replaces the "__weak " version of this routine,
+ * located in stm32f1xx_hal_uart.c
+ * </pre>
+ *
+ * @param huart - pointer to UART_HandleTypeDef
+ *
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	if (huart->Instance == USART1) // Current UART
+	{
+		if (huart->ErrorCode & HAL_UART_ERROR_ORE)
+		{
+			Rx_overruns++;
+		}
+		if (huart->ErrorCode & (HAL_UART_ERROR_FE | HAL_UART_ERROR_NE | HAL_UART_ERROR_PE))
+		{
+			Rx_errors++;
+		}
+		HAL_UART_Receive_IT(&huart1, Rx_data, 1); // Activate UART rx interrupt every time get 1 byte..
+	}
+}
+
+
+/**
+ * @brief Called when sending a string via the UART
+ * <pre>
+ *
+ *	Note:	Blocking TX means that routine will not exit
+ *			until all bytes are sent.
+ *			Not blocking TX means that routine sets up
+ *			Interrupts to send individual bytes but can
+ *			exit after that.
+ *
+ *			Not blocking allows other processing to resume
+ *		    before all bytes are sent, but it may NOT mean
+ *		    it is ok to attempt to send another message before
+ *		    all bytes are sent.
+ *
+ *
+ * </pre>
+ *
+ * @param strToTransmit - pointer to null terminated character array to TX.
+ * @param isBlocking - true for blocking TX of all bytes, false for non blocking.
+ *
+ *
+ */
+void UartPutString(char *strToTransmit, bool isBlocking)
+{
+	HAL_StatusTypeDef eHAL_Status;
+	size_t 			  len;
+	uint32_t		  tickStart;
+
+	len = 			strlen(strToTransmit);
+
+	if (isBlocking == true)
+	{
+		eHAL_Status = 	HAL_UART_Transmit(&huart1, (uint8_t *)strToTransmit, len, 1000); // Blocking.
+		// Will and wait inside this call up to 1000ms, for transmission of all bytes to complete
+	}
+	else
+	{
+		eHAL_Status = HAL_UART_Transmit_IT(&huart1, (uint8_t *)strToTransmit, len); // Non-Blocking.
+		// ISR's send the bytes, wait for the last before another transmission,
+		// (or strToTransmit), is started, at most the 100ms the fixed delay here
+		// used to be.  Might expect to be able to send 1000 chars in 100 ms at 115Kb...
+		tickStart = HAL_GetTick();
+		while ((eHAL_Status == HAL_OK) && (huart1.gState == HAL_UART_STATE_BUSY_TX) &&
+			   ((HAL_GetTick() - tickStart) < 100))
+		{
+		}
+	}
+}
+
+/**
+ * @brief One byte time at the baud rate in use, core clock cycles, (start, 8 data, stop bits).
+ */
+uint32_t UartByteCycles(void)
+{
+	return (uint32_t)(((uint64_t)SystemCoreClock * 10) / huart1.Init.BaudRate);
+}
+
+/**
+ * @brief Baud rate USART1 is actually at, PCLK2 / BRR, (BRR is set from the clock at init or clockProfileSet(..)).
+ */
+uint32_t UartBaud(void)
+{
+	return HAL_RCC_GetPCLK2Freq() / huart1.Instance->BRR;
+}
+
+/**
+ * @brief Send binary data via the UART, blocking.
+ * <pre>
+ *	For data that may hold 0 bytes, (UartPutString(..) stops at the first).
+ *	Does not return until all bytes are sent, so pData may be a local.
+ * </pre>
+ *
+ * @param pData  - Bytes to TX.
+ * @param length - Byte count.
+ *
+ */
+void UartPutBytes(const uint8_t *pData, uint16_t length)
+{
+	// HAL wants a non const pointer, but only reads from it for a TX.
+	HAL_UART_Transmit(&huart1, (uint8_t *)pData, length, 1000); // Blocking.
+}